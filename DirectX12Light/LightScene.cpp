@@ -0,0 +1,372 @@
+#include "LightScene.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+
+using namespace DirectX;
+using namespace std;
+
+const Vertex g_cubeVertex[CUBE_VERTEX_COUNT] =
+{
+	{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+	{ {1.0f, -1.0f, 1.0f}, { 1.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+	{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+
+	{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+	{ {-1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+	{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
+
+	{ {1.0f, 1.0f, -1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+	{ {1.0f, -1.0f, -1.0f}, { 1.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
+	{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
+
+	{ {1.0f, 1.0f, -1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+	{ {-1.0f, 1.0f, -1.0f}, { 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+	{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
+
+
+	{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {1.0f, 1.0f, -1.0f}, { 1.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {-1.0f, 1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+
+	{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {-1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+	{ {-1.0f, 1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
+
+	{ {1.0f, -1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } },
+	{ {1.0f, -1.0f, -1.0f}, { 1.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } },
+	{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } },
+
+	{ {1.0f, -1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } },
+	{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } },
+	{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } },
+
+
+	{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+	{ {1.0f, 1.0f, -1.0f}, { 1.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
+	{ {1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
+
+	{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+	{ {1.0f, -1.0f, 1.0f}, { 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+	{ {1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
+
+	{ {-1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
+	{ {-1.0f, 1.0f, -1.0f}, { 1.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } },
+	{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } },
+
+	{ {-1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
+	{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
+	{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } },
+};
+
+SoftwareShading g_softwareShading = {};
+
+vector<uint8_t> LoadTexture( const char* fileName )
+{
+	ifstream ifile( fileName, ios::binary );
+
+	vector<uint8_t> data(512*512 * 4);
+
+	if( !ifile.is_open() )
+	{
+		return data;
+	}
+#pragma pack(1)
+	struct BitmapHeader
+	{
+		unsigned char type[2];
+		unsigned int size;
+		unsigned short reserved[2];
+		unsigned int offset;
+	};
+#pragma pack()
+
+	struct BitmapInfoHeader
+	{
+		unsigned int size;
+		int width;
+		int height;
+		unsigned short planes;
+		unsigned short bitCount;
+		unsigned int compression;
+		unsigned int sizeImage;
+		int XPixPerMeter;
+		int YPixPerMeter;
+		unsigned int ClrUsed;
+		unsigned int CirImportant;
+	};
+	struct BitmapColor24
+	{
+		unsigned char b;
+		unsigned char g;
+		unsigned char r;
+	};
+
+	struct BitmapColor32
+	{
+		unsigned char b;
+		unsigned char g;
+		unsigned char r;
+		unsigned char a;
+	};
+
+	BitmapHeader header;
+	BitmapInfoHeader infoHeader;
+
+	ifile.read(reinterpret_cast<char*>(&header),sizeof(header));
+	ifile.read(reinterpret_cast<char*>(&infoHeader),sizeof(infoHeader));
+	
+	int colorSize = infoHeader.width * infoHeader.height;
+	if(infoHeader.bitCount == 24)
+	{
+		BitmapColor24* color = new BitmapColor24[colorSize];
+		ifile.read(reinterpret_cast<char*>(color),sizeof(BitmapColor24) * colorSize);
+		BitmapColor32* color32 = new BitmapColor32[colorSize];
+		for(int i = 0;i < infoHeader.height / 2;i++)
+		{
+			for(int k = 0;k < infoHeader.width;k++)
+			{
+				int index1 = k + i * infoHeader.width;
+				int index2 = k + (infoHeader.height-1-i) * infoHeader.width;
+				BitmapColor24 tmp = color[index1];
+				color[index1] = color[index2];
+				color[index2] = tmp;
+			}
+		}
+		for(int i = 0;i < colorSize;i++)
+		{
+			color32[i].r = color[i].b;
+			color32[i].g = color[i].g;
+			color32[i].b = color[i].r;
+			color32[i].a = 255;
+		}
+
+		memcpy(&data[0],color32,sizeof(BitmapColor32) * colorSize);
+
+		delete[] color;
+		delete[] color32;
+	}
+	else if(infoHeader.bitCount == 32)
+	{
+		ifile.read(reinterpret_cast<char*>(&data[0]),sizeof(BitmapColor24) * colorSize);
+	}
+
+	ifile.close();
+
+	return data;
+}
+
+//Update()Œ萔obt@ɓl
+//wbhX̕`łlĝŁA]̊pxvZ
+void SetSceneTransform( float angle, XMMATRIX* pWorld, XMMATRIX* pView, XMMATRIX* pProject, XMFLOAT3* pLightDirection )
+{
+	*pWorld = XMMatrixRotationY(angle);
+	*pView = XMMatrixLookAtLH({5.0f,5.0f,-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	*pProject = XMMatrixPerspectiveFovLH(0.78539816339744830961566084581988f,1280.0f/720.0f,1.0f,1000.0f);
+	*pLightDirection = XMFLOAT3(0.0f,sinf(angle) * 1.0f,cosf(angle) * 1.0f);
+}
+
+//_𐬕Ƃɕבւ
+void BuildSoftwareVertexStream( const Vertex* pVertex, uint32_t count, SoftwareVertexStream* pStream )
+{
+	ResizeSoftwareVertexStream(pStream,count);
+	for(uint32_t n = 0;n < count;n++)
+	{
+		SetSoftwareVertex(pStream,n,&pVertex[n].possition.x,&pVertex[n].normal.x,&pVertex[n].uv.x);
+	}
+}
+
+//̂̒_ƃCfbNXpӂ(DrawInstanced(36, 1, 0, 0)Ɠ_Ɏg)
+void BuildSoftwareCube( SoftwareVertexStream* pStream, vector<uint32_t>* pIndex )
+{
+	BuildSoftwareVertexStream(g_cubeVertex,CUBE_VERTEX_COUNT,pStream);
+	pIndex->resize(CUBE_VERTEX_COUNT);
+	for(uint32_t n = 0;n < CUBE_VERTEX_COUNT;n++)
+	{
+		(*pIndex)[n] = n;
+	}
+}
+
+//512x512RGBÃeNX`SOFTWARE_SIMD_WIDTHsNZǂ݁ApColor[0`3]0`1œ
+//CreateRootSignature()̐ÓITv[ƓD3D12_FILTER_MIN_MAG_MIP_LINEARD3D12_TEXTURE_ADDRESS_MODE_WRAP
+//(~bv}bv1Ȃ̂ŃoCjAA͂ݏo͔Α̃eNZƍ)
+inline void SampleSoftwareTexture( const uint8_t* pTexture, SoftwareFloat u, SoftwareFloat v, SoftwareFloat* pColor )
+{
+	const uint32_t TEXTURE_SIZE = 512;
+	//ɂĂAeNZ̒SɂȂWɂ
+	const SoftwareFloat size = SoftwareSet(static_cast<float>(TEXTURE_SIZE));
+	const SoftwareFloat half = SoftwareSet(-0.5f);
+	const SoftwareFloat x = SoftwareMulAdd(SoftwareSub(u,SoftwareFloor(u)),size,half);
+	const SoftwareFloat y = SoftwareMulAdd(SoftwareSub(v,SoftwareFloor(v)),size,half);
+	const SoftwareFloat left = SoftwareFloor(x);
+	const SoftwareFloat top = SoftwareFloor(y);
+	const SoftwareFloat fractionX = SoftwareSub(x,left);
+	const SoftwareFloat fractionY = SoftwareSub(y,top);
+
+	//4̃eNZ𐬕Ƃɕׂ(0A1EA2A3E)
+	float laneX[SOFTWARE_SIMD_WIDTH];
+	float laneY[SOFTWARE_SIMD_WIDTH];
+	SoftwareStore(laneX,left);
+	SoftwareStore(laneY,top);
+	float texel[4][4][SOFTWARE_SIMD_WIDTH];
+	for(uint32_t n = 0;n < SOFTWARE_SIMD_WIDTH;n++)
+	{
+		//-1͔Α511ɂȂ
+		const uint32_t x0 = static_cast<uint32_t>(static_cast<int>(laneX[n])) & (TEXTURE_SIZE - 1);
+		const uint32_t y0 = static_cast<uint32_t>(static_cast<int>(laneY[n])) & (TEXTURE_SIZE - 1);
+		const uint32_t x1 = (x0 + 1) & (TEXTURE_SIZE - 1);
+		const uint32_t y1 = (y0 + 1) & (TEXTURE_SIZE - 1);
+		const uint8_t* pCorner[4] =
+		{
+			&pTexture[(y0 * TEXTURE_SIZE + x0) * 4],
+			&pTexture[(y0 * TEXTURE_SIZE + x1) * 4],
+			&pTexture[(y1 * TEXTURE_SIZE + x0) * 4],
+			&pTexture[(y1 * TEXTURE_SIZE + x1) * 4],
+		};
+		for(uint32_t corner = 0;corner < 4;corner++)
+		{
+			for(uint32_t channel = 0;channel < 4;channel++)
+			{
+				texel[corner][channel][n] = pCorner[corner][channel];
+			}
+		}
+	}
+
+	const SoftwareFloat scale = SoftwareSet(1.0f / 255.0f);
+	for(uint32_t channel = 0;channel < 4;channel++)
+	{
+		const SoftwareFloat topLeft = SoftwareMul(SoftwareLoad(texel[0][channel]),scale);
+		const SoftwareFloat topRight = SoftwareMul(SoftwareLoad(texel[1][channel]),scale);
+		const SoftwareFloat bottomLeft = SoftwareMul(SoftwareLoad(texel[2][channel]),scale);
+		const SoftwareFloat bottomRight = SoftwareMul(SoftwareLoad(texel[3][channel]),scale);
+		const SoftwareFloat upper = SoftwareMulAdd(SoftwareSub(topRight,topLeft),fractionX,topLeft);
+		const SoftwareFloat lower = SoftwareMulAdd(SoftwareSub(bottomRight,bottomLeft),fractionX,bottomLeft);
+		pColor[channel] = SoftwareMulAdd(SoftwareSub(lower,upper),fractionY,upper);
+	}
+}
+
+//shader.hlslPSMainƓvZSOFTWARE_SIMD_WIDTHsNZsAF
+//@UV͏dSWŕԂA1/wŊăp[XyNeBu␳
+void ShadeSoftwarePixels( const SoftwareTriangle& triangle, SoftwarePixelBatch* pBatch )
+{
+	//[̃[͍Ō̃sNZŖ߂(݂͂Ȃ)
+	const uint32_t count = pBatch->count;
+	const uint32_t paddedCount = (count + SOFTWARE_SIMD_WIDTH - 1) / SOFTWARE_SIMD_WIDTH * SOFTWARE_SIMD_WIDTH;
+	for(uint32_t n = count;n < paddedCount;n++)
+	{
+		pBatch->b0[n] = pBatch->b0[count - 1];
+		pBatch->b1[n] = pBatch->b1[count - 1];
+		pBatch->b2[n] = pBatch->b2[count - 1];
+	}
+
+	const SoftwareFloat one = SoftwareSet(1.0f);
+	const SoftwareFloat half = SoftwareSet(0.5f);
+	const SoftwareFloat lightX = SoftwareSet(-g_softwareShading.lightDirection.x);
+	const SoftwareFloat lightY = SoftwareSet(-g_softwareShading.lightDirection.y);
+	const SoftwareFloat lightZ = SoftwareSet(-g_softwareShading.lightDirection.z);
+	for(uint32_t base = 0;base < count;base += SOFTWARE_SIMD_WIDTH)
+	{
+		const SoftwareFloat b0 = SoftwareLoad(&pBatch->b0[base]);
+		const SoftwareFloat b1 = SoftwareLoad(&pBatch->b1[base]);
+		const SoftwareFloat b2 = SoftwareLoad(&pBatch->b2[base]);
+		const SoftwareFloat w = SoftwareDiv(one,InterpolateSoftware(b0,b1,b2,triangle.invW[0],triangle.invW[1],triangle.invW[2]));
+		const SoftwareFloat normalX = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.normal[0].x,triangle.normal[1].x,triangle.normal[2].x),w);
+		const SoftwareFloat normalY = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.normal[0].y,triangle.normal[1].y,triangle.normal[2].y),w);
+		const SoftwareFloat normalZ = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.normal[0].z,triangle.normal[1].z,triangle.normal[2].z),w);
+		const SoftwareFloat u = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.uv[0].x,triangle.uv[1].x,triangle.uv[2].x),w);
+		const SoftwareFloat v = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.uv[0].y,triangle.uv[1].y,triangle.uv[2].y),w);
+
+		//p = dot(normal, -light.xyz) * 0.5 + 0.5Ap * p
+		SoftwareFloat p = SoftwareMul(normalX,lightX);
+		p = SoftwareMulAdd(normalY,lightY,p);
+		p = SoftwareMulAdd(normalZ,lightZ,p);
+		p = SoftwareMulAdd(p,half,half);
+		p = SoftwareMul(p,p);
+
+		SoftwareFloat color[4];
+		SampleSoftwareTexture(g_softwareShading.texture.data(),u,v,color);
+		for(uint32_t channel = 0;channel < 4;channel++)
+		{
+			color[channel] = SoftwareMul(color[channel],p);
+		}
+		StoreSoftwareColors(color,&pBatch->pColor[base],min(SOFTWARE_SIMD_WIDTH,count - base));
+	}
+	pBatch->count = 0;
+}
+
+//EBhEƃfoCX炸CPUŕ`悷
+//Update()Ɠ悤ɉ]ȂframeCountt[`悵AԂo͂čŌ̃t[headless.bmpɕۑ
+//ʂ͕Wo͂ɁAs̗R͕WG[o͂ɏ
+bool RunLightHeadless( const char* textureFileName, uint32_t frameCount )
+{
+	const uint32_t WIDTH = 1280;
+	const uint32_t HEIGHT = 720;
+	if(frameCount == 0)
+	{
+		frameCount = 300;
+	}
+
+	g_softwareShading.texture = LoadTexture(textureFileName);
+	SoftwareRenderer renderer;
+	const uint32_t threadCount = min(max(thread::hardware_concurrency(),1u),MAX_SOFTWARE_THREAD_COUNT);
+	//̃TṽpCvC̓JOȂ
+	if(!InitSoftwareRenderer(&renderer,WIDTH,HEIGHT,threadCount,false,ShadeSoftwarePixels))
+	{
+		fprintf(stderr,"Headless: failed to initialize the software renderer\n");
+		return false;
+	}
+
+	SoftwareVertexStream stream;
+	vector<uint32_t> index;
+	BuildSoftwareCube(&stream,&index);
+	vector<SoftwareVertex> vertex(CUBE_VERTEX_COUNT);
+	const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+	chrono::steady_clock::duration vertexTime = chrono::steady_clock::duration::zero();
+	const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+
+	float angle = 0.0f;
+	for(uint32_t frame = 0;frame < frameCount;frame++)
+	{
+		angle += 0.01f;
+		XMMATRIX world;
+		XMMATRIX view;
+		XMMATRIX project;
+		SetSceneTransform(angle,&world,&view,&project,&g_softwareShading.lightDirection);
+
+		ClearSoftwareRenderer(&renderer,clearColor);
+
+		const chrono::steady_clock::time_point vertexBegin = chrono::steady_clock::now();
+		SoftwareDrawConstant constant;
+		SetSoftwareDrawConstant(XMMatrixIdentity(),world,view,project,&constant);
+		const uint32_t jobCount = (CUBE_VERTEX_COUNT + SOFTWARE_VERTEX_JOB_SIZE - 1) / SOFTWARE_VERTEX_JOB_SIZE;
+		RunSoftwareJobs(&renderer,jobCount,[&]( uint32_t jobIndex )
+		{
+			const uint32_t first = jobIndex * SOFTWARE_VERTEX_JOB_SIZE;
+			TransformSoftwareVertexStream(stream,first,min(SOFTWARE_VERTEX_JOB_SIZE,CUBE_VERTEX_COUNT - first),constant,vertex.data());
+		});
+		vertexTime += chrono::steady_clock::now() - vertexBegin;
+
+		DrawSoftwareTriangles(&renderer,vertex.data(),index.data(),nullptr,CUBE_VERTEX_COUNT / 3);
+	}
+
+	const chrono::steady_clock::duration totalTime = chrono::steady_clock::now() - begin;
+	typedef chrono::duration<double,milli> Milliseconds;
+	printf("Headless: %u frames, %u threads, %.3f ms/frame (vertex %.3f, setup %.3f, raster %.3f)\n",
+		frameCount,renderer.threadCount,Milliseconds(totalTime).count() / frameCount,
+		Milliseconds(vertexTime).count() / frameCount,Milliseconds(renderer.setupTime).count() / frameCount,
+		Milliseconds(renderer.rasterTime).count() / frameCount);
+
+	const bool result = SaveSoftwareRenderTarget(&renderer,"headless.bmp");
+	DestroySoftwareRenderer(&renderer);
+	if(!result)
+	{
+		fprintf(stderr,"Headless: failed to save headless.bmp\n");
+	}
+	return result;
+}
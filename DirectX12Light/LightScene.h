@@ -0,0 +1,39 @@
+#pragma once
+
+//DirectX12Light̃V[(́AeNX`AVF[_[ƓvZAwbhX̕`)
+//D3D12Win32ɂ͈ˑȂ̂ŁAWindowsȊOłHeadless/LightHeadless.cpprhł
+
+#include "../DirectX12Model/SoftwareScene.h"
+
+#include <cstdint>
+#include <vector>
+
+struct Vertex
+{
+	DirectX::XMFLOAT3 possition;
+	//XMFLOAT4 color;
+	DirectX::XMFLOAT2 uv;
+	DirectX::XMFLOAT3 normal;
+};
+
+//̂̃WIg(GPUƃ\tgEFAX^CU[ŋL)
+const uint32_t CUBE_VERTEX_COUNT = 36;
+extern const Vertex g_cubeVertex[CUBE_VERTEX_COUNT];
+
+//ShadeSoftwarePixels()ǂރV[̒l
+//sNZVF[_[͊֐̃|C^œn̂ŁA`̑OɂɓĂ
+struct SoftwareShading
+{
+	std::vector<uint8_t> texture;		//test.bmp(512x512RGBA)
+	DirectX::XMFLOAT3 lightDirection;
+};
+
+extern SoftwareShading g_softwareShading;
+
+std::vector<uint8_t> LoadTexture( const char* fileName );
+void SetSceneTransform( float angle, DirectX::XMMATRIX* pWorld, DirectX::XMMATRIX* pView, DirectX::XMMATRIX* pProject,
+	DirectX::XMFLOAT3* pLightDirection );
+void BuildSoftwareVertexStream( const Vertex* pVertex, uint32_t count, SoftwareVertexStream* pStream );
+void BuildSoftwareCube( SoftwareVertexStream* pStream, std::vector<uint32_t>* pIndex );
+void ShadeSoftwarePixels( const SoftwareTriangle& triangle, SoftwarePixelBatch* pBatch );
+bool RunLightHeadless( const char* textureFileName, uint32_t frameCount );
@@ -11,6 +11,17 @@
 #include <DirectXMath.h>
 #include <vector>
 #include <fstream>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+
+#include "LightScene.h"
+#include "../DirectX12Model/ShaderCache.h"
 
 using namespace DirectX;
 using Microsoft::WRL::ComPtr;
@@ -40,21 +51,16 @@ bool CreateCommandList();
 bool CreateRootSignature();
 bool CompileShader();
 bool CreatePipelineStateObject();
+bool CompileShaderWithD3DCompiler( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode );
 bool CreateVertexBuffer();
 bool CreateCbvSrv();
+bool CreateReadbackBuffer();
+bool CompareSoftwareRenderTarget();
 
 
-std::vector<UINT8> LoadTexture( const char* fileName );
-
 const UINT FRAME_COUNT = 2;
 
-struct Vertex
-{
-	XMFLOAT3 possition;
-	//XMFLOAT4 color;
-	XMFLOAT2 uv;
-	XMFLOAT3 normal;
-};
 __declspec(align(256))
 struct ConstantBuffer
 {
@@ -113,6 +119,18 @@ HANDLE g_fenceEvent;
 bool g_useWarpDevice = false;
 float g_aspectRatio;
 
+//VF[_[̃LbV(ShaderCache.h)
+//ShaderMacroD3D_SHADER_MACROƓтɂĂ̂ŁAD3DCompileɂ͂̂܂ܓn
+#define SHADER_CACHE_DIRECTORY "ShaderCache"
+static_assert(sizeof(ShaderMacro) == sizeof(D3D_SHADER_MACRO), "ShaderMacro");
+ShaderCache g_shaderCache;
+
+//\tgEFAX^CU[
+SoftwareRenderer g_softwareRenderer;
+bool g_compareSoftware = false;
+ComPtr<ID3D12Resource> g_readbackBuffer;	//ׂ邽߂ɃobNobt@Rs[
+D3D12_PLACED_SUBRESOURCE_FOOTPRINT g_readbackFootprint;
+
 //------------------------------------------------------------------------------------------------
 // Returns required size of a buffer to be used for data upload
 inline UINT64 GetRequiredIntermediateSize(
@@ -257,8 +275,24 @@ UINT64 UpdateSubresources(
 }
 
 
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow)
 {
+	//"-headless N"w肷ƃEBhEƃfoCX炸CPUNt[`悷
+	const char* pHeadless = strstr(lpCmdLine,"-headless");
+	if(pHeadless != nullptr)
+	{
+		//WinMaiñvOɂ͕Wo͂̂ŁANR\[΂ɏo͂
+		if(AttachConsole(ATTACH_PARENT_PROCESS))
+		{
+			FILE* pFile;
+			freopen_s(&pFile,"CONOUT$","w",stdout);
+			freopen_s(&pFile,"CONOUT$","w",stderr);
+		}
+		return RunLightHeadless("test.bmp",static_cast<UINT>(atoi(pHeadless + strlen("-headless")))) ? 0 : -1;
+	}
+	//"-compare"w肷ƍŏ̃t[GPUǂݖ߂A\tgEFAX^CU[ŕ`̂Ɣׂ
+	g_compareSoftware = strstr(lpCmdLine,"-compare") != nullptr;
+
 	//EBhȄ-------------------------------
 	WNDCLASSEX windowClass = {0};
 	windowClass.cbSize = sizeof(windowClass);
@@ -318,6 +352,14 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
 			{
 				return -1;
 			}
+			if(g_compareSoftware)
+			{
+				if(!CompareSoftwareRenderTarget())
+				{
+					return -1;
+				}
+				g_compareSoftware = false;
+			}
 		}
 	}
 
@@ -427,6 +469,14 @@ bool InitResource()
 		return false;
 	}
 
+	if(g_compareSoftware)
+	{
+		if(!CreateReadbackBuffer())
+		{
+			return false;
+		}
+	}
+
 	//Õt[҂
 	/*if(!WaitForGpu())
 	{
@@ -440,11 +490,9 @@ bool Update()
 {
 	static float angle = 0.0f;
 	angle += 0.01f;
-	g_constantBufferData.world = XMMatrixRotationY(angle);
-	g_constantBufferData.view = XMMatrixLookAtLH({5.0f,5.0f,-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
-	g_constantBufferData.project = XMMatrixPerspectiveFovLH(0.78539816339744830961566084581988f,1280.0f/720.0f,1.0f,1000.0f);
+	SetSceneTransform(angle,&g_constantBufferData.world,&g_constantBufferData.view,&g_constantBufferData.project,
+		&g_lightBufferData.lightDirection);
 	memcpy(g_pCbvDataBegin,&g_constantBufferData,sizeof(g_constantBufferData));
-	g_lightBufferData.lightDirection = XMFLOAT3(0.0f,sinf(angle) * 1.0f,cosf(angle) * 1.0f);
 	memcpy(g_pCbv2DataBegin,&g_lightBufferData,sizeof(g_lightBufferData));
 	return true;
 }
@@ -542,13 +590,38 @@ bool PopulateCommandList()
 	g_commandList->IASetVertexBuffers(0, 1, &g_vertexBufferView);
 	g_commandList->DrawInstanced(36, 1, 0, 0);
 
-	//obNobt@\
+	//ׂƂ̓obNobt@ǂݖ߂p̃obt@ɃRs[
+	D3D12_RESOURCE_STATES renderTargetState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	if(g_compareSoftware)
 	{
 		D3D12_RESOURCE_BARRIER resourceBarrier = {};
 		resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 		resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
 		resourceBarrier.Transition.pResource = g_renderTarget[g_frameIndex].Get();
 		resourceBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+		resourceBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+		resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		g_commandList->ResourceBarrier( 1, &resourceBarrier );
+
+		D3D12_TEXTURE_COPY_LOCATION dest = {};
+		dest.pResource = g_readbackBuffer.Get();
+		dest.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+		dest.PlacedFootprint = g_readbackFootprint;
+		D3D12_TEXTURE_COPY_LOCATION source = {};
+		source.pResource = g_renderTarget[g_frameIndex].Get();
+		source.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+		source.SubresourceIndex = 0;
+		g_commandList->CopyTextureRegion( &dest, 0, 0, 0, &source, nullptr );
+		renderTargetState = D3D12_RESOURCE_STATE_COPY_SOURCE;
+	}
+
+	//obNobt@\
+	{
+		D3D12_RESOURCE_BARRIER resourceBarrier = {};
+		resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+		resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		resourceBarrier.Transition.pResource = g_renderTarget[g_frameIndex].Get();
+		resourceBarrier.Transition.StateBefore = renderTargetState;
 		resourceBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
 		resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
 		g_commandList->ResourceBarrier( 1, &resourceBarrier );
@@ -1001,20 +1074,21 @@ bool CompileShader()
 //pCvC̏ԃIuWFNg쐬
 bool CreatePipelineStateObject()
 {
-	//VF[_[̃RpC
-	ComPtr<ID3DBlob> vertexShader;
-	ComPtr<ID3DBlob> pixelShader;
+	//VF[_[̃RpC(LbVɂ΂g)
+	vector<uint8_t> vertexShader;
+	vector<uint8_t> pixelShader;
 
 #if defined(_DEBUG)
 	UINT compileFlag = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;;
 #else
 	UINT compileFlag = 0;
 #endif
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlag, 0, &vertexShader, nullptr) ) )
+	InitShaderCache(&g_shaderCache,SHADER_CACHE_DIRECTORY,CompileShaderWithD3DCompiler,D3D_COMPILER_VERSION);
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"VSMain","vs_5_0",compileFlag,&vertexShader,nullptr))
 	{
 		return false;
 	}
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlag, 0, &pixelShader, nullptr) ) )
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"PSMain","ps_5_0",compileFlag,&pixelShader,nullptr))
 	{
 		return false;
 	}
@@ -1064,10 +1138,10 @@ bool CreatePipelineStateObject()
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
 	psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
 	psoDesc.pRootSignature = g_rootSignature.Get();
-	psoDesc.VS.pShaderBytecode = vertexShader->GetBufferPointer();
-	psoDesc.VS.BytecodeLength = vertexShader->GetBufferSize();
-	psoDesc.PS.pShaderBytecode = pixelShader->GetBufferPointer();
-	psoDesc.PS.BytecodeLength = pixelShader->GetBufferSize();
+	psoDesc.VS.pShaderBytecode = vertexShader.data();
+	psoDesc.VS.BytecodeLength = vertexShader.size();
+	psoDesc.PS.pShaderBytecode = pixelShader.data();
+	psoDesc.PS.BytecodeLength = pixelShader.size();
 	psoDesc.RasterizerState = rasterrizerStateDesc;
 	psoDesc.BlendState = blendStateDesc;
 	psoDesc.DepthStencilState.DepthEnable = TRUE;
@@ -1085,67 +1159,38 @@ bool CreatePipelineStateObject()
 		return false;
 	}
 
+	char message[256];
+	sprintf_s(message,"shader cache: shader hit %u miss %u\n",g_shaderCache.shaderHit.load(),g_shaderCache.shaderMiss.load());
+	OutputDebugStringA(message);
+
 	return true;
 }
 
-//_obt@̍쐬
-bool CreateVertexBuffer()
+//D3DCompileŃRpC(VF[_[̃LbṼRpC)
+bool CompileShaderWithD3DCompiler( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode )
 {
-	//Op`̃WIg`
-	Vertex vertices[] =
+	ComPtr<ID3DBlob> bytecode;
+	ComPtr<ID3DBlob> error;
+	if(FAILED(D3DCompile(pSource,sourceSize,pSourceName,reinterpret_cast<const D3D_SHADER_MACRO*>(pDefines),nullptr,
+		pEntryPoint,pTarget,flags,0,&bytecode,&error)))
 	{
-		{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
-		{ {1.0f, -1.0f, 1.0f}, { 1.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
-		{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
-
-		{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
-		{ {-1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
-		{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } },
-
-		{ {1.0f, 1.0f, -1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
-		{ {1.0f, -1.0f, -1.0f}, { 1.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
-		{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
-
-		{ {1.0f, 1.0f, -1.0f}, { 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
-		{ {-1.0f, 1.0f, -1.0f}, { 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
-		{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
-
-
-		{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
-		{ {1.0f, 1.0f, -1.0f}, { 1.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
-		{ {-1.0f, 1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
-
-		{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
-		{ {-1.0f, 1.0f, 1.0f}, { 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
-		{ {-1.0f, 1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f } },
-
-		{ {1.0f, -1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } },
-		{ {1.0f, -1.0f, -1.0f}, { 1.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } },
-		{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } },
-
-		{ {1.0f, -1.0f, 1.0f}, { 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } },
-		{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } },
-		{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f } },
-
-
-		{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
-		{ {1.0f, 1.0f, -1.0f}, { 1.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
-		{ {1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
-
-		{ {1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
-		{ {1.0f, -1.0f, 1.0f}, { 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
-		{ {1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
-
-		{ {-1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
-		{ {-1.0f, 1.0f, -1.0f}, { 1.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } },
-		{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } },
+		if(error)
+		{
+			OutputDebugStringA(static_cast<const char*>(error->GetBufferPointer()));
+		}
+		return false;
+	}
 
-		{ {-1.0f, 1.0f, 1.0f}, { 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
-		{ {-1.0f, -1.0f, 1.0f}, { 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
-		{ {-1.0f, -1.0f, -1.0f}, { 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f } },
-	};
+	const UINT8* pBegin = static_cast<const UINT8*>(bytecode->GetBufferPointer());
+	pBytecode->assign(pBegin,pBegin + bytecode->GetBufferSize());
+	return true;
+}
 
-	const UINT vertexBufferSize = sizeof(vertices);
+//_obt@̍쐬
+bool CreateVertexBuffer()
+{
+	const UINT vertexBufferSize = sizeof(g_cubeVertex);
 
 	//q[vvpeB̐ݒ
 	D3D12_HEAP_PROPERTIES heapProperties = {};
@@ -1185,7 +1230,7 @@ bool CreateVertexBuffer()
 		return false;
 	}
 	//_f[^Rs[
-	memcpy(pVertexDataBegin,vertices, sizeof(vertices) );
+	memcpy(pVertexDataBegin,g_cubeVertex, sizeof(g_cubeVertex) );
 	//A}bv
 	g_vertexBuffer->Unmap( 0, nullptr );
 
@@ -1459,98 +1504,119 @@ bool CreateCbvSrv()
 }
 
 
-std::vector<UINT8> LoadTexture( const char* fileName )
+//GPUŕ`t[ǂݖ߂obt@̍쐬
+bool CreateReadbackBuffer()
 {
-	ifstream ifile( fileName, ios::binary );
+	const D3D12_RESOURCE_DESC renderTargetDesc = g_renderTarget[0]->GetDesc();
+	UINT64 size = 0;
+	g_device->GetCopyableFootprints(&renderTargetDesc,0,1,0,&g_readbackFootprint,nullptr,nullptr,&size);
+
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type = D3D12_HEAP_TYPE_READBACK;
+	prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask = 1;
+	prop.VisibleNodeMask = 1;
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment = 0;
+	desc.Width = size;
+	desc.Height = 1;
+	desc.DepthOrArraySize = 1;
+	desc.MipLevels = 1;
+	desc.Format = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	if(FAILED(g_device->CreateCommittedResource(
+		&prop,D3D12_HEAP_FLAG_NONE,&desc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,IID_PPV_ARGS(&g_readbackBuffer))))
+	{
+		return false;
+	}
+	return true;
+}
 
-	vector<UINT8> data(512*512 * 4);
+//GPUŕ`t[A萔Ń\tgEFAX^CU[ŕ`̂Ɣׂ
+//̂sNZ̐ƍő̍o͂A\tgEFǍʂsoftware.bmpAcompare.bmpɕۑ
+//GPŨoCjA̓eNZ̈ʒu8rbgxɊۂ߂̂ŁATOLERANCE܂ł͈̍vƂ݂Ȃ
+//TOLERANCE𒴂sNZ1łfalseԂ
+bool CompareSoftwareRenderTarget()
+{
+	const UINT TOLERANCE = 2;
 
-	if( !ifile.is_open() )
+	//Rs[I܂ő҂
+	if(!WaitForGpu())
 	{
-		return data;
+		return false;
 	}
-#pragma pack(1)
-	struct BitmapHeader
-	{
-		unsigned char type[2];
-		unsigned int size;
-		unsigned short reserved[2];
-		unsigned int offset;
-	};
-#pragma pack()
-
-	struct BitmapInfoHeader
-	{
-		unsigned int size;
-		int width;
-		int height;
-		unsigned short planes;
-		unsigned short bitCount;
-		unsigned int compression;
-		unsigned int sizeImage;
-		int XPixPerMeter;
-		int YPixPerMeter;
-		unsigned int ClrUsed;
-		unsigned int CirImportant;
-	};
-	struct BitmapColor24
-	{
-		unsigned char b;
-		unsigned char g;
-		unsigned char r;
-	};
 
-	struct BitmapColor32
+	g_softwareShading.texture = LoadTexture("test.bmp");
+	g_softwareShading.lightDirection = g_lightBufferData.lightDirection;
+	const UINT width = static_cast<UINT>(g_readbackFootprint.Footprint.Width);
+	const UINT height = g_readbackFootprint.Footprint.Height;
+	const UINT threadCount = min(max(thread::hardware_concurrency(),1u),MAX_SOFTWARE_THREAD_COUNT);
+	if(!InitSoftwareRenderer(&g_softwareRenderer,width,height,threadCount,false,ShadeSoftwarePixels))
 	{
-		unsigned char b;
-		unsigned char g;
-		unsigned char r;
-		unsigned char a;
-	};
+		return false;
+	}
 
-	BitmapHeader header;
-	BitmapInfoHeader infoHeader;
+	SoftwareVertexStream stream;
+	vector<UINT> index;
+	BuildSoftwareCube(&stream,&index);
+	vector<SoftwareVertex> vertex(CUBE_VERTEX_COUNT);
+	SoftwareDrawConstant constant;
+	SetSoftwareDrawConstant(XMMatrixIdentity(),g_constantBufferData.world,g_constantBufferData.view,g_constantBufferData.project,&constant);
+	TransformSoftwareVertexStream(stream,0,CUBE_VERTEX_COUNT,constant,vertex.data());
+	const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+	ClearSoftwareRenderer(&g_softwareRenderer,clearColor);
+	DrawSoftwareTriangles(&g_softwareRenderer,vertex.data(),index.data(),nullptr,CUBE_VERTEX_COUNT / 3);
+	bool result = SaveSoftwareRenderTarget(&g_softwareRenderer,"software.bmp");
 
-	ifile.read(reinterpret_cast<char*>(&header),sizeof(header));
-	ifile.read(reinterpret_cast<char*>(&infoHeader),sizeof(infoHeader));
-	
-	int colorSize = infoHeader.width * infoHeader.height;
-	if(infoHeader.bitCount == 24)
+	UINT8* pData;
+	D3D12_RANGE readRange = {0,static_cast<SIZE_T>(g_readbackFootprint.Offset + static_cast<UINT64>(g_readbackFootprint.Footprint.RowPitch) * height)};
+	if(FAILED(g_readbackBuffer->Map(0,&readRange,reinterpret_cast<void**>(&pData))))
 	{
-		BitmapColor24* color = new BitmapColor24[colorSize];
-		ifile.read(reinterpret_cast<char*>(color),sizeof(BitmapColor24) * colorSize);
-		BitmapColor32* color32 = new BitmapColor32[colorSize];
-		for(int i = 0;i < infoHeader.height / 2;i++)
+		DestroySoftwareRenderer(&g_softwareRenderer);
+		return false;
+	}
+
+	UINT maxDifference = 0;
+	UINT differentCount = 0;
+	UINT exceedCount = 0;
+	for(UINT y = 0;y < height;y++)
+	{
+		const UINT32* pGpu = reinterpret_cast<const UINT32*>(pData + g_readbackFootprint.Offset + static_cast<UINT64>(g_readbackFootprint.Footprint.RowPitch) * y);
+		UINT32* pSoftware = &g_softwareRenderer.color[static_cast<size_t>(y) * width];
+		for(UINT x = 0;x < width;x++)
 		{
-			for(int k = 0;k < infoHeader.width;k++)
+			UINT difference = 0;
+			for(UINT shift = 0;shift < 32;shift += 8)
 			{
-				int index1 = k + i * infoHeader.width;
-				int index2 = k + (infoHeader.height-1-i) * infoHeader.width;
-				BitmapColor24 tmp = color[index1];
-				color[index1] = color[index2];
-				color[index2] = tmp;
+				const int a = static_cast<int>((pGpu[x] >> shift) & 0xff);
+				const int b = static_cast<int>((pSoftware[x] >> shift) & 0xff);
+				difference = max(difference,static_cast<UINT>(abs(a - b)));
 			}
+			maxDifference = max(maxDifference,difference);
+			differentCount += difference > 0 ? 1 : 0;
+			exceedCount += difference > TOLERANCE ? 1 : 0;
+			//𖾂邳ɂāATOLERANCE𒴂Ƃ͐Ԃɂ
+			pSoftware[x] = difference > TOLERANCE ? 0xff0000ff : 0xff000000 | (min(difference * 16,255u) * 0x010101);
 		}
-		for(int i = 0;i < colorSize;i++)
-		{
-			color32[i].r = color[i].b;
-			color32[i].g = color[i].g;
-			color32[i].b = color[i].r;
-			color32[i].a = 255;
-		}
-
-		memcpy(&data[0],color32,sizeof(BitmapColor32) * colorSize);
-
-		delete[] color;
-		delete[] color32;
-	}
-	else if(infoHeader.bitCount == 32)
-	{
-		ifile.read(reinterpret_cast<char*>(&data[0]),sizeof(BitmapColor24) * colorSize);
 	}
+	D3D12_RANGE writeRange = {0,0};
+	g_readbackBuffer->Unmap(0,&writeRange);
 
-	ifile.close();
+	char text[256];
+	sprintf_s(text,"Compare: %u x %u pixels, %u differ, %u differ by more than %u (max %u)\n",
+		width,height,differentCount,exceedCount,TOLERANCE,maxDifference);
+	OutputDebugStringA(text);
 
-	return data;
+	result = SaveSoftwareRenderTarget(&g_softwareRenderer,"compare.bmp") && result;
+	DestroySoftwareRenderer(&g_softwareRenderer);
+	return result && exceedCount == 0;
 }
-
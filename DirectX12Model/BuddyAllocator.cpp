@@ -0,0 +1,183 @@
+#include "BuddyAllocator.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void BuddyPushFree( BuddyAllocator* pAllocator, uint32_t index, uint32_t order );
+void BuddyRemoveFree( BuddyAllocator* pAllocator, uint32_t index, uint32_t order );
+
+//󂫃Xgɒǉ
+void BuddyPushFree( BuddyAllocator* pAllocator, uint32_t index, uint32_t order )
+{
+	pAllocator->freeOrder[index] = static_cast<uint8_t>(order + 1);
+	pAllocator->freePrev[index] = BUDDY_INVALID_INDEX;
+	pAllocator->freeNext[index] = pAllocator->freeHead[order];
+	if(pAllocator->freeHead[order] != BUDDY_INVALID_INDEX)
+	{
+		pAllocator->freePrev[pAllocator->freeHead[order]] = index;
+	}
+	pAllocator->freeHead[order] = index;
+}
+
+//󂫃Xg폜
+void BuddyRemoveFree( BuddyAllocator* pAllocator, uint32_t index, uint32_t order )
+{
+	const uint32_t prev = pAllocator->freePrev[index];
+	const uint32_t next = pAllocator->freeNext[index];
+	if(prev != BUDDY_INVALID_INDEX)
+	{
+		pAllocator->freeNext[prev] = next;
+	}
+	else
+	{
+		pAllocator->freeHead[order] = next;
+	}
+	if(next != BUDDY_INVALID_INDEX)
+	{
+		pAllocator->freePrev[next] = prev;
+	}
+	pAllocator->freeOrder[index] = 0;
+}
+
+//ofBAP[^̏
+bool InitBuddyAllocator( BuddyAllocator* pAllocator, uint64_t size, uint64_t minBlockSize )
+{
+	//ǂ2ׂ̂ł邱
+	if(size == 0 || minBlockSize == 0 || size < minBlockSize ||
+		(size & (size - 1)) != 0 || (minBlockSize & (minBlockSize - 1)) != 0)
+	{
+		return false;
+	}
+	const uint64_t blockCount = size / minBlockSize;
+	if(blockCount >= BUDDY_INVALID_INDEX)
+	{
+		return false;
+	}
+
+	pAllocator->size = size;
+	pAllocator->minBlockSize = minBlockSize;
+	pAllocator->orderCount = 1;
+	while((minBlockSize << (pAllocator->orderCount - 1)) < size)
+	{
+		pAllocator->orderCount++;
+	}
+
+	pAllocator->freeHead.assign(pAllocator->orderCount,BUDDY_INVALID_INDEX);
+	pAllocator->freeNext.assign(static_cast<size_t>(blockCount),BUDDY_INVALID_INDEX);
+	pAllocator->freePrev.assign(static_cast<size_t>(blockCount),BUDDY_INVALID_INDEX);
+	pAllocator->freeOrder.assign(static_cast<size_t>(blockCount),0);
+	pAllocator->usedOrder.assign(static_cast<size_t>(blockCount),0);
+	pAllocator->usedSize = 0;
+	pAllocator->requestedSize = 0;
+	pAllocator->allocationCount = 0;
+
+	//ŏ͑Ŝ1̋󂫃ubN
+	BuddyPushFree(pAllocator,0,pAllocator->orderCount - 1);
+
+	return true;
+}
+
+//sizeoCgalignment̔{̃ItZbgɊ蓖Ă
+bool BuddyAllocate( BuddyAllocator* pAllocator, uint64_t size, uint64_t alignment, uint64_t* pOffset )
+{
+	uint64_t blockSize = max(max(size,alignment),pAllocator->minBlockSize);
+	uint32_t order = 0;
+	while((pAllocator->minBlockSize << order) < blockSize)
+	{
+		order++;
+		if(order >= pAllocator->orderCount)
+		{
+			return false;
+		}
+	}
+
+	//蓖Ăԏ󂫃ubNT
+	uint32_t freeOrder = order;
+	while(freeOrder < pAllocator->orderCount && pAllocator->freeHead[freeOrder] == BUDDY_INVALID_INDEX)
+	{
+		freeOrder++;
+	}
+	if(freeOrder >= pAllocator->orderCount)
+	{
+		return false;
+	}
+
+	const uint32_t index = pAllocator->freeHead[freeOrder];
+	BuddyRemoveFree(pAllocator,index,freeOrder);
+
+	//KvȃTCYɂȂ܂ŔɕāA딼󂫃Xgɖ߂
+	while(freeOrder > order)
+	{
+		freeOrder--;
+		BuddyPushFree(pAllocator,index + (1u << freeOrder),freeOrder);
+	}
+
+	pAllocator->usedOrder[index] = static_cast<uint8_t>(order + 1);
+	pAllocator->usedSize += pAllocator->minBlockSize << order;
+	pAllocator->requestedSize += size;
+	pAllocator->allocationCount++;
+
+	*pOffset = pAllocator->minBlockSize * index;
+	return true;
+}
+
+//蓖ĂA󂢂ĂofBƌ
+void BuddyFree( BuddyAllocator* pAllocator, uint64_t offset, uint64_t size )
+{
+	uint32_t index = static_cast<uint32_t>(offset / pAllocator->minBlockSize);
+	if(pAllocator->usedOrder[index] == 0)
+	{
+		return;
+	}
+	uint32_t order = pAllocator->usedOrder[index] - 1;
+	pAllocator->usedOrder[index] = 0;
+	pAllocator->usedSize -= pAllocator->minBlockSize << order;
+	pAllocator->requestedSize -= size;
+	pAllocator->allocationCount--;
+
+	while(order + 1 < pAllocator->orderCount)
+	{
+		const uint32_t buddy = index ^ (1u << order);
+		if(pAllocator->freeOrder[buddy] != order + 1)
+		{
+			break;
+		}
+		BuddyRemoveFree(pAllocator,buddy,order);
+		index = min(index,buddy);
+		order++;
+	}
+	BuddyPushFree(pAllocator,index,order);
+}
+
+//offsetn܂gpubÑTCY(gpłȂ0)
+uint64_t GetBuddyBlockSize( const BuddyAllocator* pAllocator, uint64_t offset )
+{
+	const uint8_t order = pAllocator->usedOrder[static_cast<size_t>(offset / pAllocator->minBlockSize)];
+	return (order > 0) ? pAllocator->minBlockSize << (order - 1) : 0;
+}
+
+//1Ŋ蓖ĂőTCY
+uint64_t GetBuddyLargestFreeSize( const BuddyAllocator* pAllocator )
+{
+	for(uint32_t order = pAllocator->orderCount;order > 0;order--)
+	{
+		if(pAllocator->freeHead[order - 1] != BUDDY_INVALID_INDEX)
+		{
+			return pAllocator->minBlockSize << (order - 1);
+		}
+	}
+	return 0;
+}
+
+//SĉāAő̎̋󂫃ubN1ɌĂ邩
+bool IsBuddyAllocatorEmpty( const BuddyAllocator* pAllocator )
+{
+	bool empty = pAllocator->allocationCount == 0 && pAllocator->usedSize == 0 && pAllocator->requestedSize == 0 &&
+		pAllocator->freeHead[pAllocator->orderCount - 1] == 0 && pAllocator->freeNext[0] == BUDDY_INVALID_INDEX;
+	for(uint32_t order = 0;order + 1 < pAllocator->orderCount;order++)
+	{
+		empty = empty && pAllocator->freeHead[order] == BUDDY_INVALID_INDEX;
+	}
+	return empty;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+//ofBAP[^
+//q[ṽItZbgǗ(D3D12Win32ɂ͈ˑȂ)
+//ubÑ͎TCYŃAĈŁAACg̓TCY̐؂グŖ
+
+#include <cstdint>
+#include <vector>
+
+const uint32_t BUDDY_INVALID_INDEX = 0xffffffff;
+struct BuddyAllocator
+{
+	uint64_t size;					//Ŝ̃TCY(2ׂ̂)
+	uint64_t minBlockSize;			//ŏubÑTCY(2ׂ̂)
+	uint32_t orderCount;			//0ŏubNAorderCount-1S
+	std::vector<uint32_t> freeHead;	//Ƃ̋󂫃Xg̐擪(ŏubNPʂ̃CfbNX)
+	std::vector<uint32_t> freeNext;
+	std::vector<uint32_t> freePrev;
+	std::vector<uint8_t> freeOrder;	//󂫃ubN̐擪Ȃ玟+1AȊO0
+	std::vector<uint8_t> usedOrder;	//gpubN̐擪Ȃ玟+1AȊO0
+	uint64_t usedSize;				//蓖ĂubN̍v
+	uint64_t requestedSize;			//vꂽTCY̍v
+	uint32_t allocationCount;
+};
+
+bool InitBuddyAllocator( BuddyAllocator* pAllocator, uint64_t size, uint64_t minBlockSize );
+bool BuddyAllocate( BuddyAllocator* pAllocator, uint64_t size, uint64_t alignment, uint64_t* pOffset );
+void BuddyFree( BuddyAllocator* pAllocator, uint64_t offset, uint64_t size );
+uint64_t GetBuddyBlockSize( const BuddyAllocator* pAllocator, uint64_t offset );
+uint64_t GetBuddyLargestFreeSize( const BuddyAllocator* pAllocator );
+bool IsBuddyAllocatorEmpty( const BuddyAllocator* pAllocator );
@@ -0,0 +1,140 @@
+#include "DescriptorAllocator.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//count̋󂫔͈͂1t[Xgɂ
+void InitDescriptorFreeList( DescriptorFreeList* pFreeList, uint32_t count )
+{
+	pFreeList->count = count;
+	pFreeList->freeRange.clear();
+	if(count > 0)
+	{
+		DescriptorRange range = { 0, count };
+		pFreeList->freeRange.push_back(range);
+	}
+	pFreeList->used = 0;
+}
+
+//gr[pɘAcount蓖Ă(ŏɓ󂫔͈͂g)
+bool AllocatePersistentDescriptors( DescriptorFreeList* pFreeList, uint32_t count, DescriptorRange* pRange )
+{
+	for(size_t n = 0;n < pFreeList->freeRange.size();n++)
+	{
+		DescriptorRange* pFree = &pFreeList->freeRange[n];
+		if(pFree->count < count)
+		{
+			continue;
+		}
+
+		pRange->index = pFree->index;
+		pRange->count = count;
+		pFree->index += count;
+		pFree->count -= count;
+		if(pFree->count == 0)
+		{
+			pFreeList->freeRange.erase(pFreeList->freeRange.begin() + n);
+		}
+		pFreeList->used += count;
+		return true;
+	}
+
+	return false;
+}
+
+//gr[͈̔͂Ԃ(GPUgIĂĂԂ)
+//Ő󂫔͈͂ƂȂ1ɂ܂Ƃ߂
+void FreePersistentDescriptors( DescriptorFreeList* pFreeList, DescriptorRange* pRange )
+{
+	if(pRange->count == 0)
+	{
+		return;
+	}
+
+	auto it = lower_bound(pFreeList->freeRange.begin(),pFreeList->freeRange.end(),*pRange,
+		[](const DescriptorRange& a,const DescriptorRange& b){ return a.index < b.index; });
+	it = pFreeList->freeRange.insert(it,*pRange);
+
+	//ƂȂ
+	auto next = it + 1;
+	if(next != pFreeList->freeRange.end() && it->index + it->count == next->index)
+	{
+		it->count += next->count;
+		it = pFreeList->freeRange.erase(next) - 1;
+	}
+	//OƂȂ
+	if(it != pFreeList->freeRange.begin())
+	{
+		auto prev = it - 1;
+		if(prev->index + prev->count == it->index)
+		{
+			prev->count += it->count;
+			pFreeList->freeRange.erase(it);
+		}
+	}
+
+	pFreeList->used -= pRange->count;
+	pRange->count = 0;
+}
+
+//q[vbegincountOɂ
+void InitDescriptorRing( DescriptorRing* pRing, uint32_t begin, uint32_t count )
+{
+	pRing->begin = begin;
+	pRing->count = count;
+	pRing->head = 0;
+	pRing->tail = 0;
+	pRing->used = 0;
+	pRing->frameUsed = 0;
+	pRing->frame.clear();
+}
+
+//̃t[ge[upɘAcountO犄蓖Ă
+//ɓ肫ȂƂ͗]̂ĂĐ擪犄蓖Ă
+bool AllocateTransientDescriptors( DescriptorRing* pRing, uint32_t count, DescriptorRange* pRange )
+{
+	if(count == 0 || count > pRing->count)
+	{
+		return false;
+	}
+
+	uint32_t skip = 0;
+	if(pRing->head + count > pRing->count)
+	{
+		skip = pRing->count - pRing->head;
+	}
+	if(pRing->used + skip + count > pRing->count)
+	{
+		return false;
+	}
+
+	const uint32_t head = (pRing->head + skip) % pRing->count;
+	pRange->index = pRing->begin + head;
+	pRange->count = count;
+
+	pRing->head = (head + count) % pRing->count;
+	pRing->used += skip + count;
+	pRing->frameUsed += skip + count;
+	return true;
+}
+
+//̃t[Ŋ蓖ĂɃtFX̒lt(t[̍ŌSignaľɌĂ)
+void FinishDescriptorFrame( DescriptorRing* pRing, uint64_t fenceValue )
+{
+	DescriptorRingFrame frame = { fenceValue, pRing->frameUsed };
+	pRing->frame.push_back(frame);
+	pRing->frameUsed = 0;
+}
+
+//GPUIt[̕OɕԂ
+void RetireDescriptorFrames( DescriptorRing* pRing, uint64_t completedValue )
+{
+	while(!pRing->frame.empty() && pRing->frame.front().fenceValue <= completedValue)
+	{
+		const uint32_t count = pRing->frame.front().count;
+		pRing->tail = (pRing->tail + count) % pRing->count;
+		pRing->used -= count;
+		pRing->frame.pop_front();
+	}
+}
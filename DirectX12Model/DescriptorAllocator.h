@@ -0,0 +1,51 @@
+#pragma once
+
+//Lqq̊蓖
+//D3D12ɂ͈ˑAq[v擪̈ʒu(nhւ̕ϊGpuDescriptorHeap(Main.cpp)s)
+//Egr[̓t[XgA͈͂蓖āAԂƂɑŐ󂫔͈͂Ƃ܂Ƃ߂
+//Et[Ƃ̃e[u̓O珇Ɋ蓖āAt[̍ŌɃ^CCtFX̒lt
+//  GPU̒l܂Ői񂾂܂Ƃ߂ĕԂ
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+
+struct DescriptorRange
+{
+	uint32_t index;		//q[v擪̈ʒu
+	uint32_t count;
+};
+
+//gr[̗̈
+struct DescriptorFreeList
+{
+	uint32_t count;
+	std::vector<DescriptorRange> freeRange;	//ʒuɕ񂾋󂫔͈
+	uint32_t used;
+};
+
+//t[Ƃ̃e[ü̗
+struct DescriptorRingFrame
+{
+	uint64_t fenceValue;
+	uint32_t count;		//̃t[Ŏg(Ő܂ԂƂ̗]܂)
+};
+
+struct DescriptorRing
+{
+	uint32_t begin;		//q[vł̐擪̈ʒu
+	uint32_t count;
+	uint32_t head;		//Ɋ蓖Ăʒu(begin̑Έʒu)
+	uint32_t tail;		//GPUgĂłÂʒu
+	uint32_t used;
+	uint32_t frameUsed;	//L^̃t[Ŏg
+	std::deque<DescriptorRingFrame> frame;	//tFX̒l̏ɕ
+};
+
+void InitDescriptorFreeList( DescriptorFreeList* pFreeList, uint32_t count );
+bool AllocatePersistentDescriptors( DescriptorFreeList* pFreeList, uint32_t count, DescriptorRange* pRange );
+void FreePersistentDescriptors( DescriptorFreeList* pFreeList, DescriptorRange* pRange );
+void InitDescriptorRing( DescriptorRing* pRing, uint32_t begin, uint32_t count );
+bool AllocateTransientDescriptors( DescriptorRing* pRing, uint32_t count, DescriptorRange* pRange );
+void FinishDescriptorFrame( DescriptorRing* pRing, uint64_t fenceValue );
+void RetireDescriptorFrames( DescriptorRing* pRing, uint64_t completedValue );
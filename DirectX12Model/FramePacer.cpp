@@ -0,0 +1,77 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//^CCtFX̏
+void InitTimelineFence( TimelineFence* pTimeline )
+{
+	pTimeline->nextValue = 1;
+	pTimeline->completedValue = 0;
+	pTimeline->retirement.clear();
+}
+
+//Signallo
+uint64_t AdvanceTimelineFence( TimelineFence* pTimeline )
+{
+	return pTimeline->nextValue++;
+}
+
+//completedValue܂łɓo^ꂽl̏ɌĂ
+void PollTimelineFence( TimelineFence* pTimeline, uint64_t completedValue )
+{
+	pTimeline->completedValue = max(pTimeline->completedValue,completedValue);
+	while(!pTimeline->retirement.empty() && pTimeline->retirement.front().value <= pTimeline->completedValue)
+	{
+		function<void()> callback = pTimeline->retirement.front().callback;
+		pTimeline->retirement.pop_front();
+		callback();
+	}
+}
+
+//GPUvalue܂Ői񂾂Ăԏo^
+//\[XLv`Ă΁ÂƂ܂ŉx点
+void RetireAfter( TimelineFence* pTimeline, uint64_t value, function<void()> callback )
+{
+	if(value <= pTimeline->completedValue)
+	{
+		callback();
+		return;
+	}
+
+	TimelineRetirement retirement = { value, callback };
+	auto it = pTimeline->retirement.end();
+	while(it != pTimeline->retirement.begin() && (it - 1)->value > value)
+	{
+		--it;
+	}
+	pTimeline->retirement.insert(it,retirement);
+}
+
+//cĂ̂Ă(GPŮ҂PollTimelineFence()ĂĂԂ)
+void DestroyTimelineFence( TimelineFence* pTimeline )
+{
+	pTimeline->retirement.clear();
+}
+
+//t[y[VȌ
+void InitFramePacer( FramePacer* pPacer, uint32_t frameCount )
+{
+	pPacer->frameCount = min(max(frameCount,1u),MAX_FRAME_COUNT);
+	pPacer->frameIndex = 0;
+	for(uint32_t n = 0;n < MAX_FRAME_COUNT;n++)
+	{
+		pPacer->frameFenceValue[n] = 0;
+	}
+}
+
+//̃t[̍ŌSignallL^Ď̃t[ɐi
+//̃t[̃\[XgOɁA*pWaitValue܂GPUiނ̂҂(܂gĂȂ0)
+uint32_t AdvanceFramePacer( FramePacer* pPacer, uint64_t signaledValue, uint64_t* pWaitValue )
+{
+	pPacer->frameFenceValue[pPacer->frameIndex] = signaledValue;
+	pPacer->frameIndex = (pPacer->frameIndex + 1) % pPacer->frameCount;
+	*pWaitValue = pPacer->frameFenceValue[pPacer->frameIndex];
+	return pPacer->frameIndex;
+}
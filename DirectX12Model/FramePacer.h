@@ -0,0 +1,42 @@
+#pragma once
+
+//^CCtFXƃt[y[VO
+//D3D12Win32ɂ͈ˑAlGpuFence(mFpɂ͖͋[GPU̎v)n
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+//ɏt[(1`MAX_FRAME_COUNTNɎwł)
+const uint32_t MAX_FRAME_COUNT = 4;
+
+//^CCtFX
+//Signal邽тɒl1AGPU̒l܂Ői񂾂o^ꂽĂ
+struct TimelineRetirement
+{
+	uint64_t value;
+	std::function<void()> callback;
+};
+struct TimelineFence
+{
+	uint64_t nextValue;				//Signall
+	uint64_t completedValue;		//GPUl(ŌPollTimelineFence()ɓnꂽl)
+	std::deque<TimelineRetirement> retirement;	//l̏ɕ
+};
+
+//t[y[VO
+//t[Ƃ̃\[XframeCountA\[XgÕt[̊҂Ăėp
+struct FramePacer
+{
+	uint32_t frameCount;
+	uint32_t frameIndex;
+	uint64_t frameFenceValue[MAX_FRAME_COUNT];	//et[̍ŌSignall
+};
+
+void InitTimelineFence( TimelineFence* pTimeline );
+uint64_t AdvanceTimelineFence( TimelineFence* pTimeline );
+void PollTimelineFence( TimelineFence* pTimeline, uint64_t completedValue );
+void RetireAfter( TimelineFence* pTimeline, uint64_t value, std::function<void()> callback );
+void DestroyTimelineFence( TimelineFence* pTimeline );
+void InitFramePacer( FramePacer* pPacer, uint32_t frameCount );
+uint32_t AdvanceFramePacer( FramePacer* pPacer, uint64_t signaledValue, uint64_t* pWaitValue );
@@ -0,0 +1,32 @@
+#include "IndirectArguments.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//ׂ`ƃCX^X̃ob``
+//`悲ƂɑSob`̈ɏ݁A񂾐Ԃ(eʂŐ؂Ƃ͕`PʂŐ؂)
+//̖Pȃ[vɂāAݐ(CgRoC)ւ͐擪珇ɏ
+uint32_t BuildIndirectArguments( const DrawItem* pItems, uint32_t itemCount, const Subset* pSubset,
+	const InstanceBatch* pBatch, uint32_t batchCount, IndirectCommand* pDest, uint32_t capacity )
+{
+	const uint32_t drawCount = (batchCount > 0) ? min(itemCount,capacity / batchCount) : 0;
+
+	IndirectCommand* pCommand = pDest;
+	for(uint32_t n = 0;n < drawCount;n++)
+	{
+		const Subset& subset = pSubset[pItems[n].subset];
+		for(uint32_t b = 0;b < batchCount;b++)
+		{
+			pCommand->materialIndex = subset.mat_index;
+			pCommand->draw.IndexCountPerInstance = subset.vertexCount;
+			pCommand->draw.InstanceCount = pBatch[b].instanceCount;
+			pCommand->draw.StartIndexLocation = subset.vertexStart;
+			pCommand->draw.BaseVertexLocation = 0;
+			pCommand->draw.StartInstanceLocation = pBatch[b].firstInstance;
+			pCommand++;
+		}
+	}
+
+	return static_cast<uint32_t>(pCommand - pDest);
+}
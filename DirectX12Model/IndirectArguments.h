@@ -0,0 +1,50 @@
+#pragma once
+
+//ExecuteIndirectp̕`
+//ׂ`L[ƃCX^X̃ob`A`悲ƂɃ}eÃ[g萔(b2)
+//DrawIndexedInstancedׂ̈BD3D12ɂ͈ˑA̕т𓯂ɂĂ
+
+#include <cstdint>
+
+//bṼTuZbg(bVt@C̕т̂܂ܓǂݍ)
+struct Subset
+{
+	int mat_index;
+	int vertexCount;
+	int vertexStart;
+};
+
+//`L[̗vf(L[̍Main.cppMakeDrawKey)
+struct DrawItem
+{
+	uint64_t key;
+	uint32_t subset;
+};
+
+//bVƂ̃CX^X͈̔
+struct InstanceBatch
+{
+	uint32_t meshIndex;
+	uint32_t firstInstance;		//CX^Xobt@̈ʒu
+	uint32_t instanceCount;
+};
+
+//D3D12_DRAW_INDEXED_ARGUMENTSƓ
+struct DrawIndexedArguments
+{
+	uint32_t IndexCountPerInstance;
+	uint32_t InstanceCount;
+	uint32_t StartIndexLocation;
+	int32_t BaseVertexLocation;
+	uint32_t StartInstanceLocation;
+};
+
+//R}hVOl`̈̏([g萔A`)ɕׂ
+struct IndirectCommand
+{
+	uint32_t materialIndex;
+	DrawIndexedArguments draw;
+};
+
+uint32_t BuildIndirectArguments( const DrawItem* pItems, uint32_t itemCount, const Subset* pSubset,
+	const InstanceBatch* pBatch, uint32_t batchCount, IndirectCommand* pDest, uint32_t capacity );
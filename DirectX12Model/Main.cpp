@@ -10,7 +10,28 @@
 
 #include <DirectXMath.h>
 #include <vector>
+#include <algorithm>
 #include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+#include "SoftwareRenderer.h"
+#include "BuddyAllocator.h"
+#include "FramePacer.h"
+#include "RecordWorkers.h"
+#include "RenderGraph.h"
+#include "DescriptorAllocator.h"
+#include "IndirectArguments.h"
+#include "ShaderCache.h"
+#include "ModelScene.h"
 
 using namespace DirectX;
 using Microsoft::WRL::ComPtr;
@@ -42,61 +63,528 @@ bool CompileShader();
 bool CreatePipelineStateObject();
 bool CreateVertexBuffer();
 bool CreateCbvSrv();
+bool CreateFrameConstantBuffer();
+bool AllocateFrameConstant( const void* pData, UINT size, D3D12_GPU_VIRTUAL_ADDRESS* pGpuAddress );
+struct ConstantBlock;
+bool CreateConstantBlock( ConstantBlock* pBlock, void* pShadow, UINT size );
+void SetConstantBlockData( ConstantBlock* pBlock, UINT offset, const void* pData, UINT size );
+void UploadConstantBlock( ConstantBlock* pBlock, D3D12_GPU_VIRTUAL_ADDRESS* pGpuAddress );
+void UpdateProjection();
+struct HeapPool;
+struct BufferAllocation;
+struct TextureAllocation;
+struct HeapPoolStatistics;
+void InitHeapPool( HeapPool* pPool, D3D12_HEAP_TYPE type, D3D12_HEAP_FLAGS flags, UINT64 blockSize, UINT64 minBlockSize );
+bool AllocateBuffer( HeapPool* pPool, UINT64 size, UINT64 alignment, BufferAllocation* pAllocation );
+void FreeBuffer( HeapPool* pPool, BufferAllocation* pAllocation );
+bool CreatePlacedTexture( HeapPool* pPool, const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES initialState,
+	ComPtr<ID3D12Resource>* pResource, TextureAllocation* pAllocation );
+void FreeTexture( HeapPool* pPool, TextureAllocation* pAllocation );
+void GetHeapPoolStatistics( const HeapPool* pPool, HeapPoolStatistics* pStatistics );
+void OutputHeapPoolStatistics( const char* name, const HeapPool* pPool );
+struct GpuFence;
+bool InitGpuFence( GpuFence* pFence );
+bool SignalGpuFence( GpuFence* pFence, ID3D12CommandQueue* pQueue, UINT64 value );
+bool WaitGpuFence( GpuFence* pFence, UINT64 value );
+UINT64 GetGpuFenceCompletedValue( GpuFence* pFence );
+void DestroyGpuFence( GpuFence* pFence );
+void ParseCommandLine( const char* pCommandLine );
+bool CreateRecordWorkers();
+void DestroyRecordWorkers();
+struct GpuRenderGraph;
+UINT ImportRenderGraphResource( GpuRenderGraph* pGraph, const char* name, ID3D12Resource* pResource,
+	D3D12_RESOURCE_STATES initialState, D3D12_RESOURCE_STATES finalState );
+UINT CreateRenderGraphTexture( GpuRenderGraph* pGraph, const char* name, const D3D12_RESOURCE_DESC* pDesc, const D3D12_CLEAR_VALUE* pClearValue );
+UINT AddGpuRenderGraphPass( GpuRenderGraph* pGraph, const char* name, function<void(ID3D12GraphicsCommandList*)> execute );
+bool CreateRenderGraphTransients( GpuRenderGraph* pGraph );
+void SetRenderGraphResource( GpuRenderGraph* pGraph, UINT resource, ID3D12Resource* pResource );
+void ExecuteRenderGraph( const GpuRenderGraph* pGraph, ID3D12GraphicsCommandList* pCommandList );
+void FinishRenderGraph( const GpuRenderGraph* pGraph, ID3D12GraphicsCommandList* pCommandList );
+void OutputRenderGraphStatistics( const char* name, const RenderGraph* pGraph );
+bool CreateFrameGraph();
+struct GpuDescriptorHeap;
+bool CreateGpuDescriptorHeap( GpuDescriptorHeap* pHeap, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT descriptorCount, bool shaderVisible );
+D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorCpuHandle( const GpuDescriptorHeap* pHeap, UINT index );
+D3D12_GPU_DESCRIPTOR_HANDLE GetDescriptorGpuHandle( const GpuDescriptorHeap* pHeap, UINT index );
+bool CopyFrameDescriptorTable( const DescriptorRange* pSource, DescriptorRange* pTable );
+UINT64 MakeDrawKey( UINT pass, UINT pipeline, UINT material, float depth );
+void RadixSortDrawItems( vector<DrawItem>* pItems, vector<DrawItem>* pTemp );
+void BuildDrawQueue( FXMMATRIX worldView );
+bool BenchmarkDrawSort( UINT drawCount );
+struct CachedCommandList;
+void BeginCachedCommandList( CachedCommandList* pCache, ID3D12GraphicsCommandList* pCommandList );
+void CachedSetGraphicsRootSignature( CachedCommandList* pCache, ID3D12RootSignature* pRootSignature );
+void CachedSetDescriptorHeap( CachedCommandList* pCache, ID3D12DescriptorHeap* pDescriptorHeap );
+void CachedRSSetViewport( CachedCommandList* pCache, const D3D12_VIEWPORT& viewport );
+void CachedRSSetScissorRect( CachedCommandList* pCache, const D3D12_RECT& scissorRect );
+void CachedIASetPrimitiveTopology( CachedCommandList* pCache, D3D12_PRIMITIVE_TOPOLOGY topology );
+void CachedIASetVertexBuffer( CachedCommandList* pCache, UINT slot, const D3D12_VERTEX_BUFFER_VIEW& view );
+void CachedIASetIndexBuffer( CachedCommandList* pCache, const D3D12_INDEX_BUFFER_VIEW& view );
+void CachedSetGraphicsRootConstantBufferView( CachedCommandList* pCache, UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address );
+void CachedSetGraphicsRootDescriptorTable( CachedCommandList* pCache, UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE handle );
+bool CheckCachedCommandList();
+bool CreateInstanceBuffer();
+void UpdateInstances();
+bool CreateIndirectBuffer();
+bool CompileShaderWithD3DCompiler( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode );
+bool CheckPipelineCacheKey();
+UINT64 HashPipelineStateDesc( const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, UINT64 rootSignatureKey, UINT64 vertexShaderKey, UINT64 pixelShaderKey );
+bool CreateCachedPipelineState( D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, UINT64 key, ComPtr<ID3D12PipelineState>* pPipelineState );
+struct PipelinePermutation;
+struct PipelineBuild;
+bool CreatePermutationPipelineState( const PipelinePermutation& permutation, const vector<UINT8>& vertexShader, UINT64 vertexShaderKey,
+	const vector<UINT8>& pixelShader, UINT64 pixelShaderKey, ComPtr<ID3D12PipelineState>* pPipelineState );
+UINT AddShaderJob( PipelineBuild* pBuild, const char* fileName, const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget );
+void AddPipelineJob( PipelineBuild* pBuild, UINT permutation );
+bool RunPipelineBuildJob( PipelineBuild* pBuild, UINT jobIndex );
+void PipelineBuildWorker( PipelineBuild* pBuild );
+bool RunPipelineBuild( PipelineBuild* pBuild );
+void OutputPipelineBuildStatistics( const PipelineBuild* pBuild );
+bool LoadModel( const char* fileName );
+bool RunHeadless();
+void BenchmarkSoftwareVertexTransform( UINT vertexCount );
+void MultiplyMatrixStream( XMFLOAT4X4* pOutput, const XMFLOAT4X4* pInput, UINT count, FXMMATRIX matrix );
+void BenchmarkMatrixStream( UINT matrixCount );
+struct TransformStream;
+void ResizeTransformStream( TransformStream* pTransforms, UINT count );
+void SetTransform( TransformStream* pTransforms, UINT index, FXMVECTOR position, FXMVECTOR rotation, FXMVECTOR scale );
+void SetGridTransforms( TransformStream* pTransforms, UINT count );
+void ComposeTransforms( const TransformStream& transforms, UINT first, UINT count, XMFLOAT4X4* pDest );
+void ComposeTransformRange( const TransformStream& transforms, UINT part, UINT partCount, XMFLOAT4X4* pDest );
+void ComposeTransformsParallel( const TransformStream& transforms, XMFLOAT4X4* pDest );
+void BenchmarkTransformCompose( UINT transformCount );
+struct BoundingVolume;
+struct BoundingVolumeStream;
+void ComputeBoundingVolume( const Vertex* pVertex, const int* pIndex, int indexCount, BoundingVolume* pVolume );
+void ResizeBoundingVolumeStream( BoundingVolumeStream* pVolumes, UINT count );
+void SetBoundingVolume( BoundingVolumeStream* pVolumes, UINT index, const BoundingVolume& volume );
+void ExtractFrustumPlanes( FXMMATRIX matrix, XMFLOAT4* pPlanes );
+void CullBoundingVolumes( const BoundingVolumeStream& volumes, UINT first, UINT count, const XMFLOAT4* pPlanes, UINT8* pVisible );
+void BuildInstanceBounds( const TransformStream& transforms, const BoundingVolume& localVolume, BoundingVolumeStream* pVolumes );
+void CompactTransforms( const TransformStream& source, const UINT8* pVisible, TransformStream* pDest );
+void CullScene( FXMMATRIX world, CXMMATRIX viewProject );
+void BenchmarkFrustumCulling( UINT volumeCount );
+XMMATRIX GetTransformMatrix( const TransformStream& transforms, UINT index );
+struct OcclusionBuffer;
+void InitOcclusionBuffer( OcclusionBuffer* pBuffer );
+void RenderOccluders( OcclusionBuffer* pBuffer, const TransformStream& transforms, const BoundingVolumeStream& bounds,
+	const UINT8* pVisible, FXMMATRIX world, CXMMATRIX viewProject );
+void RasterizeOcclusionBand( OcclusionBuffer* pBuffer, UINT part, UINT partCount );
+UINT CullOccludedVolumes( const OcclusionBuffer& buffer, const BoundingVolumeStream& bounds, FXMMATRIX matrix, UINT8* pVisible );
+void BenchmarkOcclusionCulling( UINT instanceCount );
+bool BenchmarkPixelShading( UINT pixelCount );
 
 
 std::vector<UINT8> LoadTexture( const char* fileName );
 
-const UINT FRAME_COUNT = 2;
+//1t[̒萔obt@̈̃TCY(256oCgPʂ4096)
+const UINT FRAME_CONSTANT_BUFFER_SIZE = 1024 * 1024;
 
-struct Vertex
+__declspec(align(256))
+struct ConstantBuffer
+{
+	XMMATRIX world;
+	XMMATRIX view;
+	XMMATRIX project;
+};
+__declspec(align(256))
+struct LightBuffer
 {
-	float position[3];
-	float normal[3];
-	float textureCoord[2];
+	XMFLOAT3 lightDirection;
 };
 
-struct Subset
+//ύX̂16oCgPʂ͈̔͂Abv[h萔obt@
+//et[̗̈ɏ풓At[Ƃɖf̍srbgŊǗ
+const UINT CONSTANT_BLOCK_ROW_SIZE = 16;
+const UINT CONSTANT_BLOCK_MAX_SIZE = CONSTANT_BLOCK_ROW_SIZE * 64;
+struct ConstantBlock
 {
-	int mat_index;
-	int vertexCount;
-	int vertexStart;
+	UINT8* pShadow;					//CPŨf[^(Ōɐݒ肳ꂽl)
+	UINT size;
+	UINT64 offset;					//et[̈̃ItZbg
+	UINT64 dirtyMask[MAX_FRAME_COUNT];	//t[Ƃ̖f̍s
 };
 
-__declspec(align(256))
-struct Material
-{
-	float diffuse[3];
-	float alpha;
-	float ambient[3];
-	float specular[3];
-	float power;
-	float emmisive[3];
+//ID3D12Heap܂Ƃ߂ĊmۂA̒Ƀ\[Xzu
+//obt@p̃v[̓q[vŜ𕢂obt@1A̒ItZbgŐ؂蕪
+//eNX`p̃v[CreatePlacedResourceŔzu(eNX`4KBAȊO64KBAC)
+struct HeapBlock
+{
+	ComPtr<ID3D12Heap> heap;
+	ComPtr<ID3D12Resource> buffer;	//obt@p̂
+	UINT8* pCpuAddress;				//Abv[hq[ṽobt@p̂
+	BuddyAllocator allocator;
+};
+struct HeapPool
+{
+	D3D12_HEAP_TYPE type;
+	D3D12_HEAP_FLAGS flags;
+	UINT64 blockSize;
+	UINT64 minBlockSize;
+	vector<HeapBlock> block;
+};
+struct BufferAllocation
+{
+	UINT blockIndex;
+	UINT64 offset;
+	UINT64 size;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress;
+	UINT8* pCpuAddress;
+};
+struct TextureAllocation
+{
+	UINT blockIndex;
+	UINT64 offset;
+	UINT64 size;
+};
+struct HeapPoolStatistics
+{
+	UINT blockCount;
+	UINT allocationCount;
+	UINT64 reservedSize;		//mۂq[v̍v
+	UINT64 usedSize;			//蓖ĂubN̍v
+	UINT64 requestedSize;		//vꂽTCY̍v
+	UINT64 largestFreeSize;		//1Ŋ蓖ĂőTCY
+	float fragmentation;		//1 - ő󂫃ubN / 󂫗eʂ̍v
 };
 
-struct Mesh
-{
-	int vertexCount;
-	Vertex* vertecies;
-	int indexCount;
-	int* indexArray;
-	int subsetCount;
-	Subset* subset;
-	int materialCount;
-	Material* material;
-	string* textureName;
+//D3D12̃tFX(TimelineFenceɊln)
+struct GpuFence
+{
+	ComPtr<ID3D12Fence> fence;
+	HANDLE event;
 };
 
-__declspec(align(256))
-struct ConstantBuffer
+//ԂLbVR}hXg̃bp[
+//ݒς݂̏ԂƓݒ͋L^ȂBsƏȂ𐔂Ă
+const UINT MAX_CACHED_ROOT_PARAMETER_COUNT = 8;
+const UINT MAX_CACHED_VERTEX_BUFFER_COUNT = 2;
+
+struct CachedCommandList
 {
-	XMMATRIX world;
-	XMMATRIX view;
-	XMMATRIX project;
+	ID3D12GraphicsCommandList* pCommandList;
+
+	ID3D12RootSignature* pRootSignature;
+	ID3D12DescriptorHeap* pDescriptorHeap;
+	D3D12_VIEWPORT viewport;
+	D3D12_RECT scissorRect;
+	D3D12_PRIMITIVE_TOPOLOGY topology;
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView[MAX_CACHED_VERTEX_BUFFER_COUNT];
+	D3D12_INDEX_BUFFER_VIEW indexBufferView;
+	bool viewportValid;
+	bool scissorRectValid;
+	bool vertexBufferValid[MAX_CACHED_VERTEX_BUFFER_COUNT];
+	bool indexBufferValid;
+
+	//[g([gVOl`ς疳)
+	UINT64 rootArgument[MAX_CACHED_ROOT_PARAMETER_COUNT];
+	UINT rootArgumentValid;		//rbgƂɃ[gݒς݂
+
+	UINT64 issuedCount;		//L^Ԑݒ̐
+	UINT64 elidedCount;		//Ԃ̂ŏȂ
 };
-__declspec(align(256))
-struct LightBuffer
+
+//CX^X`
+//bṼCX^X̃[hsCX^Xobt@ɕׂāA`1ŕ`
+//ob`(InstanceBatch)̓bVƂɃCX^Xobt@͈̔͂(̃TṽbV1)
+const UINT MAX_INSTANCE_COUNT = 128 * 1024;
+
+//CX^ẌʒuA](NH[^jI)Ag𐬕Ƃɕׂ(SOFTWARE_SIMD_WIDTH̔{܂ŒPʂ̕ϊŖ߂)
+//[hsComposeTransforms()SIMD̕܂Ƃ߂č
+struct TransformStream
 {
-	XMFLOAT3 lightDirection;
+	UINT count;
+	vector<float> positionX;
+	vector<float> positionY;
+	vector<float> positionZ;
+	vector<float> rotationX;
+	vector<float> rotationY;
+	vector<float> rotationZ;
+	vector<float> rotationW;
+	vector<float> scaleX;
+	vector<float> scaleY;
+	vector<float> scaleZ;
+};
+
+//JO
+//bVƃTuZbg̋E͓ǂݍݎɋ߁ACX^X̋E̓t[Ƃɕϊ
+//view * projecto6ʂɑ΂SOFTWARE_SIMD_WIDTH܂Ƃ߂ĒׁÂ`ɉ
+struct BoundingVolume
+{
+	XMFLOAT3 center;
+	XMFLOAT3 extent;	//AABB̑傫̔
+	float radius;		//center𒆐Sɂ̔a
+};
+
+//E𐬕Ƃɕׂ(SOFTWARE_SIMD_WIDTH̔{܂0Ŗ߂)
+struct BoundingVolumeStream
+{
+	UINT count;
+	vector<float> centerX;
+	vector<float> centerY;
+	vector<float> centerZ;
+	vector<float> extentX;
+	vector<float> extentY;
+	vector<float> extentZ;
+	vector<float> radius;
+};
+
+//JǑvpJE^
+struct CullingCounter
+{
+	UINT64 testedCount;		//ׂE̐
+	UINT64 visibleCount;	//Ɣ肵
+	UINT64 occludedCount;	//̒ɂ邪ՕɉBĂ
+	LONGLONG ticks;
+	LONGLONG occlusionTicks;	//Օ̕`Ɣ̎
+};
+
+//ExecuteIndirectp̕`(IndirectCommandIndirectArguments.h)
+//`悲ƂɃ}eÃ[g萔(b2)DrawIndexedInstancedׂ̈
+const UINT MAX_INDIRECT_COMMAND_COUNT = 64 * 1024;
+
+//DrawIndexedArgumentsD3D12_DRAW_INDEXED_ARGUMENTSƓтɂĂ
+static_assert(sizeof(DrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS), "DrawIndexedArguments");
+static_assert(offsetof(DrawIndexedArguments,IndexCountPerInstance) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS,IndexCountPerInstance), "DrawIndexedArguments");
+static_assert(offsetof(DrawIndexedArguments,InstanceCount) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS,InstanceCount), "DrawIndexedArguments");
+static_assert(offsetof(DrawIndexedArguments,StartIndexLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS,StartIndexLocation), "DrawIndexedArguments");
+static_assert(offsetof(DrawIndexedArguments,BaseVertexLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS,BaseVertexLocation), "DrawIndexedArguments");
+static_assert(offsetof(DrawIndexedArguments,StartInstanceLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS,StartInstanceLocation), "DrawIndexedArguments");
+static_assert(sizeof(IndirectCommand) == sizeof(UINT) + sizeof(D3D12_DRAW_INDEXED_ARGUMENTS), "IndirectCommand");
+
+//1̃XbhɊ蓖Ăŏ̕ϊ(ȂƃXbhNdȂ)
+const UINT MIN_TRANSFORMS_PER_JOB = 4096;
+
+//L^XbhƂ̃R}hAP[^ƃR}hXg
+struct RecordWorker : RecordCommandList
+{
+	ComPtr<ID3D12CommandAllocator> commandAllocator[MAX_FRAME_COUNT];
+	ComPtr<ID3D12GraphicsCommandList> commandList;
+	CachedCommandList cache;
+
+	bool Reset() override;
+	void SetState() override;
+	void RecordDraws( uint32_t workerIndex, const RecordJob& job ) override;
+	bool Close() override;
+};
+
+//_[OtD3D12
+//RpCRenderGraph.cppsAł̓\[X̎̂ƃpX̋L^(YRenderGraphƓ)
+struct GpuRenderGraphResource
+{
+	ComPtr<ID3D12Resource> resource;	//ꎞ\[XCreateRenderGraphTransientsō쐬
+	D3D12_RESOURCE_DESC desc;
+	D3D12_CLEAR_VALUE clearValue;
+	bool hasClearValue;
+};
+
+struct GpuRenderGraph
+{
+	RenderGraph graph;
+	vector<GpuRenderGraphResource> resource;
+	vector<function<void(ID3D12GraphicsCommandList*)>> execute;
+	ComPtr<ID3D12Heap> transientHeap;
+};
+
+//RenderGraphStateD3D12_RESOURCE_STATES̒l̂܂܎g
+static_assert(RENDER_GRAPH_STATE_COMMON == D3D12_RESOURCE_STATE_COMMON, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_VERTEX_AND_CONSTANT_BUFFER == D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_INDEX_BUFFER == D3D12_RESOURCE_STATE_INDEX_BUFFER, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_RENDER_TARGET == D3D12_RESOURCE_STATE_RENDER_TARGET, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_UNORDERED_ACCESS == D3D12_RESOURCE_STATE_UNORDERED_ACCESS, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_DEPTH_WRITE == D3D12_RESOURCE_STATE_DEPTH_WRITE, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_DEPTH_READ == D3D12_RESOURCE_STATE_DEPTH_READ, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_NON_PIXEL_SHADER_RESOURCE == D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_STREAM_OUT == D3D12_RESOURCE_STATE_STREAM_OUT, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_INDIRECT_ARGUMENT == D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_COPY_DEST == D3D12_RESOURCE_STATE_COPY_DEST, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_COPY_SOURCE == D3D12_RESOURCE_STATE_COPY_SOURCE, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_RESOLVE_DEST == D3D12_RESOURCE_STATE_RESOLVE_DEST, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_RESOLVE_SOURCE == D3D12_RESOURCE_STATE_RESOLVE_SOURCE, "RenderGraphState");
+static_assert(RENDER_GRAPH_STATE_PRESENT == D3D12_RESOURCE_STATE_PRESENT, "RenderGraphState");
+
+//Lqqq[v
+//gr[CPU猩q[vɃt[Xg犄蓖ĂčĂA
+//`Ɏge[u̓t[ƂɃVF[_[猩q[ṽOփRs[
+//(r[蒼ĂAGPUgĂÕt[̃e[u͕ςȂ)
+const UINT PERSISTENT_DESCRIPTOR_COUNT = 128 * 1024;
+const UINT TRANSIENT_DESCRIPTOR_COUNT = 64 * 1024;
+
+struct GpuDescriptorHeap
+{
+	ComPtr<ID3D12DescriptorHeap> heap;
+	UINT descriptorSize;
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuStart;
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuStart;	//VF[_[猩q[v̂
+};
+
+//`L[
+//`悲Ƃ64rbg̃L[AL[̏ɕׂĂL^
+//ʂpX(4rbg)ApCvC(12rbg)A}eA(16rbg)A[x(32rbg)
+//pCvCƃ}eA̕`悪Ԃ̂ŁAL^ɏԂ̐ݒȂ(DrawItemIndirectArguments.h)
+const UINT DRAW_KEY_PASS_SHIFT = 60;
+const UINT DRAW_KEY_PIPELINE_SHIFT = 48;
+const UINT DRAW_KEY_MATERIAL_SHIFT = 32;
+
+//VF[_[ƃpCvC̃fBXNLbV
+//VF[_[̃oCgR[hShaderCache.h̃LbVɕۑ
+//pCvCGetCachedBlob̓e𓯂fBNgɕۑACachedPSOɓn
+#define SHADER_CACHE_DIRECTORY "ShaderCache"
+const UINT PIPELINE_CACHE_VERSION = 2;	//pCvC̐ݒ̍ςグ
+
+//ShaderMacroD3D_SHADER_MACROƓтɂĂ̂ŁAD3DCompileɂ͂̂܂ܓn
+static_assert(sizeof(ShaderMacro) == sizeof(D3D_SHADER_MACRO), "ShaderMacro");
+static_assert(offsetof(ShaderMacro,Name) == offsetof(D3D_SHADER_MACRO,Name), "ShaderMacro");
+static_assert(offsetof(ShaderMacro,Definition) == offsetof(D3D_SHADER_MACRO,Definition), "ShaderMacro");
+
+struct ShaderCacheCounter
+{
+	LONG pipelineHit;
+	LONG pipelineMiss;
+	LONGLONG ticks;		//VF[_[ƃpCvC̍쐬ɂ
+};
+
+//pCvC̑gݍ킹
+//NɕKvȑgݍ킹SW߁AVF[_[̃RpCƃpCvC̍쐬Xbhŕɍs
+enum PipelinePermutationIndex
+{
+	PIPELINE_OPAQUE,
+	PIPELINE_WIREFRAME,
+	PIPELINE_PERMUTATION_COUNT
+};
+
+struct PipelinePermutation
+{
+	const char* name;
+	const char* fileName;
+	const ShaderMacro* pDefines;
+	const char* pVertexEntry;
+	const char* pPixelEntry;
+	D3D12_FILL_MODE fillMode;
+};
+
+//VF[_[̃Wu(VF[_[ggݍ킹1̃WuL)
+struct ShaderJob
+{
+	const char* fileName;
+	const ShaderMacro* pDefines;
+	const char* pEntryPoint;
+	const char* pTarget;
+	vector<UINT8> bytecode;
+	UINT64 key;
+	vector<UINT> dependent;		//̃VF[_[҂ĂpCvC̃Wu
+	LONGLONG beginTicks;
+	LONGLONG endTicks;
+};
+
+//pCvC̃Wu(_VF[_[ƃsNZVF[_[̃WuIĂs)
+struct PipelineJob
+{
+	UINT permutation;
+	UINT vertexShader;
+	UINT pixelShader;
+	UINT pendingCount;			//IĂȂVF[_[̃Wu̐
+	ComPtr<ID3D12PipelineState> pipelineState;
+	LONGLONG beginTicks;
+	LONGLONG endTicks;
+};
+
+//readyAremainingAfailedApendingCountlockŎ
+const UINT PIPELINE_JOB_BIT = 0x80000000;	//readyɐςރWuԍ̂pCvC̃Wu\rbg
+
+struct PipelineBuild
+{
+	UINT compileFlag;
+	vector<ShaderJob> shader;
+	vector<PipelineJob> pipeline;
+	mutex lock;
+	condition_variable wake;
+	deque<UINT> ready;
+	UINT remaining;
+	bool failed;
+	UINT threadCount;
+	LONGLONG beginTicks;
+	LONGLONG endTicks;
+};
+
+//baseԖڂSOFTWARE_SIMD_WIDTH̕ϊ̉]s(XMMatrixRotationQuaternion()Ɠ)Ɋg|3x3̕ǂ
+//pRow[row * 3 + column]ɓ
+inline void LoadTransformRotation( const TransformStream& transforms, UINT base, SoftwareFloat* pRow )
+{
+	const SoftwareFloat one = SoftwareSet(1.0f);
+	const SoftwareFloat x = SoftwareLoad(&transforms.rotationX[base]);
+	const SoftwareFloat y = SoftwareLoad(&transforms.rotationY[base]);
+	const SoftwareFloat z = SoftwareLoad(&transforms.rotationZ[base]);
+	const SoftwareFloat w = SoftwareLoad(&transforms.rotationW[base]);
+	const SoftwareFloat x2 = SoftwareAdd(x,x);
+	const SoftwareFloat y2 = SoftwareAdd(y,y);
+	const SoftwareFloat z2 = SoftwareAdd(z,z);
+	const SoftwareFloat xx = SoftwareMul(x,x2);
+	const SoftwareFloat yy = SoftwareMul(y,y2);
+	const SoftwareFloat zz = SoftwareMul(z,z2);
+	const SoftwareFloat xy = SoftwareMul(x,y2);
+	const SoftwareFloat xz = SoftwareMul(x,z2);
+	const SoftwareFloat yz = SoftwareMul(y,z2);
+	const SoftwareFloat wx = SoftwareMul(w,x2);
+	const SoftwareFloat wy = SoftwareMul(w,y2);
+	const SoftwareFloat wz = SoftwareMul(w,z2);
+	const SoftwareFloat scaleX = SoftwareLoad(&transforms.scaleX[base]);
+	const SoftwareFloat scaleY = SoftwareLoad(&transforms.scaleY[base]);
+	const SoftwareFloat scaleZ = SoftwareLoad(&transforms.scaleZ[base]);
+
+	pRow[0] = SoftwareMul(SoftwareSub(one,SoftwareAdd(yy,zz)),scaleX);
+	pRow[1] = SoftwareMul(SoftwareAdd(xy,wz),scaleX);
+	pRow[2] = SoftwareMul(SoftwareSub(xz,wy),scaleX);
+	pRow[3] = SoftwareMul(SoftwareSub(xy,wz),scaleY);
+	pRow[4] = SoftwareMul(SoftwareSub(one,SoftwareAdd(xx,zz)),scaleY);
+	pRow[5] = SoftwareMul(SoftwareAdd(yz,wx),scaleY);
+	pRow[6] = SoftwareMul(SoftwareAdd(xz,wy),scaleZ);
+	pRow[7] = SoftwareMul(SoftwareSub(yz,wx),scaleZ);
+	pRow[8] = SoftwareMul(SoftwareSub(one,SoftwareAdd(xx,yy)),scaleZ);
+}
+
+//ՕJO
+//̒ŎOɂCX^XՕƂĒ𑜓x̐[xobt@ɕ`A
+//^CƂ̍ł̐[x(HiZ)苫EAABBɂCX^X`悩O
+//[x̕`͍s̑тɕċL^Xbhŕɍs
+const UINT OCCLUSION_WIDTH = 320;
+const UINT OCCLUSION_HEIGHT = 192;
+const UINT OCCLUSION_TILE_SIZE = 8;
+const UINT OCCLUSION_TILE_COUNT_X = OCCLUSION_WIDTH / OCCLUSION_TILE_SIZE;
+const UINT OCCLUSION_TILE_COUNT_Y = OCCLUSION_HEIGHT / OCCLUSION_TILE_SIZE;
+const UINT MAX_OCCLUDER_COUNT = 32;
+
+//ʂɓeՕ̎Op`
+struct OcclusionTriangle
+{
+	float x[3];
+	float y[3];
+	float z[3];
+	int minX;
+	int minY;
+	int maxX;
+	int maxY;
+};
+
+struct OcclusionBuffer
+{
+	vector<float> depth;			//OCCLUSION_WIDTH * OCCLUSION_HEIGHT
+	vector<float> tileMaxDepth;		//OCCLUSION_TILE_COUNT_X * OCCLUSION_TILE_COUNT_Y
+	SoftwareVertexStream stream;	//g_mesh̒_(_ϊ̓\tgEFAX^CU[Ƌp)
+	vector<SoftwareVertex> vertex;
+	vector<OcclusionTriangle> triangle;
+	vector<UINT64> candidate;		//ՕIԍƗp(32rbg[xAʂCX^Ẍʒu)
+	UINT occluderCount;
+};
+
+//萔obt@XV̌vpJE^
+struct ConstantUploadCounter
+{
+	UINT64 uploadBytes;		//CgRoCւ̏ݗ
+	LONGLONG updateTicks;	//Update()CPU
+	UINT frameCount;
 };
 
 //pCvCIuWFNg
@@ -104,48 +592,147 @@ ComPtr<ID3D12Device> g_device;
 ComPtr<ID3D12CommandQueue> g_commandQueue;
 ComPtr<IDXGISwapChain3> g_swapChain;
 ComPtr<ID3D12DescriptorHeap> g_rtvHeap;
-ComPtr<ID3D12Resource> g_renderTarget[FRAME_COUNT];
-ComPtr<ID3D12CommandAllocator> g_commandAllocator[FRAME_COUNT];
+ComPtr<ID3D12Resource> g_renderTarget[MAX_FRAME_COUNT];
+ComPtr<ID3D12CommandAllocator> g_commandAllocator[MAX_FRAME_COUNT];
 ComPtr<ID3D12GraphicsCommandList> g_commandList;
+ComPtr<ID3D12GraphicsCommandList> g_postCommandList;	//`̃oAp(g_commandAllocatorL)
 ComPtr<ID3D12PipelineState> g_pipelineState;
 UINT g_rtvDescriptorSize = 0;
 UINT g_dsvDescriptorSize = 0;
-UINT g_cbvSrvDescriptorSize = 0;
 ComPtr<ID3D12RootSignature> g_rootSignature;
+UINT64 g_rootSignatureKey = 0;		//VACY[gVOl`̃nbV(pCvC̃LbṼL[Ɏg)
 D3D12_VIEWPORT g_viewport = { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
 D3D12_RECT g_scissorRect = { 0, 0, 1280, 720 };
 ComPtr<ID3D12DescriptorHeap> g_srvHeap;
 ComPtr<ID3D12DescriptorHeap> g_cbvHeap;
-ComPtr<ID3D12DescriptorHeap> g_cbvSrvHeap;
 
-ComPtr<ID3D12Resource> g_depthStencil;
+//CBV/SRV/UAV̋Lqqׂ͂Ă犄蓖Ă
+GpuDescriptorHeap g_stagingDescriptorHeap;	//r[q[v(VF[_[͌Ȃ)
+DescriptorFreeList g_persistentDescriptors;
+GpuDescriptorHeap g_descriptorHeap;			//`Ɏgq[v(O)
+DescriptorRing g_descriptorRing;
+DescriptorRange g_sceneTable;		//eNX`(t0)ƃ}eAe[u(t1)2
+DescriptorRange g_frameSceneTable;	//̃t[Ŏgg_sceneTablẽRs[
+
+//t[̃_[Ot([xobt@̓Oẗꎞ\[X)
+GpuRenderGraph g_frameGraph;
+UINT g_backBufferResource = RENDER_GRAPH_INVALID;
+UINT g_depthResource = RENDER_GRAPH_INVALID;
 ComPtr<ID3D12DescriptorHeap> g_dsvHeap;
 
 ComPtr<IDXGIFactory4> factory;
 
 
 //\[X
-ComPtr<ID3D12Resource> g_vertexBuffer;
+HeapPool g_uploadBufferPool;		//_ACfbNXA}eA
+HeapPool g_texturePool;				//eNX`
+BufferAllocation g_vertexBuffer;
 D3D12_VERTEX_BUFFER_VIEW g_vertexBufferView;
-ComPtr<ID3D12Resource> g_indexBuffer;
+BufferAllocation g_indexBuffer;
 D3D12_INDEX_BUFFER_VIEW g_indexBufferView;
 ComPtr<ID3D12Resource> g_texture;
-ComPtr<ID3D12Resource> g_constantBuffer = nullptr;
-ComPtr<ID3D12Resource> g_lightBuffer = nullptr;
-ComPtr<ID3D12Resource> g_materialBuffer = nullptr;
+TextureAllocation g_textureAllocation;
+BufferAllocation g_materialBuffer;
 ConstantBuffer g_constantBufferData;
 LightBuffer g_lightBufferData;
-UINT8* g_pCbvDataBegin;
-UINT8* g_pCbv2DataBegin;
-UINT8* g_pCbv3DataBegin;
+UINT8* g_pMaterialDataBegin;
+
+//t[Ƃ̒萔obt@(jAAP[^)
+//GPUÕt[ǂłԂɏȂ悤At[Ƃɕʂ̗̈g
+ComPtr<ID3D12Resource> g_frameConstantBuffer = nullptr;
+UINT8* g_pFrameConstantDataBegin = nullptr;
+UINT64 g_frameConstantOffset = 0;
+D3D12_GPU_VIRTUAL_ADDRESS g_constantBufferAddress = 0;
+D3D12_GPU_VIRTUAL_ADDRESS g_lightBufferAddress = 0;
+UINT64 g_frameConstantPersistentSize = 0;	//et[̈̐擪ɏ풓ConstantBlock̃TCY
+
+ConstantBlock g_constantBlock;
+ConstantBlock g_lightBlock;
+ConstantUploadCounter g_constantUploadCounter = {};
+
+//ˉes͉pr[|[gςƂvZ
+float g_fov = 0.78539816339744830961566084581988f;
+float g_projectionFov = 0.0f;
+D3D12_VIEWPORT g_projectionViewport = {};
+XMFLOAT4X4 g_project;	//JOɂg
 
 Mesh g_mesh;
+vector<XMFLOAT3> g_subsetCenter;	//TuZbg̒S(`L[̐[xɎg)
+BoundingVolume g_meshBounds;		//bVŜ̋E
+BoundingVolumeStream g_subsetBounds;	//TuZbgƂ̋E
+
+//בւ`L[
+vector<DrawItem> g_drawQueue;
+vector<DrawItem> g_drawSortTemp;
+
+//CX^X(-instances N Ŕ̐w)
+UINT g_instanceCount = 1;
+vector<InstanceBatch> g_instanceBatch;		//UpdateInstances()Ŗt[
+TransformStream g_instanceTransform;
+
+//JǑ(CullScene()Ŗt[)
+BoundingVolumeStream g_instanceBounds;
+vector<UINT8> g_instanceVisible;
+vector<UINT8> g_subsetVisible;
+TransformStream g_visibleTransform;		//CX^Xl߂
+CullingCounter g_cullingCounter = {};
+OcclusionBuffer g_occlusionBuffer;
+bool g_occlusionCulling = false;	//N"-occlusion"w肷ƎՕJOs
+ComPtr<ID3D12Resource> g_instanceBuffer;
+XMFLOAT4X4* g_pInstanceDataBegin = nullptr;
+D3D12_VERTEX_BUFFER_VIEW g_instanceBufferView;
+
+//ExecuteIndirecẗobt@
+//1t[͕`̌ɋL^XbhƂ̕`搔(256oCg)u
+const UINT64 INDIRECT_COUNT_OFFSET = sizeof(IndirectCommand) * MAX_INDIRECT_COMMAND_COUNT;
+const UINT64 INDIRECT_FRAME_SIZE = INDIRECT_COUNT_OFFSET + 256;
+ComPtr<ID3D12CommandSignature> g_commandSignature;
+ComPtr<ID3D12Resource> g_indirectBuffer;
+UINT8* g_pIndirectDataBegin = nullptr;
+
+//VF[_[ƃpCvC̃LbV
+ShaderCache g_shaderCache;
+ShaderCacheCounter g_shaderCacheCounter = {};
+
+//pCvC̑gݍ킹(VF[_[ggݍ킹̓RpC1ōς܂)
+const PipelinePermutation g_pipelinePermutation[PIPELINE_PERMUTATION_COUNT] =
+{
+	{ "Opaque", "shader.hlsl", nullptr, "VSMain", "PSMain", D3D12_FILL_MODE_SOLID },
+	{ "Wireframe", "shader.hlsl", nullptr, "VSMain", "PSMain", D3D12_FILL_MODE_WIREFRAME },
+};
+ComPtr<ID3D12PipelineState> g_permutationPipelineState[PIPELINE_PERMUTATION_COUNT];
+bool g_wireframe = false;	//N"-wireframe"w肷ƃC[t[ŕ`
+
+//\tgEFAX^CU[(N"-headless N"w肷ƃEBhEƃfoCX炸Nt[`)
+bool g_headless = false;
+UINT g_headlessFrameCount = 0;
+
+bool g_benchmark = false;	//N"-benchmark"w肷ƕ`L[̕בւCX^X̂܂Ƃ߁AsⒸ_̕ϊ̑xv
 
 //IuWFNg
-ComPtr<ID3D12Fence> g_fence;
-UINT g_frameIndex = 0;
-UINT64 g_fenceValue[FRAME_COUNT] = {};
-HANDLE g_fenceEvent;
+TimelineFence g_timeline;
+FramePacer g_framePacer;
+GpuFence g_gpuFence;
+UINT g_frameIndex = 0;				//t[Ƃ̃\[X(AP[^A萔obt@̈)̃CfbNX
+UINT g_backBufferIndex = 0;			//Xbv`FC̃obNobt@̃CfbNX
+HANDLE g_frameLatencyWaitableObject = nullptr;
+
+//t[y[VO̐ݒ(R}hCŕύXł)
+//-frames N : ɏt[(1`4)B₷ƃX[vbgオx
+//-latency N: Xbv`FCɗ߂\҂t[̍ő吔
+//-vsync N  : Present̓Ԋu(0ŐȂ)
+UINT g_frameCount = 2;
+UINT g_backBufferCount = 2;
+UINT g_frameLatency = 2;
+UINT g_syncInterval = 1;
+
+//L^(-threads N ŋL^XbhwB0Ȃ烁CXbhŋL^)
+RecordWorkerPool g_recordWorkers;
+RecordWorker g_recordWorker[MAX_RECORD_THREAD_COUNT];
+RecordCommandList* g_pRecordCommandList[MAX_RECORD_THREAD_COUNT];	//g_recordWorkerw
+UINT g_recordThreadCount = 0;
+bool g_recordThreadCountSpecified = false;
+vector<RecordJob> g_recordJobs;
 
 bool g_useWarpDevice = false;
 float g_aspectRatio;
@@ -294,8 +881,21 @@ UINT64 UpdateSubresources(
 }
 
 
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow)
 {
+	ParseCommandLine(lpCmdLine);
+	if(g_headless)
+	{
+		//WinMaiñvOɂ͕Wo͂̂ŁANR\[΂ɏo͂
+		if(AttachConsole(ATTACH_PARENT_PROCESS))
+		{
+			FILE* pFile;
+			freopen_s(&pFile,"CONOUT$","w",stdout);
+			freopen_s(&pFile,"CONOUT$","w",stderr);
+		}
+		return RunHeadless() ? 0 : -1;
+	}
+
 	//EBhȄ-------------------------------
 	WNDCLASSEX windowClass = {0};
 	windowClass.cbSize = sizeof(windowClass);
@@ -439,12 +1039,25 @@ bool InitPipeline(HWND hwnd)
 		return false;
 	}
 
+	//_[Ot̍쐬
+	if(!CreateFrameGraph())
+	{
+		return false;
+	}
+
+	//L^p̃R}hXgƃXbh̍쐬
+	if(!CreateRecordWorkers())
+	{
+		return false;
+	}
+
 	return true;
 }
 
 //\[X̏
 bool InitResource()
 {
+	InitShaderCache(&g_shaderCache,SHADER_CACHE_DIRECTORY,CompileShaderWithD3DCompiler,D3D_COMPILER_VERSION);
 	if(!CreateRootSignature())
 	{
 		return false;
@@ -454,16 +1067,81 @@ bool InitResource()
 		return false;
 	}
 
+	//ÓIȃobt@ƃeNX`zuq[v
+	InitHeapPool(&g_uploadBufferPool,D3D12_HEAP_TYPE_UPLOAD,D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+		16 * 1024 * 1024,D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+	InitHeapPool(&g_texturePool,D3D12_HEAP_TYPE_DEFAULT,D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+		64 * 1024 * 1024,D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT);
+
 	if(!CreateVertexBuffer())
 	{
 		return false;
 	}
 
+	if(!CreateFrameConstantBuffer())
+	{
+		return false;
+	}
+
+	//CX^Xobt@̍쐬
+	if(!CreateInstanceBuffer())
+	{
+		return false;
+	}
+	SetGridTransforms(&g_instanceTransform,g_instanceCount);
+	InitOcclusionBuffer(&g_occlusionBuffer);
+
+	//ExecuteIndirecẗobt@̍쐬
+	if(!CreateIndirectBuffer())
+	{
+		return false;
+	}
+
+	//JƃCg̒萔obt@
+	if(!CreateConstantBlock(&g_constantBlock,&g_constantBufferData,sizeof(g_constantBufferData)))
+	{
+		return false;
+	}
+	if(!CreateConstantBlock(&g_lightBlock,&g_lightBufferData,sizeof(g_lightBufferData)))
+	{
+		return false;
+	}
+	XMFLOAT3 lightDirection(0.0f,1.0f,1.0f);
+	SetConstantBlockData(&g_lightBlock,offsetof(LightBuffer,lightDirection),&lightDirection,sizeof(lightDirection));
+
 	if(!CreateCbvSrv())
 	{
 		return false;
 	}
 
+	OutputHeapPoolStatistics("UploadBufferPool",&g_uploadBufferPool);
+	OutputHeapPoolStatistics("TexturePool",&g_texturePool);
+
+	if(g_benchmark)
+	{
+		if(!CheckPipelineCacheKey())
+		{
+			return false;
+		}
+		if(!BenchmarkDrawSort(100000) || !BenchmarkDrawSort(1000000))
+		{
+			return false;
+		}
+		if(!CheckCachedCommandList())
+		{
+			return false;
+		}
+		BenchmarkMatrixStream(1000000);
+		BenchmarkTransformCompose(1000000);
+		BenchmarkFrustumCulling(1000000);
+		BenchmarkOcclusionCulling(10000);
+		BenchmarkSoftwareVertexTransform(1000000);
+		if(!BenchmarkPixelShading(1000000))
+		{
+			return false;
+		}
+	}
+
 	//Õt[҂
 	/*if(!WaitForGpu())
 	{
@@ -475,18 +1153,94 @@ bool InitResource()
 //XV
 bool Update()
 {
+	//\҂̃t[Ƃ͂ő҂
+	WaitForSingleObjectEx(g_frameLatencyWaitableObject,1000,TRUE);
+
+	LARGE_INTEGER updateBegin;
+	QueryPerformanceCounter(&updateBegin);
+
 	static float angle = 0.0f;
 	angle += 0.01f;
 	//g_constantBufferData.world = XMMatrixIdentity();
-	g_constantBufferData.world = XMMatrixRotationY(angle);
-	g_constantBufferData.view = XMMatrixLookAtLH({0.0f,3.0f * cosf(angle),-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
-	g_constantBufferData.project = XMMatrixPerspectiveFovLH(0.78539816339744830961566084581988f,1280.0f/720.0f,1.0f,10000.0f);
-	memcpy(g_pCbvDataBegin,&g_constantBufferData,sizeof(g_constantBufferData));
-	g_lightBufferData.lightDirection = XMFLOAT3(0.0f,1.0f,1.0f);
-	memcpy(g_pCbv2DataBegin,&g_lightBufferData,sizeof(g_lightBufferData));
+	XMMATRIX world = XMMatrixRotationY(angle);
+	XMMATRIX view = XMMatrixLookAtLH({0.0f,3.0f * cosf(angle),-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	SetConstantBlockData(&g_constantBlock,offsetof(ConstantBuffer,world),&world,sizeof(world));
+	SetConstantBlockData(&g_constantBlock,offsetof(ConstantBuffer,view),&view,sizeof(view));
+	UpdateProjection();
+
+	//CX^XƃTuZbgI
+	CullScene(world,view * XMLoadFloat4x4(&g_project));
+
+	//`L[ĕׂ
+	BuildDrawQueue(world * view);
+
+	//CX^X܂Ƃ߂ăCX^Xobt@ɏ
+	UpdateInstances();
+
+	//ύX͈̂͂̃t[̗̈ɏGPUAhX擾
+	UploadConstantBlock(&g_constantBlock,&g_constantBufferAddress);
+	UploadConstantBlock(&g_lightBlock,&g_lightBufferAddress);
+
+	LARGE_INTEGER updateEnd;
+	QueryPerformanceCounter(&updateEnd);
+	g_constantUploadCounter.updateTicks += updateEnd.QuadPart - updateBegin.QuadPart;
+	g_constantUploadCounter.frameCount++;
+
+	//60t[Ƃ1t[̕ςo
+	if(g_constantUploadCounter.frameCount >= 60)
+	{
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		char text[256];
+		sprintf_s(text,"Update: %.3f us/frame, constant upload: %llu bytes/frame\n",
+			1000000.0 * g_constantUploadCounter.updateTicks / frequency.QuadPart / g_constantUploadCounter.frameCount,
+			g_constantUploadCounter.uploadBytes / g_constantUploadCounter.frameCount);
+		OutputDebugStringA(text);
+
+		//L^Xbh̏Ԑݒ̐(Õt[̋L^͏IĂ)
+		UINT64 issuedCount = 0;
+		UINT64 elidedCount = 0;
+		for(UINT n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+		{
+			issuedCount += g_recordWorker[n].cache.issuedCount;
+			elidedCount += g_recordWorker[n].cache.elidedCount;
+			g_recordWorker[n].cache.issuedCount = 0;
+			g_recordWorker[n].cache.elidedCount = 0;
+		}
+		sprintf_s(text,"State calls: %llu issued, %llu elided per frame\n",
+			issuedCount / g_constantUploadCounter.frameCount,elidedCount / g_constantUploadCounter.frameCount);
+		OutputDebugStringA(text);
+
+		const double cullingMs = 1000.0 * g_cullingCounter.ticks / frequency.QuadPart;
+		sprintf_s(text,"Culling: %llu tested, %llu visible, %llu occluded per frame, %.1f objects/ms, occlusion %.1f us/frame\n",
+			g_cullingCounter.testedCount / g_constantUploadCounter.frameCount,g_cullingCounter.visibleCount / g_constantUploadCounter.frameCount,
+			g_cullingCounter.occludedCount / g_constantUploadCounter.frameCount,cullingMs > 0.0 ? g_cullingCounter.testedCount / cullingMs : 0.0,
+			1000000.0 * g_cullingCounter.occlusionTicks / frequency.QuadPart / g_constantUploadCounter.frameCount);
+		OutputDebugStringA(text);
+		g_cullingCounter = {};
+
+		g_constantUploadCounter = {};
+	}
 	return true;
 }
 
+//pr[|[gςƂˉesvZ
+void UpdateProjection()
+{
+	if(g_projectionFov == g_fov &&
+		g_projectionViewport.Width == g_viewport.Width &&
+		g_projectionViewport.Height == g_viewport.Height)
+	{
+		return;
+	}
+	g_projectionFov = g_fov;
+	g_projectionViewport = g_viewport;
+
+	XMMATRIX project = XMMatrixPerspectiveFovLH(g_fov,g_viewport.Width / g_viewport.Height,1.0f,10000.0f);
+	SetConstantBlockData(&g_constantBlock,offsetof(ConstantBuffer,project),&project,sizeof(project));
+	XMStoreFloat4x4(&g_project,project);
+}
+
 //`
 bool Render()
 {
@@ -496,12 +1250,19 @@ bool Render()
 		return false;
 	}
 
-	//R}hXgs
-	ID3D12CommandList* ppCommandList[] = {g_commandList.Get()};
-	g_commandQueue->ExecuteCommandLists(_countof(ppCommandList), ppCommandList);
+	//R}hXgL^ɂ܂Ƃ߂Ďs
+	ID3D12CommandList* ppCommandList[MAX_RECORD_THREAD_COUNT + 2];
+	UINT commandListCount = 0;
+	ppCommandList[commandListCount++] = g_commandList.Get();
+	for(UINT n = 0;n < static_cast<UINT>(g_recordJobs.size());n++)
+	{
+		ppCommandList[commandListCount++] = g_recordWorker[n].commandList.Get();
+	}
+	ppCommandList[commandListCount++] = g_postCommandList.Get();
+	g_commandQueue->ExecuteCommandLists(commandListCount, ppCommandList);
 
 	//obNobt@\
-	if( FAILED( g_swapChain->Present(1,0) ) )
+	if( FAILED( g_swapChain->Present(g_syncInterval,0) ) )
 	{
 		return false;
 	}
@@ -517,6 +1278,16 @@ bool Render()
 
 bool PopulateCommandList()
 {
+	//̃t[̃e[uOɍ(L^XbhĝŋL^̑O)
+	if(!CopyFrameDescriptorTable(&g_sceneTable,&g_frameSceneTable))
+	{
+		return false;
+	}
+
+	//`XbhƂ̘A͈͂ɕ
+	//Wu1Ȃ炠ƂŃCXbhŋL^AȂL^XbhN
+	BeginRecordDraws(&g_recordWorkers,static_cast<UINT>(g_drawQueue.size()),g_pRecordCommandList,&g_recordJobs);
+
 	//R}hXg̃AP[^[Zbg
 	if(FAILED( g_commandAllocator[g_frameIndex]->Reset() ))
 	{
@@ -529,79 +1300,34 @@ bool PopulateCommandList()
 		return false;
 	}
 
-	//Kvȏݒ
-	g_commandList->SetGraphicsRootSignature(g_rootSignature.Get());
-
-	ID3D12DescriptorHeap* ppHeap[] = {g_cbvSrvHeap.Get()};
-	g_commandList->SetDescriptorHeaps( _countof(ppHeap), ppHeap );
-
-	// fBXNv^q[ve[uݒ.
-	auto handleCBV = g_cbvSrvHeap->GetGPUDescriptorHandleForHeapStart();
-	auto handleSRV = g_cbvSrvHeap->GetGPUDescriptorHandleForHeapStart();
-	handleSRV.ptr += g_cbvSrvDescriptorSize * 3;
-	g_commandList->SetGraphicsRootDescriptorTable( 0, handleCBV );
-	handleCBV.ptr += g_cbvSrvDescriptorSize;
-	g_commandList->SetGraphicsRootDescriptorTable( 1, handleCBV );
-	handleCBV.ptr += g_cbvSrvDescriptorSize;
-	g_commandList->SetGraphicsRootDescriptorTable( 3, handleCBV );
-	//g_commandList->SetGraphicsRootDescriptorTable(1,g_cbvHeap->GetGPUDescriptorHandleForHeapStart());
-	//g_commandList->SetGraphicsRootDescriptorTable(1,g_srvHeap->GetGPUDescriptorHandleForHeapStart());
-	
-	g_commandList->RSSetViewports(1, &g_viewport);
-	g_commandList->RSSetScissorRects( 1, &g_scissorRect );
+	//oAƃNA̓_[OtŋL^
+	//V[pX̕`͋L^Xbh̃XgŁÃXg̒Ɏs
+	SetRenderGraphResource(&g_frameGraph,g_backBufferResource,g_renderTarget[g_backBufferIndex].Get());
+	ExecuteRenderGraph(&g_frameGraph,g_commandList.Get());
 
-	//\[XoAݒ肵ăobNobt@_[^[QbgƂĎw
+	//R}hXg
+	if( FAILED( g_commandList->Close() ) )
 	{
-		D3D12_RESOURCE_BARRIER resourceBarrier = {};
-		resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-		resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		resourceBarrier.Transition.pResource = g_renderTarget[g_frameIndex].Get();
-		resourceBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-		resourceBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-		resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-		g_commandList->ResourceBarrier( 1, &resourceBarrier );
+		return false;
 	}
 
-	auto handleRTV = g_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-	auto handleDSV = g_dsvHeap->GetCPUDescriptorHandleForHeapStart();
-	handleRTV.ptr += ( g_frameIndex * g_rtvDescriptorSize );
-
-	g_commandList->OMSetRenderTargets(1, &handleRTV, FALSE, &handleDSV);
-
-	//_[^[Qbgr[NA
-	const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
-	g_commandList->ClearRenderTargetView( handleRTV, clearColor, 0, nullptr );
-	
-	//[xXeVr[NA
-	g_commandList->ClearDepthStencilView(handleDSV,D3D12_CLEAR_FLAG_DEPTH,1.0f,0,0,nullptr);
-
-	
-	
-	g_commandList->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	g_commandList->IASetVertexBuffers(0, 1, &g_vertexBufferView);
-	g_commandList->IASetIndexBuffer(&g_indexBufferView);
-	//g_commandList->DrawInstanced(g_mesh.vertexCount, 1, 0, 0);
-	for(int i = 0;i < g_mesh.subsetCount;i++)
+	//`̃R}hXg͓AP[^[ŋL^
+	//(L^łȂ1̃AP[^[𕡐̃XgŎg)
+	if( FAILED( g_postCommandList->Reset( g_commandAllocator[g_frameIndex].Get(), nullptr ) ) )
 	{
-		g_commandList->SetGraphicsRootDescriptorTable( 2, handleCBV );
-		handleCBV.ptr += g_cbvSrvDescriptorSize;
-		g_commandList->DrawIndexedInstanced(g_mesh.subset[i].vertexCount, 1, g_mesh.subset[i].vertexStart, 0, 0);
+		return false;
 	}
 
-	//obNobt@\
+	//obNobt@\łԂɖ߂
+	FinishRenderGraph(&g_frameGraph,g_postCommandList.Get());
+
+	if( FAILED( g_postCommandList->Close() ) )
 	{
-		D3D12_RESOURCE_BARRIER resourceBarrier = {};
-		resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-		resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		resourceBarrier.Transition.pResource = g_renderTarget[g_frameIndex].Get();
-		resourceBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-		resourceBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-		resourceBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-		g_commandList->ResourceBarrier( 1, &resourceBarrier );
+		return false;
 	}
 
-	//R}hXg
-	if( FAILED( g_commandList->Close() ) )
+	//SXbh̋L^I܂ő҂
+	if(!EndRecordDraws(&g_recordWorkers,g_pRecordCommandList,g_recordJobs))
 	{
 		return false;
 	}
@@ -633,41 +1359,47 @@ bool PopulateCommandList()
 
 bool WaitForGpu()
 {
-	if( FAILED( g_commandQueue->Signal(g_fence.Get(),g_fenceValue[g_frameIndex]) ) )
+	const UINT64 value = AdvanceTimelineFence(&g_timeline);
+	if(!SignalGpuFence(&g_gpuFence,g_commandQueue.Get(),value))
 	{
 		return false;
 	}
 
-	if( FAILED( g_fence->SetEventOnCompletion(g_fenceValue[g_frameIndex],g_fenceEvent) ) )
+	if(!WaitGpuFence(&g_gpuFence,value))
 	{
 		return false;
 	}
 
-	WaitForSingleObjectEx(g_fenceEvent,INFINITE,FALSE);
-
-	g_fenceValue[g_frameIndex]++;
+	PollTimelineFence(&g_timeline,GetGpuFenceCompletedValue(&g_gpuFence));
 
 	return true;
 }
 
 bool MoveToNextFrame()
 {
-	const UINT64 fence = g_fenceValue[g_frameIndex];
-	if( FAILED( g_commandQueue->Signal( g_fence.Get(), fence ) ) )
+	//̃t[̏IL^
+	const UINT64 value = AdvanceTimelineFence(&g_timeline);
+	if(!SignalGpuFence(&g_gpuFence,g_commandQueue.Get(),value))
 	{
 		return false;
 	}
-	g_frameIndex = g_swapChain->GetCurrentBackBufferIndex();
+	FinishDescriptorFrame(&g_descriptorRing,value);
 
-	if( g_fence->GetCompletedValue() < g_fenceValue[g_frameIndex] )
+	//̃t[̃\[XGPUgI܂ő҂
+	UINT64 waitValue;
+	g_frameIndex = AdvanceFramePacer(&g_framePacer,value,&waitValue);
+	g_backBufferIndex = g_swapChain->GetCurrentBackBufferIndex();
+	if(!WaitGpuFence(&g_gpuFence,waitValue))
 	{
-		if( FAILED( g_fence->SetEventOnCompletion( g_fenceValue[g_frameIndex], g_fenceEvent ) ))
-		{
-			return false;
-		}
-		WaitForSingleObjectEx(g_fenceEvent,INFINITE,FALSE);
+		return false;
 	}
-	g_fenceValue[g_frameIndex] = fence + 1;
+
+	//gI\[XƋLqq
+	PollTimelineFence(&g_timeline,GetGpuFenceCompletedValue(&g_gpuFence));
+	RetireDescriptorFrames(&g_descriptorRing,g_timeline.completedValue);
+
+	//GPŨt[̒萔obt@̈gÎŏ풓̈̌܂Ŗ߂
+	g_frameConstantOffset = g_frameConstantPersistentSize;
 	
 	return true;
 }
@@ -680,8 +1412,13 @@ bool Destroy()
 		return false;
 	}
 
-	//Cxgnh
-	CloseHandle(g_fenceEvent);
+	//L^XbhI
+	DestroyRecordWorkers();
+
+	//^CCtFXj
+	DestroyTimelineFence(&g_timeline);
+	DestroyGpuFence(&g_gpuFence);
+	CloseHandle(g_frameLatencyWaitableObject);
 	
 	return true;
 }
@@ -773,22 +1510,13 @@ bool CreateCommandQueue()
 		return false;
 	}
 
-	//tFX쐬
-	if(FAILED(g_device->CreateFence(g_fenceValue[g_frameIndex],D3D12_FENCE_FLAG_NONE,IID_PPV_ARGS(&g_fence))))
+	//^CCtFX쐬
+	InitTimelineFence(&g_timeline);
+	InitFramePacer(&g_framePacer,g_frameCount);
+	if(!InitGpuFence(&g_gpuFence))
 	{
 		return false;
 	}
-	g_fenceValue[g_frameIndex]++;
-
-	//tFXp̃Cxgnh쐬
-	g_fenceEvent = CreateEventEx(nullptr,FALSE,FALSE,EVENT_ALL_ACCESS);
-	if(g_fenceEvent == nullptr)
-	{
-		if(FAILED(HRESULT_FROM_WIN32(GetLastError())))
-		{
-			return false;
-		}
-	}
 
 	return true;
 }
@@ -798,12 +1526,13 @@ bool CreateSwapChain(HWND hwnd)
 {
 	//Xbv`FC쐬
 	DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
-	swapChainDesc.BufferCount = FRAME_COUNT;
+	swapChainDesc.BufferCount = g_backBufferCount;
 	swapChainDesc.Width = 1280;
 	swapChainDesc.Height = 720;
 	swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+	swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 	swapChainDesc.SampleDesc.Count = 1;
 
 	ComPtr<IDXGISwapChain1> swapChain;
@@ -825,7 +1554,15 @@ bool CreateSwapChain(HWND hwnd)
 	{
 		return false;
 	}
-	g_frameIndex = g_swapChain->GetCurrentBackBufferIndex();
+	g_frameIndex = 0;
+	g_backBufferIndex = g_swapChain->GetCurrentBackBufferIndex();
+
+	//\҂̃t[𐧌
+	if(FAILED(g_swapChain->SetMaximumFrameLatency(g_frameLatency)))
+	{
+		return false;
+	}
+	g_frameLatencyWaitableObject = g_swapChain->GetFrameLatencyWaitableObject();
 
 	return true;
 }
@@ -835,7 +1572,7 @@ bool CreateRenderTarget()
 {
 	//_[^[Qbgr[p̋Lqqq[v쐬
 	D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-	rtvHeapDesc.NumDescriptors = FRAME_COUNT;
+	rtvHeapDesc.NumDescriptors = g_backBufferCount;
 	rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
 	rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 	if(FAILED(g_device->CreateDescriptorHeap(&rtvHeapDesc,IID_PPV_ARGS(&g_rtvHeap))))
@@ -848,7 +1585,7 @@ bool CreateRenderTarget()
 
 	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = g_rtvHeap->GetCPUDescriptorHandleForHeapStart();
 	//et[̃_[^[Qbgr[쐬
-	for(UINT n = 0;n < FRAME_COUNT;n++)
+	for(UINT n = 0;n < g_backBufferCount;n++)
 	{
 		if(FAILED(g_swapChain->GetBuffer(n,IID_PPV_ARGS(&g_renderTarget[n]))))
 		{
@@ -866,7 +1603,7 @@ bool CreateDepthStencilBuffer()
 {
 	//[xXeVr[p̋Lqqq[v쐬
 	D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
-	dsvHeapDesc.NumDescriptors = FRAME_COUNT;
+	dsvHeapDesc.NumDescriptors = 1;
 	dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
 	dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 	if(FAILED(g_device->CreateDescriptorHeap(&dsvHeapDesc,IID_PPV_ARGS(&g_dsvHeap))))
@@ -877,14 +1614,6 @@ bool CreateDepthStencilBuffer()
 	//[xXeVr[r[̋LqqTCY擾
 	g_dsvDescriptorSize = g_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
 
-	//q[vvpeB̐ݒ
-	D3D12_HEAP_PROPERTIES heapProperties;
-	heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
-	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-	heapProperties.CreationNodeMask = 1;
-	heapProperties.VisibleNodeMask = 1;
-
 	//\[X̐ݒ
 	D3D12_RESOURCE_DESC resourceDesc;
 	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
@@ -892,7 +1621,7 @@ bool CreateDepthStencilBuffer()
 	resourceDesc.Width = 1280;
 	resourceDesc.Height = 720;
 	resourceDesc.DepthOrArraySize = 1;
-	resourceDesc.MipLevels = 0;
+	resourceDesc.MipLevels = 1;
 	resourceDesc.Format = DXGI_FORMAT_D32_FLOAT;
 	resourceDesc.SampleDesc.Count = 1;
 	resourceDesc.SampleDesc.Quality = 0;
@@ -905,29 +1634,21 @@ bool CreateDepthStencilBuffer()
 	clearValue.DepthStencil.Depth = 1.0f;
 	clearValue.DepthStencil.Stencil = 0;
 
-	//\[X̍쐬
-	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
-		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_DEPTH_WRITE,
-		&clearValue,IID_PPV_ARGS(&g_depthStencil))))
+	//[xobt@̓t[ŎĝŃ_[Oẗꎞ\[Xɂ
+	//(̂ƃr[CreateFrameGraphō쐬)
+	g_depthResource = CreateRenderGraphTexture(&g_frameGraph,"Depth",&resourceDesc,&clearValue);
+	if(g_depthResource == RENDER_GRAPH_INVALID)
 	{
 		return false;
 	}
 
-	//[xXeVr[̍쐬
-	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
-	dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
-	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-	dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
-
-	g_device->CreateDepthStencilView(g_depthStencil.Get(),&dsvDesc,g_dsvHeap->GetCPUDescriptorHandleForHeapStart());
-
 	return true;
 }
 
 //R}hL[ER}hAP[^̍쐬
 bool CreateCommandList()
 {
-	for(UINT n = 0;n < FRAME_COUNT;n++)
+	for(UINT n = 0;n < g_frameCount;n++)
 	{
 		//R}hAP[^[쐬
 		if(FAILED(g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,IID_PPV_ARGS(&g_commandAllocator[n]))))
@@ -955,53 +1676,38 @@ bool CreateCommandList()
 bool CreateRootSignature()
 {
 	//LqqW̐ݒ
-	D3D12_DESCRIPTOR_RANGE range[4];
-	range[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-	range[0].NumDescriptors = 1;
+	//b0,b1̓[gCBVAb2̓[g萔Őݒ肷̂ŋLqqW̓eNX`(t0)ƃ}eAe[u(t1)̂
+	D3D12_DESCRIPTOR_RANGE range[1];
+	range[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	range[0].NumDescriptors = 2;
 	range[0].BaseShaderRegister = 0;
 	range[0].RegisterSpace = 0;
 	range[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
-	range[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-	range[1].NumDescriptors = 1;
-	range[1].BaseShaderRegister = 1;
-	range[1].RegisterSpace = 0;
-	range[1].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-	range[2].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-	range[2].NumDescriptors = 1;
-	range[2].BaseShaderRegister = 2;
-	range[2].RegisterSpace = 0;
-	range[2].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-	range[3].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-	range[3].NumDescriptors = 1;
-	range[3].BaseShaderRegister = 0;
-	range[3].RegisterSpace = 0;
-	range[3].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
 
 	//[gp[^̐ݒ
 	D3D12_ROOT_PARAMETER param[4];
-	param[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	param[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
 	param[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
-	param[0].DescriptorTable.NumDescriptorRanges = 1;
-	param[0].DescriptorTable.pDescriptorRanges = &range[0];
+	param[0].Descriptor.ShaderRegister = 0;
+	param[0].Descriptor.RegisterSpace = 0;
 
-	param[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	param[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
 	param[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-	param[1].DescriptorTable.NumDescriptorRanges = 1;
-	param[1].DescriptorTable.pDescriptorRanges = &range[1];
+	param[1].Descriptor.ShaderRegister = 1;
+	param[1].Descriptor.RegisterSpace = 0;
 
-	param[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	//}eÃCfbNX
+	param[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
 	param[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-	param[2].DescriptorTable.NumDescriptorRanges = 1;
-	param[2].DescriptorTable.pDescriptorRanges = &range[2];
+	param[2].Constants.ShaderRegister = 2;
+	param[2].Constants.RegisterSpace = 0;
+	param[2].Constants.Num32BitValues = 1;
 
 	param[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
 	param[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 	param[3].DescriptorTable.NumDescriptorRanges = 1;
-	param[3].DescriptorTable.pDescriptorRanges = &range[3];
+	param[3].DescriptorTable.pDescriptorRanges = &range[0];
 
 	//Tv[̐ݒ
 	D3D12_STATIC_SAMPLER_DESC sampler = {};
@@ -1043,6 +1749,7 @@ bool CreateRootSignature()
 	{
 		return false;
 	}
+	g_rootSignatureKey = HashBytes(signature->GetBufferPointer(),signature->GetBufferSize(),HASH_SEED);
 
 	return true;
 }
@@ -1058,35 +1765,70 @@ bool CompileShader()
 //pCvC̏ԃIuWFNg쐬
 bool CreatePipelineStateObject()
 {
-	//VF[_[̃RpC
-	ComPtr<ID3DBlob> vertexShader;
-	ComPtr<ID3DBlob> pixelShader;
+	LARGE_INTEGER beginTime;
+	QueryPerformanceCounter(&beginTime);
 
+	//Kvȑgݍ킹ɑSW߁AVF[_[̃RpCƃpCvC̍쐬Xbhōs
+	//VF[_[̓LbVɂ΂g
+	PipelineBuild build;
 #if defined(_DEBUG)
-	UINT compileFlag = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;;
+	build.compileFlag = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;;
 #else
-	UINT compileFlag = 0;
+	build.compileFlag = 0;
 #endif
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlag, 0, &vertexShader, nullptr) ) )
+	for(UINT n = 0;n < PIPELINE_PERMUTATION_COUNT;n++)
 	{
-		return false;
+		AddPipelineJob(&build,n);
 	}
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlag, 0, &pixelShader, nullptr) ) )
+	if(!RunPipelineBuild(&build))
 	{
 		return false;
 	}
+	for(const PipelineJob& job : build.pipeline)
+	{
+		g_permutationPipelineState[job.permutation] = job.pipelineState;
+	}
+	g_pipelineState = g_permutationPipelineState[g_wireframe ? PIPELINE_WIREFRAME : PIPELINE_OPAQUE];
+
+	LARGE_INTEGER endTime;
+	QueryPerformanceCounter(&endTime);
+	g_shaderCacheCounter.ticks += endTime.QuadPart - beginTime.QuadPart;
+
+	OutputPipelineBuildStatistics(&build);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	char message[256];
+	sprintf_s(message,"shader cache: shader hit %u miss %u, pipeline hit %ld miss %ld, %.3f ms\n",
+		g_shaderCache.shaderHit.load(),g_shaderCache.shaderMiss.load(),
+		g_shaderCacheCounter.pipelineHit,g_shaderCacheCounter.pipelineMiss,
+		g_shaderCacheCounter.ticks * 1000.0 / frequency.QuadPart);
+	OutputDebugStringA(message);
 
+	return true;
+}
+
+//gݍ킹ɍ킹ăpCvC̏ԃIuWFNg쐬
+//rh̃XbhĂ΂
+bool CreatePermutationPipelineState( const PipelinePermutation& permutation, const vector<UINT8>& vertexShader, UINT64 vertexShaderKey,
+	const vector<UINT8>& pixelShader, UINT64 pixelShaderKey, ComPtr<ID3D12PipelineState>* pPipelineState )
+{
 	//_̓C[`
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
 	{
 		{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		//CX^XƂ̃[hs(Xbg1)
+		{"WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{"WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{"WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{"WORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
 	};
 
 	//X^CU[Xe[g̐ݒ
 	D3D12_RASTERIZER_DESC rasterrizerStateDesc;
-	rasterrizerStateDesc.FillMode = D3D12_FILL_MODE_SOLID;
+	rasterrizerStateDesc.FillMode = permutation.fillMode;
 	rasterrizerStateDesc.CullMode = D3D12_CULL_MODE_BACK;
 	rasterrizerStateDesc.FrontCounterClockwise = FALSE;
 	rasterrizerStateDesc.DepthBias = D3D12_DEFAULT_DEPTH_BIAS;
@@ -1109,7 +1851,7 @@ bool CreatePipelineStateObject()
 	};
 
 	//uhXe[g̐ݒ
-	D3D12_BLEND_DESC blendStateDesc;
+	D3D12_BLEND_DESC blendStateDesc = {};
 	blendStateDesc.AlphaToCoverageEnable = FALSE;
 	blendStateDesc.IndependentBlendEnable = FALSE;
 	for(UINT i = 0;i<D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT;i++)
@@ -1120,10 +1862,10 @@ bool CreatePipelineStateObject()
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
 	psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
 	psoDesc.pRootSignature = g_rootSignature.Get();
-	psoDesc.VS.pShaderBytecode = vertexShader->GetBufferPointer();
-	psoDesc.VS.BytecodeLength = vertexShader->GetBufferSize();
-	psoDesc.PS.pShaderBytecode = pixelShader->GetBufferPointer();
-	psoDesc.PS.BytecodeLength = pixelShader->GetBufferSize();
+	psoDesc.VS.pShaderBytecode = vertexShader.data();
+	psoDesc.VS.BytecodeLength = vertexShader.size();
+	psoDesc.PS.pShaderBytecode = pixelShader.data();
+	psoDesc.PS.BytecodeLength = pixelShader.size();
 	psoDesc.RasterizerState = rasterrizerStateDesc;
 	psoDesc.BlendState = blendStateDesc;
 	psoDesc.DepthStencilState.DepthEnable = TRUE;
@@ -1136,12 +1878,7 @@ bool CreatePipelineStateObject()
 	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
 	psoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
 	psoDesc.SampleDesc.Count = 1;
-	if(FAILED(g_device->CreateGraphicsPipelineState(&psoDesc,IID_PPV_ARGS(&g_pipelineState))))
-	{
-		return false;
-	}
-
-	return true;
+	return CreateCachedPipelineState(&psoDesc,HashPipelineStateDesc(&psoDesc,g_rootSignatureKey,vertexShaderKey,pixelShaderKey),pPipelineState);
 }
 
 //_obt@̍쐬
@@ -1202,262 +1939,91 @@ bool CreateVertexBuffer()
 	};*/
 
 
-	//ifstream file("boxMaterial.gmb",ios::binary);
-	//ifstream file("SD_unitychan_humanoid.gmb",ios::binary);
-	ifstream file("boxMaterial.gmb",ios::binary);
-
-	if(!file.is_open())
+	if(!LoadModel("boxMaterial.gmb"))
 	{
 		return false;
 	}
 
-	file.read(reinterpret_cast<char*>(&g_mesh.vertexCount),sizeof(int));
-	file.read(reinterpret_cast<char*>(&g_mesh.indexCount),sizeof(int));
-	file.read(reinterpret_cast<char*>(&g_mesh.subsetCount),sizeof(int));
-	file.read(reinterpret_cast<char*>(&g_mesh.materialCount),sizeof(int));
-
-	g_mesh.vertecies = new Vertex[g_mesh.vertexCount];
-	g_mesh.indexArray = new int[g_mesh.indexCount];
-	g_mesh.subset = new Subset[g_mesh.subsetCount];
-	
-
-	file.read(reinterpret_cast<char*>(g_mesh.vertecies),sizeof(Vertex) * g_mesh.vertexCount);
-	file.read(reinterpret_cast<char*>(g_mesh.indexArray),sizeof(int) * g_mesh.indexCount);
-	file.read(reinterpret_cast<char*>(g_mesh.subset),sizeof(Subset) * g_mesh.subsetCount);
+	const UINT vertexBufferSize = sizeof(Vertex) * g_mesh.vertexCount;
 
-	g_mesh.material = nullptr;
-	if(g_mesh.materialCount > 0)
+	//Abv[hq[ṽv[؂o(}bvς)
+	if(!AllocateBuffer(&g_uploadBufferPool,vertexBufferSize,sizeof(float),&g_vertexBuffer))
 	{
-		g_mesh.material = new Material[g_mesh.materialCount];
-		g_mesh.textureName = new string[g_mesh.materialCount];
-		for(int i = 0;i < g_mesh.materialCount;i++)
-		{
-			file.read(reinterpret_cast<char*>(g_mesh.material[i].diffuse),sizeof(float) * 3);
-			file.read(reinterpret_cast<char*>(&g_mesh.material[i].alpha),sizeof(float));
-			file.read(reinterpret_cast<char*>(g_mesh.material[i].ambient),sizeof(float) * 3);
-			file.read(reinterpret_cast<char*>(g_mesh.material[i].specular),sizeof(float) * 3);
-			file.read(reinterpret_cast<char*>(&g_mesh.material[i].power),sizeof(float));
-			file.read(reinterpret_cast<char*>(g_mesh.material[i].emmisive),sizeof(float) * 3);
+		return false;
+	}
+	//_f[^Rs[
+	memcpy(g_vertexBuffer.pCpuAddress,g_mesh.vertecies,vertexBufferSize);
+
+	//_obt@r[̐ݒ
+	g_vertexBufferView.BufferLocation = g_vertexBuffer.gpuAddress;
+	g_vertexBufferView.StrideInBytes = sizeof(Vertex);
+	g_vertexBufferView.SizeInBytes = vertexBufferSize;
 
 
-			int nameLength;
-			file.read(reinterpret_cast<char*>(&nameLength),sizeof(int));
 
-			char* textureName = new char[nameLength];
-			file.read(textureName,nameLength);
-			g_mesh.textureName[i] = textureName;
+	const UINT indexBufferSize = sizeof(int) * g_mesh.indexCount;
 
-			//Todo:eNX`ǂݍ݁H
-		}
+	if(!AllocateBuffer(&g_uploadBufferPool,indexBufferSize,sizeof(int),&g_indexBuffer))
+	{
+		return false;
 	}
+	//CfbNXf[^Rs[
+	memcpy(g_indexBuffer.pCpuAddress,g_mesh.indexArray,indexBufferSize);
 
-	file.close();
+	//CfbNXobt@r[̐ݒ
+	g_indexBufferView.BufferLocation = g_indexBuffer.gpuAddress;
+	g_indexBufferView.SizeInBytes = indexBufferSize;
+	g_indexBufferView.Format = DXGI_FORMAT_R32_UINT;
 
-	const UINT vertexBufferSize = sizeof(Vertex) * g_mesh.vertexCount;
+	return true;
+}
 
-	//q[vvpeB̐ݒ
-	D3D12_HEAP_PROPERTIES heapProperties = {};
-	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
-	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-	heapProperties.CreationNodeMask = 1;
-	heapProperties.VisibleNodeMask = 1;
-
-	//\[X̐ݒ
-	D3D12_RESOURCE_DESC resourceDesc = {};
-	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	resourceDesc.Alignment = 0;
-	resourceDesc.Width = vertexBufferSize;
-	resourceDesc.Height = 1;
-	resourceDesc.DepthOrArraySize = 1;
-	resourceDesc.MipLevels = 1;
-	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-	resourceDesc.SampleDesc.Count = 1;
-	resourceDesc.SampleDesc.Quality = 0;
-	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
-		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,IID_PPV_ARGS(&g_vertexBuffer))))
-	{
-		return false;
-	}
-
-	//}bv
-	UINT8* pVertexDataBegin;
-	D3D12_RANGE readRange = {0,0};
-	if(FAILED(g_vertexBuffer->Map(0,&readRange,
-		reinterpret_cast<void**>(&pVertexDataBegin))))
+bool CreateCbvSrv()
+{
+	//VF[_[\[Xr[p̋Lqqq[v쐬
+	if(!CreateGpuDescriptorHeap(&g_stagingDescriptorHeap,D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,PERSISTENT_DESCRIPTOR_COUNT,false))
 	{
 		return false;
 	}
-	//_f[^Rs[
-	memcpy(pVertexDataBegin,g_mesh.vertecies, vertexBufferSize );
-	//A}bv
-	g_vertexBuffer->Unmap( 0, nullptr );
-
-	//_obt@r[̐ݒ
-	g_vertexBufferView.BufferLocation = g_vertexBuffer->GetGPUVirtualAddress();
-	g_vertexBufferView.StrideInBytes = sizeof(Vertex);
-	g_vertexBufferView.SizeInBytes = vertexBufferSize;
-
-
-
-	const UINT indexBufferSize = sizeof(int) * g_mesh.indexCount;
-
-	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
-		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,IID_PPV_ARGS(&g_indexBuffer))))
+	InitDescriptorFreeList(&g_persistentDescriptors,PERSISTENT_DESCRIPTOR_COUNT);
+	if(!CreateGpuDescriptorHeap(&g_descriptorHeap,D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,TRANSIENT_DESCRIPTOR_COUNT,true))
 	{
 		return false;
 	}
+	InitDescriptorRing(&g_descriptorRing,0,TRANSIENT_DESCRIPTOR_COUNT);
 
-	//}bv
-	UINT8* pIndexDataBegin;
-	if(FAILED(g_indexBuffer->Map(0,&readRange,
-		reinterpret_cast<void**>(&pIndexDataBegin))))
+	//eNX`ƃ}eAe[u1̃e[uɂ̂ŘA2蓖Ă
+	if(!AllocatePersistentDescriptors(&g_persistentDescriptors,2,&g_sceneTable))
 	{
 		return false;
 	}
-	//_f[^Rs[
-	memcpy(pIndexDataBegin,g_mesh.indexArray,indexBufferSize);
-	//A}bv
-	g_indexBuffer->Unmap( 0, nullptr );
-
-	//_obt@r[̐ݒ
-	g_indexBufferView.BufferLocation = g_indexBuffer->GetGPUVirtualAddress();
-	g_indexBufferView.SizeInBytes = indexBufferSize;
-	g_indexBufferView.Format = DXGI_FORMAT_R32_UINT;
-
-	return true;
-}
 
-bool CreateCbvSrv()
-{
-	//萔obt@AVF[_[\[Xr[p̋Lqqq[v쐬
-	{
-		D3D12_DESCRIPTOR_HEAP_DESC desc = {};
-		desc.NumDescriptors = 3 + g_mesh.materialCount;	//萔obt@ƃVF[_\[Xr[쐬̂2
-		desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-		desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-		if(FAILED(g_device->CreateDescriptorHeap(&desc,IID_PPV_ARGS(&g_cbvSrvHeap))))
-		{
-			return false;
-		}
-	}
-	//萔obt@쐬
+	//}eAe[u쐬
 	{
-		//q[vvpeB̐ݒ
-		D3D12_HEAP_PROPERTIES prop = {};
-		prop.Type = D3D12_HEAP_TYPE_UPLOAD;
-		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-		prop.CreationNodeMask = 1;
-		prop.VisibleNodeMask = 1;
-
-		D3D12_RESOURCE_DESC desc = {};
-		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		desc.Alignment = 0;
-		desc.Width = sizeof(ConstantBuffer);
-		desc.Height = 1;
-		desc.DepthOrArraySize = 1;
-		desc.MipLevels = 1;
-		desc.Format = DXGI_FORMAT_UNKNOWN;
-		desc.SampleDesc.Count = 1;
-		desc.SampleDesc.Quality = 0;
-		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-		//\[X쐬
-		if(FAILED(g_device->CreateCommittedResource(
-			&prop,D3D12_HEAP_FLAG_NONE,&desc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,IID_PPV_ARGS(&g_constantBuffer))))
-		{
-			return false;
-		}
-
-		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc = {};
-		cbvDesc.BufferLocation = g_constantBuffer->GetGPUVirtualAddress();
-		cbvDesc.SizeInBytes = sizeof(ConstantBuffer);
-
-		//萔obt@r[쐬
-		D3D12_CPU_DESCRIPTOR_HANDLE handle = g_cbvSrvHeap->GetCPUDescriptorHandleForHeapStart();
-		g_device->CreateConstantBufferView(&cbvDesc,handle);
-		g_cbvSrvDescriptorSize = g_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		handle.ptr += g_cbvSrvDescriptorSize;
-
-		D3D12_RANGE readRange = {0,0};
-		if( FAILED(g_constantBuffer->Map(0,&readRange,reinterpret_cast<void**>(&g_pCbvDataBegin) )))
-		{
-			return false;
-		}
-		//XMMATRIX proj = XMMatrixOrthographicLH(1280.0f,720.0f,10.0f,100000.0f);
-		g_constantBufferData.world = XMMatrixIdentity();
-		g_constantBufferData.view = XMMatrixLookAtLH({0.0f,0.0f,-0.5f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
-		g_constantBufferData.project = XMMatrixPerspectiveFovLH(0.78539816339744830961566084581988f,1280.0f/720.0f,1.0f,1000.0f);
-		memcpy(g_pCbvDataBegin,&g_constantBufferData,sizeof(g_constantBufferData));
-
-
-		// Cg
-		desc.Width = sizeof(LightBuffer);
-
-		//\[X쐬
-		if(FAILED(g_device->CreateCommittedResource(
-			&prop,D3D12_HEAP_FLAG_NONE,&desc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,IID_PPV_ARGS(&g_lightBuffer))))
-		{
-			return false;
-		}
-
-		cbvDesc.BufferLocation = g_lightBuffer->GetGPUVirtualAddress();
-		cbvDesc.SizeInBytes = sizeof(LightBuffer);
-
-		//萔obt@r[쐬
-		g_device->CreateConstantBufferView(&cbvDesc,handle);
-		handle.ptr += g_cbvSrvDescriptorSize;
-
-		readRange = {0,0};
-		if( FAILED(g_lightBuffer->Map(0,&readRange,reinterpret_cast<void**>(&g_pCbv2DataBegin) )))
-		{
-			return false;
-		}
-		g_lightBufferData.lightDirection = XMFLOAT3(0.0f,1.0f,1.0f);
-		memcpy(g_pCbv2DataBegin,&g_lightBufferData,sizeof(g_lightBufferData));
-
-		// Cg
-		desc.Width = sizeof(Material) * g_mesh.materialCount;
-
-		//\[X쐬
-		if(FAILED(g_device->CreateCommittedResource(
-			&prop,D3D12_HEAP_FLAG_NONE,&desc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,IID_PPV_ARGS(&g_materialBuffer))))
-		{
-			return false;
-		}
-
-		if( FAILED(g_materialBuffer->Map(0,nullptr,reinterpret_cast<void**>(&g_pCbv3DataBegin) )))
+		//256oCgɃpfBOl߂ĕׂ
+		//StructuredBuffer̐擪͗vfTCY̔{ɒuKv̂1vf]Ɋmۂ
+		const UINT64 tableSize = sizeof(Material) * g_mesh.materialCount;
+		if(!AllocateBuffer(&g_uploadBufferPool,tableSize + sizeof(Material),sizeof(float),&g_materialBuffer))
 		{
 			return false;
 		}
+		const UINT64 firstElement = (g_materialBuffer.offset + sizeof(Material) - 1) / sizeof(Material);
+		g_pMaterialDataBegin = g_materialBuffer.pCpuAddress + (firstElement * sizeof(Material) - g_materialBuffer.offset);
 
-		memcpy(g_pCbv3DataBegin,&g_mesh.material[0],sizeof(Material) * g_mesh.materialCount);
-
-		cbvDesc.BufferLocation = g_materialBuffer->GetGPUVirtualAddress();
-		cbvDesc.SizeInBytes = sizeof(Material);
-
-		for(int i = 0;i < g_mesh.materialCount;i++)
-		{
-			//萔obt@r[쐬
-			g_device->CreateConstantBufferView(&cbvDesc,handle);
-			handle.ptr += g_cbvSrvDescriptorSize;
-			cbvDesc.BufferLocation += sizeof(Material);
-		}
+		memcpy(g_pMaterialDataBegin,&g_mesh.material[0],tableSize);
 
-		
+		//StructuredBufferƂăVF[_[\[Xr[쐬(t1)
+		D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+		viewDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+		viewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+		viewDesc.Buffer.FirstElement = firstElement;
+		viewDesc.Buffer.NumElements = g_mesh.materialCount;
+		viewDesc.Buffer.StructureByteStride = sizeof(Material);
+		viewDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
+
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = GetDescriptorCpuHandle(&g_stagingDescriptorHeap,g_sceneTable.index + 1);
+		g_device->CreateShaderResourceView(g_uploadBufferPool.block[g_materialBuffer.blockIndex].buffer.Get(),&viewDesc,handle);
 	}
 
 	//VF[_[\[Xr[̍쐬
@@ -1479,16 +2045,8 @@ bool CreateCbvSrv()
 		
 		
 
-		D3D12_HEAP_PROPERTIES prop = {};
-		prop.Type = D3D12_HEAP_TYPE_DEFAULT;
-		prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-		prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-		prop.CreationNodeMask = 1;
-		prop.VisibleNodeMask = 1;
-
-		if(FAILED(g_device->CreateCommittedResource(&prop,
-			D3D12_HEAP_FLAG_NONE,&desc,D3D12_RESOURCE_STATE_COPY_DEST,
-			nullptr,IID_PPV_ARGS(&g_texture))))
+		//eNX`p̃q[vv[ɔzu
+		if(!CreatePlacedTexture(&g_texturePool,&desc,D3D12_RESOURCE_STATE_COPY_DEST,&g_texture,&g_textureAllocation))
 		{
 			return false;
 		}
@@ -1541,20 +2099,20 @@ bool CreateCbvSrv()
 		subResourceData.RowPitch = 256 * 4;
 		subResourceData.SlicePitch = subResourceData.RowPitch * 256;
 
-		UpdateSubresources(g_commandList.Get(),
-			g_texture.Get(),
-			textureUploadHeap.Get(), 0, 0, 1, &subResourceData);
-
-		D3D12_RESOURCE_BARRIER barrier = {};
-		barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-		barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-		barrier.Transition.pResource = g_texture.Get();
-		barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-		barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-		barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-
-
-		g_commandList->ResourceBarrier(1, &barrier);
+		//Rs[VF[_[\[Xւ̑Jڂ̓_[OtɔC
+		GpuRenderGraph uploadGraph = {};
+		const UINT textureResource = ImportRenderGraphResource(&uploadGraph,"Texture",g_texture.Get(),
+			D3D12_RESOURCE_STATE_COPY_DEST,D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		const UINT uploadPass = AddGpuRenderGraphPass(&uploadGraph,"UploadTexture",[&](ID3D12GraphicsCommandList* pCommandList)
+		{
+			UpdateSubresources(pCommandList,
+				g_texture.Get(),
+				textureUploadHeap.Get(), 0, 0, 1, &subResourceData);
+		});
+		RenderGraphWrite(&uploadGraph.graph,uploadPass,textureResource,D3D12_RESOURCE_STATE_COPY_DEST);
+		CompileRenderGraph(&uploadGraph.graph);
+		ExecuteRenderGraph(&uploadGraph,g_commandList.Get());
+		FinishRenderGraph(&uploadGraph,g_commandList.Get());
 
 		//VF[_[\[Xr[̐ݒ
 		D3D12_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
@@ -1564,9 +2122,8 @@ bool CreateCbvSrv()
 		viewDesc.Texture2D.MipLevels = 1;
 		viewDesc.Texture2D.MostDetailedMip = 0;
 
-		//VF[_[\[Xr[̍쐬
-		D3D12_CPU_DESCRIPTOR_HANDLE handle = g_cbvSrvHeap->GetCPUDescriptorHandleForHeapStart();
-		handle.ptr += g_cbvSrvDescriptorSize * 5;
+		//VF[_[\[Xr[̍쐬(t0)
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = GetDescriptorCpuHandle(&g_stagingDescriptorHeap,g_sceneTable.index);
 		g_device->CreateShaderResourceView(g_texture.Get(),&viewDesc,handle);
 
 		
@@ -1598,29 +2155,16 @@ bool CreateCbvSrv()
 	ID3D12CommandList* ppCommandLists[] = { g_commandList.Get() };
 	g_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
-	// Create synchronization objects and wait until assets have been uploaded to the GPU.
-	{
-		if(FAILED(g_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&g_fence))))
-		{
-			return false;
-		}
-		g_fenceValue[g_frameIndex] = 1;
-
-		// Create an event handle to use for frame synchronization.
-		g_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-		if (g_fenceEvent == nullptr)
-		{
-			if(FAILED(HRESULT_FROM_WIN32(GetLastError())))
-			{
-				return false;
-			}
-		}
+	//Abv[hp̃obt@GPURs[I
+	RetireAfter(&g_timeline,g_timeline.nextValue,[textureUploadHeap](){});
 
-		// Wait for the command list to execute; we are reusing the same command 
-		// list in our main loop but for now, we just want to wait for setup to 
-		// complete before continuing.
-		//WaitForPreviousFrame();
-		WaitForGpu();
+	// Wait for the command list to execute; we are reusing the same command 
+	// list in our main loop but for now, we just want to wait for setup to 
+	// complete before continuing.
+	//WaitForPreviousFrame();
+	if(!WaitForGpu())
+	{
+		return false;
 	}
 
 	return true;
@@ -1722,3 +2266,2801 @@ std::vector<UINT8> LoadTexture( const char* fileName )
 	return data;
 }
 
+//t[Ƃ̒萔obt@쐬
+bool CreateFrameConstantBuffer()
+{
+	//q[vvpeB̐ݒ
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type = D3D12_HEAP_TYPE_UPLOAD;
+	prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask = 1;
+	prop.VisibleNodeMask = 1;
+
+	//St[̗̈܂Ƃ߂1̃obt@ƂĊm
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment = 0;
+	desc.Width = static_cast<UINT64>(FRAME_CONSTANT_BUFFER_SIZE) * g_frameCount;
+	desc.Height = 1;
+	desc.DepthOrArraySize = 1;
+	desc.MipLevels = 1;
+	desc.Format = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	if(FAILED(g_device->CreateCommittedResource(
+		&prop,D3D12_HEAP_FLAG_NONE,&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,IID_PPV_ARGS(&g_frameConstantBuffer))))
+	{
+		return false;
+	}
+
+	//Abv[hq[vȂ̂Ń}bv܂܂ɂĂ
+	D3D12_RANGE readRange = {0,0};
+	if(FAILED(g_frameConstantBuffer->Map(0,&readRange,reinterpret_cast<void**>(&g_pFrameConstantDataBegin))))
+	{
+		return false;
+	}
+	g_frameConstantOffset = 0;
+	g_frameConstantPersistentSize = 0;
+
+	return true;
+}
+
+//݂̃t[̗̈悩萔obt@蓖Ăăf[^
+bool AllocateFrameConstant( const void* pData, UINT size, D3D12_GPU_VIRTUAL_ADDRESS* pGpuAddress )
+{
+	//萔obt@r[256oCgEɒuKv
+	const UINT64 alignedSize = (static_cast<UINT64>(size) + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) &
+		~static_cast<UINT64>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+	if(g_frameConstantOffset + alignedSize > FRAME_CONSTANT_BUFFER_SIZE)
+	{
+		return false;
+	}
+
+	const UINT64 offset = static_cast<UINT64>(FRAME_CONSTANT_BUFFER_SIZE) * g_frameIndex + g_frameConstantOffset;
+	memcpy(g_pFrameConstantDataBegin + offset,pData,size);
+	*pGpuAddress = g_frameConstantBuffer->GetGPUVirtualAddress() + offset;
+	g_frameConstantOffset += alignedSize;
+
+	return true;
+}
+
+//et[̗̈ConstantBlock̏풓̈mۂ
+//t[Ƃ̊蓖Ăn܂O()ɌĂԂ
+bool CreateConstantBlock( ConstantBlock* pBlock, void* pShadow, UINT size )
+{
+	if(size > CONSTANT_BLOCK_MAX_SIZE)
+	{
+		return false;
+	}
+
+	const UINT64 alignedSize = (static_cast<UINT64>(size) + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) &
+		~static_cast<UINT64>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+	if(g_frameConstantPersistentSize + alignedSize > FRAME_CONSTANT_BUFFER_SIZE)
+	{
+		return false;
+	}
+
+	pBlock->pShadow = reinterpret_cast<UINT8*>(pShadow);
+	pBlock->size = size;
+	pBlock->offset = g_frameConstantPersistentSize;
+	g_frameConstantPersistentSize += alignedSize;
+	g_frameConstantOffset = g_frameConstantPersistentSize;
+
+	//ŏ͑St[̑S͈͂
+	const UINT rowCount = (size + CONSTANT_BLOCK_ROW_SIZE - 1) / CONSTANT_BLOCK_ROW_SIZE;
+	const UINT64 allRows = (rowCount == 64) ? ~0ULL : ((1ULL << rowCount) - 1);
+	for(UINT n = 0;n < g_frameCount;n++)
+	{
+		pBlock->dirtyMask[n] = allRows;
+	}
+
+	return true;
+}
+
+//lςƂY16oCg̍sSt[_[eBɂ
+void SetConstantBlockData( ConstantBlock* pBlock, UINT offset, const void* pData, UINT size )
+{
+	if(memcmp(pBlock->pShadow + offset,pData,size) == 0)
+	{
+		return;
+	}
+	memcpy(pBlock->pShadow + offset,pData,size);
+
+	const UINT firstRow = offset / CONSTANT_BLOCK_ROW_SIZE;
+	const UINT lastRow = (offset + size - 1) / CONSTANT_BLOCK_ROW_SIZE;
+	UINT64 rows = 0;
+	for(UINT row = firstRow;row <= lastRow;row++)
+	{
+		rows |= 1ULL << row;
+	}
+	for(UINT n = 0;n < g_frameCount;n++)
+	{
+		pBlock->dirtyMask[n] |= rows;
+	}
+}
+
+//݂̃t[̗̈ɖf̍s
+void UploadConstantBlock( ConstantBlock* pBlock, D3D12_GPU_VIRTUAL_ADDRESS* pGpuAddress )
+{
+	const UINT64 frameOffset = static_cast<UINT64>(FRAME_CONSTANT_BUFFER_SIZE) * g_frameIndex + pBlock->offset;
+	UINT64 mask = pBlock->dirtyMask[g_frameIndex];
+	UINT row = 0;
+	while(mask != 0)
+	{
+		//A_[eBȍs͂܂Ƃ߂1ŃRs[
+		while((mask & 1) == 0)
+		{
+			mask >>= 1;
+			row++;
+		}
+		UINT firstRow = row;
+		while((mask & 1) != 0)
+		{
+			mask >>= 1;
+			row++;
+		}
+		const UINT begin = firstRow * CONSTANT_BLOCK_ROW_SIZE;
+		const UINT end = min(row * CONSTANT_BLOCK_ROW_SIZE,pBlock->size);
+		memcpy(g_pFrameConstantDataBegin + frameOffset + begin,pBlock->pShadow + begin,end - begin);
+		g_constantUploadCounter.uploadBytes += end - begin;
+	}
+	pBlock->dirtyMask[g_frameIndex] = 0;
+
+	*pGpuAddress = g_frameConstantBuffer->GetGPUVirtualAddress() + frameOffset;
+}
+
+//q[vv[̏(q[v͕KvɂȂƂɍ쐬)
+void InitHeapPool( HeapPool* pPool, D3D12_HEAP_TYPE type, D3D12_HEAP_FLAGS flags, UINT64 blockSize, UINT64 minBlockSize )
+{
+	pPool->type = type;
+	pPool->flags = flags;
+	pPool->blockSize = blockSize;
+	pPool->minBlockSize = minBlockSize;
+	pPool->block.clear();
+}
+
+//sizeoCgȏ̃q[vv[ɒǉ
+bool AddHeapBlock( HeapPool* pPool, UINT64 size )
+{
+	//ofBAP[^ŊǗ̂2ׂ̂ɐ؂グ
+	UINT64 blockSize = pPool->blockSize;
+	while(blockSize < size)
+	{
+		blockSize *= 2;
+	}
+
+	HeapBlock block = {};
+
+	D3D12_HEAP_DESC heapDesc = {};
+	heapDesc.SizeInBytes = blockSize;
+	heapDesc.Properties.Type = pPool->type;
+	heapDesc.Properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapDesc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapDesc.Properties.CreationNodeMask = 1;
+	heapDesc.Properties.VisibleNodeMask = 1;
+	heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	heapDesc.Flags = pPool->flags;
+	if(FAILED(g_device->CreateHeap(&heapDesc,IID_PPV_ARGS(&block.heap))))
+	{
+		return false;
+	}
+
+	//obt@pȂq[vŜ𕢂obt@쐬
+	if(pPool->flags & D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS)
+	{
+		D3D12_RESOURCE_DESC desc = {};
+		desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		desc.Alignment = 0;
+		desc.Width = blockSize;
+		desc.Height = 1;
+		desc.DepthOrArraySize = 1;
+		desc.MipLevels = 1;
+		desc.Format = DXGI_FORMAT_UNKNOWN;
+		desc.SampleDesc.Count = 1;
+		desc.SampleDesc.Quality = 0;
+		desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+		const D3D12_RESOURCE_STATES state = (pPool->type == D3D12_HEAP_TYPE_UPLOAD) ?
+			D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON;
+		if(FAILED(g_device->CreatePlacedResource(block.heap.Get(),0,&desc,state,
+			nullptr,IID_PPV_ARGS(&block.buffer))))
+		{
+			return false;
+		}
+
+		//Abv[hq[vȂ}bv܂܂ɂ
+		block.pCpuAddress = nullptr;
+		if(pPool->type == D3D12_HEAP_TYPE_UPLOAD)
+		{
+			D3D12_RANGE readRange = {0,0};
+			if(FAILED(block.buffer->Map(0,&readRange,reinterpret_cast<void**>(&block.pCpuAddress))))
+			{
+				return false;
+			}
+		}
+	}
+
+	if(!InitBuddyAllocator(&block.allocator,blockSize,pPool->minBlockSize))
+	{
+		return false;
+	}
+
+	pPool->block.push_back(block);
+	return true;
+}
+
+//̃q[v犄蓖āA󂫂Ȃ΃q[vǉ
+bool AllocateFromHeapPool( HeapPool* pPool, UINT64 size, UINT64 alignment, UINT* pBlockIndex, UINT64* pOffset )
+{
+	for(UINT i = 0;i < pPool->block.size();i++)
+	{
+		if(BuddyAllocate(&pPool->block[i].allocator,size,alignment,pOffset))
+		{
+			*pBlockIndex = i;
+			return true;
+		}
+	}
+
+	if(!AddHeapBlock(pPool,max(size,alignment)))
+	{
+		return false;
+	}
+	*pBlockIndex = static_cast<UINT>(pPool->block.size() - 1);
+	return BuddyAllocate(&pPool->block.back().allocator,size,alignment,pOffset);
+}
+
+//obt@p̃v[obt@؂o
+bool AllocateBuffer( HeapPool* pPool, UINT64 size, UINT64 alignment, BufferAllocation* pAllocation )
+{
+	if(!AllocateFromHeapPool(pPool,size,alignment,&pAllocation->blockIndex,&pAllocation->offset))
+	{
+		return false;
+	}
+
+	const HeapBlock& block = pPool->block[pAllocation->blockIndex];
+	pAllocation->size = size;
+	pAllocation->gpuAddress = block.buffer->GetGPUVirtualAddress() + pAllocation->offset;
+	pAllocation->pCpuAddress = (block.pCpuAddress != nullptr) ? block.pCpuAddress + pAllocation->offset : nullptr;
+
+	return true;
+}
+
+//؂oobt@Ԃ(GPUgIĂĂԂ)
+void FreeBuffer( HeapPool* pPool, BufferAllocation* pAllocation )
+{
+	BuddyFree(&pPool->block[pAllocation->blockIndex].allocator,pAllocation->offset,pAllocation->size);
+	*pAllocation = {};
+}
+
+//eNX`p̃v[ɃeNX`zu
+bool CreatePlacedTexture( HeapPool* pPool, const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES initialState,
+	ComPtr<ID3D12Resource>* pResource, TextureAllocation* pAllocation )
+{
+	//eNX`4KBACŔzuł邩
+	D3D12_RESOURCE_DESC desc = *pDesc;
+	desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+	D3D12_RESOURCE_ALLOCATION_INFO info = g_device->GetResourceAllocationInfo(0,1,&desc);
+	if(info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+	{
+		desc.Alignment = 0;
+		info = g_device->GetResourceAllocationInfo(0,1,&desc);
+	}
+
+	if(!AllocateFromHeapPool(pPool,info.SizeInBytes,info.Alignment,&pAllocation->blockIndex,&pAllocation->offset))
+	{
+		return false;
+	}
+	pAllocation->size = info.SizeInBytes;
+
+	if(FAILED(g_device->CreatePlacedResource(pPool->block[pAllocation->blockIndex].heap.Get(),
+		pAllocation->offset,&desc,initialState,nullptr,IID_PPV_ARGS(pResource->ReleaseAndGetAddressOf()))))
+	{
+		FreeTexture(pPool,pAllocation);
+		return false;
+	}
+
+	return true;
+}
+
+//eNX`̗̈Ԃ(\[XĂĂԂ)
+void FreeTexture( HeapPool* pPool, TextureAllocation* pAllocation )
+{
+	BuddyFree(&pPool->block[pAllocation->blockIndex].allocator,pAllocation->offset,pAllocation->size);
+	*pAllocation = {};
+}
+
+//蓖ĂƒfЉ̓v擾
+void GetHeapPoolStatistics( const HeapPool* pPool, HeapPoolStatistics* pStatistics )
+{
+	*pStatistics = {};
+	UINT64 freeSize = 0;
+	for(UINT i = 0;i < pPool->block.size();i++)
+	{
+		const BuddyAllocator& allocator = pPool->block[i].allocator;
+		pStatistics->blockCount++;
+		pStatistics->allocationCount += allocator.allocationCount;
+		pStatistics->reservedSize += allocator.size;
+		pStatistics->usedSize += allocator.usedSize;
+		pStatistics->requestedSize += allocator.requestedSize;
+		freeSize += allocator.size - allocator.usedSize;
+		pStatistics->largestFreeSize = max(pStatistics->largestFreeSize,GetBuddyLargestFreeSize(&allocator));
+	}
+	pStatistics->fragmentation = (freeSize > 0) ?
+		1.0f - static_cast<float>(pStatistics->largestFreeSize) / static_cast<float>(freeSize) : 0.0f;
+}
+
+//vfobOo͂
+void OutputHeapPoolStatistics( const char* name, const HeapPool* pPool )
+{
+	HeapPoolStatistics statistics;
+	GetHeapPoolStatistics(pPool,&statistics);
+
+	char text[512];
+	sprintf_s(text,"%s: %u heaps, %u allocations, reserved %llu, used %llu, requested %llu, largest free %llu, fragmentation %.3f\n",
+		name,statistics.blockCount,statistics.allocationCount,statistics.reservedSize,statistics.usedSize,
+		statistics.requestedSize,statistics.largestFreeSize,statistics.fragmentation);
+	OutputDebugStringA(text);
+}
+
+//D3D12̃tFX̍쐬
+bool InitGpuFence( GpuFence* pFence )
+{
+	if(FAILED(g_device->CreateFence(0,D3D12_FENCE_FLAG_NONE,IID_PPV_ARGS(&pFence->fence))))
+	{
+		return false;
+	}
+
+	//tFXp̃Cxgnh쐬
+	pFence->event = CreateEventEx(nullptr,FALSE,FALSE,EVENT_ALL_ACCESS);
+	if(pFence->event == nullptr)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//L[valueSignalς
+bool SignalGpuFence( GpuFence* pFence, ID3D12CommandQueue* pQueue, UINT64 value )
+{
+	return SUCCEEDED(pQueue->Signal(pFence->fence.Get(),value));
+}
+
+//GPUvalue܂Őiނ̂҂
+bool WaitGpuFence( GpuFence* pFence, UINT64 value )
+{
+	if(pFence->fence->GetCompletedValue() < value)
+	{
+		if(FAILED(pFence->fence->SetEventOnCompletion(value,pFence->event)))
+		{
+			return false;
+		}
+		WaitForSingleObjectEx(pFence->event,INFINITE,FALSE);
+	}
+
+	return true;
+}
+
+//GPUl
+UINT64 GetGpuFenceCompletedValue( GpuFence* pFence )
+{
+	return pFence->fence->GetCompletedValue();
+}
+
+//Cxg
+void DestroyGpuFence( GpuFence* pFence )
+{
+	CloseHandle(pFence->event);
+	pFence->event = nullptr;
+}
+
+//R}hCt[y[VO̐ݒǂ
+void ParseCommandLine( const char* pCommandLine )
+{
+	const char* pOption = strstr(pCommandLine,"-frames ");
+	if(pOption != nullptr)
+	{
+		g_frameCount = static_cast<UINT>(atoi(pOption + strlen("-frames ")));
+	}
+	pOption = strstr(pCommandLine,"-latency ");
+	if(pOption != nullptr)
+	{
+		g_frameLatency = static_cast<UINT>(atoi(pOption + strlen("-latency ")));
+	}
+	pOption = strstr(pCommandLine,"-threads ");
+	if(pOption != nullptr)
+	{
+		g_recordThreadCount = static_cast<UINT>(atoi(pOption + strlen("-threads ")));
+		g_recordThreadCountSpecified = true;
+	}
+	if(strstr(pCommandLine,"-benchmark") != nullptr)
+	{
+		g_benchmark = true;
+	}
+	if(strstr(pCommandLine,"-wireframe") != nullptr)
+	{
+		g_wireframe = true;
+	}
+	if(strstr(pCommandLine,"-occlusion") != nullptr)
+	{
+		g_occlusionCulling = true;
+	}
+	pOption = strstr(pCommandLine,"-headless");
+	if(pOption != nullptr)
+	{
+		g_headless = true;
+		g_headlessFrameCount = static_cast<UINT>(atoi(pOption + strlen("-headless")));
+	}
+	pOption = strstr(pCommandLine,"-instances ");
+	if(pOption != nullptr)
+	{
+		g_instanceCount = min(static_cast<UINT>(atoi(pOption + strlen("-instances "))),MAX_INSTANCE_COUNT);
+	}
+	pOption = strstr(pCommandLine,"-vsync ");
+	if(pOption != nullptr)
+	{
+		g_syncInterval = static_cast<UINT>(atoi(pOption + strlen("-vsync ")));
+	}
+
+	g_frameCount = min(max(g_frameCount,1u),MAX_FRAME_COUNT);
+	g_frameLatency = min(max(g_frameLatency,1u),16u);
+	g_syncInterval = min(g_syncInterval,4u);
+
+	//tbvf̃Xbv`FC2ȏKv
+	g_backBufferCount = max(g_frameCount,2u);
+}
+
+//L^XbhƂ̃R}hXg쐬
+bool CreateRecordWorkers()
+{
+	//w肪Θ_RA-1(CXbh̕)
+	if(!g_recordThreadCountSpecified)
+	{
+		const UINT coreCount = thread::hardware_concurrency();
+		g_recordThreadCount = (coreCount > 1) ? coreCount - 1 : 0;
+	}
+	g_recordThreadCount = min(g_recordThreadCount,MAX_RECORD_THREAD_COUNT);
+
+	//CXbhŋL^Ƃ1ڂ̃Xgg
+	const UINT listCount = max(g_recordThreadCount,1u);
+	for(UINT n = 0;n < listCount;n++)
+	{
+		RecordWorker* pWorker = &g_recordWorker[n];
+		for(UINT frame = 0;frame < g_frameCount;frame++)
+		{
+			if(FAILED(g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,IID_PPV_ARGS(&pWorker->commandAllocator[frame]))))
+			{
+				return false;
+			}
+		}
+
+		if(FAILED(g_device->CreateCommandList(0,D3D12_COMMAND_LIST_TYPE_DIRECT,pWorker->commandAllocator[0].Get(),nullptr,IID_PPV_ARGS(&pWorker->commandList))))
+		{
+			return false;
+		}
+		if(FAILED(pWorker->commandList->Close()))
+		{
+			return false;
+		}
+	}
+
+	//`̃oAp̃R}hXg
+	if(FAILED(g_device->CreateCommandList(0,D3D12_COMMAND_LIST_TYPE_DIRECT,g_commandAllocator[0].Get(),nullptr,IID_PPV_ARGS(&g_postCommandList))))
+	{
+		return false;
+	}
+	if(FAILED(g_postCommandList->Close()))
+	{
+		return false;
+	}
+
+	//Wu̔ԍ̃Xbh̃XgɋL^
+	for(UINT n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+	{
+		g_pRecordCommandList[n] = &g_recordWorker[n];
+	}
+
+	//Xbh1Ȃ烁CXbhŋL^̂ōȂ
+	CreateRecordWorkerPool(&g_recordWorkers,g_recordThreadCount);
+	g_recordThreadCount = g_recordWorkers.threadCount;
+
+	return true;
+}
+
+//L^XbhI
+void DestroyRecordWorkers()
+{
+	DestroyRecordWorkerPool(&g_recordWorkers);
+}
+
+//̃t[̃R}hAP[^ŋL^n߂
+bool RecordWorker::Reset()
+{
+	ID3D12CommandAllocator* pAllocator = commandAllocator[g_frameIndex].Get();
+	if(FAILED(pAllocator->Reset()))
+	{
+		return false;
+	}
+	if(FAILED(commandList->Reset(pAllocator,g_pipelineState.Get())))
+	{
+		return false;
+	}
+	return true;
+}
+
+//`ɕKvȏԂSĐݒ肷
+void RecordWorker::SetState()
+{
+	//Ԃ̐ݒ̓bp[ŏȂ
+	CachedCommandList* pCache = &cache;
+	BeginCachedCommandList(pCache,commandList.Get());
+
+	//Kvȏݒ
+	CachedSetGraphicsRootSignature(pCache,g_rootSignature.Get());
+	CachedSetDescriptorHeap(pCache,g_descriptorHeap.heap.Get());
+
+	//萔obt@̓[gCBVƂGPUAhXŒڐݒ
+	CachedSetGraphicsRootConstantBufferView(pCache,0,g_constantBufferAddress);
+	CachedSetGraphicsRootConstantBufferView(pCache,1,g_lightBufferAddress);
+
+	//eNX`ƃ}eAe[u1̃e[uőS`拤
+	CachedSetGraphicsRootDescriptorTable(pCache,3,GetDescriptorGpuHandle(&g_descriptorHeap,g_frameSceneTable.index));
+
+	CachedRSSetViewport(pCache,g_viewport);
+	CachedRSSetScissorRect(pCache,g_scissorRect);
+
+	auto handleRTV = g_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+	auto handleDSV = g_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+	handleRTV.ptr += ( g_backBufferIndex * g_rtvDescriptorSize );
+	commandList->OMSetRenderTargets(1, &handleRTV, FALSE, &handleDSV);
+
+	CachedIASetPrimitiveTopology(pCache,D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	CachedIASetVertexBuffer(pCache,0,g_vertexBufferView);
+	CachedIASetVertexBuffer(pCache,1,g_instanceBufferView);
+	CachedIASetIndexBuffer(pCache,g_indexBufferView);
+}
+
+//S͈͂̕`L^
+void RecordWorker::RecordDraws( uint32_t workerIndex, const RecordJob& job )
+{
+	//S͈͂̕`̃t[̈obt@ɏ݁AExecuteIndirectŕ`
+	//}eÃ[g萔Ɋ܂߂B̈ʒu͕`L[̈ʒu猈܂̂ő̃XbhƏdȂȂ
+	const UINT batchCount = static_cast<UINT>(g_instanceBatch.size());
+	const UINT first = job.first * batchCount;
+	const UINT capacity = (first < MAX_INDIRECT_COMMAND_COUNT) ? min(job.count * batchCount,MAX_INDIRECT_COMMAND_COUNT - first) : 0;
+	const UINT64 frameOffset = INDIRECT_FRAME_SIZE * g_frameIndex;
+	const UINT64 argumentOffset = frameOffset + sizeof(IndirectCommand) * first;
+	const UINT64 countOffset = frameOffset + INDIRECT_COUNT_OFFSET + sizeof(UINT) * workerIndex;
+
+	IndirectCommand* pCommand = reinterpret_cast<IndirectCommand*>(g_pIndirectDataBegin + argumentOffset);
+	const UINT commandCount = BuildIndirectArguments(&g_drawQueue[job.first],job.count,g_mesh.subset,
+		g_instanceBatch.data(),batchCount,pCommand,capacity);
+	*reinterpret_cast<UINT*>(g_pIndirectDataBegin + countOffset) = commandCount;
+
+	if(commandCount > 0)
+	{
+		commandList->ExecuteIndirect(g_commandSignature.Get(),capacity,
+			g_indirectBuffer.Get(),argumentOffset,g_indirectBuffer.Get(),countOffset);
+	}
+}
+
+//L^I
+bool RecordWorker::Close()
+{
+	return SUCCEEDED(commandList->Close());
+}
+
+//Õ\[XOtɓo^
+//initialState̓t[Jn̏ԁAfinalState̓t[Iɖ߂
+UINT ImportRenderGraphResource( GpuRenderGraph* pGraph, const char* name, ID3D12Resource* pResource,
+	D3D12_RESOURCE_STATES initialState, D3D12_RESOURCE_STATES finalState )
+{
+	GpuRenderGraphResource resource = {};
+	resource.resource = pResource;
+	pGraph->resource.push_back(resource);
+	return AddRenderGraphImport(&pGraph->graph,name,initialState,finalState);
+}
+
+//OtŎgꎞeNX`o^(_[^[Qbg[xobt@̂)
+//̂CreateRenderGraphTransientső̈ꎞ\[Xƃq[vLč
+UINT CreateRenderGraphTexture( GpuRenderGraph* pGraph, const char* name, const D3D12_RESOURCE_DESC* pDesc, const D3D12_CLEAR_VALUE* pClearValue )
+{
+	if((pDesc->Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) == 0)
+	{
+		return RENDER_GRAPH_INVALID;
+	}
+
+	//v͂ŒׂĂARpC͒lg
+	const D3D12_RESOURCE_ALLOCATION_INFO info = g_device->GetResourceAllocationInfo(0,1,pDesc);
+	GpuRenderGraphResource resource = {};
+	resource.desc = *pDesc;
+	resource.hasClearValue = (pClearValue != nullptr);
+	if(pClearValue != nullptr)
+	{
+		resource.clearValue = *pClearValue;
+	}
+	pGraph->resource.push_back(resource);
+	return AddRenderGraphTransient(&pGraph->graph,name,info.SizeInBytes,info.Alignment);
+}
+
+//pXǉ(execute͋L^ɌĂ΂)
+UINT AddGpuRenderGraphPass( GpuRenderGraph* pGraph, const char* name, function<void(ID3D12GraphicsCommandList*)> execute )
+{
+	pGraph->execute.push_back(execute);
+	return AddRenderGraphPass(&pGraph->graph,name);
+}
+
+//ꎞ\[X̃q[vƔzu\[X쐬(RpCɌĂ)
+bool CreateRenderGraphTransients( GpuRenderGraph* pGraph )
+{
+	const RenderGraph* pCompiled = &pGraph->graph;
+	if(pCompiled->transientHeapSize == 0)
+	{
+		return true;
+	}
+
+	D3D12_HEAP_DESC heapDesc = {};
+	heapDesc.SizeInBytes = pCompiled->transientHeapSize;
+	heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+	heapDesc.Properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapDesc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapDesc.Properties.CreationNodeMask = 1;
+	heapDesc.Properties.VisibleNodeMask = 1;
+	heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+	if(FAILED(g_device->CreateHeap(&heapDesc,IID_PPV_ARGS(&pGraph->transientHeap))))
+	{
+		return false;
+	}
+
+	for(size_t n = 0;n < pCompiled->resource.size();n++)
+	{
+		const RenderGraphResource& compiled = pCompiled->resource[n];
+		if(compiled.imported || compiled.firstPass == RENDER_GRAPH_INVALID)
+		{
+			continue;
+		}
+		GpuRenderGraphResource& resource = pGraph->resource[n];
+		if(FAILED(g_device->CreatePlacedResource(pGraph->transientHeap.Get(),compiled.heapOffset,&resource.desc,
+			static_cast<D3D12_RESOURCE_STATES>(compiled.initialState),resource.hasClearValue ? &resource.clearValue : nullptr,IID_PPV_ARGS(&resource.resource))))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//O\[Xւ(obNobt@̓t[Ƃɕς)
+void SetRenderGraphResource( GpuRenderGraph* pGraph, UINT resource, ID3D12Resource* pResource )
+{
+	pGraph->resource[resource].resource = pResource;
+}
+
+//܂Ƃ߂oA1ResourceBarrierŔs
+void RecordRenderGraphBarriers( const GpuRenderGraph* pGraph, const vector<RenderGraphBarrier>& barrier, ID3D12GraphicsCommandList* pCommandList )
+{
+	if(barrier.empty())
+	{
+		return;
+	}
+
+	vector<D3D12_RESOURCE_BARRIER> resourceBarrier(barrier.size());
+	for(size_t n = 0;n < barrier.size();n++)
+	{
+		ID3D12Resource* pResource = pGraph->resource[barrier[n].resource].resource.Get();
+		resourceBarrier[n] = {};
+		resourceBarrier[n].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		if(barrier[n].aliasing)
+		{
+			resourceBarrier[n].Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			resourceBarrier[n].Aliasing.pResourceBefore = nullptr;
+			resourceBarrier[n].Aliasing.pResourceAfter = pResource;
+		}
+		else
+		{
+			resourceBarrier[n].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			resourceBarrier[n].Transition.pResource = pResource;
+			resourceBarrier[n].Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(barrier[n].before);
+			resourceBarrier[n].Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(barrier[n].after);
+			resourceBarrier[n].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		}
+	}
+	pCommandList->ResourceBarrier(static_cast<UINT>(resourceBarrier.size()),&resourceBarrier[0]);
+}
+
+//cpXoAƋɏɋL^
+void ExecuteRenderGraph( const GpuRenderGraph* pGraph, ID3D12GraphicsCommandList* pCommandList )
+{
+	for(size_t n = 0;n < pGraph->graph.pass.size();n++)
+	{
+		const RenderGraphPass& pass = pGraph->graph.pass[n];
+		if(pass.culled)
+		{
+			continue;
+		}
+		RecordRenderGraphBarriers(pGraph,pass.barrier,pCommandList);
+		if(pGraph->execute[n])
+		{
+			pGraph->execute[n](pCommandList);
+		}
+	}
+}
+
+//t[ĨoAL^
+void FinishRenderGraph( const GpuRenderGraph* pGraph, ID3D12GraphicsCommandList* pCommandList )
+{
+	RecordRenderGraphBarriers(pGraph,pGraph->graph.finalBarrier,pCommandList);
+}
+
+//RpCʂfobOo͂ɕ\
+void OutputRenderGraphStatistics( const char* name, const RenderGraph* pGraph )
+{
+	char text[256];
+	sprintf_s(text,"%s: passes %u (culled %u), barriers %u, transient heap %llu KB (without aliasing %llu KB)\n",
+		name,
+		static_cast<UINT>(pGraph->pass.size()),pGraph->culledPassCount,pGraph->barrierCount,
+		pGraph->transientHeapSize / 1024,pGraph->transientRequestedSize / 1024);
+	OutputDebugStringA(text);
+}
+
+//t[̃_[Ot쐬
+//obNobt@֐[xtŃV[`A\łԂɖ߂
+bool CreateFrameGraph()
+{
+	g_backBufferResource = ImportRenderGraphResource(&g_frameGraph,"BackBuffer",g_renderTarget[0].Get(),
+		D3D12_RESOURCE_STATE_PRESENT,D3D12_RESOURCE_STATE_PRESENT);
+
+	//V[pX(NAŋL^A`͋L^XbhċL^)
+	const UINT scenePass = AddGpuRenderGraphPass(&g_frameGraph,"Scene",[](ID3D12GraphicsCommandList* pCommandList)
+	{
+		auto handleRTV = g_rtvHeap->GetCPUDescriptorHandleForHeapStart();
+		auto handleDSV = g_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+		handleRTV.ptr += ( g_backBufferIndex * g_rtvDescriptorSize );
+
+		pCommandList->OMSetRenderTargets(1, &handleRTV, FALSE, &handleDSV);
+
+		//_[^[Qbgr[NA
+		const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+		pCommandList->ClearRenderTargetView( handleRTV, clearColor, 0, nullptr );
+
+		//[xXeVr[NA
+		pCommandList->ClearDepthStencilView(handleDSV,D3D12_CLEAR_FLAG_DEPTH,1.0f,0,0,nullptr);
+	});
+	RenderGraphWrite(&g_frameGraph.graph,scenePass,g_backBufferResource,D3D12_RESOURCE_STATE_RENDER_TARGET);
+	RenderGraphWrite(&g_frameGraph.graph,scenePass,g_depthResource,D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+	CompileRenderGraph(&g_frameGraph.graph);
+	if(!CreateRenderGraphTransients(&g_frameGraph))
+	{
+		return false;
+	}
+	OutputRenderGraphStatistics("frame graph",&g_frameGraph.graph);
+
+	//[xXeVr[̍쐬
+	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+	dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+	dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+
+	g_device->CreateDepthStencilView(g_frameGraph.resource[g_depthResource].resource.Get(),&dsvDesc,g_dsvHeap->GetCPUDescriptorHandleForHeapStart());
+
+	return true;
+}
+
+//Lqqq[v쐬
+bool CreateGpuDescriptorHeap( GpuDescriptorHeap* pHeap, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT descriptorCount, bool shaderVisible )
+{
+	D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+	desc.NumDescriptors = descriptorCount;
+	desc.Flags = shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	desc.Type = type;
+	if(FAILED(g_device->CreateDescriptorHeap(&desc,IID_PPV_ARGS(&pHeap->heap))))
+	{
+		return false;
+	}
+	pHeap->descriptorSize = g_device->GetDescriptorHandleIncrementSize(type);
+	pHeap->cpuStart = pHeap->heap->GetCPUDescriptorHandleForHeapStart();
+	pHeap->gpuStart = {};
+	if(shaderVisible)
+	{
+		pHeap->gpuStart = pHeap->heap->GetGPUDescriptorHandleForHeapStart();
+	}
+
+	return true;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorCpuHandle( const GpuDescriptorHeap* pHeap, UINT index )
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE handle = pHeap->cpuStart;
+	handle.ptr += static_cast<SIZE_T>(index) * pHeap->descriptorSize;
+	return handle;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE GetDescriptorGpuHandle( const GpuDescriptorHeap* pHeap, UINT index )
+{
+	D3D12_GPU_DESCRIPTOR_HANDLE handle = pHeap->gpuStart;
+	handle.ptr += static_cast<UINT64>(index) * pHeap->descriptorSize;
+	return handle;
+}
+
+//gr[͈̔͂Ãt[̃e[uƂăOɃRs[
+//O̕MoveToNextFrame()ŃtFX̒ltAGPUIԂ
+bool CopyFrameDescriptorTable( const DescriptorRange* pSource, DescriptorRange* pTable )
+{
+	if(!AllocateTransientDescriptors(&g_descriptorRing,pSource->count,pTable))
+	{
+		return false;
+	}
+	g_device->CopyDescriptorsSimple(pSource->count,
+		GetDescriptorCpuHandle(&g_descriptorHeap,pTable->index),
+		GetDescriptorCpuHandle(&g_stagingDescriptorHeap,pSource->index),
+		D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	return true;
+}
+
+//`L[
+//[x͐float̃rbg񂪂̂܂ܑ召ɂȂ̂ŁA̒l0ɂĎg(O珇)
+UINT64 MakeDrawKey( UINT pass, UINT pipeline, UINT material, float depth )
+{
+	UINT depthBits = 0;
+	if(depth > 0.0f)
+	{
+		memcpy(&depthBits,&depth,sizeof(depthBits));
+	}
+	return (static_cast<UINT64>(pass & 0xf) << DRAW_KEY_PASS_SHIFT) |
+		(static_cast<UINT64>(pipeline & 0xfff) << DRAW_KEY_PIPELINE_SHIFT) |
+		(static_cast<UINT64>(material & 0xffff) << DRAW_KEY_MATERIAL_SHIFT) |
+		depthBits;
+}
+
+//L[̉ʂ8rbgבւ(LSD\[gA)
+//Svfœľ͕בւȂ
+void RadixSortDrawItems( vector<DrawItem>* pItems, vector<DrawItem>* pTemp )
+{
+	const size_t count = pItems->size();
+	if(count < 2)
+	{
+		return;
+	}
+	pTemp->resize(count);
+
+	//SĂ̌̃qXgO1̑ō
+	UINT histogram[8][256] = {};
+	for(size_t n = 0;n < count;n++)
+	{
+		const UINT64 key = (*pItems)[n].key;
+		for(UINT digit = 0;digit < 8;digit++)
+		{
+			histogram[digit][(key >> (digit * 8)) & 0xff]++;
+		}
+	}
+
+	DrawItem* pSource = &(*pItems)[0];
+	DrawItem* pDest = &(*pTemp)[0];
+	for(UINT digit = 0;digit < 8;digit++)
+	{
+		UINT* pCount = histogram[digit];
+		const UINT shift = digit * 8;
+
+		//1̒lɑSvfW܂Ă錅͔΂
+		if(pCount[(pSource[0].key >> shift) & 0xff] == count)
+		{
+			continue;
+		}
+
+		UINT offset = 0;
+		for(UINT n = 0;n < 256;n++)
+		{
+			const UINT c = pCount[n];
+			pCount[n] = offset;
+			offset += c;
+		}
+		for(size_t n = 0;n < count;n++)
+		{
+			pDest[pCount[(pSource[n].key >> shift) & 0xff]++] = pSource[n];
+		}
+		swap(pSource,pDest);
+	}
+
+	//ւƂ͌ʂƗp̕ɂ
+	if(pSource != &(*pItems)[0])
+	{
+		pItems->swap(*pTemp);
+	}
+}
+
+//TuZbg̕`L[ĕׂ
+void BuildDrawQueue( FXMMATRIX worldView )
+{
+	g_drawQueue.clear();
+	for(int i = 0;i < g_mesh.subsetCount;i++)
+	{
+		if(!g_subsetVisible[i])
+		{
+			continue;
+		}
+		const XMVECTOR center = XMVector3TransformCoord(XMLoadFloat3(&g_subsetCenter[i]),worldView);
+		DrawItem item;
+		item.key = MakeDrawKey(0,0,g_mesh.subset[i].mat_index,XMVectorGetZ(center));
+		item.subset = i;
+		g_drawQueue.push_back(item);
+	}
+	RadixSortDrawItems(&g_drawQueue,&g_drawSortTemp);
+}
+
+//`L[̕בւ̑xv
+//L[̏ɕсAL[̕`͌̏(subset̏)ۂĂ邱Ƃm߂
+bool BenchmarkDrawSort( UINT drawCount )
+{
+	const UINT LOOP_COUNT = 20;
+
+	vector<DrawItem> source(drawCount);
+	vector<DrawItem> items;
+	vector<DrawItem> temp;
+	UINT seed = 12345;
+	for(UINT n = 0;n < drawCount;n++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		const UINT material = seed >> 20;
+		//[x1/16PʂɂāAL[̕`
+		seed = seed * 1664525 + 1013904223;
+		const float depth = ((seed >> 8) % 1600) / 16.0f;
+		source[n].key = MakeDrawKey(0,material & 0x3,material,depth);
+		source[n].subset = n;
+	}
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LONGLONG ticks = 0;
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		items = source;
+		LARGE_INTEGER begin;
+		QueryPerformanceCounter(&begin);
+		RadixSortDrawItems(&items,&temp);
+		LARGE_INTEGER end;
+		QueryPerformanceCounter(&end);
+		ticks += end.QuadPart - begin.QuadPart;
+	}
+
+	bool sorted = true;
+	bool stable = true;
+	UINT equalCount = 0;
+	for(UINT n = 1;n < drawCount;n++)
+	{
+		if(items[n - 1].key > items[n].key)
+		{
+			sorted = false;
+		}
+		else if(items[n - 1].key == items[n].key)
+		{
+			equalCount++;
+			if(items[n - 1].subset > items[n].subset)
+			{
+				stable = false;
+			}
+		}
+	}
+
+	char text[256];
+	sprintf_s(text,"Draw sort: %u draws, %.3f ms/sort, %u equal keys%s%s\n",drawCount,
+		1000.0 * ticks / frequency.QuadPart / LOOP_COUNT,equalCount,sorted ? "" : " (NOT SORTED)",stable ? "" : " (NOT STABLE)");
+	OutputDebugStringA(text);
+
+	//L[ƈ肩ǂm߂Ȃ
+	return sorted && stable && equalCount > 0;
+}
+
+//R}hXg̃ZbgɌĂŁALbV𖢐ݒɂ
+void BeginCachedCommandList( CachedCommandList* pCache, ID3D12GraphicsCommandList* pCommandList )
+{
+	const UINT64 issuedCount = pCache->issuedCount;
+	const UINT64 elidedCount = pCache->elidedCount;
+	*pCache = {};
+	pCache->pCommandList = pCommandList;
+	pCache->topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	pCache->issuedCount = issuedCount;
+	pCache->elidedCount = elidedCount;
+}
+
+//ԂȂtrueԂďȂ𐔂AႤȂ甭s鐔𐔂
+bool IsRedundantState( CachedCommandList* pCache, bool same )
+{
+	if(same)
+	{
+		pCache->elidedCount++;
+		return true;
+	}
+	pCache->issuedCount++;
+	return false;
+}
+
+void CachedSetGraphicsRootSignature( CachedCommandList* pCache, ID3D12RootSignature* pRootSignature )
+{
+	if(IsRedundantState(pCache,pCache->pRootSignature == pRootSignature))
+	{
+		return;
+	}
+	pCache->pCommandList->SetGraphicsRootSignature(pRootSignature);
+	pCache->pRootSignature = pRootSignature;
+
+	//[gVOl`ςƃ[g͑SĖɂȂ
+	pCache->rootArgumentValid = 0;
+}
+
+void CachedSetDescriptorHeap( CachedCommandList* pCache, ID3D12DescriptorHeap* pDescriptorHeap )
+{
+	if(IsRedundantState(pCache,pCache->pDescriptorHeap == pDescriptorHeap))
+	{
+		return;
+	}
+	ID3D12DescriptorHeap* ppHeap[] = {pDescriptorHeap};
+	pCache->pCommandList->SetDescriptorHeaps(_countof(ppHeap),ppHeap);
+	pCache->pDescriptorHeap = pDescriptorHeap;
+}
+
+void CachedRSSetViewport( CachedCommandList* pCache, const D3D12_VIEWPORT& viewport )
+{
+	if(IsRedundantState(pCache,pCache->viewportValid && memcmp(&pCache->viewport,&viewport,sizeof(viewport)) == 0))
+	{
+		return;
+	}
+	pCache->pCommandList->RSSetViewports(1,&viewport);
+	pCache->viewport = viewport;
+	pCache->viewportValid = true;
+}
+
+void CachedRSSetScissorRect( CachedCommandList* pCache, const D3D12_RECT& scissorRect )
+{
+	if(IsRedundantState(pCache,pCache->scissorRectValid && memcmp(&pCache->scissorRect,&scissorRect,sizeof(scissorRect)) == 0))
+	{
+		return;
+	}
+	pCache->pCommandList->RSSetScissorRects(1,&scissorRect);
+	pCache->scissorRect = scissorRect;
+	pCache->scissorRectValid = true;
+}
+
+void CachedIASetPrimitiveTopology( CachedCommandList* pCache, D3D12_PRIMITIVE_TOPOLOGY topology )
+{
+	if(IsRedundantState(pCache,pCache->topology == topology))
+	{
+		return;
+	}
+	pCache->pCommandList->IASetPrimitiveTopology(topology);
+	pCache->topology = topology;
+}
+
+void CachedIASetVertexBuffer( CachedCommandList* pCache, UINT slot, const D3D12_VERTEX_BUFFER_VIEW& view )
+{
+	if(IsRedundantState(pCache,pCache->vertexBufferValid[slot] && memcmp(&pCache->vertexBufferView[slot],&view,sizeof(view)) == 0))
+	{
+		return;
+	}
+	pCache->pCommandList->IASetVertexBuffers(slot,1,&view);
+	pCache->vertexBufferView[slot] = view;
+	pCache->vertexBufferValid[slot] = true;
+}
+
+void CachedIASetIndexBuffer( CachedCommandList* pCache, const D3D12_INDEX_BUFFER_VIEW& view )
+{
+	if(IsRedundantState(pCache,pCache->indexBufferValid && memcmp(&pCache->indexBufferView,&view,sizeof(view)) == 0))
+	{
+		return;
+	}
+	pCache->pCommandList->IASetIndexBuffer(&view);
+	pCache->indexBufferView = view;
+	pCache->indexBufferValid = true;
+}
+
+void CachedSetGraphicsRootConstantBufferView( CachedCommandList* pCache, UINT rootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS address )
+{
+	const UINT bit = 1u << rootParameterIndex;
+	if(IsRedundantState(pCache,(pCache->rootArgumentValid & bit) && pCache->rootArgument[rootParameterIndex] == address))
+	{
+		return;
+	}
+	pCache->pCommandList->SetGraphicsRootConstantBufferView(rootParameterIndex,address);
+	pCache->rootArgument[rootParameterIndex] = address;
+	pCache->rootArgumentValid |= bit;
+}
+
+void CachedSetGraphicsRootDescriptorTable( CachedCommandList* pCache, UINT rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE handle )
+{
+	const UINT bit = 1u << rootParameterIndex;
+	if(IsRedundantState(pCache,(pCache->rootArgumentValid & bit) && pCache->rootArgument[rootParameterIndex] == handle.ptr))
+	{
+		return;
+	}
+	pCache->pCommandList->SetGraphicsRootDescriptorTable(rootParameterIndex,handle);
+	pCache->rootArgument[rootParameterIndex] = handle.ptr;
+	pCache->rootArgumentValid |= bit;
+}
+
+//ԃLbṼbp[œԂƕςԂ𑱂Đݒ肵AsƏȂm߂
+//R}hXgɂ͎ۂɋL^邪As͂ɕ
+bool CheckCachedCommandList()
+{
+	ComPtr<ID3D12CommandAllocator> commandAllocator;
+	if(FAILED(g_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,IID_PPV_ARGS(&commandAllocator))))
+	{
+		return false;
+	}
+	ComPtr<ID3D12GraphicsCommandList> commandList;
+	if(FAILED(g_device->CreateCommandList(0,D3D12_COMMAND_LIST_TYPE_DIRECT,commandAllocator.Get(),nullptr,IID_PPV_ARGS(&commandList))))
+	{
+		return false;
+	}
+
+	const D3D12_GPU_VIRTUAL_ADDRESS address = g_frameConstantBuffer->GetGPUVirtualAddress();
+	const D3D12_GPU_DESCRIPTOR_HANDLE table = GetDescriptorGpuHandle(&g_descriptorHeap,0);
+	CachedCommandList cache = {};
+	BeginCachedCommandList(&cache,commandList.Get());
+
+	//SetState()Ɠݒ2sƁA2ڂ͑SďȂ
+	for(UINT repeat = 0;repeat < 2;repeat++)
+	{
+		CachedSetGraphicsRootSignature(&cache,g_rootSignature.Get());
+		CachedSetDescriptorHeap(&cache,g_descriptorHeap.heap.Get());
+		CachedSetGraphicsRootConstantBufferView(&cache,0,address);
+		CachedSetGraphicsRootDescriptorTable(&cache,3,table);
+		CachedRSSetViewport(&cache,g_viewport);
+		CachedRSSetScissorRect(&cache,g_scissorRect);
+		CachedIASetPrimitiveTopology(&cache,D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		CachedIASetVertexBuffer(&cache,0,g_vertexBufferView);
+		CachedIASetIndexBuffer(&cache,g_indexBufferView);
+	}
+	const bool repeated = cache.issuedCount == 9 && cache.elidedCount == 9;
+
+	//ςݒƁA܂ݒ肵ĂȂXbg𔭍s
+	D3D12_VIEWPORT viewport = g_viewport;
+	viewport.Width *= 0.5f;
+	CachedSetGraphicsRootConstantBufferView(&cache,0,address + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+	CachedSetGraphicsRootConstantBufferView(&cache,1,address);
+	CachedRSSetViewport(&cache,viewport);
+	CachedIASetPrimitiveTopology(&cache,D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	CachedIASetVertexBuffer(&cache,0,g_vertexBufferView);
+	CachedIASetVertexBuffer(&cache,1,g_instanceBufferView);
+	const bool changed = cache.issuedCount == 9 + 4 && cache.elidedCount == 9 + 2;
+
+	//Zbg͑ȌԂpȂ̂őSĔs(͈p)
+	if(FAILED(commandList->Close()) || FAILED(commandList->Reset(commandAllocator.Get(),nullptr)))
+	{
+		return false;
+	}
+	BeginCachedCommandList(&cache,commandList.Get());
+	CachedSetGraphicsRootSignature(&cache,g_rootSignature.Get());
+	CachedSetGraphicsRootConstantBufferView(&cache,0,address);
+	CachedRSSetViewport(&cache,g_viewport);
+	const bool reset = cache.issuedCount == 13 + 3 && cache.elidedCount == 11;
+	if(FAILED(commandList->Close()))
+	{
+		return false;
+	}
+
+	char text[256];
+	sprintf_s(text,"CachedCommandList: %llu issued, %llu elided%s\n",cache.issuedCount,cache.elidedCount,
+		(repeated && changed && reset) ? "" : " (UNEXPECTED COUNTS)");
+	OutputDebugStringA(text);
+	return repeated && changed && reset;
+}
+
+//CX^Xobt@쐬(St[̗̈܂Ƃ߂Ċmۂ}bv܂܂ɂ)
+bool CreateInstanceBuffer()
+{
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type = D3D12_HEAP_TYPE_UPLOAD;
+	prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask = 1;
+	prop.VisibleNodeMask = 1;
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment = 0;
+	desc.Width = static_cast<UINT64>(sizeof(XMFLOAT4X4)) * MAX_INSTANCE_COUNT * g_frameCount;
+	desc.Height = 1;
+	desc.DepthOrArraySize = 1;
+	desc.MipLevels = 1;
+	desc.Format = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	if(FAILED(g_device->CreateCommittedResource(
+		&prop,D3D12_HEAP_FLAG_NONE,&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,IID_PPV_ARGS(&g_instanceBuffer))))
+	{
+		return false;
+	}
+
+	D3D12_RANGE readRange = {0,0};
+	if(FAILED(g_instanceBuffer->Map(0,&readRange,reinterpret_cast<void**>(&g_pInstanceDataBegin))))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//CX^X̃[hsẴt[̃CX^Xobt@ɒڏ
+//SCX^XbVȂ̂Ńob`1ɂ܂Ƃ܂
+void UpdateInstances()
+{
+	XMFLOAT4X4* pDest = g_pInstanceDataBegin + static_cast<size_t>(MAX_INSTANCE_COUNT) * g_frameIndex;
+	ComposeTransformsParallel(g_visibleTransform,pDest);
+
+	g_instanceBatch.clear();
+	if(g_visibleTransform.count > 0)
+	{
+		InstanceBatch batch = { 0, 0, g_visibleTransform.count };
+		g_instanceBatch.push_back(batch);
+	}
+
+	g_instanceBufferView.BufferLocation = g_instanceBuffer->GetGPUVirtualAddress() +
+		static_cast<UINT64>(sizeof(XMFLOAT4X4)) * MAX_INSTANCE_COUNT * g_frameIndex;
+	g_instanceBufferView.StrideInBytes = sizeof(XMFLOAT4X4);
+	g_instanceBufferView.SizeInBytes = sizeof(XMFLOAT4X4) * MAX_INSTANCE_COUNT;
+}
+
+//ExecuteIndirect̃R}hVOl`ƈobt@쐬
+//obt@̓t[ƂɁA`̌ɋL^XbhƂ̕`搔u
+bool CreateIndirectBuffer()
+{
+	//}eÃ[g萔ݒ肵Ă`悷
+	D3D12_INDIRECT_ARGUMENT_DESC argumentDesc[2] = {};
+	argumentDesc[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+	argumentDesc[0].Constant.RootParameterIndex = 2;
+	argumentDesc[0].Constant.DestOffsetIn32BitValues = 0;
+	argumentDesc[0].Constant.Num32BitValuesToSet = 1;
+	argumentDesc[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+	D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+	signatureDesc.ByteStride = sizeof(IndirectCommand);
+	signatureDesc.NumArgumentDescs = _countof(argumentDesc);
+	signatureDesc.pArgumentDescs = argumentDesc;
+	if(FAILED(g_device->CreateCommandSignature(&signatureDesc,g_rootSignature.Get(),IID_PPV_ARGS(&g_commandSignature))))
+	{
+		return false;
+	}
+
+	D3D12_HEAP_PROPERTIES prop = {};
+	prop.Type = D3D12_HEAP_TYPE_UPLOAD;
+	prop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	prop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	prop.CreationNodeMask = 1;
+	prop.VisibleNodeMask = 1;
+
+	D3D12_RESOURCE_DESC desc = {};
+	desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment = 0;
+	desc.Width = INDIRECT_FRAME_SIZE * g_frameCount;
+	desc.Height = 1;
+	desc.DepthOrArraySize = 1;
+	desc.MipLevels = 1;
+	desc.Format = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	//Abv[hq[vGENERIC_READINDIRECT_ARGUMENT܂ނ̂ł̂܂܎g
+	if(FAILED(g_device->CreateCommittedResource(
+		&prop,D3D12_HEAP_FLAG_NONE,&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,IID_PPV_ARGS(&g_indirectBuffer))))
+	{
+		return false;
+	}
+
+	D3D12_RANGE readRange = {0,0};
+	if(FAILED(g_indirectBuffer->Map(0,&readRange,reinterpret_cast<void**>(&g_pIndirectDataBegin))))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//D3DCompileŃRpC(VF[_[̃LbṼRpC)
+bool CompileShaderWithD3DCompiler( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode )
+{
+	ComPtr<ID3DBlob> bytecode;
+	ComPtr<ID3DBlob> error;
+	if(FAILED(D3DCompile(pSource,sourceSize,pSourceName,reinterpret_cast<const D3D_SHADER_MACRO*>(pDefines),nullptr,
+		pEntryPoint,pTarget,flags,0,&bytecode,&error)))
+	{
+		if(error)
+		{
+			OutputDebugStringA(static_cast<const char*>(error->GetBufferPointer()));
+		}
+		return false;
+	}
+
+	const UINT8* pBegin = static_cast<const UINT8*>(bytecode->GetBufferPointer());
+	pBytecode->assign(pBegin,pBegin + bytecode->GetBufferSize());
+	return true;
+}
+
+//pCvC̃LbṼL[
+//[gVOl`ƃVF[_[̃L[ƁA|C^܂܂Ȃݒ肾nbV
+//lߕ̂\(uhƐ[xXeV)͋lߕ̒gsȂ̂Ńo[ƂɃnbV
+UINT64 HashPipelineStateDesc( const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, UINT64 rootSignatureKey, UINT64 vertexShaderKey, UINT64 pixelShaderKey )
+{
+	UINT64 key = HASH_SEED;
+	key = HashBytes(&PIPELINE_CACHE_VERSION,sizeof(PIPELINE_CACHE_VERSION),key);
+	key = HashBytes(&rootSignatureKey,sizeof(rootSignatureKey),key);
+	key = HashBytes(&vertexShaderKey,sizeof(vertexShaderKey),key);
+	key = HashBytes(&pixelShaderKey,sizeof(pixelShaderKey),key);
+	for(UINT n = 0;n < pDesc->InputLayout.NumElements;n++)
+	{
+		const D3D12_INPUT_ELEMENT_DESC& element = pDesc->InputLayout.pInputElementDescs[n];
+		key = HashString(element.SemanticName,key);
+		key = HashBytes(&element.SemanticIndex,sizeof(D3D12_INPUT_ELEMENT_DESC) - offsetof(D3D12_INPUT_ELEMENT_DESC,SemanticIndex),key);
+	}
+
+	const D3D12_BLEND_DESC& blend = pDesc->BlendState;
+	key = HashBytes(&blend.AlphaToCoverageEnable,sizeof(blend.AlphaToCoverageEnable),key);
+	key = HashBytes(&blend.IndependentBlendEnable,sizeof(blend.IndependentBlendEnable),key);
+	for(const D3D12_RENDER_TARGET_BLEND_DESC& target : blend.RenderTarget)
+	{
+		key = HashBytes(&target.BlendEnable,sizeof(target.BlendEnable),key);
+		key = HashBytes(&target.LogicOpEnable,sizeof(target.LogicOpEnable),key);
+		key = HashBytes(&target.SrcBlend,sizeof(target.SrcBlend),key);
+		key = HashBytes(&target.DestBlend,sizeof(target.DestBlend),key);
+		key = HashBytes(&target.BlendOp,sizeof(target.BlendOp),key);
+		key = HashBytes(&target.SrcBlendAlpha,sizeof(target.SrcBlendAlpha),key);
+		key = HashBytes(&target.DestBlendAlpha,sizeof(target.DestBlendAlpha),key);
+		key = HashBytes(&target.BlendOpAlpha,sizeof(target.BlendOpAlpha),key);
+		key = HashBytes(&target.LogicOp,sizeof(target.LogicOp),key);
+		key = HashBytes(&target.RenderTargetWriteMask,sizeof(target.RenderTargetWriteMask),key);
+	}
+	key = HashBytes(&pDesc->SampleMask,sizeof(pDesc->SampleMask),key);
+	key = HashBytes(&pDesc->RasterizerState,sizeof(pDesc->RasterizerState),key);
+
+	const D3D12_DEPTH_STENCIL_DESC& depthStencil = pDesc->DepthStencilState;
+	key = HashBytes(&depthStencil.DepthEnable,sizeof(depthStencil.DepthEnable),key);
+	key = HashBytes(&depthStencil.DepthWriteMask,sizeof(depthStencil.DepthWriteMask),key);
+	key = HashBytes(&depthStencil.DepthFunc,sizeof(depthStencil.DepthFunc),key);
+	key = HashBytes(&depthStencil.StencilEnable,sizeof(depthStencil.StencilEnable),key);
+	key = HashBytes(&depthStencil.StencilReadMask,sizeof(depthStencil.StencilReadMask),key);
+	key = HashBytes(&depthStencil.StencilWriteMask,sizeof(depthStencil.StencilWriteMask),key);
+	key = HashBytes(&depthStencil.FrontFace,sizeof(depthStencil.FrontFace),key);
+	key = HashBytes(&depthStencil.BackFace,sizeof(depthStencil.BackFace),key);
+	key = HashBytes(&pDesc->PrimitiveTopologyType,sizeof(pDesc->PrimitiveTopologyType),key);
+	key = HashBytes(&pDesc->NumRenderTargets,sizeof(pDesc->NumRenderTargets),key);
+	key = HashBytes(pDesc->RTVFormats,sizeof(pDesc->RTVFormats),key);
+	key = HashBytes(&pDesc->DSVFormat,sizeof(pDesc->DSVFormat),key);
+	key = HashBytes(&pDesc->SampleDesc,sizeof(pDesc->SampleDesc),key);
+	return key;
+}
+
+//LbVgăpCvC쐬
+//hCo[A_v^[ςăLbVgȂƂ͍蒼ĕۑ
+bool CreateCachedPipelineState( D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc, UINT64 key, ComPtr<ID3D12PipelineState>* pPipelineState )
+{
+	vector<UINT8> cachedBlob;
+	if(ReadShaderCacheFile(&g_shaderCache,key,"pso",&cachedBlob))
+	{
+		pDesc->CachedPSO.pCachedBlob = cachedBlob.data();
+		pDesc->CachedPSO.CachedBlobSizeInBytes = cachedBlob.size();
+		const HRESULT result = g_device->CreateGraphicsPipelineState(pDesc,IID_PPV_ARGS(&(*pPipelineState)));
+		pDesc->CachedPSO.pCachedBlob = nullptr;
+		pDesc->CachedPSO.CachedBlobSizeInBytes = 0;
+		if(SUCCEEDED(result))
+		{
+			InterlockedIncrement(&g_shaderCacheCounter.pipelineHit);
+			return true;
+		}
+	}
+
+	InterlockedIncrement(&g_shaderCacheCounter.pipelineMiss);
+	if(FAILED(g_device->CreateGraphicsPipelineState(pDesc,IID_PPV_ARGS(&(*pPipelineState)))))
+	{
+		return false;
+	}
+
+	ComPtr<ID3DBlob> blob;
+	if(SUCCEEDED((*pPipelineState)->GetCachedBlob(&blob)))
+	{
+		WriteShaderCacheFile(&g_shaderCache,key,"pso",blob->GetBufferPointer(),blob->GetBufferSize());
+	}
+	return true;
+}
+
+//pCvC̃LbṼL[m߂
+//Elߕʂ̒lŖ߂Ă瓯ݒɂpCvC͓L[ɂȂ
+//E[gVOl`uhႦΕς
+//VF[_[̃LbVTests/ShaderCacheTest.cppŊm߂
+bool CheckPipelineCacheKey()
+{
+	D3D12_INPUT_ELEMENT_DESC element = { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc[2];
+	for(UINT n = 0;n < 2;n++)
+	{
+		memset(&desc[n],(n == 0) ? 0x00 : 0xcd,sizeof(desc[n]));
+		desc[n].InputLayout = { &element, 1 };
+		desc[n].BlendState.AlphaToCoverageEnable = FALSE;
+		desc[n].BlendState.IndependentBlendEnable = FALSE;
+		for(D3D12_RENDER_TARGET_BLEND_DESC& target : desc[n].BlendState.RenderTarget)
+		{
+			target.BlendEnable = FALSE;
+			target.LogicOpEnable = FALSE;
+			target.SrcBlend = D3D12_BLEND_ONE;
+			target.DestBlend = D3D12_BLEND_ZERO;
+			target.BlendOp = D3D12_BLEND_OP_ADD;
+			target.SrcBlendAlpha = D3D12_BLEND_ONE;
+			target.DestBlendAlpha = D3D12_BLEND_ZERO;
+			target.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+			target.LogicOp = D3D12_LOGIC_OP_NOOP;
+			target.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+		}
+		desc[n].SampleMask = UINT_MAX;
+		desc[n].RasterizerState = {};
+		desc[n].DepthStencilState.DepthEnable = TRUE;
+		desc[n].DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+		desc[n].DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+		desc[n].DepthStencilState.StencilEnable = FALSE;
+		desc[n].DepthStencilState.StencilReadMask = 0;
+		desc[n].DepthStencilState.StencilWriteMask = 0;
+		desc[n].DepthStencilState.FrontFace = {};
+		desc[n].DepthStencilState.BackFace = {};
+		desc[n].PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+		desc[n].NumRenderTargets = 1;
+		for(DXGI_FORMAT& format : desc[n].RTVFormats)
+		{
+			format = DXGI_FORMAT_UNKNOWN;
+		}
+		desc[n].RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+		desc[n].DSVFormat = DXGI_FORMAT_D32_FLOAT;
+		desc[n].SampleDesc.Count = 1;
+		desc[n].SampleDesc.Quality = 0;
+	}
+	const UINT64 pipelineKey = HashPipelineStateDesc(&desc[0],1,2,3);
+	bool valid = pipelineKey == HashPipelineStateDesc(&desc[1],1,2,3);
+	valid = valid && pipelineKey != HashPipelineStateDesc(&desc[0],4,2,3);
+	desc[1].BlendState.RenderTarget[0].BlendEnable = TRUE;
+	valid = valid && pipelineKey != HashPipelineStateDesc(&desc[1],1,2,3);
+
+	char text[256];
+	sprintf_s(text,"PipelineCacheKey: %s\n",valid ? "ok" : "FAILED");
+	OutputDebugStringA(text);
+	return valid;
+}
+
+//VF[_[̃Wuǉ(VF[_[̃Wu΂Ԃ)
+UINT AddShaderJob( PipelineBuild* pBuild, const char* fileName, const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget )
+{
+	for(UINT n = 0;n < pBuild->shader.size();n++)
+	{
+		const ShaderJob& job = pBuild->shader[n];
+		if(strcmp(job.fileName,fileName) == 0 && job.pDefines == pDefines &&
+			strcmp(job.pEntryPoint,pEntryPoint) == 0 && strcmp(job.pTarget,pTarget) == 0)
+		{
+			return n;
+		}
+	}
+
+	ShaderJob job = {};
+	job.fileName = fileName;
+	job.pDefines = pDefines;
+	job.pEntryPoint = pEntryPoint;
+	job.pTarget = pTarget;
+	pBuild->shader.push_back(job);
+	return static_cast<UINT>(pBuild->shader.size() - 1);
+}
+
+//gݍ킹̃pCvC̃WuƁAꂪgVF[_[̃Wuǉ
+void AddPipelineJob( PipelineBuild* pBuild, UINT permutation )
+{
+	const PipelinePermutation& desc = g_pipelinePermutation[permutation];
+	const UINT pipelineIndex = static_cast<UINT>(pBuild->pipeline.size());
+
+	PipelineJob job = {};
+	job.permutation = permutation;
+	job.vertexShader = AddShaderJob(pBuild,desc.fileName,desc.pDefines,desc.pVertexEntry,"vs_5_0");
+	job.pixelShader = AddShaderJob(pBuild,desc.fileName,desc.pDefines,desc.pPixelEntry,"ps_5_0");
+	job.pendingCount = 2;
+	pBuild->pipeline.push_back(job);
+
+	pBuild->shader[job.vertexShader].dependent.push_back(pipelineIndex);
+	pBuild->shader[job.pixelShader].dependent.push_back(pipelineIndex);
+}
+
+//Wu1s
+bool RunPipelineBuildJob( PipelineBuild* pBuild, UINT jobIndex )
+{
+	LARGE_INTEGER beginTime;
+	QueryPerformanceCounter(&beginTime);
+
+	bool result;
+	if(jobIndex & PIPELINE_JOB_BIT)
+	{
+		//ˑĂVF[_[̃Wu͏IĂ̂ŁAbNɓǂ߂
+		PipelineJob& job = pBuild->pipeline[jobIndex & ~PIPELINE_JOB_BIT];
+		const ShaderJob& vertexShader = pBuild->shader[job.vertexShader];
+		const ShaderJob& pixelShader = pBuild->shader[job.pixelShader];
+		result = CreatePermutationPipelineState(g_pipelinePermutation[job.permutation],
+			vertexShader.bytecode,vertexShader.key,pixelShader.bytecode,pixelShader.key,&job.pipelineState);
+	}
+	else
+	{
+		ShaderJob& job = pBuild->shader[jobIndex];
+		result = LoadShader(&g_shaderCache,job.fileName,job.pDefines,job.pEntryPoint,job.pTarget,pBuild->compileFlag,&job.bytecode,&job.key);
+	}
+
+	LARGE_INTEGER endTime;
+	QueryPerformanceCounter(&endTime);
+
+	{
+		lock_guard<mutex> lock(pBuild->lock);
+		if(jobIndex & PIPELINE_JOB_BIT)
+		{
+			PipelineJob& job = pBuild->pipeline[jobIndex & ~PIPELINE_JOB_BIT];
+			job.beginTicks = beginTime.QuadPart;
+			job.endTicks = endTime.QuadPart;
+		}
+		else
+		{
+			ShaderJob& job = pBuild->shader[jobIndex];
+			job.beginTicks = beginTime.QuadPart;
+			job.endTicks = endTime.QuadPart;
+			if(result)
+			{
+				//҂ĂpCvC̃Wusł悤ɂ
+				for(UINT dependent : job.dependent)
+				{
+					if(--pBuild->pipeline[dependent].pendingCount == 0)
+					{
+						pBuild->ready.push_back(dependent | PIPELINE_JOB_BIT);
+					}
+				}
+			}
+		}
+		if(!result)
+		{
+			pBuild->failed = true;
+		}
+		pBuild->remaining--;
+	}
+	pBuild->wake.notify_all();
+	return result;
+}
+
+//rh̃Xbh
+void PipelineBuildWorker( PipelineBuild* pBuild )
+{
+	for(;;)
+	{
+		UINT jobIndex;
+		{
+			unique_lock<mutex> lock(pBuild->lock);
+			pBuild->wake.wait(lock,[pBuild](){ return !pBuild->ready.empty() || pBuild->remaining == 0 || pBuild->failed; });
+			if(pBuild->failed || pBuild->ready.empty())
+			{
+				return;
+			}
+			jobIndex = pBuild->ready.front();
+			pBuild->ready.pop_front();
+		}
+		RunPipelineBuildJob(pBuild,jobIndex);
+	}
+}
+
+//W߂WuXbhŎs
+bool RunPipelineBuild( PipelineBuild* pBuild )
+{
+	pBuild->remaining = static_cast<UINT>(pBuild->shader.size() + pBuild->pipeline.size());
+	pBuild->failed = false;
+	pBuild->ready.clear();
+	for(UINT n = 0;n < pBuild->shader.size();n++)
+	{
+		pBuild->ready.push_back(n);
+	}
+
+	pBuild->threadCount = min(max(thread::hardware_concurrency(),1u),max(pBuild->remaining,1u));
+
+	LARGE_INTEGER beginTime;
+	QueryPerformanceCounter(&beginTime);
+	pBuild->beginTicks = beginTime.QuadPart;
+
+	vector<thread> worker;
+	for(UINT n = 0;n < pBuild->threadCount;n++)
+	{
+		worker.push_back(thread(PipelineBuildWorker,pBuild));
+	}
+	for(thread& t : worker)
+	{
+		t.join();
+	}
+
+	LARGE_INTEGER endTime;
+	QueryPerformanceCounter(&endTime);
+	pBuild->endTicks = endTime.QuadPart;
+
+	return !pBuild->failed;
+}
+
+//gݍ킹Ƃ̎ԂƃNeBJpX̎Ԃo͂
+//NeBJpX́Ax̃VF[_[ƃpCvC̍쐬Ԃ̘a̍ől
+void OutputPipelineBuildStatistics( const PipelineBuild* pBuild )
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	const double toMs = 1000.0 / frequency.QuadPart;
+
+	char message[256];
+	double criticalPath = 0.0;
+	double serialTime = 0.0;
+	for(const ShaderJob& job : pBuild->shader)
+	{
+		serialTime += (job.endTicks - job.beginTicks) * toMs;
+	}
+	for(const PipelineJob& job : pBuild->pipeline)
+	{
+		const ShaderJob& vertexShader = pBuild->shader[job.vertexShader];
+		const ShaderJob& pixelShader = pBuild->shader[job.pixelShader];
+		const double vertexTime = (vertexShader.endTicks - vertexShader.beginTicks) * toMs;
+		const double pixelTime = (pixelShader.endTicks - pixelShader.beginTicks) * toMs;
+		const double pipelineTime = (job.endTicks - job.beginTicks) * toMs;
+		const double path = max(vertexTime,pixelTime) + pipelineTime;
+		criticalPath = max(criticalPath,path);
+		serialTime += pipelineTime;
+
+		sprintf_s(message,"pipeline %s: vs %.3f ms, ps %.3f ms, pso %.3f ms, path %.3f ms\n",
+			g_pipelinePermutation[job.permutation].name,vertexTime,pixelTime,pipelineTime,path);
+		OutputDebugStringA(message);
+	}
+
+	sprintf_s(message,"pipeline build: %u shaders, %u pipelines, %u threads, wall %.3f ms, critical path %.3f ms, serial %.3f ms\n",
+		static_cast<UINT>(pBuild->shader.size()),static_cast<UINT>(pBuild->pipeline.size()),pBuild->threadCount,
+		(pBuild->endTicks - pBuild->beginTicks) * toMs,criticalPath,serialTime);
+	OutputDebugStringA(message);
+}
+
+//bVt@Cg_meshɓǂݍ݁A`L[ƃJOɎgl߂
+bool LoadModel( const char* fileName )
+{
+	if(!LoadMesh(fileName,&g_mesh))
+	{
+		return false;
+	}
+	g_softwareShading.pMesh = &g_mesh;
+
+	//TuZbg̒S߂Ă
+	g_subsetCenter.resize(g_mesh.subsetCount);
+	for(int i = 0;i < g_mesh.subsetCount;i++)
+	{
+		XMVECTOR sum = XMVectorZero();
+		for(int n = 0;n < g_mesh.subset[i].vertexCount;n++)
+		{
+			const Vertex& vertex = g_mesh.vertecies[g_mesh.indexArray[g_mesh.subset[i].vertexStart + n]];
+			sum = XMVectorAdd(sum,XMVectorSet(vertex.position[0],vertex.position[1],vertex.position[2],0.0f));
+		}
+		if(g_mesh.subset[i].vertexCount > 0)
+		{
+			sum = XMVectorScale(sum,1.0f / g_mesh.subset[i].vertexCount);
+		}
+		XMStoreFloat3(&g_subsetCenter[i],sum);
+	}
+
+	//JOp̋E
+	ComputeBoundingVolume(g_mesh.vertecies,g_mesh.indexArray,g_mesh.indexCount,&g_meshBounds);
+	ResizeBoundingVolumeStream(&g_subsetBounds,g_mesh.subsetCount);
+	for(int i = 0;i < g_mesh.subsetCount;i++)
+	{
+		BoundingVolume volume;
+		ComputeBoundingVolume(g_mesh.vertecies,g_mesh.indexArray + g_mesh.subset[i].vertexStart,g_mesh.subset[i].vertexCount,&volume);
+		SetBoundingVolume(&g_subsetBounds,i,volume);
+	}
+
+	return true;
+}
+
+//EBhEƃfoCX炸CPUŕ`悷(`ModelScene.cppRunModelHeadless())
+//"-benchmark"w肵Ƃ́Ag_meshǂݍōsⒸ_AsNŽvZ̑xv
+bool RunHeadless()
+{
+	if(g_benchmark)
+	{
+		if(!LoadModel("boxMaterial.gmb"))
+		{
+			fprintf(stderr,"Headless: failed to load boxMaterial.gmb\n");
+			return false;
+		}
+		InitOcclusionBuffer(&g_occlusionBuffer);
+		BenchmarkMatrixStream(1000000);
+		BenchmarkTransformCompose(1000000);
+		BenchmarkFrustumCulling(1000000);
+		BenchmarkOcclusionCulling(10000);
+		BenchmarkSoftwareVertexTransform(1000000);
+		if(!BenchmarkPixelShading(1000000))
+		{
+			fprintf(stderr,"Headless: pixel shading does not match the reference\n");
+			return false;
+		}
+	}
+	return RunModelHeadless("boxMaterial.gmb",g_headlessFrameCount,g_instanceCount,g_fov);
+}
+
+//_ϊ̑x1XbhŌv
+//VSMainƓōs|TransformSoftwareVertices()Ƃ̍o͂
+void BenchmarkSoftwareVertexTransform( UINT vertexCount )
+{
+	const UINT LOOP_COUNT = 10;
+	if(g_mesh.vertexCount <= 0)
+	{
+		return;
+	}
+
+	//bV̒_JԂׂē͂ɂ
+	vector<Vertex> input(vertexCount);
+	for(UINT n = 0;n < vertexCount;n++)
+	{
+		input[n] = g_mesh.vertecies[n % g_mesh.vertexCount];
+	}
+	SoftwareVertexStream stream;
+	BuildSoftwareVertexStream(input.data(),vertexCount,&stream);
+
+	const XMMATRIX world = XMMatrixRotationY(0.5f);
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,3.0f,-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(g_fov,1280.0f / 720.0f,1.0f,10000.0f);
+	SoftwareDrawConstant constant;
+	SetSoftwareDrawConstant(XMMatrixIdentity(),world,view,project,&constant);
+	vector<SoftwareVertex> output(vertexCount);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		TransformSoftwareVertexStream(stream,0,vertexCount,constant,output.data());
+	}
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	//CX^XPʍsɂΓ_ϊł
+	XMFLOAT4X4 identity;
+	XMStoreFloat4x4(&identity,XMMatrixIdentity());
+	vector<XMFLOAT4X4> instance((vertexCount + g_mesh.vertexCount - 1) / g_mesh.vertexCount,identity);
+	vector<SoftwareVertex> reference(vertexCount);
+	TransformSoftwareVertices(g_mesh,instance.data(),0,vertexCount,world,view,project,reference.data());
+	float maxError = 0.0f;
+	for(UINT n = 0;n < vertexCount;n++)
+	{
+		const XMVECTOR difference = XMVectorAbs(XMVectorSubtract(XMLoadFloat4(&output[n].position),XMLoadFloat4(&reference[n].position)));
+		const XMVECTOR normalDifference = XMVectorAbs(XMVectorSubtract(XMLoadFloat4(&output[n].normal),XMLoadFloat4(&reference[n].normal)));
+		XMFLOAT4 error;
+		XMStoreFloat4(&error,XMVectorMax(difference,normalDifference));
+		maxError = max(maxError,max(max(error.x,error.y),max(error.z,error.w)));
+	}
+
+	const double seconds = static_cast<double>(end.QuadPart - begin.QuadPart) / frequency.QuadPart;
+	char text[256];
+	sprintf_s(text,"Vertex transform: %u vertices, SIMD width %u, %.1f Mvertices/s per core, max error %g\n",
+		vertexCount,SOFTWARE_SIMD_WIDTH,static_cast<double>(vertexCount) * LOOP_COUNT / seconds / 1000000.0,maxError);
+	OutputDebugStringA(text);
+}
+
+//s̔zɂ܂Ƃ߂ēs|(pOutput[n] = pInput[n] * matrixApOutputpInput͓ł悢)
+//sƂXMVector4TransformStream()ŕϊ̂ŁADirectXMathSSE/AVX2/NEON̎̂܂܎g
+void MultiplyMatrixStream( XMFLOAT4X4* pOutput, const XMFLOAT4X4* pInput, UINT count, FXMMATRIX matrix )
+{
+	XMVector4TransformStream(reinterpret_cast<XMFLOAT4*>(pOutput),sizeof(XMFLOAT4),
+		reinterpret_cast<const XMFLOAT4*>(pInput),sizeof(XMFLOAT4),static_cast<size_t>(count) * 4,matrix);
+}
+
+//s̈ꊇϊ̑x1XbhŌv
+//1XMMatrixMultiply()Ŋ|ʂƂ̍ƁArbg܂ňvȂvf̐o͂
+void BenchmarkMatrixStream( UINT matrixCount )
+{
+	const UINT LOOP_COUNT = 10;
+
+	vector<XMFLOAT4X4> input(matrixCount);
+	const UINT columnCount = static_cast<UINT>(ceilf(sqrtf(static_cast<float>(matrixCount))));
+	for(UINT n = 0;n < matrixCount;n++)
+	{
+		XMStoreFloat4x4(&input[n],XMMatrixRotationY(n * 0.001f) * GetGridInstanceWorld(n,columnCount));
+	}
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,3.0f,-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(g_fov,1280.0f / 720.0f,1.0f,10000.0f);
+	const XMMATRIX viewProject = XMMatrixRotationY(0.5f) * view * project;
+	vector<XMFLOAT4X4> output(matrixCount);
+	vector<XMFLOAT4X4> reference(matrixCount);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		MultiplyMatrixStream(output.data(),input.data(),matrixCount,viewProject);
+	}
+	LARGE_INTEGER middle;
+	QueryPerformanceCounter(&middle);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		for(UINT n = 0;n < matrixCount;n++)
+		{
+			XMStoreFloat4x4(&reference[n],XMMatrixMultiply(XMLoadFloat4x4(&input[n]),viewProject));
+		}
+	}
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	float maxError = 0.0f;
+	UINT mismatchCount = 0;
+	for(UINT n = 0;n < matrixCount;n++)
+	{
+		for(UINT k = 0;k < 16;k++)
+		{
+			const float a = (&output[n].m[0][0])[k];
+			const float b = (&reference[n].m[0][0])[k];
+			maxError = max(maxError,fabsf(a - b));
+			mismatchCount += memcmp(&a,&b,sizeof(float)) != 0 ? 1 : 0;
+		}
+	}
+
+	const double toMs = 1000.0 / frequency.QuadPart / LOOP_COUNT;
+	char text[256];
+	sprintf_s(text,"Matrix stream: %u matrices, %.3f ms (XMMatrixMultiply %.3f ms), max error %g, %u elements differ\n",
+		matrixCount,(middle.QuadPart - begin.QuadPart) * toMs,(end.QuadPart - middle.QuadPart) * toMs,maxError,mismatchCount);
+	OutputDebugStringA(text);
+}
+
+//ϊ̐ς(͒Pʂ̕ϊɂ)
+void ResizeTransformStream( TransformStream* pTransforms, UINT count )
+{
+	const UINT paddedCount = (count + SOFTWARE_SIMD_WIDTH - 1) / SOFTWARE_SIMD_WIDTH * SOFTWARE_SIMD_WIDTH;
+	pTransforms->count = count;
+	pTransforms->positionX.resize(paddedCount,0.0f);
+	pTransforms->positionY.resize(paddedCount,0.0f);
+	pTransforms->positionZ.resize(paddedCount,0.0f);
+	pTransforms->rotationX.resize(paddedCount,0.0f);
+	pTransforms->rotationY.resize(paddedCount,0.0f);
+	pTransforms->rotationZ.resize(paddedCount,0.0f);
+	pTransforms->rotationW.resize(paddedCount,1.0f);
+	pTransforms->scaleX.resize(paddedCount,1.0f);
+	pTransforms->scaleY.resize(paddedCount,1.0f);
+	pTransforms->scaleZ.resize(paddedCount,1.0f);
+}
+
+void SetTransform( TransformStream* pTransforms, UINT index, FXMVECTOR position, FXMVECTOR rotation, FXMVECTOR scale )
+{
+	XMFLOAT4 value;
+	XMStoreFloat4(&value,position);
+	pTransforms->positionX[index] = value.x;
+	pTransforms->positionY[index] = value.y;
+	pTransforms->positionZ[index] = value.z;
+	XMStoreFloat4(&value,rotation);
+	pTransforms->rotationX[index] = value.x;
+	pTransforms->rotationY[index] = value.y;
+	pTransforms->rotationZ[index] = value.z;
+	pTransforms->rotationW[index] = value.w;
+	XMStoreFloat4(&value,scale);
+	pTransforms->scaleX[index] = value.x;
+	pTransforms->scaleY[index] = value.y;
+	pTransforms->scaleZ[index] = value.z;
+}
+
+//GetGridInstanceWorld()Ɠiq̔zuɂ
+void SetGridTransforms( TransformStream* pTransforms, UINT count )
+{
+	ResizeTransformStream(pTransforms,count);
+	const UINT columnCount = static_cast<UINT>(ceilf(sqrtf(static_cast<float>(count))));
+	for(UINT n = 0;n < count;n++)
+	{
+		const XMMATRIX world = GetGridInstanceWorld(n,columnCount);
+		SetTransform(pTransforms,n,world.r[3],XMQuaternionIdentity(),XMVectorSplatOne());
+	}
+}
+
+//scale * rotation * translatioñ[hsSOFTWARE_SIMD_WIDTH܂Ƃ߂čApDest[first]`ɏ
+//ݐ̓CgRoCł悢悤ɁAs񂲂Ƃɐ擪珇ɏ
+void ComposeTransforms( const TransformStream& transforms, UINT first, UINT count, XMFLOAT4X4* pDest )
+{
+	const UINT end = first + count;
+	for(UINT base = first;base < end;base += SOFTWARE_SIMD_WIDTH)
+	{
+		SoftwareFloat row[9];
+		LoadTransformRotation(transforms,base,row);
+
+		float lane[12][SOFTWARE_SIMD_WIDTH];
+		for(UINT n = 0;n < 9;n++)
+		{
+			SoftwareStore(lane[n],row[n]);
+		}
+		SoftwareStore(lane[9],SoftwareLoad(&transforms.positionX[base]));
+		SoftwareStore(lane[10],SoftwareLoad(&transforms.positionY[base]));
+		SoftwareStore(lane[11],SoftwareLoad(&transforms.positionZ[base]));
+
+		const UINT laneCount = min(SOFTWARE_SIMD_WIDTH,end - base);
+		for(UINT n = 0;n < laneCount;n++)
+		{
+			XMFLOAT4X4 world;
+			world.m[0][0] = lane[0][n];
+			world.m[0][1] = lane[1][n];
+			world.m[0][2] = lane[2][n];
+			world.m[0][3] = 0.0f;
+			world.m[1][0] = lane[3][n];
+			world.m[1][1] = lane[4][n];
+			world.m[1][2] = lane[5][n];
+			world.m[1][3] = 0.0f;
+			world.m[2][0] = lane[6][n];
+			world.m[2][1] = lane[7][n];
+			world.m[2][2] = lane[8][n];
+			world.m[2][3] = 0.0f;
+			world.m[3][0] = lane[9][n];
+			world.m[3][1] = lane[10][n];
+			world.m[3][2] = lane[11][n];
+			world.m[3][3] = 1.0f;
+			pDest[base + n] = world;
+		}
+	}
+}
+
+//ŜpartCountɕpartԖڂ(ESOFTWARE_SIMD_WIDTHɂ낦)
+void ComposeTransformRange( const TransformStream& transforms, UINT part, UINT partCount, XMFLOAT4X4* pDest )
+{
+	const UINT64 blockCount = (transforms.count + SOFTWARE_SIMD_WIDTH - 1) / SOFTWARE_SIMD_WIDTH;
+	const UINT begin = static_cast<UINT>(blockCount * part / partCount) * SOFTWARE_SIMD_WIDTH;
+	const UINT end = min(static_cast<UINT>(blockCount * (part + 1) / partCount) * SOFTWARE_SIMD_WIDTH,transforms.count);
+	if(begin < end)
+	{
+		ComposeTransforms(transforms,begin,end - begin,pDest);
+	}
+}
+
+//L^XbhŕSă[hs
+//L^XbhƂ␔ȂƂ̓CXbhō
+void ComposeTransformsParallel( const TransformStream& transforms, XMFLOAT4X4* pDest )
+{
+	const bool parallel = IsRecordWorkerPoolRunning(&g_recordWorkers) && transforms.count >= MIN_TRANSFORMS_PER_JOB * 2;
+	if(!parallel)
+	{
+		ComposeTransforms(transforms,0,transforms.count,pDest);
+		return;
+	}
+
+	RunRecordWorkerTask(&g_recordWorkers,[&transforms,pDest]( UINT workerIndex )
+	{
+		ComposeTransformRange(transforms,workerIndex,g_recordThreadCount,pDest);
+		return true;
+	});
+}
+
+//[hs̍̑xv
+//XMMatrixScaling() * XMMatrixRotationQuaternion() * XMMatrixTranslation()Ƃ̍o͂
+void BenchmarkTransformCompose( UINT transformCount )
+{
+	const UINT LOOP_COUNT = 10;
+
+	TransformStream transforms;
+	ResizeTransformStream(&transforms,transformCount);
+	for(UINT n = 0;n < transformCount;n++)
+	{
+		const XMVECTOR position = XMVectorSet(static_cast<float>(n % 1000),static_cast<float>(n / 1000 % 1000),static_cast<float>(n / 1000000),1.0f);
+		const XMVECTOR rotation = XMQuaternionRotationRollPitchYaw(n * 0.001f,n * 0.002f,n * 0.003f);
+		const XMVECTOR scale = XMVectorSet(1.0f + (n % 7) * 0.25f,1.0f + (n % 5) * 0.25f,1.0f + (n % 3) * 0.25f,1.0f);
+		SetTransform(&transforms,n,position,rotation,scale);
+	}
+	vector<XMFLOAT4X4> output(transformCount);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		ComposeTransforms(transforms,0,transformCount,output.data());
+	}
+	LARGE_INTEGER middle;
+	QueryPerformanceCounter(&middle);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		ComposeTransformsParallel(transforms,output.data());
+	}
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	float maxError = 0.0f;
+	for(UINT n = 0;n < transformCount;n++)
+	{
+		const XMMATRIX reference =
+			XMMatrixScaling(transforms.scaleX[n],transforms.scaleY[n],transforms.scaleZ[n]) *
+			XMMatrixRotationQuaternion(XMVectorSet(transforms.rotationX[n],transforms.rotationY[n],transforms.rotationZ[n],transforms.rotationW[n])) *
+			XMMatrixTranslation(transforms.positionX[n],transforms.positionY[n],transforms.positionZ[n]);
+		XMFLOAT4X4 expected;
+		XMStoreFloat4x4(&expected,reference);
+		for(UINT k = 0;k < 16;k++)
+		{
+			maxError = max(maxError,fabsf((&output[n].m[0][0])[k] - (&expected.m[0][0])[k]));
+		}
+	}
+
+	const double toMs = 1000.0 / frequency.QuadPart / LOOP_COUNT;
+	const double parallelMs = (end.QuadPart - middle.QuadPart) * toMs;
+	const UINT threadCount = IsRecordWorkerPoolRunning(&g_recordWorkers) ? g_recordThreadCount : 1;
+	char text[256];
+	sprintf_s(text,"Transform compose: %u transforms, SIMD width %u, 1 thread %.3f ms, %u threads %.3f ms (%.1f Mtransforms/s), max error %g\n",
+		transformCount,SOFTWARE_SIMD_WIDTH,(middle.QuadPart - begin.QuadPart) * toMs,threadCount,parallelMs,
+		transformCount / parallelMs / 1000.0,maxError);
+	OutputDebugStringA(text);
+}
+
+//CfbNXŎw肵_͂AABBƁA̒S̋߂
+void ComputeBoundingVolume( const Vertex* pVertex, const int* pIndex, int indexCount, BoundingVolume* pVolume )
+{
+	if(indexCount <= 0)
+	{
+		pVolume->center = XMFLOAT3(0.0f,0.0f,0.0f);
+		pVolume->extent = XMFLOAT3(0.0f,0.0f,0.0f);
+		pVolume->radius = 0.0f;
+		return;
+	}
+
+	XMVECTOR minimum = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(pVertex[pIndex[0]].position));
+	XMVECTOR maximum = minimum;
+	for(int n = 1;n < indexCount;n++)
+	{
+		const XMVECTOR position = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(pVertex[pIndex[n]].position));
+		minimum = XMVectorMin(minimum,position);
+		maximum = XMVectorMax(maximum,position);
+	}
+	const XMVECTOR center = XMVectorScale(XMVectorAdd(minimum,maximum),0.5f);
+
+	float radiusSquare = 0.0f;
+	for(int n = 0;n < indexCount;n++)
+	{
+		const XMVECTOR position = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(pVertex[pIndex[n]].position));
+		radiusSquare = max(radiusSquare,XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(position,center))));
+	}
+
+	XMStoreFloat3(&pVolume->center,center);
+	XMStoreFloat3(&pVolume->extent,XMVectorSubtract(maximum,center));
+	pVolume->radius = sqrtf(radiusSquare);
+}
+
+void ResizeBoundingVolumeStream( BoundingVolumeStream* pVolumes, UINT count )
+{
+	const UINT paddedCount = (count + SOFTWARE_SIMD_WIDTH - 1) / SOFTWARE_SIMD_WIDTH * SOFTWARE_SIMD_WIDTH;
+	pVolumes->count = count;
+	pVolumes->centerX.resize(paddedCount,0.0f);
+	pVolumes->centerY.resize(paddedCount,0.0f);
+	pVolumes->centerZ.resize(paddedCount,0.0f);
+	pVolumes->extentX.resize(paddedCount,0.0f);
+	pVolumes->extentY.resize(paddedCount,0.0f);
+	pVolumes->extentZ.resize(paddedCount,0.0f);
+	pVolumes->radius.resize(paddedCount,0.0f);
+}
+
+void SetBoundingVolume( BoundingVolumeStream* pVolumes, UINT index, const BoundingVolume& volume )
+{
+	pVolumes->centerX[index] = volume.center.x;
+	pVolumes->centerY[index] = volume.center.y;
+	pVolumes->centerZ[index] = volume.center.z;
+	pVolumes->extentX[index] = volume.extent.x;
+	pVolumes->extentY[index] = volume.extent.y;
+	pVolumes->extentZ[index] = volume.extent.z;
+	pVolumes->radius[index] = volume.radius;
+}
+
+//s̗񂩂王6(AEAAAOA)o
+//s|O̍Wn̕ʂɂȂA@͓悤ɐK
+void ExtractFrustumPlanes( FXMMATRIX matrix, XMFLOAT4* pPlanes )
+{
+	const XMMATRIX transpose = XMMatrixTranspose(matrix);
+	const XMVECTOR plane[6] =
+	{
+		XMVectorAdd(transpose.r[3],transpose.r[0]),
+		XMVectorSubtract(transpose.r[3],transpose.r[0]),
+		XMVectorAdd(transpose.r[3],transpose.r[1]),
+		XMVectorSubtract(transpose.r[3],transpose.r[1]),
+		transpose.r[2],
+		XMVectorSubtract(transpose.r[3],transpose.r[2]),
+	};
+	for(UINT n = 0;n < 6;n++)
+	{
+		XMStoreFloat4(&pPlanes[n],XMPlaneNormalize(plane[n]));
+	}
+}
+
+//firstԖڂcount̋Eɂ邩𒲂ׁApVisible[first]`10
+//ʂƂɋAABB̂ʑɒȍŔ肵ASʂ̓ɂΌ
+void CullBoundingVolumes( const BoundingVolumeStream& volumes, UINT first, UINT count, const XMFLOAT4* pPlanes, UINT8* pVisible )
+{
+	SoftwareFloat plane[6][4];
+	SoftwareFloat absNormal[6][3];
+	for(UINT n = 0;n < 6;n++)
+	{
+		plane[n][0] = SoftwareSet(pPlanes[n].x);
+		plane[n][1] = SoftwareSet(pPlanes[n].y);
+		plane[n][2] = SoftwareSet(pPlanes[n].z);
+		plane[n][3] = SoftwareSet(pPlanes[n].w);
+		absNormal[n][0] = SoftwareSet(fabsf(pPlanes[n].x));
+		absNormal[n][1] = SoftwareSet(fabsf(pPlanes[n].y));
+		absNormal[n][2] = SoftwareSet(fabsf(pPlanes[n].z));
+	}
+
+	const UINT end = first + count;
+	for(UINT base = first;base < end;base += SOFTWARE_SIMD_WIDTH)
+	{
+		const SoftwareFloat x = SoftwareLoad(&volumes.centerX[base]);
+		const SoftwareFloat y = SoftwareLoad(&volumes.centerY[base]);
+		const SoftwareFloat z = SoftwareLoad(&volumes.centerZ[base]);
+		const SoftwareFloat extentX = SoftwareLoad(&volumes.extentX[base]);
+		const SoftwareFloat extentY = SoftwareLoad(&volumes.extentY[base]);
+		const SoftwareFloat extentZ = SoftwareLoad(&volumes.extentZ[base]);
+		const SoftwareFloat radius = SoftwareLoad(&volumes.radius[base]);
+
+		//ʂƂ̋ + o̍ŏlȂO
+		SoftwareFloat minimum = SoftwareSet(0.0f);
+		for(UINT n = 0;n < 6;n++)
+		{
+			SoftwareFloat distance = SoftwareMulAdd(x,plane[n][0],plane[n][3]);
+			distance = SoftwareMulAdd(y,plane[n][1],distance);
+			distance = SoftwareMulAdd(z,plane[n][2],distance);
+			SoftwareFloat box = SoftwareMul(extentX,absNormal[n][0]);
+			box = SoftwareMulAdd(extentY,absNormal[n][1],box);
+			box = SoftwareMulAdd(extentZ,absNormal[n][2],box);
+			const SoftwareFloat margin = SoftwareAdd(distance,SoftwareMin(radius,box));
+			minimum = (n == 0) ? margin : SoftwareMin(minimum,margin);
+		}
+
+		float lane[SOFTWARE_SIMD_WIDTH];
+		SoftwareStore(lane,minimum);
+		const UINT laneCount = min(SOFTWARE_SIMD_WIDTH,end - base);
+		for(UINT n = 0;n < laneCount;n++)
+		{
+			pVisible[base + n] = (lane[n] >= 0.0f) ? 1 : 0;
+		}
+	}
+}
+
+//bV̋EeCX^X̕ϊœ
+//AABB͉]̊eւ̒o𑫂A̔a͍ő̊g嗦|
+void BuildInstanceBounds( const TransformStream& transforms, const BoundingVolume& localVolume, BoundingVolumeStream* pVolumes )
+{
+	ResizeBoundingVolumeStream(pVolumes,transforms.count);
+
+	const SoftwareFloat centerX = SoftwareSet(localVolume.center.x);
+	const SoftwareFloat centerY = SoftwareSet(localVolume.center.y);
+	const SoftwareFloat centerZ = SoftwareSet(localVolume.center.z);
+	const SoftwareFloat extentX = SoftwareSet(localVolume.extent.x);
+	const SoftwareFloat extentY = SoftwareSet(localVolume.extent.y);
+	const SoftwareFloat extentZ = SoftwareSet(localVolume.extent.z);
+	const SoftwareFloat radius = SoftwareSet(localVolume.radius);
+	for(UINT base = 0;base < transforms.count;base += SOFTWARE_SIMD_WIDTH)
+	{
+		SoftwareFloat row[9];
+		LoadTransformRotation(transforms,base,row);
+
+		SoftwareFloat center[3];
+		SoftwareFloat extent[3];
+		for(UINT column = 0;column < 3;column++)
+		{
+			SoftwareFloat value = SoftwareMul(centerX,row[column]);
+			value = SoftwareMulAdd(centerY,row[3 + column],value);
+			center[column] = SoftwareMulAdd(centerZ,row[6 + column],value);
+			value = SoftwareMul(extentX,SoftwareAbs(row[column]));
+			value = SoftwareMulAdd(extentY,SoftwareAbs(row[3 + column]),value);
+			extent[column] = SoftwareMulAdd(extentZ,SoftwareAbs(row[6 + column]),value);
+		}
+		SoftwareStore(&pVolumes->centerX[base],SoftwareAdd(center[0],SoftwareLoad(&transforms.positionX[base])));
+		SoftwareStore(&pVolumes->centerY[base],SoftwareAdd(center[1],SoftwareLoad(&transforms.positionY[base])));
+		SoftwareStore(&pVolumes->centerZ[base],SoftwareAdd(center[2],SoftwareLoad(&transforms.positionZ[base])));
+		SoftwareStore(&pVolumes->extentX[base],extent[0]);
+		SoftwareStore(&pVolumes->extentY[base],extent[1]);
+		SoftwareStore(&pVolumes->extentZ[base],extent[2]);
+
+		const SoftwareFloat scale = SoftwareMax(SoftwareAbs(SoftwareLoad(&transforms.scaleX[base])),
+			SoftwareMax(SoftwareAbs(SoftwareLoad(&transforms.scaleY[base])),SoftwareAbs(SoftwareLoad(&transforms.scaleZ[base]))));
+		SoftwareStore(&pVolumes->radius[base],SoftwareMul(radius,scale));
+	}
+}
+
+//̂Ԃۂċl߂
+void CompactTransforms( const TransformStream& source, const UINT8* pVisible, TransformStream* pDest )
+{
+	UINT visibleCount = 0;
+	for(UINT n = 0;n < source.count;n++)
+	{
+		visibleCount += pVisible[n];
+	}
+	ResizeTransformStream(pDest,visibleCount);
+
+	UINT index = 0;
+	for(UINT n = 0;n < source.count;n++)
+	{
+		if(!pVisible[n])
+		{
+			continue;
+		}
+		pDest->positionX[index] = source.positionX[n];
+		pDest->positionY[index] = source.positionY[n];
+		pDest->positionZ[index] = source.positionZ[n];
+		pDest->rotationX[index] = source.rotationX[n];
+		pDest->rotationY[index] = source.rotationY[n];
+		pDest->rotationZ[index] = source.rotationZ[n];
+		pDest->rotationW[index] = source.rotationW[n];
+		pDest->scaleX[index] = source.scaleX[n];
+		pDest->scaleY[index] = source.scaleY[n];
+		pDest->scaleZ[index] = source.scaleZ[n];
+		index++;
+	}
+}
+
+//CX^Xg_visibleTransformɋl߁A`TuZbgg_subsetVisibleɏ
+//CX^Xworld|O̍WnŒׂ
+//CX^X1̂Ƃ́ATuZbg̃CX^X̍WnŒׂ
+//g_occlusionCullingȂ王̒̃CX^XɎՕŒׂ
+void CullScene( FXMMATRIX world, CXMMATRIX viewProject )
+{
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+
+	XMFLOAT4 planes[6];
+	ExtractFrustumPlanes(world * viewProject,planes);
+	BuildInstanceBounds(g_instanceTransform,g_meshBounds,&g_instanceBounds);
+	g_instanceVisible.resize(g_instanceTransform.count);
+	CullBoundingVolumes(g_instanceBounds,0,g_instanceTransform.count,planes,g_instanceVisible.data());
+	if(g_occlusionCulling)
+	{
+		LARGE_INTEGER occlusionBegin;
+		QueryPerformanceCounter(&occlusionBegin);
+		RenderOccluders(&g_occlusionBuffer,g_instanceTransform,g_instanceBounds,g_instanceVisible.data(),world,viewProject);
+		g_cullingCounter.occludedCount += CullOccludedVolumes(g_occlusionBuffer,g_instanceBounds,world * viewProject,g_instanceVisible.data());
+		LARGE_INTEGER occlusionEnd;
+		QueryPerformanceCounter(&occlusionEnd);
+		g_cullingCounter.occlusionTicks += occlusionEnd.QuadPart - occlusionBegin.QuadPart;
+	}
+	CompactTransforms(g_instanceTransform,g_instanceVisible.data(),&g_visibleTransform);
+
+	g_subsetVisible.assign(g_mesh.subsetCount,g_visibleTransform.count > 0 ? 1 : 0);
+	UINT testedCount = g_instanceTransform.count;
+	if(g_visibleTransform.count == 1)
+	{
+		XMFLOAT4X4 instanceWorld;
+		ComposeTransforms(g_visibleTransform,0,1,&instanceWorld);
+		ExtractFrustumPlanes(XMLoadFloat4x4(&instanceWorld) * world * viewProject,planes);
+		CullBoundingVolumes(g_subsetBounds,0,g_subsetBounds.count,planes,g_subsetVisible.data());
+		testedCount += g_subsetBounds.count;
+	}
+
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+	g_cullingCounter.ticks += end.QuadPart - begin.QuadPart;
+	g_cullingCounter.testedCount += testedCount;
+	g_cullingCounter.visibleCount += g_visibleTransform.count;
+	for(int i = 0;i < g_mesh.subsetCount;i++)
+	{
+		g_cullingCounter.visibleCount += g_subsetVisible[i];
+	}
+}
+
+//JȎx1XbhŌv
+//1XMPlaneDotCoord()ŒׂʂƐHo͂
+void BenchmarkFrustumCulling( UINT volumeCount )
+{
+	const UINT LOOP_COUNT = 10;
+
+	//J̎ɑ傫̈ႤU΂点
+	BoundingVolumeStream volumes;
+	ResizeBoundingVolumeStream(&volumes,volumeCount);
+	UINT seed = 12345;
+	for(UINT n = 0;n < volumeCount;n++)
+	{
+		float value[4];
+		for(UINT k = 0;k < 4;k++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			value[k] = (seed >> 8) / 16777216.0f;
+		}
+		BoundingVolume volume;
+		volume.center = XMFLOAT3((value[0] - 0.5f) * 200.0f,(value[1] - 0.5f) * 200.0f,(value[2] - 0.5f) * 200.0f);
+		volume.extent = XMFLOAT3(value[3] * 2.0f + 0.1f,value[3] + 0.1f,value[3] * 0.5f + 0.1f);
+		volume.radius = sqrtf(volume.extent.x * volume.extent.x + volume.extent.y * volume.extent.y + volume.extent.z * volume.extent.z);
+		SetBoundingVolume(&volumes,n,volume);
+	}
+
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,3.0f,-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(g_fov,1280.0f / 720.0f,1.0f,10000.0f);
+	XMFLOAT4 planes[6];
+	ExtractFrustumPlanes(view * project,planes);
+	vector<UINT8> visible(volumeCount);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		CullBoundingVolumes(volumes,0,volumeCount,planes,visible.data());
+	}
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	UINT visibleCount = 0;
+	UINT mismatchCount = 0;
+	for(UINT n = 0;n < volumeCount;n++)
+	{
+		const XMVECTOR center = XMVectorSet(volumes.centerX[n],volumes.centerY[n],volumes.centerZ[n],1.0f);
+		const XMVECTOR extent = XMVectorSet(volumes.extentX[n],volumes.extentY[n],volumes.extentZ[n],0.0f);
+		bool inside = true;
+		for(UINT k = 0;k < 6;k++)
+		{
+			const XMVECTOR plane = XMLoadFloat4(&planes[k]);
+			const float box = XMVectorGetX(XMVector3Dot(extent,XMVectorAbs(plane)));
+			if(XMVectorGetX(XMPlaneDotCoord(plane,center)) + min(volumes.radius[n],box) < 0.0f)
+			{
+				inside = false;
+			}
+		}
+		visibleCount += visible[n];
+		mismatchCount += ((visible[n] != 0) != inside) ? 1 : 0;
+	}
+
+	const double ms = 1000.0 * (end.QuadPart - begin.QuadPart) / frequency.QuadPart / LOOP_COUNT;
+	char text[256];
+	sprintf_s(text,"Frustum culling: %u volumes, SIMD width %u, %.3f ms (%.0f objects/ms), %u visible, %u differ from scalar\n",
+		volumeCount,SOFTWARE_SIMD_WIDTH,ms,volumeCount / ms,visibleCount,mismatchCount);
+	OutputDebugStringA(text);
+}
+
+//indexԖڂ̕ϊ̍s(ComposeTransforms()1̂Ɠ)
+XMMATRIX GetTransformMatrix( const TransformStream& transforms, UINT index )
+{
+	return XMMatrixScaling(transforms.scaleX[index],transforms.scaleY[index],transforms.scaleZ[index]) *
+		XMMatrixRotationQuaternion(XMVectorSet(transforms.rotationX[index],transforms.rotationY[index],transforms.rotationZ[index],transforms.rotationW[index])) *
+		XMMatrixTranslation(transforms.positionX[index],transforms.positionY[index],transforms.positionZ[index]);
+}
+
+//ՕJȌ(g_meshǂݍ񂾌ɌĂ)
+void InitOcclusionBuffer( OcclusionBuffer* pBuffer )
+{
+	pBuffer->depth.assign(OCCLUSION_WIDTH * OCCLUSION_HEIGHT,1.0f);
+	pBuffer->tileMaxDepth.assign(OCCLUSION_TILE_COUNT_X * OCCLUSION_TILE_COUNT_Y,1.0f);
+	BuildSoftwareVertexStream(g_mesh.vertecies,g_mesh.vertexCount,&pBuffer->stream);
+	pBuffer->vertex.resize(static_cast<size_t>(g_mesh.vertexCount) * MAX_OCCLUDER_COUNT);
+	pBuffer->occluderCount = 0;
+}
+
+//CX^X̂OMAX_OCCLUDER_COUNTՕɂĐ[x`
+//boundspVisibletransformsƓсBmatrixworld * view * project
+void RenderOccluders( OcclusionBuffer* pBuffer, const TransformStream& transforms, const BoundingVolumeStream& bounds,
+	const UINT8* pVisible, FXMMATRIX world, CXMMATRIX viewProject )
+{
+	const XMMATRIX matrix = world * viewProject;
+
+	//E̒S̐[xŎÔ̂I
+	//̕_̓rbĝ܂ܐƂĔׂ̂ŁA[xƈʒu1̃L[ɂ
+	pBuffer->candidate.clear();
+	for(UINT n = 0;n < transforms.count;n++)
+	{
+		if(pVisible[n])
+		{
+			const XMVECTOR center = XMVectorSet(bounds.centerX[n],bounds.centerY[n],bounds.centerZ[n],1.0f);
+			const float depth = max(XMVectorGetW(XMVector3Transform(center,matrix)),0.0f);
+			UINT depthBits;
+			memcpy(&depthBits,&depth,sizeof(depthBits));
+			pBuffer->candidate.push_back((static_cast<UINT64>(depthBits) << 32) | n);
+		}
+	}
+	pBuffer->occluderCount = min(static_cast<UINT>(pBuffer->candidate.size()),MAX_OCCLUDER_COUNT);
+	if(pBuffer->candidate.size() > pBuffer->occluderCount)
+	{
+		nth_element(pBuffer->candidate.begin(),pBuffer->candidate.begin() + pBuffer->occluderCount,pBuffer->candidate.end());
+	}
+
+	//_̓\tgEFAX^CU[ƓSIMD̒_ϊŎˉe
+	const UINT vertexCount = g_mesh.vertexCount;
+	for(UINT n = 0;n < pBuffer->occluderCount;n++)
+	{
+		SoftwareDrawConstant constant;
+		const UINT index = static_cast<UINT>(pBuffer->candidate[n] & 0xffffffff);
+		SetSoftwareDrawConstant(GetTransformMatrix(transforms,index),world,XMMatrixIdentity(),viewProject,&constant);
+		TransformSoftwareVertexStream(pBuffer->stream,0,vertexCount,constant,&pBuffer->vertex[static_cast<size_t>(n) * vertexCount]);
+	}
+
+	//ʏ̎Op`ɂ
+	//O̖ʂOɏo钸_͎̂ՕO(`Ȃɂ͌ʂSɂȂ)
+	pBuffer->triangle.clear();
+	for(UINT n = 0;n < pBuffer->occluderCount;n++)
+	{
+		const SoftwareVertex* pVertex = &pBuffer->vertex[static_cast<size_t>(n) * vertexCount];
+		for(int i = 0;i + 2 < g_mesh.indexCount;i += 3)
+		{
+			OcclusionTriangle triangle;
+			bool clipped = false;
+			for(int k = 0;k < 3;k++)
+			{
+				const XMFLOAT4& position = pVertex[g_mesh.indexArray[i + k]].position;
+				if(position.z < 0.0f || position.w <= 0.0f)
+				{
+					clipped = true;
+					break;
+				}
+				const float invW = 1.0f / position.w;
+				triangle.x[k] = (position.x * invW * 0.5f + 0.5f) * OCCLUSION_WIDTH;
+				triangle.y[k] = (0.5f - position.y * invW * 0.5f) * OCCLUSION_HEIGHT;
+				triangle.z[k] = position.z * invW;
+			}
+			if(clipped)
+			{
+				continue;
+			}
+
+			//bVȂ̂ŗʂ͕\ʂɉBBʏŎv肪\(FrontCounterClockwise = FALSE)
+			const float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+			if(area <= 0.0f)
+			{
+				continue;
+			}
+
+			//f̒S܂ޔ͈
+			triangle.minX = max(static_cast<int>(ceilf(min(triangle.x[0],min(triangle.x[1],triangle.x[2])) - 0.5f)),0);
+			triangle.minY = max(static_cast<int>(ceilf(min(triangle.y[0],min(triangle.y[1],triangle.y[2])) - 0.5f)),0);
+			triangle.maxX = min(static_cast<int>(floorf(max(triangle.x[0],max(triangle.x[1],triangle.x[2])) - 0.5f)),static_cast<int>(OCCLUSION_WIDTH) - 1);
+			triangle.maxY = min(static_cast<int>(floorf(max(triangle.y[0],max(triangle.y[1],triangle.y[2])) - 0.5f)),static_cast<int>(OCCLUSION_HEIGHT) - 1);
+			if(triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+			{
+				continue;
+			}
+			pBuffer->triangle.push_back(triangle);
+		}
+	}
+
+	if(IsRecordWorkerPoolRunning(&g_recordWorkers))
+	{
+		RunRecordWorkerTask(&g_recordWorkers,[pBuffer]( UINT workerIndex )
+		{
+			RasterizeOcclusionBand(pBuffer,workerIndex,g_recordThreadCount);
+			return true;
+		});
+	}
+	else
+	{
+		RasterizeOcclusionBand(pBuffer,0,1);
+	}
+}
+
+//^C̍spartCount̑тɕpartԖڂNAĎOp``AHiZ
+//Op`͕\̂̂ĂBfƂɍłO̐[xc
+void RasterizeOcclusionBand( OcclusionBuffer* pBuffer, UINT part, UINT partCount )
+{
+	const int beginY = static_cast<int>(OCCLUSION_TILE_COUNT_Y * part / partCount * OCCLUSION_TILE_SIZE);
+	const int endY = static_cast<int>(OCCLUSION_TILE_COUNT_Y * (part + 1) / partCount * OCCLUSION_TILE_SIZE);
+	if(beginY >= endY)
+	{
+		return;
+	}
+	float* pDepth = pBuffer->depth.data();
+	fill(pDepth + beginY * OCCLUSION_WIDTH,pDepth + endY * OCCLUSION_WIDTH,1.0f);
+
+	for(const OcclusionTriangle& triangle : pBuffer->triangle)
+	{
+		const int minY = max(triangle.minY,beginY);
+		const int maxY = min(triangle.maxY,endY - 1);
+		if(minY > maxY)
+		{
+			continue;
+		}
+
+		//ӊ֐ e = a * x + b * y + c(Ő)
+		float a[3];
+		float b[3];
+		float c[3];
+		for(int k = 0;k < 3;k++)
+		{
+			const int k1 = (k + 1) % 3;
+			const int k2 = (k + 2) % 3;
+			a[k] = triangle.y[k1] - triangle.y[k2];
+			b[k] = triangle.x[k2] - triangle.x[k1];
+			c[k] = triangle.x[k1] * triangle.y[k2] - triangle.x[k2] * triangle.y[k1];
+		}
+		const float invArea = 1.0f / (c[0] + c[1] + c[2]);
+		//[x͉ʏŐ`Ȃ̂ŕӊ֐Ɠ悤ɑ₷
+		const float depthA = (a[0] * triangle.z[0] + a[1] * triangle.z[1] + a[2] * triangle.z[2]) * invArea;
+		const float depthB = (b[0] * triangle.z[0] + b[1] * triangle.z[1] + b[2] * triangle.z[2]) * invArea;
+		const float depthC = (c[0] * triangle.z[0] + c[1] * triangle.z[1] + c[2] * triangle.z[2]) * invArea;
+
+		//sƂ3ӂ̓ɂȂ͈͂߁ÅԂ[x
+		for(int y = minY;y <= maxY;y++)
+		{
+			const float py = y + 0.5f;
+			float left = static_cast<float>(triangle.minX);
+			float right = static_cast<float>(triangle.maxX);
+			for(int k = 0;k < 3;k++)
+			{
+				//f̒S x + 0.5  a * (x + 0.5) + value >= 0 ɂȂ͈
+				const float value = b[k] * py + c[k];
+				if(a[k] > 0.0f)
+				{
+					left = max(left,ceilf(-value / a[k] - 0.5f));
+				}
+				else if(a[k] < 0.0f)
+				{
+					right = min(right,floorf(-value / a[k] - 0.5f));
+				}
+				else if(value < 0.0f)
+				{
+					right = left - 1.0f;
+				}
+			}
+
+			float* pRow = pDepth + y * OCCLUSION_WIDTH;
+			const float rowDepth = depthB * py + depthC + depthA * 0.5f;
+			for(int x = static_cast<int>(left);x <= static_cast<int>(right);x++)
+			{
+				pRow[x] = min(pRow[x],rowDepth + depthA * x);
+			}
+		}
+	}
+
+	//^CƂɍł̐[xc
+	for(int tileY = beginY / static_cast<int>(OCCLUSION_TILE_SIZE);tileY < endY / static_cast<int>(OCCLUSION_TILE_SIZE);tileY++)
+	{
+		for(UINT tileX = 0;tileX < OCCLUSION_TILE_COUNT_X;tileX++)
+		{
+			float maxDepth = 0.0f;
+			for(UINT y = 0;y < OCCLUSION_TILE_SIZE;y++)
+			{
+				const float* pRow = pDepth + (tileY * OCCLUSION_TILE_SIZE + y) * OCCLUSION_WIDTH + tileX * OCCLUSION_TILE_SIZE;
+				for(UINT x = 0;x < OCCLUSION_TILE_SIZE;x++)
+				{
+					maxDepth = max(maxDepth,pRow[x]);
+				}
+			}
+			pBuffer->tileMaxDepth[tileY * OCCLUSION_TILE_COUNT_X + tileX] = maxDepth;
+		}
+	}
+}
+
+//pVisible1̋EAABBʂɓeAS^CHiZ艜ɂ0ɂ
+//O̖ʂOɏop̂͌邱ƂɂBBĂԂ
+UINT CullOccludedVolumes( const OcclusionBuffer& buffer, const BoundingVolumeStream& bounds, FXMMATRIX matrix, UINT8* pVisible )
+{
+	UINT occludedCount = 0;
+	for(UINT n = 0;n < bounds.count;n++)
+	{
+		if(!pVisible[n])
+		{
+			continue;
+		}
+
+		float minX = FLT_MAX;
+		float minY = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float maxY = -FLT_MAX;
+		float minZ = FLT_MAX;
+		bool crossNear = false;
+		for(UINT corner = 0;corner < 8;corner++)
+		{
+			const XMVECTOR position = XMVector3Transform(XMVectorSet(
+				bounds.centerX[n] + ((corner & 1) ? bounds.extentX[n] : -bounds.extentX[n]),
+				bounds.centerY[n] + ((corner & 2) ? bounds.extentY[n] : -bounds.extentY[n]),
+				bounds.centerZ[n] + ((corner & 4) ? bounds.extentZ[n] : -bounds.extentZ[n]),1.0f),matrix);
+			XMFLOAT4 clip;
+			XMStoreFloat4(&clip,position);
+			if(clip.z < 0.0f || clip.w <= 0.0f)
+			{
+				crossNear = true;
+				break;
+			}
+			const float invW = 1.0f / clip.w;
+			const float x = (clip.x * invW * 0.5f + 0.5f) * OCCLUSION_WIDTH;
+			const float y = (0.5f - clip.y * invW * 0.5f) * OCCLUSION_HEIGHT;
+			minX = min(minX,x);
+			minY = min(minY,y);
+			maxX = max(maxX,x);
+			maxY = max(maxY,y);
+			minZ = min(minZ,clip.z * invW);
+		}
+		if(crossNear)
+		{
+			continue;
+		}
+
+		const int tileMinX = max(static_cast<int>(minX) / static_cast<int>(OCCLUSION_TILE_SIZE),0);
+		const int tileMinY = max(static_cast<int>(minY) / static_cast<int>(OCCLUSION_TILE_SIZE),0);
+		const int tileMaxX = min(static_cast<int>(maxX) / static_cast<int>(OCCLUSION_TILE_SIZE),static_cast<int>(OCCLUSION_TILE_COUNT_X) - 1);
+		const int tileMaxY = min(static_cast<int>(maxY) / static_cast<int>(OCCLUSION_TILE_SIZE),static_cast<int>(OCCLUSION_TILE_COUNT_Y) - 1);
+		bool occluded = true;
+		for(int tileY = tileMinY;tileY <= tileMaxY && occluded;tileY++)
+		{
+			for(int tileX = tileMinX;tileX <= tileMaxX;tileX++)
+			{
+				if(buffer.tileMaxDepth[tileY * OCCLUSION_TILE_COUNT_X + tileX] >= minZ)
+				{
+					occluded = false;
+					break;
+				}
+			}
+		}
+		if(occluded)
+		{
+			pVisible[n] = 0;
+			occludedCount++;
+		}
+	}
+	return occludedCount;
+}
+
+//ՕJȎxv
+//iqɕׂCX^X̊ԂႢ_ŌāABꂽƎԂo͂
+void BenchmarkOcclusionCulling( UINT instanceCount )
+{
+	const UINT LOOP_COUNT = 20;
+	if(g_occlusionBuffer.depth.empty())
+	{
+		return;
+	}
+
+	TransformStream transforms;
+	SetGridTransforms(&transforms,instanceCount);
+	BoundingVolumeStream bounds;
+	BuildInstanceBounds(transforms,g_meshBounds,&bounds);
+
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,1.0f,-10.0f,0.0f},{0.0f,1.0f,100.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(g_fov,1280.0f / 720.0f,1.0f,10000.0f);
+	const XMMATRIX viewProject = view * project;
+	XMFLOAT4 planes[6];
+	ExtractFrustumPlanes(viewProject,planes);
+	vector<UINT8> frustumVisible(instanceCount);
+	CullBoundingVolumes(bounds,0,instanceCount,planes,frustumVisible.data());
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LONGLONG renderTicks = 0;
+	LONGLONG testTicks = 0;
+	UINT occludedCount = 0;
+	vector<UINT8> visible;
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		visible = frustumVisible;
+		LARGE_INTEGER begin;
+		QueryPerformanceCounter(&begin);
+		RenderOccluders(&g_occlusionBuffer,transforms,bounds,visible.data(),XMMatrixIdentity(),viewProject);
+		LARGE_INTEGER middle;
+		QueryPerformanceCounter(&middle);
+		occludedCount = CullOccludedVolumes(g_occlusionBuffer,bounds,viewProject,visible.data());
+		LARGE_INTEGER end;
+		QueryPerformanceCounter(&end);
+		renderTicks += middle.QuadPart - begin.QuadPart;
+		testTicks += end.QuadPart - middle.QuadPart;
+	}
+
+	UINT frustumCount = 0;
+	for(UINT n = 0;n < instanceCount;n++)
+	{
+		frustumCount += frustumVisible[n];
+	}
+	const UINT threadCount = IsRecordWorkerPoolRunning(&g_recordWorkers) ? g_recordThreadCount : 1;
+	char text[256];
+	sprintf_s(text,"Occlusion culling: %u instances, %u in frustum, %u occluded, %u threads, occluders %.1f us, test %.1f us\n",
+		instanceCount,frustumCount,occludedCount,threadCount,
+		1000000.0 * renderTicks / frequency.QuadPart / LOOP_COUNT,1000000.0 * testTicks / frequency.QuadPart / LOOP_COUNT);
+	OutputDebugStringA(text);
+}
+
+//sNZVF[_[̌vZ̑xvA1sNZvZʂƔׂ
+//_Ƃɖ@Ɛ[̈ႤOp`̒AdSW炵Ȃ疄߂
+//Ϙåۂ߂̈Ⴂ1iK邱Ƃ͂̂ŁATOLERANCE𒴂鍷ƂfalseԂ
+bool BenchmarkPixelShading( UINT pixelCount )
+{
+	const UINT LOOP_COUNT = 10;
+	const UINT TOLERANCE = 1;
+
+	SoftwareTriangle triangle = {};
+	const XMFLOAT3 normal[3] = { { 0.0f, 1.0f, 0.0f }, { 0.7f, 0.0f, -0.7f }, { -0.6f, -0.3f, -0.74f } };
+	const float w[3] = { 2.0f, 7.0f, 30.0f };
+	for(UINT n = 0;n < 3;n++)
+	{
+		triangle.invW[n] = 1.0f / w[n];
+		triangle.normal[n] = XMFLOAT4(normal[n].x * triangle.invW[n],normal[n].y * triangle.invW[n],normal[n].z * triangle.invW[n],0.0f);
+		triangle.uv[n] = XMFLOAT2(n * 0.5f * triangle.invW[n],n * 0.25f * triangle.invW[n]);
+	}
+	vector<float> b0(pixelCount);
+	vector<float> b1(pixelCount);
+	vector<float> b2(pixelCount);
+	for(UINT n = 0;n < pixelCount;n++)
+	{
+		float u = (n % 1000) / 1000.0f;
+		float v = (n / 1000 % 1000) / 1000.0f;
+		if(u + v > 1.0f)
+		{
+			u = 1.0f - u;
+			v = 1.0f - v;
+		}
+		b0[n] = u;
+		b1[n] = v;
+		b2[n] = 1.0f - u - v;
+	}
+	vector<UINT32> output(pixelCount);
+	vector<UINT32> reference(pixelCount);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		SoftwarePixelBatch batch;
+		batch.count = 0;
+		for(UINT n = 0;n < pixelCount;n++)
+		{
+			batch.b0[batch.count] = b0[n];
+			batch.b1[batch.count] = b1[n];
+			batch.b2[batch.count] = b2[n];
+			batch.pColor[batch.count] = &output[n];
+			batch.count++;
+			if(batch.count == SOFTWARE_PIXEL_BATCH_SIZE)
+			{
+				ShadeSoftwarePixels(triangle,&batch);
+			}
+		}
+		if(batch.count > 0)
+		{
+			ShadeSoftwarePixels(triangle,&batch);
+		}
+	}
+	LARGE_INTEGER middle;
+	QueryPerformanceCounter(&middle);
+	for(UINT loop = 0;loop < LOOP_COUNT;loop++)
+	{
+		for(UINT n = 0;n < pixelCount;n++)
+		{
+			const float pixelW = 1.0f / (b0[n] * triangle.invW[0] + b1[n] * triangle.invW[1] + b2[n] * triangle.invW[2]);
+			const XMVECTOR pixelNormal = XMVectorScale(XMVectorAdd(XMVectorAdd(
+				XMVectorScale(XMLoadFloat4(&triangle.normal[0]),b0[n]),
+				XMVectorScale(XMLoadFloat4(&triangle.normal[1]),b1[n])),
+				XMVectorScale(XMLoadFloat4(&triangle.normal[2]),b2[n])),pixelW);
+			const XMVECTOR pixelUV = XMVectorScale(XMVectorAdd(XMVectorAdd(
+				XMVectorScale(XMLoadFloat2(&triangle.uv[0]),b0[n]),
+				XMVectorScale(XMLoadFloat2(&triangle.uv[1]),b1[n])),
+				XMVectorScale(XMLoadFloat2(&triangle.uv[2]),b2[n])),pixelW);
+			reference[n] = PackSoftwareColor(ShadeSoftwarePixel(triangle,pixelNormal,pixelUV));
+		}
+	}
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	UINT maxDifference = 0;
+	UINT differentCount = 0;
+	for(UINT n = 0;n < pixelCount;n++)
+	{
+		UINT difference = 0;
+		for(UINT shift = 0;shift < 32;shift += 8)
+		{
+			const int a = static_cast<int>((output[n] >> shift) & 0xff);
+			const int b = static_cast<int>((reference[n] >> shift) & 0xff);
+			difference = max(difference,static_cast<UINT>(abs(a - b)));
+		}
+		maxDifference = max(maxDifference,difference);
+		differentCount += difference > 0 ? 1 : 0;
+	}
+
+	const double toMs = 1000.0 / frequency.QuadPart / LOOP_COUNT;
+	char text[256];
+	sprintf_s(text,"Pixel shading: %u pixels, %.3f ms (1 pixel at a time %.3f ms), max difference %u, %u pixels differ\n",
+		pixelCount,(middle.QuadPart - begin.QuadPart) * toMs,(end.QuadPart - middle.QuadPart) * toMs,maxDifference,differentCount);
+	OutputDebugStringA(text);
+	if(maxDifference > TOLERANCE)
+	{
+		OutputDebugStringA("Pixel shading: difference from the reference exceeds the tolerance\n");
+		return false;
+	}
+	return true;
+}
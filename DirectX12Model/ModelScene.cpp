@@ -0,0 +1,317 @@
+#include "ModelScene.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+using namespace DirectX;
+using namespace std;
+
+SoftwareShading g_softwareShading = {};
+
+//bVt@Cǂݍ
+bool LoadMesh( const char* fileName, Mesh* pMesh )
+{
+	ifstream file(fileName,ios::binary);
+
+	if(!file.is_open())
+	{
+		return false;
+	}
+
+	file.read(reinterpret_cast<char*>(&pMesh->vertexCount),sizeof(int));
+	file.read(reinterpret_cast<char*>(&pMesh->indexCount),sizeof(int));
+	file.read(reinterpret_cast<char*>(&pMesh->subsetCount),sizeof(int));
+	file.read(reinterpret_cast<char*>(&pMesh->materialCount),sizeof(int));
+
+	pMesh->vertecies = new Vertex[pMesh->vertexCount];
+	pMesh->indexArray = new int[pMesh->indexCount];
+	pMesh->subset = new Subset[pMesh->subsetCount];
+
+	file.read(reinterpret_cast<char*>(pMesh->vertecies),sizeof(Vertex) * pMesh->vertexCount);
+	file.read(reinterpret_cast<char*>(pMesh->indexArray),sizeof(int) * pMesh->indexCount);
+	file.read(reinterpret_cast<char*>(pMesh->subset),sizeof(Subset) * pMesh->subsetCount);
+
+	pMesh->material = nullptr;
+	pMesh->textureName = nullptr;
+	if(pMesh->materialCount > 0)
+	{
+		pMesh->material = new Material[pMesh->materialCount];
+		pMesh->textureName = new string[pMesh->materialCount];
+		for(int i = 0;i < pMesh->materialCount;i++)
+		{
+			file.read(reinterpret_cast<char*>(pMesh->material[i].diffuse),sizeof(float) * 3);
+			file.read(reinterpret_cast<char*>(&pMesh->material[i].alpha),sizeof(float));
+			file.read(reinterpret_cast<char*>(pMesh->material[i].ambient),sizeof(float) * 3);
+			file.read(reinterpret_cast<char*>(pMesh->material[i].specular),sizeof(float) * 3);
+			file.read(reinterpret_cast<char*>(&pMesh->material[i].power),sizeof(float));
+			file.read(reinterpret_cast<char*>(pMesh->material[i].emmisive),sizeof(float) * 3);
+
+
+			int nameLength;
+			file.read(reinterpret_cast<char*>(&nameLength),sizeof(int));
+
+			char* textureName = new char[nameLength];
+			file.read(textureName,nameLength);
+			pMesh->textureName[i] = textureName;
+			delete[] textureName;
+
+			//Todo:eNX`ǂݍ݁H
+		}
+	}
+
+	file.close();
+
+	return true;
+}
+
+//LoadMesh()Ŋmۂ̂
+void DestroyMesh( Mesh* pMesh )
+{
+	delete[] pMesh->vertecies;
+	delete[] pMesh->indexArray;
+	delete[] pMesh->subset;
+	delete[] pMesh->material;
+	delete[] pMesh->textureName;
+	*pMesh = Mesh();
+}
+
+//iqɕׂCX^X̃[hs
+XMMATRIX GetGridInstanceWorld( uint32_t index, uint32_t columnCount )
+{
+	const float x = (static_cast<float>(index % columnCount) - (columnCount - 1) * 0.5f) * INSTANCE_SPACING;
+	const float z = static_cast<float>(index / columnCount) * INSTANCE_SPACING;
+	return XMMatrixTranslation(x,0.0f,z);
+}
+
+//bV̒_𐬕Ƃɕבւ
+void BuildSoftwareVertexStream( const Vertex* pVertex, uint32_t count, SoftwareVertexStream* pStream )
+{
+	ResizeSoftwareVertexStream(pStream,count);
+	for(uint32_t n = 0;n < count;n++)
+	{
+		SetSoftwareVertex(pStream,n,pVertex[n].position,pVertex[n].normal,pVertex[n].textureCoord);
+	}
+}
+
+//shader.hlslPSMainƓvZ
+//1sNZvZ(ShadeSoftwarePixels()̌ʂ̊mFɎg)
+XMVECTOR ShadeSoftwarePixel( const SoftwareTriangle& triangle, FXMVECTOR normal, FXMVECTOR uv )
+{
+	float p = XMVectorGetX(XMVector3Dot(normal,XMVectorNegate(XMLoadFloat3(&g_softwareShading.lightDirection))));
+	p = p * 0.2f + 0.8f;
+	p = p * p;
+	if(g_softwareShading.pMesh == nullptr || g_softwareShading.pMesh->material == nullptr)
+	{
+		return XMVectorReplicate(p);
+	}
+	const Material& material = g_softwareShading.pMesh->material[triangle.material];
+	return XMVectorScale(XMVectorSet(material.diffuse[0],material.diffuse[1],material.diffuse[2],1.0f),p);
+}
+
+//shader.hlslPSMainƓvZSOFTWARE_SIMD_WIDTHsNZsAF
+//@͏dSWŕԂA1/wŊăp[XyNeBu␳(eNX`͓ǂ܂Ȃ̂UV͎gȂ)
+void ShadeSoftwarePixels( const SoftwareTriangle& triangle, SoftwarePixelBatch* pBatch )
+{
+	//[̃[͍Ō̃sNZŖ߂(݂͂Ȃ)
+	const uint32_t count = pBatch->count;
+	const uint32_t paddedCount = (count + SOFTWARE_SIMD_WIDTH - 1) / SOFTWARE_SIMD_WIDTH * SOFTWARE_SIMD_WIDTH;
+	for(uint32_t n = count;n < paddedCount;n++)
+	{
+		pBatch->b0[n] = pBatch->b0[count - 1];
+		pBatch->b1[n] = pBatch->b1[count - 1];
+		pBatch->b2[n] = pBatch->b2[count - 1];
+	}
+
+	//}eA̐F͎Op`1(}eAƂ1)
+	const SoftwareFloat one = SoftwareSet(1.0f);
+	SoftwareFloat diffuse[4] = { one, one, one, one };
+	if(g_softwareShading.pMesh != nullptr && g_softwareShading.pMesh->material != nullptr)
+	{
+		const Material& material = g_softwareShading.pMesh->material[triangle.material];
+		for(uint32_t channel = 0;channel < 3;channel++)
+		{
+			diffuse[channel] = SoftwareSet(material.diffuse[channel]);
+		}
+	}
+	const SoftwareFloat scale = SoftwareSet(0.2f);
+	const SoftwareFloat bias = SoftwareSet(0.8f);
+	const SoftwareFloat lightX = SoftwareSet(-g_softwareShading.lightDirection.x);
+	const SoftwareFloat lightY = SoftwareSet(-g_softwareShading.lightDirection.y);
+	const SoftwareFloat lightZ = SoftwareSet(-g_softwareShading.lightDirection.z);
+	for(uint32_t base = 0;base < count;base += SOFTWARE_SIMD_WIDTH)
+	{
+		const SoftwareFloat b0 = SoftwareLoad(&pBatch->b0[base]);
+		const SoftwareFloat b1 = SoftwareLoad(&pBatch->b1[base]);
+		const SoftwareFloat b2 = SoftwareLoad(&pBatch->b2[base]);
+		const SoftwareFloat w = SoftwareDiv(one,InterpolateSoftware(b0,b1,b2,triangle.invW[0],triangle.invW[1],triangle.invW[2]));
+		const SoftwareFloat normalX = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.normal[0].x,triangle.normal[1].x,triangle.normal[2].x),w);
+		const SoftwareFloat normalY = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.normal[0].y,triangle.normal[1].y,triangle.normal[2].y),w);
+		const SoftwareFloat normalZ = SoftwareMul(InterpolateSoftware(b0,b1,b2,triangle.normal[0].z,triangle.normal[1].z,triangle.normal[2].z),w);
+
+		//p = dot(normal, -light.xyz) * 0.2 + 0.8Ap * p
+		SoftwareFloat p = SoftwareMul(normalX,lightX);
+		p = SoftwareMulAdd(normalY,lightY,p);
+		p = SoftwareMulAdd(normalZ,lightZ,p);
+		p = SoftwareMulAdd(p,scale,bias);
+		p = SoftwareMul(p,p);
+
+		SoftwareFloat color[4];
+		for(uint32_t channel = 0;channel < 4;channel++)
+		{
+			color[channel] = SoftwareMul(diffuse[channel],p);
+		}
+		StoreSoftwareColors(color,&pBatch->pColor[base],min(SOFTWARE_SIMD_WIDTH,count - base));
+	}
+	pBatch->count = 0;
+}
+
+//shader.hlslVSMainƓvZŒ_ϊ(1_Aōs|)
+//TransformSoftwareVertexStream()̌ʂ̊mFɎg
+//o͂̓CX^XƂɃbV̒_ׂ̂ŁAfirstcount͈͂̒̔
+//POSITIONNORMAL3vfȂ̂w1Ƃēǂ܂
+void TransformSoftwareVertices( const Mesh& mesh, const XMFLOAT4X4* pInstance, uint32_t first, uint32_t count,
+	FXMMATRIX world, CXMMATRIX view, CXMMATRIX project, SoftwareVertex* pOutput )
+{
+	for(uint32_t n = first;n < first + count;n++)
+	{
+		const Vertex& vertex = mesh.vertecies[n % mesh.vertexCount];
+		const XMMATRIX instanceWorld = XMLoadFloat4x4(&pInstance[n / mesh.vertexCount]);
+
+		XMVECTOR position = XMVectorSet(vertex.position[0],vertex.position[1],vertex.position[2],1.0f);
+		position = XMVector4Transform(position,instanceWorld);
+		position = XMVector4Transform(position,world);
+		position = XMVector4Transform(position,view);
+		position = XMVector4Transform(position,project);
+		XMVECTOR normal = XMVector3TransformNormal(XMVectorSet(vertex.normal[0],vertex.normal[1],vertex.normal[2],0.0f),instanceWorld);
+		normal = XMVector4Transform(XMVector4Normalize(XMVectorSetW(normal,1.0f)),world);
+
+		XMStoreFloat4(&pOutput[n].position,position);
+		XMStoreFloat4(&pOutput[n].normal,normal);
+		pOutput[n].uv = XMFLOAT2(vertex.textureCoord[0],vertex.textureCoord[1]);
+	}
+}
+
+//EBhEƃfoCX炸CPUŕ`悷
+//Update()Ɠ悤ɉ]ȂframeCountt[`悵AԂo͂čŌ̃t[headless.bmpɕۑ
+//CX^XinstanceCountiqɕׂ(SetGridTransforms()Ɠzu)
+//ʂ͕Wo͂ɁAs̗R͕WG[o͂ɏ
+bool RunModelHeadless( const char* meshFileName, uint32_t frameCount, uint32_t instanceCount, float fov )
+{
+	const uint32_t WIDTH = 1280;
+	const uint32_t HEIGHT = 720;
+	if(frameCount == 0)
+	{
+		frameCount = 300;
+	}
+	instanceCount = max(instanceCount,1u);
+
+	Mesh mesh = {};
+	if(!LoadMesh(meshFileName,&mesh))
+	{
+		fprintf(stderr,"Headless: failed to load %s\n",meshFileName);
+		return false;
+	}
+	SoftwareRenderer renderer;
+	const uint32_t threadCount = min(max(thread::hardware_concurrency(),1u),MAX_SOFTWARE_THREAD_COUNT);
+	if(!InitSoftwareRenderer(&renderer,WIDTH,HEIGHT,threadCount,true,ShadeSoftwarePixels))
+	{
+		fprintf(stderr,"Headless: failed to initialize the software renderer\n");
+		DestroyMesh(&mesh);
+		return false;
+	}
+
+	const uint32_t columnCount = static_cast<uint32_t>(ceilf(sqrtf(static_cast<float>(instanceCount))));
+	vector<XMFLOAT4X4> instance(instanceCount);
+	for(uint32_t n = 0;n < instanceCount;n++)
+	{
+		XMStoreFloat4x4(&instance[n],GetGridInstanceWorld(n,columnCount));
+	}
+
+	//SCX^X̃TuZbg1̎Op`Xgɂ܂Ƃ߂
+	vector<uint32_t> index;
+	vector<uint32_t> material;
+	for(uint32_t n = 0;n < instanceCount;n++)
+	{
+		for(int i = 0;i < mesh.subsetCount;i++)
+		{
+			const Subset& subset = mesh.subset[i];
+			for(int k = 0;k + 2 < subset.vertexCount;k += 3)
+			{
+				for(int j = 0;j < 3;j++)
+				{
+					index.push_back(n * mesh.vertexCount + mesh.indexArray[subset.vertexStart + k + j]);
+				}
+				material.push_back(subset.mat_index);
+			}
+		}
+	}
+	const uint32_t meshVertexCount = static_cast<uint32_t>(mesh.vertexCount);
+	vector<SoftwareVertex> vertex(static_cast<size_t>(instanceCount) * meshVertexCount);
+	vector<XMFLOAT4X4> instanceWorldViewProject(instanceCount);
+	SoftwareVertexStream stream;
+	BuildSoftwareVertexStream(mesh.vertecies,meshVertexCount,&stream);
+
+	g_softwareShading.pMesh = &mesh;
+	g_softwareShading.lightDirection = XMFLOAT3(0.0f,1.0f,1.0f);
+	const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+	chrono::steady_clock::duration vertexTime = chrono::steady_clock::duration::zero();
+	const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+
+	float angle = 0.0f;
+	for(uint32_t frame = 0;frame < frameCount;frame++)
+	{
+		angle += 0.01f;
+		const XMMATRIX world = XMMatrixRotationY(angle);
+		const XMMATRIX view = XMMatrixLookAtLH({0.0f,3.0f * cosf(angle),-5.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+		const XMMATRIX project = XMMatrixPerspectiveFovLH(fov,static_cast<float>(WIDTH) / HEIGHT,1.0f,10000.0f);
+
+		ClearSoftwareRenderer(&renderer,clearColor);
+
+		const chrono::steady_clock::time_point vertexBegin = chrono::steady_clock::now();
+		//CX^X̍sɂ̓t[̍ŏɂ܂Ƃ߂worldAviewAproject|Ă
+		const XMMATRIX worldViewProject = world * view * project;
+		for(uint32_t n = 0;n < instanceCount;n++)
+		{
+			XMStoreFloat4x4(&instanceWorldViewProject[n],XMLoadFloat4x4(&instance[n]) * worldViewProject);
+		}
+		//CX^XƂ̕`𒸓_͈̔͂ŕăWuɂ
+		const uint32_t chunkCount = (meshVertexCount + SOFTWARE_VERTEX_JOB_SIZE - 1) / SOFTWARE_VERTEX_JOB_SIZE;
+		RunSoftwareJobs(&renderer,instanceCount * chunkCount,[&]( uint32_t jobIndex )
+		{
+			const uint32_t instanceIndex = jobIndex / chunkCount;
+			const uint32_t first = (jobIndex % chunkCount) * SOFTWARE_VERTEX_JOB_SIZE;
+			SoftwareDrawConstant constant;
+			constant.worldViewProject = instanceWorldViewProject[instanceIndex];
+			constant.instanceNormal = instance[instanceIndex];
+			XMStoreFloat4x4(&constant.world,world);
+			TransformSoftwareVertexStream(stream,first,min(SOFTWARE_VERTEX_JOB_SIZE,meshVertexCount - first),constant,
+				vertex.data() + static_cast<size_t>(instanceIndex) * meshVertexCount);
+		});
+		vertexTime += chrono::steady_clock::now() - vertexBegin;
+
+		DrawSoftwareTriangles(&renderer,vertex.data(),index.data(),material.data(),static_cast<uint32_t>(material.size()));
+	}
+
+	const chrono::steady_clock::duration totalTime = chrono::steady_clock::now() - begin;
+	typedef chrono::duration<double,milli> Milliseconds;
+	printf("Headless: %u frames, %u instances, %u threads, %.3f ms/frame (vertex %.3f, setup %.3f, raster %.3f)\n",
+		frameCount,instanceCount,renderer.threadCount,Milliseconds(totalTime).count() / frameCount,
+		Milliseconds(vertexTime).count() / frameCount,Milliseconds(renderer.setupTime).count() / frameCount,
+		Milliseconds(renderer.rasterTime).count() / frameCount);
+
+	const bool result = SaveSoftwareRenderTarget(&renderer,"headless.bmp");
+	DestroySoftwareRenderer(&renderer);
+	g_softwareShading.pMesh = nullptr;
+	DestroyMesh(&mesh);
+	if(!result)
+	{
+		fprintf(stderr,"Headless: failed to save headless.bmp\n");
+	}
+	return result;
+}
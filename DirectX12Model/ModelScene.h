@@ -0,0 +1,63 @@
+#pragma once
+
+//DirectX12Model̃V[(bV̓ǂݍ݁AVF[_[ƓvZAwbhX̕`)
+//D3D12Win32ɂ͈ˑȂ̂ŁAWindowsȊOłHeadlessMain.cpprhł
+
+#include "SoftwareScene.h"
+#include "IndirectArguments.h"
+
+#include <cstdint>
+#include <string>
+
+struct Vertex
+{
+	float position[3];
+	float normal[3];
+	float textureCoord[2];
+};
+
+//}eA1StructuredBufferɋl߂Ċi[A`悲ƂɃ[g萔̃CfbNXŎQƂ
+struct Material
+{
+	float diffuse[3];
+	float alpha;
+	float ambient[3];
+	float specular[3];
+	float power;
+	float emmisive[3];
+};
+
+struct Mesh
+{
+	int vertexCount;
+	Vertex* vertecies;
+	int indexCount;
+	int* indexArray;
+	int subsetCount;
+	Subset* subset;
+	int materialCount;
+	Material* material;
+	std::string* textureName;
+};
+
+const float INSTANCE_SPACING = 3.0f;
+
+//ShadeSoftwarePixels()ǂރV[̒l
+//sNZVF[_[͊֐̃|C^œn̂ŁA`̑OɂɓĂ
+struct SoftwareShading
+{
+	const Mesh* pMesh;					//}eA̐F(nullptrȂ1)
+	DirectX::XMFLOAT3 lightDirection;
+};
+
+extern SoftwareShading g_softwareShading;
+
+bool LoadMesh( const char* fileName, Mesh* pMesh );
+void DestroyMesh( Mesh* pMesh );
+DirectX::XMMATRIX GetGridInstanceWorld( uint32_t index, uint32_t columnCount );
+void BuildSoftwareVertexStream( const Vertex* pVertex, uint32_t count, SoftwareVertexStream* pStream );
+DirectX::XMVECTOR ShadeSoftwarePixel( const SoftwareTriangle& triangle, DirectX::FXMVECTOR normal, DirectX::FXMVECTOR uv );
+void ShadeSoftwarePixels( const SoftwareTriangle& triangle, SoftwarePixelBatch* pBatch );
+void TransformSoftwareVertices( const Mesh& mesh, const DirectX::XMFLOAT4X4* pInstance, uint32_t first, uint32_t count,
+	DirectX::FXMMATRIX world, DirectX::CXMMATRIX view, DirectX::CXMMATRIX project, SoftwareVertex* pOutput );
+bool RunModelHeadless( const char* meshFileName, uint32_t frameCount, uint32_t instanceCount, float fov );
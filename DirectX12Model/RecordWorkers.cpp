@@ -0,0 +1,199 @@
+#include "RecordWorkers.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void RecordWorkerMain( RecordWorkerPool* pPool, uint32_t workerIndex );
+
+//drawCount̕`threadCountȉ̘A͈͂ɕ
+//e͈͂minDrawsPerJobȏɂȂ悤ɂA`悪΃WuȂ
+void PartitionDraws( uint32_t drawCount, uint32_t threadCount, uint32_t minDrawsPerJob, vector<RecordJob>* pJobs )
+{
+	pJobs->clear();
+	if(drawCount == 0)
+	{
+		return;
+	}
+
+	uint32_t jobCount = (minDrawsPerJob > 0) ? drawCount / minDrawsPerJob : drawCount;
+	jobCount = min(max(jobCount,1u),max(threadCount,1u));
+
+	//]͑ÕWu1z
+	const uint32_t baseCount = drawCount / jobCount;
+	const uint32_t remainder = drawCount % jobCount;
+	uint32_t first = 0;
+	for(uint32_t n = 0;n < jobCount;n++)
+	{
+		RecordJob job;
+		job.first = first;
+		job.count = baseCount + ((n < remainder) ? 1 : 0);
+		pJobs->push_back(job);
+		first += job.count;
+	}
+}
+
+//w肵͈͂̕`R}hXgɋL^
+//R}hXgԂŏԂ͈pȂ̂ŁAXgƂɑSĐݒ肵
+bool RecordDrawRange( RecordCommandList* pCommandList, uint32_t workerIndex, const RecordJob& job )
+{
+	if(!pCommandList->Reset())
+	{
+		return false;
+	}
+	pCommandList->SetState();
+	pCommandList->RecordDraws(workerIndex,job);
+	return pCommandList->Close();
+}
+
+//L^Xbh쐬
+//1Ȃ烁CXbhŋL^̂ōȂ
+void CreateRecordWorkerPool( RecordWorkerPool* pPool, uint32_t threadCount )
+{
+	pPool->threadCount = min(max(threadCount,1u),MAX_RECORD_THREAD_COUNT);
+	pPool->generation = 0;
+	pPool->remaining = 0;
+	pPool->failed = false;
+	pPool->quit = false;
+	if(pPool->threadCount > 1)
+	{
+		for(uint32_t n = 0;n < pPool->threadCount;n++)
+		{
+			pPool->worker[n] = thread(RecordWorkerMain,pPool,n);
+		}
+	}
+}
+
+//L^XbhI
+void DestroyRecordWorkerPool( RecordWorkerPool* pPool )
+{
+	{
+		lock_guard<mutex> lock(pPool->mutex);
+		pPool->quit = true;
+	}
+	pPool->start.notify_all();
+
+	for(uint32_t n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+	{
+		if(pPool->worker[n].joinable())
+		{
+			pPool->worker[n].join();
+		}
+	}
+	pPool->task = nullptr;
+}
+
+//L^Xbh邩(ΕS鏈̓CXbhōs)
+bool IsRecordWorkerPoolRunning( const RecordWorkerPool* pPool )
+{
+	return pPool->worker[0].joinable();
+}
+
+//L^Xbh̏
+//generationiނтɋNāA̔ԍtaskĂ
+void RecordWorkerMain( RecordWorkerPool* pPool, uint32_t workerIndex )
+{
+	uint64_t generation = 0;
+	while(true)
+	{
+		{
+			unique_lock<mutex> lock(pPool->mutex);
+			pPool->start.wait(lock,[&](){ return pPool->quit || pPool->generation != generation; });
+			if(pPool->quit)
+			{
+				return;
+			}
+			generation = pPool->generation;
+		}
+
+		//task͑SI܂ŕςȂ
+		const bool result = pPool->task(workerIndex);
+
+		bool done = false;
+		{
+			lock_guard<mutex> lock(pPool->mutex);
+			if(!result)
+			{
+				pPool->failed = true;
+			}
+			pPool->remaining--;
+			done = (pPool->remaining == 0);
+		}
+		if(done)
+		{
+			pPool->done.notify_one();
+		}
+	}
+}
+
+//L^XbhNtask𕪒S
+//Xbh΂ŃCXbhĂ
+void BeginRecordWorkerTask( RecordWorkerPool* pPool, function<bool( uint32_t workerIndex )> task )
+{
+	if(!IsRecordWorkerPoolRunning(pPool))
+	{
+		pPool->failed = !task(0);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(pPool->mutex);
+		pPool->task = task;
+		pPool->remaining = pPool->threadCount;
+		pPool->failed = false;
+		pPool->generation++;
+	}
+	pPool->start.notify_all();
+}
+
+//SI܂ő҂AsXbhtrueԂ
+bool EndRecordWorkerTask( RecordWorkerPool* pPool )
+{
+	unique_lock<mutex> lock(pPool->mutex);
+	pPool->done.wait(lock,[pPool](){ return pPool->remaining == 0; });
+	return !pPool->failed;
+}
+
+//L^Xbhtask𕪒SāASI܂ő҂
+bool RunRecordWorkerTask( RecordWorkerPool* pPool, function<bool( uint32_t workerIndex )> task )
+{
+	BeginRecordWorkerTask(pPool,task);
+	return EndRecordWorkerTask(pPool);
+}
+
+//`L^Xbh̐ȉ̘A͈͂ɕāAppCommandList[Wu̔ԍ]ւ̋L^n߂
+//Wu1ȂEndRecordDraws()ŃCXbhL^
+//L^ppCommandList*pJobsύXȂ
+void BeginRecordDraws( RecordWorkerPool* pPool, uint32_t drawCount, RecordCommandList* const* ppCommandList, vector<RecordJob>* pJobs )
+{
+	PartitionDraws(drawCount,pPool->threadCount,MIN_DRAWS_PER_RECORD_JOB,pJobs);
+	if(pJobs->size() <= 1)
+	{
+		return;
+	}
+
+	const vector<RecordJob>* pRecordJobs = pJobs;
+	BeginRecordWorkerTask(pPool,[ppCommandList,pRecordJobs]( uint32_t workerIndex )
+	{
+		//WuXbh菭ȂƂ͉Ȃ
+		if(workerIndex >= pRecordJobs->size())
+		{
+			return true;
+		}
+		return RecordDrawRange(ppCommandList[workerIndex],workerIndex,(*pRecordJobs)[workerIndex]);
+	});
+}
+
+//SẴWűL^I܂ő҂
+bool EndRecordDraws( RecordWorkerPool* pPool, RecordCommandList* const* ppCommandList, const vector<RecordJob>& jobs )
+{
+	if(jobs.size() > 1)
+	{
+		return EndRecordWorkerTask(pPool);
+	}
+	if(!jobs.empty())
+	{
+		return RecordDrawRange(ppCommandList[0],0,jobs[0]);
+	}
+	return true;
+}
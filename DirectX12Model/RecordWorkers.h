@@ -0,0 +1,64 @@
+#pragma once
+
+//R}hXg̕L^
+//`A͈͂ɕċL^XbhƂ̃R}hXgɋL^AWȕɎs
+//D3D12Win32ɂ͈ˑAR}hXgRecordCommandListʂĈ(eXgł̓bNg)
+//L^Xbh͕`̋L^̂قɁA[hs̍Ȃǂ̕Sɂg
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//R}hXgɋL^Xbh̍ő吔
+const uint32_t MAX_RECORD_THREAD_COUNT = 8;
+//1̃WuɊ蓖Ăŏ̕`搔(ȂƃXgƂ̏Ԑݒ̕dȂ)
+const uint32_t MIN_DRAWS_PER_RECORD_JOB = 64;
+
+//Xbh1L^`͈̔
+//`揇ۂߘA͈͂ɕAWȕExecuteCommandLists֓n
+struct RecordJob
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+//L^̃R}hXg
+//D3D12ł̓XbhƂ̃R}hAP[^ƃR}hXg
+struct RecordCommandList
+{
+	virtual ~RecordCommandList() {}
+	virtual bool Reset() = 0;			//̃t[̃AP[^ŋL^n߂
+	virtual void SetState() = 0;		//R}hXgԂŏԂ͈pȂ̂ŁA`ɕKvȏԂSĐݒ肷
+	virtual void RecordDraws( uint32_t workerIndex, const RecordJob& job ) = 0;
+	virtual bool Close() = 0;
+};
+
+//L^Xbh
+//BeginRecordWorkerTask()őSNtask𕪒SAEndRecordWorkerTask()őSÎ҂
+struct RecordWorkerPool
+{
+	uint32_t threadCount;		//S鐔(XbhȂƂ1)
+	std::thread worker[MAX_RECORD_THREAD_COUNT];
+	std::mutex mutex;
+	std::condition_variable start;
+	std::condition_variable done;
+	uint64_t generation;		//Nтɐi߂
+	uint32_t remaining;			//܂IĂȂXbh̐
+	bool failed;
+	bool quit;
+	std::function<bool( uint32_t workerIndex )> task;
+};
+
+void PartitionDraws( uint32_t drawCount, uint32_t threadCount, uint32_t minDrawsPerJob, std::vector<RecordJob>* pJobs );
+bool RecordDrawRange( RecordCommandList* pCommandList, uint32_t workerIndex, const RecordJob& job );
+void CreateRecordWorkerPool( RecordWorkerPool* pPool, uint32_t threadCount );
+void DestroyRecordWorkerPool( RecordWorkerPool* pPool );
+bool IsRecordWorkerPoolRunning( const RecordWorkerPool* pPool );
+void BeginRecordWorkerTask( RecordWorkerPool* pPool, std::function<bool( uint32_t workerIndex )> task );
+bool EndRecordWorkerTask( RecordWorkerPool* pPool );
+bool RunRecordWorkerTask( RecordWorkerPool* pPool, std::function<bool( uint32_t workerIndex )> task );
+void BeginRecordDraws( RecordWorkerPool* pPool, uint32_t drawCount, RecordCommandList* const* ppCommandList, std::vector<RecordJob>* pJobs );
+bool EndRecordDraws( RecordWorkerPool* pPool, RecordCommandList* const* ppCommandList, const std::vector<RecordJob>& jobs );
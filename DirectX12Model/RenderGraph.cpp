@@ -0,0 +1,475 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void BuildRenderGraphBarriers( RenderGraph* pGraph );
+
+//Õ\[XOtɓo^
+//initialState̓t[Jn̏ԁAfinalState̓t[Iɖ߂
+uint32_t AddRenderGraphImport( RenderGraph* pGraph, const char* name, RenderGraphState initialState, RenderGraphState finalState )
+{
+	RenderGraphResource resource = {};
+	resource.name = name;
+	resource.imported = true;
+	resource.initialState = initialState;
+	resource.finalState = finalState;
+	resource.firstPass = RENDER_GRAPH_INVALID;
+	resource.lastPass = RENDER_GRAPH_INVALID;
+	pGraph->resource.push_back(resource);
+	return static_cast<uint32_t>(pGraph->resource.size() - 1);
+}
+
+//vꎞ\[Xo^
+//RpC͂̒lĝŁAfoCXŃOtgݗĂ
+uint32_t AddRenderGraphTransient( RenderGraph* pGraph, const char* name, uint64_t size, uint64_t alignment )
+{
+	RenderGraphResource resource = {};
+	resource.name = name;
+	resource.imported = false;
+	resource.size = size;
+	resource.alignment = alignment;
+	resource.firstPass = RENDER_GRAPH_INVALID;
+	resource.lastPass = RENDER_GRAPH_INVALID;
+	pGraph->resource.push_back(resource);
+	return static_cast<uint32_t>(pGraph->resource.size() - 1);
+}
+
+//pXǉ(L^鏈͌ĂяopX̔ԍŎ)
+uint32_t AddRenderGraphPass( RenderGraph* pGraph, const char* name )
+{
+	RenderGraphPass pass;
+	pass.name = name;
+	pass.culled = false;
+	pGraph->pass.push_back(pass);
+	return static_cast<uint32_t>(pGraph->pass.size() - 1);
+}
+
+void RenderGraphRead( RenderGraph* pGraph, uint32_t pass, uint32_t resource, RenderGraphState state )
+{
+	RenderGraphAccess access = { resource, state, false };
+	pGraph->pass[pass].access.push_back(access);
+}
+
+void RenderGraphWrite( RenderGraph* pGraph, uint32_t pass, uint32_t resource, RenderGraphState state )
+{
+	RenderGraphAccess access = { resource, state, true };
+	pGraph->pass[pass].access.push_back(access);
+}
+
+//ǂݍݐp̏Ԃǂ(ǂݍݓmȂԂ܂Ƃ߂)
+bool IsReadOnlyRenderGraphState( RenderGraphState state )
+{
+	const RenderGraphState writeStates =
+		RENDER_GRAPH_STATE_RENDER_TARGET |
+		RENDER_GRAPH_STATE_UNORDERED_ACCESS |
+		RENDER_GRAPH_STATE_DEPTH_WRITE |
+		RENDER_GRAPH_STATE_STREAM_OUT |
+		RENDER_GRAPH_STATE_COPY_DEST |
+		RENDER_GRAPH_STATE_RESOLVE_DEST;
+	return state != RENDER_GRAPH_STATE_COMMON && (state & writeStates) == 0;
+}
+
+//OtRpC
+//pX̏Aꎞ\[X̔zuAoǍvZs
+void CompileRenderGraph( RenderGraph* pGraph )
+{
+	const uint32_t resourceCount = static_cast<uint32_t>(pGraph->resource.size());
+	const uint32_t passCount = static_cast<uint32_t>(pGraph->pass.size());
+
+	//̃pX猩ĂAO\[Xœǂ܂郊\[XɏރpXc
+	vector<bool> needed(resourceCount,false);
+	pGraph->culledPassCount = 0;
+	for(uint32_t p = passCount;p-- > 0;)
+	{
+		RenderGraphPass* pPass = &pGraph->pass[p];
+		bool used = false;
+		for(const RenderGraphAccess& access : pPass->access)
+		{
+			if(access.write && (pGraph->resource[access.resource].imported || needed[access.resource]))
+			{
+				used = true;
+			}
+		}
+		pPass->culled = !used;
+		if(pPass->culled)
+		{
+			pGraph->culledPassCount++;
+			continue;
+		}
+
+		//񂾓e͂̃pXOł͕svAǂݍނ̂͑ÕpXŕKv
+		for(const RenderGraphAccess& access : pPass->access)
+		{
+			if(access.write && !pGraph->resource[access.resource].imported)
+			{
+				needed[access.resource] = false;
+			}
+		}
+		for(const RenderGraphAccess& access : pPass->access)
+		{
+			if(!access.write)
+			{
+				needed[access.resource] = true;
+			}
+		}
+	}
+
+	//cpX烊\[X̎߂
+	for(uint32_t r = 0;r < resourceCount;r++)
+	{
+		pGraph->resource[r].firstPass = RENDER_GRAPH_INVALID;
+		pGraph->resource[r].lastPass = RENDER_GRAPH_INVALID;
+		pGraph->resource[r].aliased = false;
+	}
+	for(uint32_t p = 0;p < passCount;p++)
+	{
+		if(pGraph->pass[p].culled)
+		{
+			continue;
+		}
+		for(const RenderGraphAccess& access : pGraph->pass[p].access)
+		{
+			RenderGraphResource* pResource = &pGraph->resource[access.resource];
+			if(pResource->firstPass == RENDER_GRAPH_INVALID)
+			{
+				pResource->firstPass = p;
+				//ꎞ\[X͍ŏɎgԂō쐬
+				if(!pResource->imported)
+				{
+					pResource->initialState = access.state;
+				}
+			}
+			pResource->lastPass = p;
+		}
+	}
+
+	//ꎞ\[X傫Ƀq[v֔zu
+	//dȂ̂Ƃ̓dȂȂʒûAłOɒu
+	vector<uint32_t> transient;
+	for(uint32_t r = 0;r < resourceCount;r++)
+	{
+		if(!pGraph->resource[r].imported && pGraph->resource[r].firstPass != RENDER_GRAPH_INVALID)
+		{
+			transient.push_back(r);
+		}
+	}
+	sort(transient.begin(),transient.end(),[pGraph](uint32_t a,uint32_t b)
+	{
+		return pGraph->resource[a].size > pGraph->resource[b].size;
+	});
+
+	pGraph->transientHeapSize = 0;
+	pGraph->transientRequestedSize = 0;
+	vector<uint32_t> placed;
+	for(uint32_t r : transient)
+	{
+		RenderGraphResource* pResource = &pGraph->resource[r];
+		pGraph->transientRequestedSize += pResource->size;
+
+		//dȂzuς݂̃\[XItZbgɕׂ
+		vector<uint32_t> overlap;
+		for(uint32_t other : placed)
+		{
+			const RenderGraphResource& o = pGraph->resource[other];
+			if(o.firstPass <= pResource->lastPass && pResource->firstPass <= o.lastPass)
+			{
+				overlap.push_back(other);
+			}
+		}
+		sort(overlap.begin(),overlap.end(),[pGraph](uint32_t a,uint32_t b)
+		{
+			return pGraph->resource[a].heapOffset < pGraph->resource[b].heapOffset;
+		});
+
+		//Ԃɓ邩ɒׂ
+		uint64_t offset = 0;
+		for(uint32_t other : overlap)
+		{
+			const RenderGraphResource& o = pGraph->resource[other];
+			if(offset + pResource->size <= o.heapOffset)
+			{
+				break;
+			}
+			offset = max(offset,(o.heapOffset + o.size + pResource->alignment - 1) & ~(pResource->alignment - 1));
+		}
+		pResource->heapOffset = offset;
+		pGraph->transientHeapSize = max(pGraph->transientHeapSize,offset + pResource->size);
+
+		//dȂȂ\[XƃdȂ΃GCAVO
+		for(uint32_t other : placed)
+		{
+			RenderGraphResource* pOther = &pGraph->resource[other];
+			if(pOther->heapOffset < offset + pResource->size && offset < pOther->heapOffset + pOther->size)
+			{
+				pResource->aliased = true;
+				pOther->aliased = true;
+			}
+		}
+		placed.push_back(r);
+	}
+
+	//oAvZ
+	//ꎞ\[X̓t[̏ȈԂ̂܂܎̃t[}̂ŁA
+	//ȈԂ쐬̏ԂƈႦ΁AJn̏ԂƂČvZ
+	//(LĂ郊\[X͎gĂȂԂɑJڂȂ)
+	for(uint32_t n = 0;n < 2;n++)
+	{
+		BuildRenderGraphBarriers(pGraph);
+
+		bool changed = false;
+		for(RenderGraphResource& resource : pGraph->resource)
+		{
+			if(!resource.imported && resource.firstPass != RENDER_GRAPH_INVALID && resource.finalState != resource.initialState)
+			{
+				resource.initialState = resource.finalState;
+				changed = true;
+			}
+		}
+		if(!changed)
+		{
+			break;
+		}
+	}
+}
+
+//pXƂɕKvȏԑJڂ܂Ƃ߂
+void BuildRenderGraphBarriers( RenderGraph* pGraph )
+{
+	const uint32_t resourceCount = static_cast<uint32_t>(pGraph->resource.size());
+	const uint32_t passCount = static_cast<uint32_t>(pGraph->pass.size());
+
+	vector<RenderGraphState> state(resourceCount);
+	for(uint32_t r = 0;r < resourceCount;r++)
+	{
+		state[r] = pGraph->resource[r].initialState;
+	}
+	pGraph->barrierCount = 0;
+	for(uint32_t p = 0;p < passCount;p++)
+	{
+		RenderGraphPass* pPass = &pGraph->pass[p];
+		pPass->barrier.clear();
+		if(pPass->culled)
+		{
+			continue;
+		}
+
+		//pXŕǂނƂ͏Ԃ܂Ƃ߁A݂΂D
+		vector<RenderGraphAccess> merged;
+		for(const RenderGraphAccess& access : pPass->access)
+		{
+			bool found = false;
+			for(RenderGraphAccess& m : merged)
+			{
+				if(m.resource != access.resource)
+				{
+					continue;
+				}
+				if(access.write)
+				{
+					m.state = access.state;
+					m.write = true;
+				}
+				else if(!m.write)
+				{
+					m.state |= access.state;
+				}
+				found = true;
+			}
+			if(!found)
+			{
+				merged.push_back(access);
+			}
+		}
+
+		for(const RenderGraphAccess& access : merged)
+		{
+			RenderGraphResource* pResource = &pGraph->resource[access.resource];
+
+			//LĂꎞ\[X͎gn߂ɃGCAVOoAKv
+			if(pResource->aliased && pResource->firstPass == p)
+			{
+				RenderGraphBarrier barrier = { access.resource, state[access.resource], state[access.resource], true };
+				pPass->barrier.push_back(barrier);
+			}
+
+			const RenderGraphState before = state[access.resource];
+			if(before == access.state)
+			{
+				continue;
+			}
+			//ǂݍݓmŊɊ܂܂ĂԂȂJڂȂ
+			if(!access.write && IsReadOnlyRenderGraphState(before) && (before & access.state) == access.state)
+			{
+				continue;
+			}
+			RenderGraphBarrier barrier = { access.resource, before, access.state, false };
+			pPass->barrier.push_back(barrier);
+			state[access.resource] = access.state;
+		}
+		pGraph->barrierCount += static_cast<uint32_t>(pPass->barrier.size());
+	}
+
+	//t[̏IɊO\[X͎w̏Ԃ֖߂
+	//ꎞ\[X͏ȈԂL^Ă
+	pGraph->finalBarrier.clear();
+	for(uint32_t r = 0;r < resourceCount;r++)
+	{
+		RenderGraphResource* pResource = &pGraph->resource[r];
+		if(pResource->firstPass == RENDER_GRAPH_INVALID)
+		{
+			continue;
+		}
+		if(!pResource->imported)
+		{
+			pResource->finalState = state[r];
+			continue;
+		}
+		if(state[r] != pResource->finalState)
+		{
+			RenderGraphBarrier barrier = { r, state[r], pResource->finalState, false };
+			pGraph->finalBarrier.push_back(barrier);
+		}
+	}
+	pGraph->barrierCount += static_cast<uint32_t>(pGraph->finalBarrier.size());
+}
+
+//RpCʂm߂
+//EdȂꎞ\[X̃dȂ炸AACgƃq[v͈̔͂Ă
+//EcpX͊O\[X̃pXǂރ\[Xɏ݁ApXɃoA
+//EoAɓKpƁAepX̑Oɂ̓ANZXԂɂȂĂāAJڂ̓\[XƂɃpX1܂
+//EŌ̃oǍAO\[X͏ȈԁAꎞ\[X͎̃t[̊Jn̏ԂɂȂĂ
+bool ValidateRenderGraph( const RenderGraph* pGraph )
+{
+	const uint32_t resourceCount = static_cast<uint32_t>(pGraph->resource.size());
+	const uint32_t passCount = static_cast<uint32_t>(pGraph->pass.size());
+
+	for(uint32_t a = 0;a < resourceCount;a++)
+	{
+		const RenderGraphResource& r = pGraph->resource[a];
+		if(r.imported || r.firstPass == RENDER_GRAPH_INVALID)
+		{
+			continue;
+		}
+		if(r.heapOffset % r.alignment != 0 || r.heapOffset + r.size > pGraph->transientHeapSize)
+		{
+			return false;
+		}
+		for(uint32_t b = a + 1;b < resourceCount;b++)
+		{
+			const RenderGraphResource& o = pGraph->resource[b];
+			if(o.imported || o.firstPass == RENDER_GRAPH_INVALID)
+			{
+				continue;
+			}
+			const bool lifetimeOverlap = o.firstPass <= r.lastPass && r.firstPass <= o.lastPass;
+			const bool memoryOverlap = o.heapOffset < r.heapOffset + r.size && r.heapOffset < o.heapOffset + o.size;
+			if(lifetimeOverlap && memoryOverlap)
+			{
+				return false;
+			}
+			if(memoryOverlap && (!r.aliased || !o.aliased))
+			{
+				return false;
+			}
+		}
+	}
+
+	//œǂ܂郊\[X(ĂȂpX)
+	for(uint32_t p = 0;p < passCount;p++)
+	{
+		const RenderGraphPass& pass = pGraph->pass[p];
+		if(pass.culled)
+		{
+			if(!pass.barrier.empty())
+			{
+				return false;
+			}
+			continue;
+		}
+		bool used = false;
+		for(const RenderGraphAccess& access : pass.access)
+		{
+			if(!access.write)
+			{
+				continue;
+			}
+			used = used || pGraph->resource[access.resource].imported;
+			for(uint32_t later = p + 1;later < passCount && !used;later++)
+			{
+				if(pGraph->pass[later].culled)
+				{
+					continue;
+				}
+				for(const RenderGraphAccess& next : pGraph->pass[later].access)
+				{
+					used = used || (!next.write && next.resource == access.resource);
+				}
+			}
+		}
+		if(!used)
+		{
+			return false;
+		}
+	}
+
+	vector<RenderGraphState> state(resourceCount);
+	for(uint32_t r = 0;r < resourceCount;r++)
+	{
+		state[r] = pGraph->resource[r].initialState;
+	}
+	for(uint32_t p = 0;p < passCount;p++)
+	{
+		const RenderGraphPass& pass = pGraph->pass[p];
+		if(pass.culled)
+		{
+			continue;
+		}
+		vector<uint32_t> transitionCount(resourceCount,0);
+		for(const RenderGraphBarrier& barrier : pass.barrier)
+		{
+			if(barrier.aliasing)
+			{
+				continue;
+			}
+			if(barrier.before != state[barrier.resource] || barrier.before == barrier.after || ++transitionCount[barrier.resource] > 1)
+			{
+				return false;
+			}
+			state[barrier.resource] = barrier.after;
+		}
+		for(const RenderGraphAccess& access : pass.access)
+		{
+			const RenderGraphState current = state[access.resource];
+			const bool ready = (current == access.state) ||
+				(!access.write && IsReadOnlyRenderGraphState(current) && (current & access.state) == access.state);
+			if(!ready)
+			{
+				return false;
+			}
+		}
+	}
+	for(const RenderGraphBarrier& barrier : pGraph->finalBarrier)
+	{
+		if(barrier.before != state[barrier.resource])
+		{
+			return false;
+		}
+		state[barrier.resource] = barrier.after;
+	}
+	for(uint32_t r = 0;r < resourceCount;r++)
+	{
+		const RenderGraphResource& resource = pGraph->resource[r];
+		if(resource.firstPass == RENDER_GRAPH_INVALID)
+		{
+			continue;
+		}
+		if(state[r] != (resource.imported ? resource.finalState : resource.initialState))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+//_[Ot
+//pXǂݏ郊\[XƏԂ錾ĂƁARpC
+//Eo͂Ɋ֌WȂpX菜
+//EԑJڂ̃oApXƂɂ܂Ƃ
+//EdȂȂꎞ\[X𓯂q[v̓ꏊɔzu
+//RpCD3D12Win32ɈˑȂB\[X̎̂ƃpX̋L^GpuRenderGraph(Main.cpp)
+
+#include <cstdint>
+#include <vector>
+
+const uint32_t RENDER_GRAPH_INVALID = 0xffffffff;
+
+//\[X̏
+//lD3D12_RESOURCE_STATESƓȂ̂ŁAD3D12ł͂̂܂ܕϊĎg
+typedef uint32_t RenderGraphState;
+const RenderGraphState RENDER_GRAPH_STATE_COMMON = 0;
+const RenderGraphState RENDER_GRAPH_STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1;
+const RenderGraphState RENDER_GRAPH_STATE_INDEX_BUFFER = 0x2;
+const RenderGraphState RENDER_GRAPH_STATE_RENDER_TARGET = 0x4;
+const RenderGraphState RENDER_GRAPH_STATE_UNORDERED_ACCESS = 0x8;
+const RenderGraphState RENDER_GRAPH_STATE_DEPTH_WRITE = 0x10;
+const RenderGraphState RENDER_GRAPH_STATE_DEPTH_READ = 0x20;
+const RenderGraphState RENDER_GRAPH_STATE_NON_PIXEL_SHADER_RESOURCE = 0x40;
+const RenderGraphState RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE = 0x80;
+const RenderGraphState RENDER_GRAPH_STATE_STREAM_OUT = 0x100;
+const RenderGraphState RENDER_GRAPH_STATE_INDIRECT_ARGUMENT = 0x200;
+const RenderGraphState RENDER_GRAPH_STATE_COPY_DEST = 0x400;
+const RenderGraphState RENDER_GRAPH_STATE_COPY_SOURCE = 0x800;
+const RenderGraphState RENDER_GRAPH_STATE_RESOLVE_DEST = 0x1000;
+const RenderGraphState RENDER_GRAPH_STATE_RESOLVE_SOURCE = 0x2000;
+const RenderGraphState RENDER_GRAPH_STATE_PRESENT = 0;
+
+struct RenderGraphResource
+{
+	const char* name;
+	bool imported;						//Õ\[X(obNobt@Ȃ)
+	RenderGraphState initialState;		//t[Jn̏(ꎞ\[X͍쐬̏)
+	RenderGraphState finalState;		//t[Ȉ
+	uint64_t size;
+	uint64_t alignment;
+	uint32_t firstPass;					//gŏƍŌ̃pX(ꎞ\[X̎)
+	uint32_t lastPass;
+	uint64_t heapOffset;
+	bool aliased;						//̈ꎞ\[XƃLĂ
+};
+
+struct RenderGraphAccess
+{
+	uint32_t resource;
+	RenderGraphState state;
+	bool write;
+};
+
+struct RenderGraphBarrier
+{
+	uint32_t resource;
+	RenderGraphState before;
+	RenderGraphState after;
+	bool aliasing;						//trueȂGCAVOoA
+};
+
+struct RenderGraphPass
+{
+	const char* name;
+	std::vector<RenderGraphAccess> access;
+	bool culled;
+	std::vector<RenderGraphBarrier> barrier;	//pX̑Oɂ܂Ƃ߂Ĕs
+};
+
+struct RenderGraph
+{
+	std::vector<RenderGraphResource> resource;
+	std::vector<RenderGraphPass> pass;
+	std::vector<RenderGraphBarrier> finalBarrier;	//Ō̃pX̌ɂ܂Ƃ߂Ĕs
+	uint64_t transientHeapSize;
+	uint64_t transientRequestedSize;	//GCAVOȂꍇ̃TCY
+	uint32_t culledPassCount;
+	uint32_t barrierCount;
+};
+
+uint32_t AddRenderGraphImport( RenderGraph* pGraph, const char* name, RenderGraphState initialState, RenderGraphState finalState );
+uint32_t AddRenderGraphTransient( RenderGraph* pGraph, const char* name, uint64_t size, uint64_t alignment );
+uint32_t AddRenderGraphPass( RenderGraph* pGraph, const char* name );
+void RenderGraphRead( RenderGraph* pGraph, uint32_t pass, uint32_t resource, RenderGraphState state );
+void RenderGraphWrite( RenderGraph* pGraph, uint32_t pass, uint32_t resource, RenderGraphState state );
+bool IsReadOnlyRenderGraphState( RenderGraphState state );
+void CompileRenderGraph( RenderGraph* pGraph );
+bool ValidateRenderGraph( const RenderGraph* pGraph );
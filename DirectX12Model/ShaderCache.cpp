@@ -0,0 +1,187 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+//FNV-1aŃnbVvZ(seedɑÕnbVnƑČvZł)
+uint64_t HashBytes( const void* pData, size_t size, uint64_t seed )
+{
+	const uint8_t* pByte = static_cast<const uint8_t*>(pData);
+	uint64_t hash = seed;
+	for(size_t n = 0;n < size;n++)
+	{
+		hash ^= pByte[n];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+uint64_t HashString( const char* pString, uint64_t seed )
+{
+	//I[܂߂ċ؂ɂ
+	return HashBytes(pString,strlen(pString) + 1,seed);
+}
+
+bool ReadFileBytes( const char* fileName, vector<uint8_t>* pData )
+{
+	ifstream file(fileName,ios::binary);
+	if(!file.is_open())
+	{
+		return false;
+	}
+	file.seekg(0,ios::end);
+	const streamoff size = file.tellg();
+	file.seekg(0,ios::beg);
+	pData->resize(static_cast<size_t>(size));
+	if(size > 0)
+	{
+		file.read(reinterpret_cast<char*>(&(*pData)[0]),size);
+	}
+	return !file.fail();
+}
+
+//ꎞt@CɏĂûŁArŗĂꂽLbV͎cȂ
+//ꎞt@C̖O̓XbhƂɕςAt@CɏĂȂ悤ɂ
+bool WriteFileBytes( const char* fileName, const void* pData, size_t size )
+{
+	const string tempName = string(fileName) + "." + to_string(hash<thread::id>()(this_thread::get_id())) + ".tmp";
+	{
+		ofstream file(tempName,ios::binary | ios::trunc);
+		if(!file.is_open())
+		{
+			return false;
+		}
+		file.write(static_cast<const char*>(pData),size);
+		if(file.fail())
+		{
+			return false;
+		}
+	}
+
+	error_code error;
+	filesystem::rename(tempName,fileName,error);
+	if(error)
+	{
+		filesystem::remove(tempName,error);
+		return false;
+	}
+	return true;
+}
+
+void InitShaderCache( ShaderCache* pCache, const char* directory, ShaderCompiler compiler, uint32_t compilerVersion )
+{
+	pCache->directory = directory;
+	pCache->compiler = compiler;
+	pCache->compilerVersion = compilerVersion;
+	pCache->shaderHit = 0;
+	pCache->shaderMiss = 0;
+}
+
+//LbṼt@C(fBNg/L[.gq)
+string GetShaderCacheFileName( const ShaderCache* pCache, uint64_t key, const char* extension )
+{
+	char name[32];
+	snprintf(name,sizeof(name),"%016llx.%s",static_cast<unsigned long long>(key),extension);
+	return (filesystem::path(pCache->directory) / name).string();
+}
+
+bool ReadShaderCacheFile( const ShaderCache* pCache, uint64_t key, const char* extension, vector<uint8_t>* pData )
+{
+	return ReadFileBytes(GetShaderCacheFileName(pCache,key,extension).c_str(),pData) && !pData->empty();
+}
+
+//fBNg΍Ăۑ
+bool WriteShaderCacheFile( const ShaderCache* pCache, uint64_t key, const char* extension, const void* pData, size_t size )
+{
+	error_code error;
+	filesystem::create_directories(pCache->directory,error);
+	if(error)
+	{
+		return false;
+	}
+	return WriteFileBytes(GetShaderCacheFileName(pCache,key,extension).c_str(),pData,size);
+}
+
+bool DeleteShaderCacheFile( const ShaderCache* pCache, uint64_t key, const char* extension )
+{
+	error_code error;
+	return filesystem::remove(GetShaderCacheFileName(pCache,key,extension),error);
+}
+
+//VF[_[̃LbṼL[
+uint64_t MakeShaderKey( const void* pSource, size_t sourceSize, const ShaderMacro* pDefines, const char* pEntryPoint,
+	const char* pTarget, uint32_t flags, uint32_t compilerVersion )
+{
+	uint64_t key = HashBytes(pSource,sourceSize,HASH_SEED);
+	for(const ShaderMacro* pDefine = pDefines;pDefine != nullptr && pDefine->Name != nullptr;pDefine++)
+	{
+		key = HashString(pDefine->Name,key);
+		key = HashString(pDefine->Definition != nullptr ? pDefine->Definition : "",key);
+	}
+	key = HashString(pEntryPoint,key);
+	key = HashString(pTarget,key);
+	key = HashBytes(&flags,sizeof(flags),key);
+	key = HashBytes(&compilerVersion,sizeof(compilerVersion),key);
+	return key;
+}
+
+//VF[_[ǂݍ
+//LbVɂ΂gA΃RpCăLbVɕۑ
+//pKeyɂ̓LbṼL[Ԃ(pCvC̃L[Ɏg)
+//̃Xbh瓯ɌĂł悢
+bool LoadShader( ShaderCache* pCache, const char* fileName, const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget,
+	uint32_t flags, vector<uint8_t>* pBytecode, uint64_t* pKey )
+{
+	vector<uint8_t> source;
+	if(!ReadFileBytes(fileName,&source))
+	{
+		return false;
+	}
+
+	const uint64_t key = MakeShaderKey(source.data(),source.size(),pDefines,pEntryPoint,pTarget,flags,pCache->compilerVersion);
+	if(pKey != nullptr)
+	{
+		*pKey = key;
+	}
+	if(ReadShaderCacheFile(pCache,key,"cso",pBytecode))
+	{
+		pCache->shaderHit++;
+		return true;
+	}
+
+	pCache->shaderMiss++;
+	if(!pCache->compiler(reinterpret_cast<const char*>(source.data()),source.size(),fileName,
+		pDefines,pEntryPoint,pTarget,flags,pBytecode))
+	{
+		return false;
+	}
+
+	//ۑłȂĂRpCȂ̂Ŏsɂ͂Ȃ
+	WriteShaderCacheFile(pCache,key,"cso",pBytecode->data(),pBytecode->size());
+	return true;
+}
+
+//mFp̃RpC
+//\[Xƃ}NAGg|CgA^[QbgAtÕnbVoCgR[h̑ɕԂ
+bool CompileShaderWithStub( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode )
+{
+	uint64_t hash = HashBytes(pSource,sourceSize,HASH_SEED);
+	for(const ShaderMacro* pDefine = pDefines;pDefine != nullptr && pDefine->Name != nullptr;pDefine++)
+	{
+		hash = HashString(pDefine->Name,hash);
+	}
+	hash = HashString(pEntryPoint,hash);
+	hash = HashString(pTarget,hash);
+	hash = HashBytes(&flags,sizeof(flags),hash);
+
+	const uint8_t* pHash = reinterpret_cast<const uint8_t*>(&hash);
+	pBytecode->assign(pHash,pHash + sizeof(hash));
+	return true;
+}
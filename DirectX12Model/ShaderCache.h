@@ -0,0 +1,51 @@
+#pragma once
+
+//VF[_[̃fBXNLbV
+//\[XA}NAGg|CgA^[QbgAtOARpC̃o[WnbV
+//t@CɂăoCgR[hۑBpCvC̃LbVfBNgɒu
+//t@C̑std::filesystemōsAD3D12Win32ɂ͈ˑȂ(RpC͊֐œn)
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <atomic>
+
+//FNV-1ȁl
+const uint64_t HASH_SEED = 14695981039346656037ULL;
+
+//D3D_SHADER_MACROƓ(I[Namenullptr)
+struct ShaderMacro
+{
+	const char* Name;
+	const char* Definition;
+};
+
+//RpCւ悤ɂĂ(D3DCompileł悤)
+typedef bool (*ShaderCompiler)( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, std::vector<uint8_t>* pBytecode );
+
+struct ShaderCache
+{
+	std::string directory;
+	ShaderCompiler compiler;
+	uint32_t compilerVersion;		//L[Ɋ܂߂(D3D_COMPILER_VERSION)
+	std::atomic<uint32_t> shaderHit;
+	std::atomic<uint32_t> shaderMiss;
+};
+
+uint64_t HashBytes( const void* pData, size_t size, uint64_t seed );
+uint64_t HashString( const char* pString, uint64_t seed );
+bool ReadFileBytes( const char* fileName, std::vector<uint8_t>* pData );
+bool WriteFileBytes( const char* fileName, const void* pData, size_t size );
+void InitShaderCache( ShaderCache* pCache, const char* directory, ShaderCompiler compiler, uint32_t compilerVersion );
+std::string GetShaderCacheFileName( const ShaderCache* pCache, uint64_t key, const char* extension );
+bool ReadShaderCacheFile( const ShaderCache* pCache, uint64_t key, const char* extension, std::vector<uint8_t>* pData );
+bool WriteShaderCacheFile( const ShaderCache* pCache, uint64_t key, const char* extension, const void* pData, size_t size );
+bool DeleteShaderCacheFile( const ShaderCache* pCache, uint64_t key, const char* extension );
+uint64_t MakeShaderKey( const void* pSource, size_t sourceSize, const ShaderMacro* pDefines, const char* pEntryPoint,
+	const char* pTarget, uint32_t flags, uint32_t compilerVersion );
+bool LoadShader( ShaderCache* pCache, const char* fileName, const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget,
+	uint32_t flags, std::vector<uint8_t>* pBytecode, uint64_t* pKey );
+bool CompileShaderWithStub( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, std::vector<uint8_t>* pBytecode );
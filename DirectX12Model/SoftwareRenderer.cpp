@@ -0,0 +1,506 @@
+#include "SoftwareRenderer.h"
+
+#include <fstream>
+
+using namespace DirectX;
+using namespace std;
+
+void RunSoftwareJobLoop( SoftwareRenderer* pRenderer );
+void SoftwareWorkerMain( SoftwareRenderer* pRenderer );
+SoftwareVertex LerpSoftwareVertex( const SoftwareVertex& a, const SoftwareVertex& b, float t );
+float GetSoftwareClipDistance( const XMFLOAT4& position, uint32_t plane );
+uint32_t ClipSoftwareTriangle( const SoftwareVertex* pInput, SoftwareVertex* pOutput );
+bool SetupSoftwareTriangle( const SoftwareRenderer* pRenderer, const SoftwareVertex& v0, const SoftwareVertex& v1, const SoftwareVertex& v2,
+	uint32_t material, SoftwareTriangle* pTriangle );
+void RasterizeSoftwareTriangle( SoftwareRenderer* pRenderer, const SoftwareTriangle& triangle, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY );
+
+//\tgEFAX^CU[̏
+bool InitSoftwareRenderer( SoftwareRenderer* pRenderer, uint32_t width, uint32_t height, uint32_t threadCount, bool cullBackFace,
+	SoftwarePixelShader pixelShader )
+{
+	pRenderer->width = width;
+	pRenderer->height = height;
+	pRenderer->tileCountX = (width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	pRenderer->tileCountY = (height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	pRenderer->color.resize(static_cast<size_t>(width) * height);
+	pRenderer->depth.resize(static_cast<size_t>(width) * height);
+	pRenderer->cullBackFace = cullBackFace;
+	pRenderer->pixelShader = pixelShader;
+	for(uint32_t n = 0;n < MAX_SOFTWARE_THREAD_COUNT;n++)
+	{
+		pRenderer->triangle[n].clear();
+		pRenderer->bin[n].assign(pRenderer->tileCountX * pRenderer->tileCountY,vector<uint32_t>());
+	}
+
+	pRenderer->threadCount = min(max(threadCount,1u),MAX_SOFTWARE_THREAD_COUNT);
+	pRenderer->jobCount = 0;
+	pRenderer->nextJob = 0;
+	pRenderer->generation = 0;
+	pRenderer->runningCount = 0;
+	pRenderer->quit = false;
+	pRenderer->setupTime = chrono::steady_clock::duration::zero();
+	pRenderer->rasterTime = chrono::steady_clock::duration::zero();
+	for(uint32_t n = 1;n < pRenderer->threadCount;n++)
+	{
+		pRenderer->worker[n] = thread(SoftwareWorkerMain,pRenderer);
+	}
+	return true;
+}
+
+void DestroySoftwareRenderer( SoftwareRenderer* pRenderer )
+{
+	{
+		lock_guard<mutex> lock(pRenderer->lock);
+		pRenderer->quit = true;
+	}
+	pRenderer->wake.notify_all();
+	for(uint32_t n = 1;n < pRenderer->threadCount;n++)
+	{
+		pRenderer->worker[n].join();
+	}
+	pRenderer->threadCount = 0;
+}
+
+//cĂWuoĎs
+void RunSoftwareJobLoop( SoftwareRenderer* pRenderer )
+{
+	for(;;)
+	{
+		const uint32_t jobIndex = pRenderer->nextJob++;
+		if(jobIndex >= pRenderer->jobCount)
+		{
+			break;
+		}
+		pRenderer->job(jobIndex);
+	}
+}
+
+//\tgEFAX^CU[̃Xbh
+void SoftwareWorkerMain( SoftwareRenderer* pRenderer )
+{
+	uint64_t generation = 0;
+	for(;;)
+	{
+		{
+			unique_lock<mutex> lock(pRenderer->lock);
+			pRenderer->wake.wait(lock,[&](){ return pRenderer->quit || pRenderer->generation != generation; });
+			if(pRenderer->quit)
+			{
+				return;
+			}
+			generation = pRenderer->generation;
+		}
+
+		RunSoftwareJobLoop(pRenderer);
+
+		{
+			lock_guard<mutex> lock(pRenderer->lock);
+			pRenderer->runningCount--;
+		}
+		pRenderer->done.notify_one();
+	}
+}
+
+//jobCount̃WuSXbhŎsAI܂ő҂
+void RunSoftwareJobs( SoftwareRenderer* pRenderer, uint32_t jobCount, const function<void(uint32_t)>& job )
+{
+	{
+		lock_guard<mutex> lock(pRenderer->lock);
+		pRenderer->job = job;
+		pRenderer->jobCount = jobCount;
+		pRenderer->nextJob = 0;
+		pRenderer->runningCount = pRenderer->threadCount - 1;
+		pRenderer->generation++;
+	}
+	pRenderer->wake.notify_all();
+
+	RunSoftwareJobLoop(pRenderer);
+
+	unique_lock<mutex> lock(pRenderer->lock);
+	pRenderer->done.wait(lock,[pRenderer](){ return pRenderer->runningCount == 0; });
+}
+
+//FR8G8B8A8_UNORMɕϊ
+uint32_t PackSoftwareColor( FXMVECTOR color )
+{
+	XMFLOAT4 value;
+	XMStoreFloat4(&value,XMVectorAdd(XMVectorScale(XMVectorSaturate(color),255.0f),XMVectorReplicate(0.5f)));
+	return static_cast<uint32_t>(value.x) | (static_cast<uint32_t>(value.y) << 8) |
+		(static_cast<uint32_t>(value.z) << 16) | (static_cast<uint32_t>(value.w) << 24);
+}
+
+//FƐ[xNA([x1.0)
+void ClearSoftwareRenderer( SoftwareRenderer* pRenderer, const float* pClearColor )
+{
+	const uint32_t color = PackSoftwareColor(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pClearColor)));
+	RunSoftwareJobs(pRenderer,pRenderer->tileCountY,[pRenderer,color]( uint32_t tileY )
+	{
+		const uint32_t beginY = tileY * SOFTWARE_TILE_SIZE;
+		const uint32_t endY = min(beginY + SOFTWARE_TILE_SIZE,pRenderer->height);
+		const size_t begin = static_cast<size_t>(beginY) * pRenderer->width;
+		const size_t end = static_cast<size_t>(endY) * pRenderer->width;
+		fill(pRenderer->color.begin() + begin,pRenderer->color.begin() + end,color);
+		fill(pRenderer->depth.begin() + begin,pRenderer->depth.begin() + end,1.0f);
+	});
+}
+
+//_̒l`Ԃ(Nbvp)
+SoftwareVertex LerpSoftwareVertex( const SoftwareVertex& a, const SoftwareVertex& b, float t )
+{
+	SoftwareVertex result;
+	XMStoreFloat4(&result.position,XMVectorLerp(XMLoadFloat4(&a.position),XMLoadFloat4(&b.position),t));
+	XMStoreFloat4(&result.normal,XMVectorLerp(XMLoadFloat4(&a.normal),XMLoadFloat4(&b.normal),t));
+	XMStoreFloat2(&result.uv,XMVectorLerp(XMLoadFloat2(&a.uv),XMLoadFloat2(&b.uv),t));
+	return result;
+}
+
+//Nbvʂ܂ł̋(Ȃ)
+//0 <= z <= w(DepthClipEnable)ƁAxỹK[hoh
+float GetSoftwareClipDistance( const XMFLOAT4& position, uint32_t plane )
+{
+	switch(plane)
+	{
+	case 0: return position.z;
+	case 1: return position.w - position.z;
+	case 2: return position.w * SOFTWARE_GUARD_BAND + position.x;
+	case 3: return position.w * SOFTWARE_GUARD_BAND - position.x;
+	case 4: return position.w * SOFTWARE_GUARD_BAND + position.y;
+	default: return position.w * SOFTWARE_GUARD_BAND - position.y;
+	}
+}
+
+//Op`Nbvđp`̒_Ԃ(ő9_)
+uint32_t ClipSoftwareTriangle( const SoftwareVertex* pInput, SoftwareVertex* pOutput )
+{
+	SoftwareVertex buffer[2][9];
+	uint32_t count = 3;
+	buffer[0][0] = pInput[0];
+	buffer[0][1] = pInput[1];
+	buffer[0][2] = pInput[2];
+
+	uint32_t current = 0;
+	for(uint32_t plane = 0;plane < 6 && count > 0;plane++)
+	{
+		const SoftwareVertex* pSource = buffer[current];
+		SoftwareVertex* pDest = buffer[current ^ 1];
+		uint32_t destCount = 0;
+		for(uint32_t n = 0;n < count;n++)
+		{
+			const SoftwareVertex& a = pSource[n];
+			const SoftwareVertex& b = pSource[(n + 1) % count];
+			const float distanceA = GetSoftwareClipDistance(a.position,plane);
+			const float distanceB = GetSoftwareClipDistance(b.position,plane);
+			if(distanceA >= 0.0f)
+			{
+				pDest[destCount++] = a;
+			}
+			if((distanceA >= 0.0f) != (distanceB >= 0.0f))
+			{
+				pDest[destCount++] = LerpSoftwareVertex(a,b,distanceA / (distanceA - distanceB));
+			}
+		}
+		count = destCount;
+		current ^= 1;
+	}
+
+	for(uint32_t n = 0;n < count;n++)
+	{
+		pOutput[n] = buffer[current][n];
+	}
+	return count;
+}
+
+//Op`ʍWɕϊAX^CYɕKvȒl߂
+//̂ĂƂʐς0̂ƂfalseԂ
+bool SetupSoftwareTriangle( const SoftwareRenderer* pRenderer, const SoftwareVertex& v0, const SoftwareVertex& v1, const SoftwareVertex& v2,
+	uint32_t material, SoftwareTriangle* pTriangle )
+{
+	const SoftwareVertex* pVertex[3] = { &v0, &v1, &v2 };
+	float screenX[3];
+	float screenY[3];
+	for(uint32_t n = 0;n < 3;n++)
+	{
+		const SoftwareVertex& vertex = *pVertex[n];
+		const float invW = 1.0f / vertex.position.w;
+		//r[|[g̕ϊ(オ_Ay͉)
+		screenX[n] = (vertex.position.x * invW * 0.5f + 0.5f) * pRenderer->width;
+		screenY[n] = (0.5f - vertex.position.y * invW * 0.5f) * pRenderer->height;
+		pTriangle->x[n] = static_cast<int64_t>(floorf(screenX[n] * SOFTWARE_SUBPIXEL_SCALE + 0.5f));
+		pTriangle->y[n] = static_cast<int64_t>(floorf(screenY[n] * SOFTWARE_SUBPIXEL_SCALE + 0.5f));
+		pTriangle->z[n] = vertex.position.z * invW;
+		pTriangle->invW[n] = invW;
+		XMStoreFloat4(&pTriangle->normal[n],XMVectorScale(XMLoadFloat4(&vertex.normal),invW));
+		XMStoreFloat2(&pTriangle->uv[n],XMVectorScale(XMLoadFloat2(&vertex.uv),invW));
+	}
+
+	//ʏŎv肪\(FrontCounterClockwise = FALSE)
+	int64_t area = (pTriangle->x[1] - pTriangle->x[0]) * (pTriangle->y[2] - pTriangle->y[0]) -
+		(pTriangle->x[2] - pTriangle->x[0]) * (pTriangle->y[1] - pTriangle->y[0]);
+	if(area == 0 || (area < 0 && pRenderer->cullBackFace))
+	{
+		return false;
+	}
+	if(area < 0)
+	{
+		//ʕ`̂Ƃ͒_ւĕ\ɂ낦
+		swap(pTriangle->x[1],pTriangle->x[2]);
+		swap(pTriangle->y[1],pTriangle->y[2]);
+		swap(pTriangle->z[1],pTriangle->z[2]);
+		swap(pTriangle->invW[1],pTriangle->invW[2]);
+		swap(pTriangle->normal[1],pTriangle->normal[2]);
+		swap(pTriangle->uv[1],pTriangle->uv[2]);
+		swap(screenX[1],screenX[2]);
+		swap(screenY[1],screenY[2]);
+		area = -area;
+	}
+	pTriangle->invArea = 1.0f / static_cast<float>(area);
+	pTriangle->material = material;
+
+	const float minX = min(min(screenX[0],screenX[1]),screenX[2]);
+	const float minY = min(min(screenY[0],screenY[1]),screenY[2]);
+	const float maxX = max(max(screenX[0],screenX[1]),screenX[2]);
+	const float maxY = max(max(screenY[0],screenY[1]),screenY[2]);
+	pTriangle->minX = max(static_cast<int>(floorf(minX)),0);
+	pTriangle->minY = max(static_cast<int>(floorf(minY)),0);
+	pTriangle->maxX = min(static_cast<int>(floorf(maxX)) + 1,static_cast<int>(pRenderer->width));
+	pTriangle->maxY = min(static_cast<int>(floorf(maxY)) + 1,static_cast<int>(pRenderer->height));
+	return pTriangle->minX < pTriangle->maxX && pTriangle->minY < pTriangle->maxY;
+}
+
+//Op`̃^CƏdȂ镔h
+void RasterizeSoftwareTriangle( SoftwareRenderer* pRenderer, const SoftwareTriangle& triangle, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY )
+{
+	const int beginX = max(triangle.minX,tileMinX);
+	const int beginY = max(triangle.minY,tileMinY);
+	const int endX = min(triangle.maxX,tileMaxX);
+	const int endY = min(triangle.maxY,tileMaxY);
+	if(beginX >= endX || beginY >= endY)
+	{
+		return;
+	}
+
+	//ӂ̎ E(p) = (xb - xa) * (py - ya) - (yb - ya) * (px - xa)
+	//edge[n]͒_ň̕ӂŁAE / ʐς_n̏dSWɂȂ
+	int64_t stepX[3];
+	int64_t stepY[3];
+	int64_t rowValue[3];
+	int64_t bias[3];
+	const int64_t sampleX = static_cast<int64_t>(beginX) * SOFTWARE_SUBPIXEL_SCALE + SOFTWARE_SUBPIXEL_SCALE / 2;
+	const int64_t sampleY = static_cast<int64_t>(beginY) * SOFTWARE_SUBPIXEL_SCALE + SOFTWARE_SUBPIXEL_SCALE / 2;
+	for(uint32_t n = 0;n < 3;n++)
+	{
+		const uint32_t a = (n + 1) % 3;
+		const uint32_t b = (n + 2) % 3;
+		const int64_t dx = triangle.x[b] - triangle.x[a];
+		const int64_t dy = triangle.y[b] - triangle.y[a];
+		stepX[n] = -dy * SOFTWARE_SUBPIXEL_SCALE;
+		stepY[n] = dx * SOFTWARE_SUBPIXEL_SCALE;
+		rowValue[n] = dx * (sampleY - triangle.y[a]) - dy * (sampleX - triangle.x[a]);
+		//gbvtg[(̕ӂƍ̕ӂɂ傤ǏsNZ܂߂)
+		const bool topLeft = (dy == 0 && dx > 0) || dy < 0;
+		bias[n] = topLeft ? 0 : -1;
+	}
+
+	SoftwarePixelBatch batch;
+	batch.count = 0;
+	for(int y = beginY;y < endY;y++)
+	{
+		int64_t value[3] = { rowValue[0], rowValue[1], rowValue[2] };
+		uint32_t* pColor = &pRenderer->color[static_cast<size_t>(y) * pRenderer->width];
+		float* pDepth = &pRenderer->depth[static_cast<size_t>(y) * pRenderer->width];
+		for(int x = beginX;x < endX;x++)
+		{
+			if((value[0] + bias[0]) >= 0 && (value[1] + bias[1]) >= 0 && (value[2] + bias[2]) >= 0)
+			{
+				const float b0 = static_cast<float>(value[0]) * triangle.invArea;
+				const float b1 = static_cast<float>(value[1]) * triangle.invArea;
+				const float b2 = static_cast<float>(value[2]) * triangle.invArea;
+				const float z = b0 * triangle.z[0] + b1 * triangle.z[1] + b2 * triangle.z[2];
+				if(z <= pDepth[x])
+				{
+					//Op`̃sNZ͏dȂȂ̂ŁA[xɏĐF͌ł܂Ƃ߂ČvZ
+					batch.b0[batch.count] = b0;
+					batch.b1[batch.count] = b1;
+					batch.b2[batch.count] = b2;
+					batch.pColor[batch.count] = &pColor[x];
+					batch.count++;
+					pDepth[x] = z;
+					if(batch.count == SOFTWARE_PIXEL_BATCH_SIZE)
+					{
+						pRenderer->pixelShader(triangle,&batch);
+					}
+				}
+			}
+			value[0] += stepX[0];
+			value[1] += stepX[1];
+			value[2] += stepX[2];
+		}
+		rowValue[0] += stepY[0];
+		rowValue[1] += stepY[1];
+		rowValue[2] += stepY[2];
+	}
+	if(batch.count > 0)
+	{
+		pRenderer->pixelShader(triangle,&batch);
+	}
+}
+
+//Op`Xg`悷
+//pMaterialnullptr̂Ƃ̓}eA0
+void DrawSoftwareTriangles( SoftwareRenderer* pRenderer, const SoftwareVertex* pVertex, const uint32_t* pIndex, const uint32_t* pMaterial, uint32_t triangleCount )
+{
+	const chrono::steady_clock::time_point setupBegin = chrono::steady_clock::now();
+
+	//Op`A͈͂ɕăZbgAbvAXbhƂ̃rɐU蕪
+	const uint32_t threadCount = pRenderer->threadCount;
+	RunSoftwareJobs(pRenderer,threadCount,[=]( uint32_t jobIndex )
+	{
+		vector<SoftwareTriangle>& triangle = pRenderer->triangle[jobIndex];
+		vector<vector<uint32_t>>& bin = pRenderer->bin[jobIndex];
+		triangle.clear();
+		for(vector<uint32_t>& tile : bin)
+		{
+			tile.clear();
+		}
+
+		const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(triangleCount) * jobIndex / threadCount);
+		const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(triangleCount) * (jobIndex + 1) / threadCount);
+		for(uint32_t n = begin;n < end;n++)
+		{
+			const SoftwareVertex input[3] = { pVertex[pIndex[n * 3]], pVertex[pIndex[n * 3 + 1]], pVertex[pIndex[n * 3 + 2]] };
+			const uint32_t material = pMaterial != nullptr ? pMaterial[n] : 0;
+
+			//S̒_Nbvʂ̓Ȃ瑽p`ɂȂĂ悢
+			bool inside = true;
+			for(uint32_t plane = 0;plane < 6 && inside;plane++)
+			{
+				inside = GetSoftwareClipDistance(input[0].position,plane) >= 0.0f &&
+					GetSoftwareClipDistance(input[1].position,plane) >= 0.0f &&
+					GetSoftwareClipDistance(input[2].position,plane) >= 0.0f;
+			}
+			SoftwareVertex polygon[9];
+			uint32_t polygonCount = 3;
+			if(inside)
+			{
+				polygon[0] = input[0];
+				polygon[1] = input[1];
+				polygon[2] = input[2];
+			}
+			else
+			{
+				polygonCount = ClipSoftwareTriangle(input,polygon);
+			}
+
+			for(uint32_t k = 2;k < polygonCount;k++)
+			{
+				SoftwareTriangle setup;
+				if(!SetupSoftwareTriangle(pRenderer,polygon[0],polygon[k - 1],polygon[k],material,&setup))
+				{
+					continue;
+				}
+				const uint32_t triangleIndex = static_cast<uint32_t>(triangle.size());
+				triangle.push_back(setup);
+
+				const uint32_t tileBeginX = setup.minX / SOFTWARE_TILE_SIZE;
+				const uint32_t tileBeginY = setup.minY / SOFTWARE_TILE_SIZE;
+				const uint32_t tileEndX = (setup.maxX - 1) / SOFTWARE_TILE_SIZE;
+				const uint32_t tileEndY = (setup.maxY - 1) / SOFTWARE_TILE_SIZE;
+				for(uint32_t tileY = tileBeginY;tileY <= tileEndY;tileY++)
+				{
+					for(uint32_t tileX = tileBeginX;tileX <= tileEndX;tileX++)
+					{
+						bin[tileY * pRenderer->tileCountX + tileX].push_back(triangleIndex);
+					}
+				}
+			}
+		}
+	});
+
+	const chrono::steady_clock::time_point rasterBegin = chrono::steady_clock::now();
+
+	//^CƂɃXbhœh
+	RunSoftwareJobs(pRenderer,pRenderer->tileCountX * pRenderer->tileCountY,[pRenderer,threadCount]( uint32_t tile )
+	{
+		const int tileMinX = static_cast<int>((tile % pRenderer->tileCountX) * SOFTWARE_TILE_SIZE);
+		const int tileMinY = static_cast<int>((tile / pRenderer->tileCountX) * SOFTWARE_TILE_SIZE);
+		const int tileMaxX = min(tileMinX + static_cast<int>(SOFTWARE_TILE_SIZE),static_cast<int>(pRenderer->width));
+		const int tileMaxY = min(tileMinY + static_cast<int>(SOFTWARE_TILE_SIZE),static_cast<int>(pRenderer->height));
+		for(uint32_t n = 0;n < threadCount;n++)
+		{
+			for(uint32_t triangleIndex : pRenderer->bin[n][tile])
+			{
+				RasterizeSoftwareTriangle(pRenderer,pRenderer->triangle[n][triangleIndex],tileMinX,tileMinY,tileMaxX,tileMaxY);
+			}
+		}
+	});
+
+	const chrono::steady_clock::time_point rasterEnd = chrono::steady_clock::now();
+	pRenderer->setupTime += rasterBegin - setupBegin;
+	pRenderer->rasterTime += rasterEnd - rasterBegin;
+}
+
+//`挋ʂ24rbg̃rbg}bvɕۑ
+bool SaveSoftwareRenderTarget( const SoftwareRenderer* pRenderer, const char* fileName )
+{
+#pragma pack(1)
+	struct BitmapHeader
+	{
+		unsigned char type[2];
+		unsigned int size;
+		unsigned short reserved[2];
+		unsigned int offset;
+	};
+#pragma pack()
+
+	struct BitmapInfoHeader
+	{
+		unsigned int size;
+		int width;
+		int height;
+		unsigned short planes;
+		unsigned short bitCount;
+		unsigned int compression;
+		unsigned int sizeImage;
+		int XPixPerMeter;
+		int YPixPerMeter;
+		unsigned int ClrUsed;
+		unsigned int CirImportant;
+	};
+
+	const uint32_t rowSize = (pRenderer->width * 3 + 3) & ~3u;
+	BitmapHeader header = {};
+	header.type[0] = 'B';
+	header.type[1] = 'M';
+	header.offset = sizeof(BitmapHeader) + sizeof(BitmapInfoHeader);
+	header.size = header.offset + rowSize * pRenderer->height;
+	BitmapInfoHeader infoHeader = {};
+	infoHeader.size = sizeof(BitmapInfoHeader);
+	infoHeader.width = static_cast<int>(pRenderer->width);
+	infoHeader.height = static_cast<int>(pRenderer->height);
+	infoHeader.planes = 1;
+	infoHeader.bitCount = 24;
+	infoHeader.sizeImage = rowSize * pRenderer->height;
+
+	ofstream file(fileName,ios::binary);
+	if(!file.is_open())
+	{
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+	file.write(reinterpret_cast<const char*>(&infoHeader),sizeof(infoHeader));
+
+	//rbg}bv͉̍sBGȐɕ
+	vector<uint8_t> row(rowSize,0);
+	for(uint32_t y = pRenderer->height;y-- > 0;)
+	{
+		const uint32_t* pColor = &pRenderer->color[static_cast<size_t>(y) * pRenderer->width];
+		for(uint32_t x = 0;x < pRenderer->width;x++)
+		{
+			row[x * 3 + 0] = static_cast<uint8_t>(pColor[x] >> 16);
+			row[x * 3 + 1] = static_cast<uint8_t>(pColor[x] >> 8);
+			row[x * 3 + 2] = static_cast<uint8_t>(pColor[x]);
+		}
+		file.write(reinterpret_cast<const char*>(row.data()),rowSize);
+	}
+	return !file.fail();
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+//\tgEFAX^CU[
+//GPUEBhEĂ`m߂悤ɁA_ƃVF[_[̌vZCPUōs
+//Op`ʂ̃^CɐU蕪ĂA^CƂɃXbhœh
+//Win32ɈˑȂ̂ŁÃt@CSoftwareRenderer.cppWindowsȊOłrhł
+//sNZVF[_[̓TvƂɈႤ̂ŁAInitSoftwareRenderer()Ɋ֐n
+
+#include <DirectXMath.h>
+#if defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#else
+#include <immintrin.h>
+#endif
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+const uint32_t SOFTWARE_TILE_SIZE = 64;
+const uint32_t MAX_SOFTWARE_THREAD_COUNT = 16;
+const int SOFTWARE_SUBPIXEL_SCALE = 256;	//GPUƓ1/256sNZɊۂ߂
+const float SOFTWARE_GUARD_BAND = 8.0f;		//ʂ̉{͈̔͂܂łxyŃNbvȂ
+
+//ϊ̒_(NbvԂ̈ʒuƃsNZVF[_[ɓnl)
+struct SoftwareVertex
+{
+	DirectX::XMFLOAT4 position;
+	DirectX::XMFLOAT4 normal;
+	DirectX::XMFLOAT2 uv;
+};
+
+//ZbgAbvς݂̎Op`
+struct SoftwareTriangle
+{
+	int64_t x[3];		//1/256sNZPʂ̉ʍW
+	int64_t y[3];
+	float z[3];
+	float invW[3];
+	DirectX::XMFLOAT4 normal[3];	//1/w|l(p[XyNeBu␳p)
+	DirectX::XMFLOAT2 uv[3];
+	float invArea;
+	int minX;			//sNZPʂ͈̔(max͊܂܂Ȃ)
+	int minY;
+	int maxX;
+	int maxY;
+	uint32_t material;
+};
+
+//[xeXgʂsNZ
+//sNZVF[_[̌vZ͎Op`Ƃɂ߂ĂASOFTWARE_SIMD_WIDTHsNZ܂Ƃ߂čs
+const uint32_t SOFTWARE_PIXEL_BATCH_SIZE = 64;	//SOFTWARE_SIMD_WIDTH̔{
+struct SoftwarePixelBatch
+{
+	uint32_t count;
+	float b0[SOFTWARE_PIXEL_BATCH_SIZE];		//dSW
+	float b1[SOFTWARE_PIXEL_BATCH_SIZE];
+	float b2[SOFTWARE_PIXEL_BATCH_SIZE];
+	uint32_t* pColor[SOFTWARE_PIXEL_BATCH_SIZE];	//ݐ
+};
+
+//߂sNZ̐FvZď݁ApBatch->count0ɖ߂
+typedef void (*SoftwarePixelShader)( const SoftwareTriangle& triangle, SoftwarePixelBatch* pBatch );
+
+struct SoftwareRenderer
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t tileCountX;
+	uint32_t tileCountY;
+	std::vector<uint32_t> color;	//R8G8B8A8_UNORMƓ
+	std::vector<float> depth;		//D32_FLOATALESS_EQUALŔr
+	bool cullBackFace;
+	SoftwarePixelShader pixelShader;
+
+	//XbhƂ̃ZbgAbvʂƁA^CƂɐU蕪Op`̔ԍ
+	//Xbhɂ͎Op`A͈͂œn̂ŁAXbh̏ɓhΕ`揇ۂ
+	std::vector<SoftwareTriangle> triangle[MAX_SOFTWARE_THREAD_COUNT];
+	std::vector<std::vector<uint32_t>> bin[MAX_SOFTWARE_THREAD_COUNT];
+
+	//WuzXbh(threadCount͌ĂяõXbh܂)
+	uint32_t threadCount;
+	std::thread worker[MAX_SOFTWARE_THREAD_COUNT];
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::function<void(uint32_t)> job;
+	uint32_t jobCount;
+	std::atomic<uint32_t> nextJob;
+	uint64_t generation;
+	uint32_t runningCount;
+	bool quit;
+
+	//vp
+	std::chrono::steady_clock::duration setupTime;
+	std::chrono::steady_clock::duration rasterTime;
+};
+
+bool InitSoftwareRenderer( SoftwareRenderer* pRenderer, uint32_t width, uint32_t height, uint32_t threadCount, bool cullBackFace,
+	SoftwarePixelShader pixelShader );
+void DestroySoftwareRenderer( SoftwareRenderer* pRenderer );
+void RunSoftwareJobs( SoftwareRenderer* pRenderer, uint32_t jobCount, const std::function<void(uint32_t)>& job );
+uint32_t PackSoftwareColor( DirectX::FXMVECTOR color );
+void ClearSoftwareRenderer( SoftwareRenderer* pRenderer, const float* pClearColor );
+void DrawSoftwareTriangles( SoftwareRenderer* pRenderer, const SoftwareVertex* pVertex, const uint32_t* pIndex, const uint32_t* pMaterial, uint32_t triangleCount );
+bool SaveSoftwareRenderTarget( const SoftwareRenderer* pRenderer, const char* fileName );
+
+//_ϊƃsNZVF[_[SIMD
+//̓RpC̃IvVŌ܂(/arch:AVX512Ȃ16A/arch:AVX2Ȃ8Ax64ARM64Ȃ4AȊO1)
+#if defined(__AVX512F__)
+typedef __m512 SoftwareFloat;
+const uint32_t SOFTWARE_SIMD_WIDTH = 16;
+inline SoftwareFloat SoftwareLoad( const float* p ) { return _mm512_loadu_ps(p); }
+inline void SoftwareStore( float* p, SoftwareFloat value ) { _mm512_storeu_ps(p,value); }
+inline SoftwareFloat SoftwareSet( float value ) { return _mm512_set1_ps(value); }
+inline SoftwareFloat SoftwareAdd( SoftwareFloat a, SoftwareFloat b ) { return _mm512_add_ps(a,b); }
+inline SoftwareFloat SoftwareSub( SoftwareFloat a, SoftwareFloat b ) { return _mm512_sub_ps(a,b); }
+inline SoftwareFloat SoftwareMin( SoftwareFloat a, SoftwareFloat b ) { return _mm512_min_ps(a,b); }
+inline SoftwareFloat SoftwareMax( SoftwareFloat a, SoftwareFloat b ) { return _mm512_max_ps(a,b); }
+inline SoftwareFloat SoftwareAbs( SoftwareFloat a ) { return _mm512_abs_ps(a); }
+inline SoftwareFloat SoftwareMul( SoftwareFloat a, SoftwareFloat b ) { return _mm512_mul_ps(a,b); }
+inline SoftwareFloat SoftwareMulAdd( SoftwareFloat a, SoftwareFloat b, SoftwareFloat c ) { return _mm512_fmadd_ps(a,b,c); }
+inline SoftwareFloat SoftwareDiv( SoftwareFloat a, SoftwareFloat b ) { return _mm512_div_ps(a,b); }
+inline SoftwareFloat SoftwareSqrt( SoftwareFloat a ) { return _mm512_sqrt_ps(a); }
+inline SoftwareFloat SoftwareFloor( SoftwareFloat a ) { return _mm512_roundscale_ps(a,_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+#elif defined(__AVX2__)
+typedef __m256 SoftwareFloat;
+const uint32_t SOFTWARE_SIMD_WIDTH = 8;
+inline SoftwareFloat SoftwareLoad( const float* p ) { return _mm256_loadu_ps(p); }
+inline void SoftwareStore( float* p, SoftwareFloat value ) { _mm256_storeu_ps(p,value); }
+inline SoftwareFloat SoftwareSet( float value ) { return _mm256_set1_ps(value); }
+inline SoftwareFloat SoftwareAdd( SoftwareFloat a, SoftwareFloat b ) { return _mm256_add_ps(a,b); }
+inline SoftwareFloat SoftwareSub( SoftwareFloat a, SoftwareFloat b ) { return _mm256_sub_ps(a,b); }
+inline SoftwareFloat SoftwareMin( SoftwareFloat a, SoftwareFloat b ) { return _mm256_min_ps(a,b); }
+inline SoftwareFloat SoftwareMax( SoftwareFloat a, SoftwareFloat b ) { return _mm256_max_ps(a,b); }
+inline SoftwareFloat SoftwareAbs( SoftwareFloat a ) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f),a); }
+inline SoftwareFloat SoftwareMul( SoftwareFloat a, SoftwareFloat b ) { return _mm256_mul_ps(a,b); }
+inline SoftwareFloat SoftwareMulAdd( SoftwareFloat a, SoftwareFloat b, SoftwareFloat c ) { return _mm256_fmadd_ps(a,b,c); }
+inline SoftwareFloat SoftwareDiv( SoftwareFloat a, SoftwareFloat b ) { return _mm256_div_ps(a,b); }
+inline SoftwareFloat SoftwareSqrt( SoftwareFloat a ) { return _mm256_sqrt_ps(a); }
+inline SoftwareFloat SoftwareFloor( SoftwareFloat a ) { return _mm256_floor_ps(a); }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+typedef float32x4_t SoftwareFloat;
+const uint32_t SOFTWARE_SIMD_WIDTH = 4;
+inline SoftwareFloat SoftwareLoad( const float* p ) { return vld1q_f32(p); }
+inline void SoftwareStore( float* p, SoftwareFloat value ) { vst1q_f32(p,value); }
+inline SoftwareFloat SoftwareSet( float value ) { return vdupq_n_f32(value); }
+inline SoftwareFloat SoftwareAdd( SoftwareFloat a, SoftwareFloat b ) { return vaddq_f32(a,b); }
+inline SoftwareFloat SoftwareSub( SoftwareFloat a, SoftwareFloat b ) { return vsubq_f32(a,b); }
+inline SoftwareFloat SoftwareMin( SoftwareFloat a, SoftwareFloat b ) { return vminq_f32(a,b); }
+inline SoftwareFloat SoftwareMax( SoftwareFloat a, SoftwareFloat b ) { return vmaxq_f32(a,b); }
+inline SoftwareFloat SoftwareAbs( SoftwareFloat a ) { return vabsq_f32(a); }
+inline SoftwareFloat SoftwareMul( SoftwareFloat a, SoftwareFloat b ) { return vmulq_f32(a,b); }
+inline SoftwareFloat SoftwareMulAdd( SoftwareFloat a, SoftwareFloat b, SoftwareFloat c ) { return vfmaq_f32(c,a,b); }
+inline SoftwareFloat SoftwareDiv( SoftwareFloat a, SoftwareFloat b ) { return vdivq_f32(a,b); }
+inline SoftwareFloat SoftwareSqrt( SoftwareFloat a ) { return vsqrtq_f32(a); }
+inline SoftwareFloat SoftwareFloor( SoftwareFloat a ) { return vrndmq_f32(a); }
+#elif defined(_M_X64) || defined(__SSE2__)
+typedef __m128 SoftwareFloat;
+const uint32_t SOFTWARE_SIMD_WIDTH = 4;
+inline SoftwareFloat SoftwareLoad( const float* p ) { return _mm_loadu_ps(p); }
+inline void SoftwareStore( float* p, SoftwareFloat value ) { _mm_storeu_ps(p,value); }
+inline SoftwareFloat SoftwareSet( float value ) { return _mm_set1_ps(value); }
+inline SoftwareFloat SoftwareAdd( SoftwareFloat a, SoftwareFloat b ) { return _mm_add_ps(a,b); }
+inline SoftwareFloat SoftwareSub( SoftwareFloat a, SoftwareFloat b ) { return _mm_sub_ps(a,b); }
+inline SoftwareFloat SoftwareMin( SoftwareFloat a, SoftwareFloat b ) { return _mm_min_ps(a,b); }
+inline SoftwareFloat SoftwareMax( SoftwareFloat a, SoftwareFloat b ) { return _mm_max_ps(a,b); }
+inline SoftwareFloat SoftwareAbs( SoftwareFloat a ) { return _mm_andnot_ps(_mm_set1_ps(-0.0f),a); }
+inline SoftwareFloat SoftwareMul( SoftwareFloat a, SoftwareFloat b ) { return _mm_mul_ps(a,b); }
+inline SoftwareFloat SoftwareMulAdd( SoftwareFloat a, SoftwareFloat b, SoftwareFloat c ) { return _mm_add_ps(_mm_mul_ps(a,b),c); }
+inline SoftwareFloat SoftwareDiv( SoftwareFloat a, SoftwareFloat b ) { return _mm_div_ps(a,b); }
+inline SoftwareFloat SoftwareSqrt( SoftwareFloat a ) { return _mm_sqrt_ps(a); }
+//SSE2ɂ͐؂̂Ă̂ŁA0Ɋۂ߂Ă傫Ȃ
+inline SoftwareFloat SoftwareFloor( SoftwareFloat a ) { const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); return _mm_sub_ps(t,_mm_and_ps(_mm_cmpgt_ps(t,a),_mm_set1_ps(1.0f))); }
+#else
+typedef float SoftwareFloat;
+const uint32_t SOFTWARE_SIMD_WIDTH = 1;
+inline SoftwareFloat SoftwareLoad( const float* p ) { return *p; }
+inline void SoftwareStore( float* p, SoftwareFloat value ) { *p = value; }
+inline SoftwareFloat SoftwareSet( float value ) { return value; }
+inline SoftwareFloat SoftwareAdd( SoftwareFloat a, SoftwareFloat b ) { return a + b; }
+inline SoftwareFloat SoftwareSub( SoftwareFloat a, SoftwareFloat b ) { return a - b; }
+inline SoftwareFloat SoftwareMin( SoftwareFloat a, SoftwareFloat b ) { return (std::min)(a,b); }
+inline SoftwareFloat SoftwareMax( SoftwareFloat a, SoftwareFloat b ) { return (std::max)(a,b); }
+inline SoftwareFloat SoftwareAbs( SoftwareFloat a ) { return fabsf(a); }
+inline SoftwareFloat SoftwareMul( SoftwareFloat a, SoftwareFloat b ) { return a * b; }
+inline SoftwareFloat SoftwareMulAdd( SoftwareFloat a, SoftwareFloat b, SoftwareFloat c ) { return a * b + c; }
+inline SoftwareFloat SoftwareDiv( SoftwareFloat a, SoftwareFloat b ) { return a / b; }
+inline SoftwareFloat SoftwareSqrt( SoftwareFloat a ) { return sqrtf(a); }
+inline SoftwareFloat SoftwareFloor( SoftwareFloat a ) { return floorf(a); }
+#endif
+
+//dSWb0`b23_̒la0`a2Ԃ
+inline SoftwareFloat InterpolateSoftware( SoftwareFloat b0, SoftwareFloat b1, SoftwareFloat b2, float a0, float a1, float a2 )
+{
+	return SoftwareMulAdd(b2,SoftwareSet(a2),SoftwareMulAdd(b1,SoftwareSet(a1),SoftwareMul(b0,SoftwareSet(a0))));
+}
+
+//SOFTWARE_SIMD_WIDTHsNZRGBA(pColor[0`3])PackSoftwareColor()Ɠ0`1Ɋۂ߂R8G8B8A8ɂA
+//擪countppDest̎wɏ
+inline void StoreSoftwareColors( const SoftwareFloat* pColor, uint32_t* const* ppDest, uint32_t count )
+{
+	const SoftwareFloat zero = SoftwareSet(0.0f);
+	const SoftwareFloat one = SoftwareSet(1.0f);
+	float lane[4][SOFTWARE_SIMD_WIDTH];
+	for(uint32_t channel = 0;channel < 4;channel++)
+	{
+		const SoftwareFloat value = SoftwareMin(SoftwareMax(pColor[channel],zero),one);
+		SoftwareStore(lane[channel],SoftwareMulAdd(value,SoftwareSet(255.0f),SoftwareSet(0.5f)));
+	}
+	for(uint32_t n = 0;n < count;n++)
+	{
+		*ppDest[n] = static_cast<uint32_t>(lane[0][n]) | (static_cast<uint32_t>(lane[1][n]) << 8) |
+			(static_cast<uint32_t>(lane[2][n]) << 16) | (static_cast<uint32_t>(lane[3][n]) << 24);
+	}
+}
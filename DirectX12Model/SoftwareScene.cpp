@@ -0,0 +1,115 @@
+#include "SoftwareScene.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+using namespace std;
+
+//count_̗̈pӂ([SOFTWARE_SIMD_WIDTH̔{܂0Ŗ߂)
+void ResizeSoftwareVertexStream( SoftwareVertexStream* pStream, uint32_t count )
+{
+	const uint32_t paddedCount = (count + SOFTWARE_SIMD_WIDTH - 1) / SOFTWARE_SIMD_WIDTH * SOFTWARE_SIMD_WIDTH;
+	pStream->count = count;
+	pStream->positionX.assign(paddedCount,0.0f);
+	pStream->positionY.assign(paddedCount,0.0f);
+	pStream->positionZ.assign(paddedCount,0.0f);
+	pStream->normalX.assign(paddedCount,0.0f);
+	pStream->normalY.assign(paddedCount,0.0f);
+	pStream->normalZ.assign(paddedCount,0.0f);
+	pStream->u.assign(paddedCount,0.0f);
+	pStream->v.assign(paddedCount,0.0f);
+}
+
+//indexԖڂ̒_𐬕Ƃɏ(ʒuƖ@3vfAUV2vf)
+//_̍\̂̓TvƂɈႤ̂ŁAבւ͌Ăяo1_s
+void SetSoftwareVertex( SoftwareVertexStream* pStream, uint32_t index, const float* pPosition, const float* pNormal, const float* pUV )
+{
+	pStream->positionX[index] = pPosition[0];
+	pStream->positionY[index] = pPosition[1];
+	pStream->positionZ[index] = pPosition[2];
+	pStream->normalX[index] = pNormal[0];
+	pStream->normalY[index] = pNormal[1];
+	pStream->normalZ[index] = pNormal[2];
+	pStream->u[index] = pUV[0];
+	pStream->v[index] = pUV[1];
+}
+
+//`悲Ƃ̍s܂Ƃ߂
+void SetSoftwareDrawConstant( FXMMATRIX instanceWorld, CXMMATRIX world, CXMMATRIX view, CXMMATRIX project, SoftwareDrawConstant* pConstant )
+{
+	XMStoreFloat4x4(&pConstant->worldViewProject,instanceWorld * world * view * project);
+	XMStoreFloat4x4(&pConstant->instanceNormal,instanceWorld);
+	XMStoreFloat4x4(&pConstant->world,world);
+}
+
+//VSMainƓvZSOFTWARE_SIMD_WIDTH_܂Ƃ߂čs
+//ʒu͂܂Ƃ߂s1|邾ɂ
+//@float4(n * (float3x3)instance, 1)𐳋KĂworld|
+void TransformSoftwareVertexStream( const SoftwareVertexStream& stream, uint32_t first, uint32_t count, const SoftwareDrawConstant& constant, SoftwareVertex* pOutput )
+{
+	SoftwareFloat matrix[4][4];
+	SoftwareFloat world[4][4];
+	SoftwareFloat instance[3][3];
+	for(uint32_t row = 0;row < 4;row++)
+	{
+		for(uint32_t column = 0;column < 4;column++)
+		{
+			matrix[row][column] = SoftwareSet(constant.worldViewProject.m[row][column]);
+			world[row][column] = SoftwareSet(constant.world.m[row][column]);
+			if(row < 3 && column < 3)
+			{
+				instance[row][column] = SoftwareSet(constant.instanceNormal.m[row][column]);
+			}
+		}
+	}
+	const SoftwareFloat one = SoftwareSet(1.0f);
+
+	const uint32_t end = first + count;
+	for(uint32_t base = first;base < end;base += SOFTWARE_SIMD_WIDTH)
+	{
+		const SoftwareFloat x = SoftwareLoad(&stream.positionX[base]);
+		const SoftwareFloat y = SoftwareLoad(&stream.positionY[base]);
+		const SoftwareFloat z = SoftwareLoad(&stream.positionZ[base]);
+		const SoftwareFloat nx = SoftwareLoad(&stream.normalX[base]);
+		const SoftwareFloat ny = SoftwareLoad(&stream.normalY[base]);
+		const SoftwareFloat nz = SoftwareLoad(&stream.normalZ[base]);
+
+		//ƂɌvZĈU߂Ă(0`3ʒuA4`7@)
+		float lane[8][SOFTWARE_SIMD_WIDTH];
+		for(uint32_t column = 0;column < 4;column++)
+		{
+			SoftwareFloat value = SoftwareMulAdd(x,matrix[0][column],matrix[3][column]);
+			value = SoftwareMulAdd(y,matrix[1][column],value);
+			value = SoftwareMulAdd(z,matrix[2][column],value);
+			SoftwareStore(lane[column],value);
+		}
+
+		SoftwareFloat normal[3];
+		for(uint32_t column = 0;column < 3;column++)
+		{
+			SoftwareFloat value = SoftwareMul(nx,instance[0][column]);
+			value = SoftwareMulAdd(ny,instance[1][column],value);
+			normal[column] = SoftwareMulAdd(nz,instance[2][column],value);
+		}
+		SoftwareFloat lengthSquare = SoftwareMulAdd(normal[0],normal[0],one);
+		lengthSquare = SoftwareMulAdd(normal[1],normal[1],lengthSquare);
+		lengthSquare = SoftwareMulAdd(normal[2],normal[2],lengthSquare);
+		const SoftwareFloat invLength = SoftwareDiv(one,SoftwareSqrt(lengthSquare));
+		for(uint32_t column = 0;column < 4;column++)
+		{
+			SoftwareFloat value = SoftwareMulAdd(normal[0],world[0][column],world[3][column]);
+			value = SoftwareMulAdd(normal[1],world[1][column],value);
+			value = SoftwareMulAdd(normal[2],world[2][column],value);
+			SoftwareStore(lane[4 + column],SoftwareMul(value,invLength));
+		}
+
+		const uint32_t laneCount = min(SOFTWARE_SIMD_WIDTH,end - base);
+		for(uint32_t n = 0;n < laneCount;n++)
+		{
+			SoftwareVertex& vertex = pOutput[base + n];
+			vertex.position = XMFLOAT4(lane[0][n],lane[1][n],lane[2][n],lane[3][n]);
+			vertex.normal = XMFLOAT4(lane[4][n],lane[5][n],lane[6][n],lane[7][n]);
+			vertex.uv = XMFLOAT2(stream.u[base + n],stream.v[base + n]);
+		}
+	}
+}
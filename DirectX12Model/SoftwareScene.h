@@ -0,0 +1,41 @@
+#pragma once
+
+//\tgEFAX^CU[(SoftwareRenderer.h)ɓn_̕ϊ
+//bV̒_𐬕ƂɕבւĂAVSMainƓvZSOFTWARE_SIMD_WIDTH_s
+//D3D12Win32ɂ͈ˑȂ̂ŁAwbhX̕`ƃTv̗Ŏg
+
+#include "SoftwareRenderer.h"
+
+#include <cstdint>
+#include <vector>
+
+const uint32_t SOFTWARE_VERTEX_JOB_SIZE = 1024;	//1̃Wuŕϊ钸_̐
+
+//SIMDœǂ߂悤ɐƂɕבւ_(SOFTWARE_SIMD_WIDTH̔{܂0Ŗ߂)
+struct SoftwareVertexStream
+{
+	uint32_t count;
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> normalX;
+	std::vector<float> normalY;
+	std::vector<float> normalZ;
+	std::vector<float> u;
+	std::vector<float> v;
+};
+
+//`悲Ƃ1񂾂vZĂs
+struct SoftwareDrawConstant
+{
+	DirectX::XMFLOAT4X4 worldViewProject;	//CX^XAworldAviewAproject܂Ƃ߂
+	DirectX::XMFLOAT4X4 instanceNormal;		//@Ɋ|CX^X3x3̕
+	DirectX::XMFLOAT4X4 world;
+};
+
+void ResizeSoftwareVertexStream( SoftwareVertexStream* pStream, uint32_t count );
+void SetSoftwareVertex( SoftwareVertexStream* pStream, uint32_t index, const float* pPosition, const float* pNormal, const float* pUV );
+void SetSoftwareDrawConstant( DirectX::FXMMATRIX instanceWorld, DirectX::CXMMATRIX world, DirectX::CXMMATRIX view, DirectX::CXMMATRIX project,
+	SoftwareDrawConstant* pConstant );
+void TransformSoftwareVertexStream( const SoftwareVertexStream& stream, uint32_t first, uint32_t count, const SoftwareDrawConstant& constant,
+	SoftwareVertex* pOutput );
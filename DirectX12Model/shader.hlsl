@@ -14,7 +14,11 @@ cbuffer LightBuffer : register(b1)
 {
 	float3 light;
 };
-cbuffer MaterialBuffer : register(b2)
+cbuffer DrawConstant : register(b2)
+{
+	uint materialIndex;
+};
+struct Material
 {
 	float3 diffuse;
 	float alpha;
@@ -25,18 +29,23 @@ cbuffer MaterialBuffer : register(b2)
 };
 
 Texture2D g_texture : register(t0);
+StructuredBuffer<Material> g_material : register(t1);
 SamplerState g_sampler : register(s0);
 
 
-PSInput VSMain(float4 position : POSITION, float4 normal : NORMAL, float2 uv : TEXCOORD)
+PSInput VSMain(float4 position : POSITION, float4 normal : NORMAL, float2 uv : TEXCOORD,
+	float4 instance0 : WORLD0, float4 instance1 : WORLD1, float4 instance2 : WORLD2, float4 instance3 : WORLD3)
 {
     PSInput result;
-	result.position = mul(world,position);
+	float4x4 instanceWorld = float4x4(instance0, instance1, instance2, instance3);
+	float4 instancePosition = mul(position, instanceWorld);
+	float4 instanceNormal = float4(mul(normal.xyz, (float3x3)instanceWorld), normal.w);
+	result.position = mul(world,instancePosition);
 	result.position = mul(view,result.position);
 	result.position = mul(proj,result.position);
 	//result.color = color;
 	//result.uv = uv;
-	result.normal = mul(world,normalize(normal));
+	result.normal = mul(world,normalize(instanceNormal));
 
     return result;
 }
@@ -46,5 +55,6 @@ float4 PSMain(PSInput input) : SV_TARGET
 	float p = dot(input.normal, -light.xyz);
 	p = p * 0.2 + 0.8;
 	p = p * p;
-	return p * float4(diffuse,1.0); // * g_texture.Sample(g_sampler, input.uv);
+	Material material = g_material[materialIndex];
+	return p * float4(material.diffuse,1.0); // * g_texture.Sample(g_sampler, input.uv);
 }
\ No newline at end of file
@@ -10,7 +10,15 @@
 
 #include <DirectXMath.h>
 #include <vector>
+#include <algorithm>
+#include <thread>
 #include <fstream>
+#include <cstdio>
+
+#include "../DirectX12Model/ShaderCache.h"
+#include "SpriteExpand.h"
+#include "SpriteBillboard.h"
+#include "ParticleSystem.h"
 
 using namespace DirectX;
 using Microsoft::WRL::ComPtr;
@@ -40,8 +48,15 @@ bool CreateCommandList();
 bool CreateRootSignature();
 bool CompileShader();
 bool CreatePipelineStateObject();
+bool CompileShaderWithD3DCompiler( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode );
 bool CreateVertexBuffer();
 bool CreateCbvSrv();
+bool BenchmarkDynamicVertexStream();
+bool CreateQuadIndexBuffer( UINT quadCount );
+bool RunHeadless( UINT pointCount );
+bool CreateSpriteCornerBuffer();
+bool BenchmarkParticleSystem( UINT count, UINT threadCount );
 
 //bool UpdateSubresouce(
 //	ID3D12GraphicsCommandList* pList,
@@ -85,13 +100,33 @@ std::vector<UINT8> LoadTexture( const char* fileName );
 
 const UINT FRAME_COUNT = 2;
 
-struct Vertex
+//|CgXvCg̕`@
+enum SpriteMode
+{
+	SPRITE_MODE_GEOMETRY_SHADER,	//_̂܂GSMainŎlp`ɂ
+	SPRITE_MODE_CPU_EXPAND,			//CPUŎlp`̒_ɂĂWIgVF[_[ŕ`
+	SPRITE_MODE_INSTANCED,			//ʂ̎lp`XvCg̐CX^X`悵AVSInstancedMainŃJɌ
+};
+
+//t[CPU珑ޓI_Xg[
+//t[Ƃɕʂ̗̈A}bv܂ܒǋLĂ
+const UINT DYNAMIC_VERTEX_CAPACITY = 2 * 1024 * 1024;	//1t[̍ő咸_
+const UINT SPRITE_INSTANCE_CAPACITY = 2 * 1024 * 1024;	//1t[̍őXvCg(SPRITE_MODE_INSTANCED)
+struct DynamicVertexStream
 {
-	XMFLOAT3 possition;
-	float scale;
-	//XMFLOAT4 color;
-	//XMFLOAT2 uv;
+	ComPtr<ID3D12Resource> buffer;
+	UINT8* pDataBegin;		//St[̐擪(ݐpAǂݏoȂ)
+	UINT stride;			//1_̃oCg
+	UINT capacity;
+	UINT frame;				//ݒ̃t[
+	UINT count;				//̃t[Œǉ_
 };
+
+bool CreateDynamicVertexStream( DynamicVertexStream* pStream, UINT capacity, UINT stride );
+void BeginDynamicVertexStream( DynamicVertexStream* pStream, UINT frame );
+void* AppendDynamicVertex( DynamicVertexStream* pStream, UINT count );
+bool AppendDynamicVertex( DynamicVertexStream* pStream, const void* pVertices, UINT count );
+D3D12_VERTEX_BUFFER_VIEW GetDynamicVertexBufferView( const DynamicVertexStream* pStream );
 __declspec(align(256))
 struct ConstantBuffer
 {
@@ -109,6 +144,8 @@ ComPtr<ID3D12Resource> g_renderTarget[FRAME_COUNT];
 ComPtr<ID3D12CommandAllocator> g_commandAllocator[FRAME_COUNT];
 ComPtr<ID3D12GraphicsCommandList> g_commandList;
 ComPtr<ID3D12PipelineState> g_pipelineState;
+ComPtr<ID3D12PipelineState> g_quadPipelineState;	//SPRITE_MODE_CPU_EXPANDp(WIgVF[_[)
+ComPtr<ID3D12PipelineState> g_instancedPipelineState;	//SPRITE_MODE_INSTANCEDp
 UINT g_rtvDescriptorSize = 0;
 UINT g_dsvDescriptorSize = 0;
 UINT g_cbvSrvDescriptorSize = 0;
@@ -126,8 +163,19 @@ ComPtr<IDXGIFactory4> factory;
 
 
 //\[X
-ComPtr<ID3D12Resource> g_vertexBuffer;
+DynamicVertexStream g_vertexStream;
 D3D12_VERTEX_BUFFER_VIEW g_vertexBufferView;
+DynamicVertexStream g_quadStream;			//CPUœWJXvCg̒_(14_)
+D3D12_VERTEX_BUFFER_VIEW g_quadVertexBufferView;
+ComPtr<ID3D12Resource> g_quadIndexBuffer;	//lp`2̎Op`ɂCfbNX(St[ŋ)
+D3D12_INDEX_BUFFER_VIEW g_quadIndexBufferView;
+ComPtr<ID3D12Resource> g_spriteCornerBuffer;	//SPRITE_CORNER̒_obt@
+D3D12_VERTEX_BUFFER_VIEW g_spriteCornerBufferView;
+DynamicVertexStream g_instanceStream;		//XvCgƂSpriteInstance
+D3D12_VERTEX_BUFFER_VIEW g_instanceBufferView;
+vector<SpriteInstance> g_spriteInstances;	//"-instanced N"ōXvCg(t[g_instanceStreamɎʂ)
+ParticleSystem g_particles;
+vector<Vertex> g_particleVertices;			//SPRITE_MODE_CPU_EXPANDœWJÕp[eBN
 ComPtr<ID3D12Resource> g_texture;
 ComPtr<ID3D12Resource> g_constantBuffer = nullptr;
 ConstantBuffer g_constantBufferData;
@@ -140,8 +188,18 @@ UINT64 g_fenceValue[FRAME_COUNT] = {};
 HANDLE g_fenceEvent;
 
 bool g_useWarpDevice = false;
+bool g_benchmarkVertexStream = false;	//N"-benchmark"w肷ƒ_Xg[̏ݑxv
+UINT g_spriteMode = SPRITE_MODE_GEOMETRY_SHADER;	//N"-cpuexpand"w肷SPRITE_MODE_CPU_EXPANDA"-instanced"SPRITE_MODE_INSTANCED
+UINT g_spriteInstanceCount = 0;		//"-instanced N"N(0Ȃ3̓_`)
+UINT g_particleCount = 0;			//"-particles N"N(0Ȃp[eBNgȂ)
 float g_aspectRatio;
 
+//VF[_[̃LbV(ShaderCache.h)
+//ShaderMacroD3D_SHADER_MACROƓтɂĂ̂ŁAD3DCompileɂ͂̂܂ܓn
+#define SHADER_CACHE_DIRECTORY "ShaderCache"
+static_assert(sizeof(ShaderMacro) == sizeof(D3D_SHADER_MACRO), "ShaderMacro");
+ShaderCache g_shaderCache;
+
 //------------------------------------------------------------------------------------------------
 // Returns required size of a buffer to be used for data upload
 inline UINT64 GetRequiredIntermediateSize(
@@ -286,8 +344,40 @@ UINT64 UpdateSubresources(
 }
 
 
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow)
 {
+	//"-headless N"w肷ƃEBhEƃfoCX炸CPUN̓_lp`ɓWJ
+	const char* pHeadless = strstr(lpCmdLine,"-headless");
+	if(pHeadless != nullptr)
+	{
+		return RunHeadless(static_cast<UINT>(atoi(pHeadless + strlen("-headless")))) ? 0 : -1;
+	}
+
+	if(strstr(lpCmdLine,"-benchmark") != nullptr)
+	{
+		g_benchmarkVertexStream = true;
+	}
+	if(strstr(lpCmdLine,"-cpuexpand") != nullptr)
+	{
+		g_spriteMode = SPRITE_MODE_CPU_EXPAND;
+	}
+	const char* pInstanced = strstr(lpCmdLine,"-instanced");
+	if(pInstanced != nullptr)
+	{
+		g_spriteMode = SPRITE_MODE_INSTANCED;
+		g_spriteInstanceCount = min(static_cast<UINT>(atoi(pInstanced + strlen("-instanced"))),SPRITE_INSTANCE_CAPACITY);
+	}
+	//"-particles N"w肷3̓_̑N炢̃p[eBN𕬂グ
+	const char* pParticles = strstr(lpCmdLine,"-particles");
+	if(pParticles != nullptr)
+	{
+		g_particleCount = static_cast<UINT>(atoi(pParticles + strlen("-particles")));
+		if(g_particleCount == 0)
+		{
+			g_particleCount = 100000;
+		}
+	}
+
 	//EBhȄ-------------------------------
 	WNDCLASSEX windowClass = {0};
 	windowClass.cbSize = sizeof(windowClass);
@@ -318,6 +408,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
 
 	if(!Init(hwnd))
 	{
+		//p[eBÑXbhjoinȂ܂܏Istd::terminate()ɂȂ̂ŁAsĂ~߂
+		DestroyParticleSystem(&g_particles);
 		return -1;
 	}
 
@@ -339,12 +431,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
 		}
 		else
 		{
-			if(!Update())
-			{
-				return -1;
-			}
-			if(!Render())
+			if(!Update() || !Render())
 			{
+				DestroyParticleSystem(&g_particles);
 				return -1;
 			}
 		}
@@ -451,6 +540,34 @@ bool InitResource()
 		return false;
 	}
 
+	if(g_particleCount > 0)
+	{
+		//ݐ̃Xg[Ɏ܂鐔ɂ
+		UINT capacity = DYNAMIC_VERTEX_CAPACITY;
+		if(g_spriteMode == SPRITE_MODE_CPU_EXPAND)
+		{
+			capacity = DYNAMIC_VERTEX_CAPACITY / 4;
+		}
+		else if(g_spriteMode == SPRITE_MODE_INSTANCED)
+		{
+			capacity = SPRITE_INSTANCE_CAPACITY;
+		}
+		g_particleCount = min(g_particleCount,capacity / 5 * 4);
+		const UINT threadCount = min(max(thread::hardware_concurrency(),1u),MAX_PARTICLE_THREAD_COUNT);
+		if(!CreateParticleFountain(&g_particles,g_particleCount,capacity,threadCount))
+		{
+			return false;
+		}
+	}
+
+	if(g_benchmarkVertexStream)
+	{
+		if(!BenchmarkDynamicVertexStream())
+		{
+			return false;
+		}
+	}
+
 	if(!CreateCbvSrv())
 	{
 		return false;
@@ -467,6 +584,128 @@ bool InitResource()
 //XV
 bool Update()
 {
+	//̃t[̒_
+	//GPUMoveToNextFrame()ł̃t[̗̈gIĂ
+	BeginDynamicVertexStream(&g_vertexStream,g_frameIndex);
+
+	if(g_particleCount > 0)
+	{
+		//Õt[̌oߎԂp[eBNi߂āA`@ɍ킹Xg[ɏ
+		static LARGE_INTEGER previous = {};
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER now;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&now);
+		float deltaTime = 1.0f / 60.0f;
+		if(previous.QuadPart != 0)
+		{
+			deltaTime = min(static_cast<float>(now.QuadPart - previous.QuadPart) / frequency.QuadPart,0.1f);
+		}
+		previous = now;
+		UpdateParticleSystem(&g_particles,deltaTime);
+
+		const UINT count = g_particles.count;
+		if(g_spriteMode == SPRITE_MODE_INSTANCED)
+		{
+			BeginDynamicVertexStream(&g_instanceStream,g_frameIndex);
+			SpriteInstance* pInstance = static_cast<SpriteInstance*>(AppendDynamicVertex(&g_instanceStream,count));
+			if(pInstance == nullptr)
+			{
+				return false;
+			}
+			WriteParticleSprites(&g_particles,pInstance);
+			g_instanceBufferView = GetDynamicVertexBufferView(&g_instanceStream);
+		}
+		else if(g_spriteMode == SPRITE_MODE_CPU_EXPAND)
+		{
+			g_particleVertices.resize(count);
+			WriteParticleVertices(&g_particles,g_particleVertices.data());
+			BeginDynamicVertexStream(&g_quadStream,g_frameIndex);
+			SpriteVertex* pQuad = static_cast<SpriteVertex*>(AppendDynamicVertex(&g_quadStream,count * 4));
+			if(pQuad == nullptr)
+			{
+				return false;
+			}
+			ExpandPointSprites(g_particleVertices.data(),count,
+				g_constantBufferData.world * g_constantBufferData.view * g_constantBufferData.project,pQuad);
+			g_quadVertexBufferView = GetDynamicVertexBufferView(&g_quadStream);
+		}
+		else
+		{
+			Vertex* pVertex = static_cast<Vertex*>(AppendDynamicVertex(&g_vertexStream,count));
+			if(pVertex == nullptr)
+			{
+				return false;
+			}
+			WriteParticleVertices(&g_particles,pVertex);
+			g_vertexBufferView = GetDynamicVertexBufferView(&g_vertexStream);
+		}
+		return true;
+	}
+
+	const Vertex vertices[] =
+	{
+		{ {0.0f, 1.0f, 0.0f}, 1.0f },
+		{ {1.0f, -1.0f, 0.0f}, 5.0f },
+		{ {-1.0f, -1.0f, 0.0f}, 10.0f},
+	};
+	if(g_spriteMode == SPRITE_MODE_INSTANCED)
+	{
+		//pVSInstancedMainŋ߂̂ŁAXvCg1SpriteInstance1
+		BeginDynamicVertexStream(&g_instanceStream,g_frameIndex);
+		if(g_spriteInstanceCount > 0)
+		{
+			if(!AppendDynamicVertex(&g_instanceStream,g_spriteInstances.data(),g_spriteInstanceCount))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			static float angle = 0.0f;
+			angle += 0.01f;
+			const XMFLOAT4 color[_countof(vertices)] =
+			{
+				{ 1.0f, 1.0f, 1.0f, 1.0f },
+				{ 1.0f, 0.5f, 0.5f, 1.0f },
+				{ 0.5f, 0.5f, 1.0f, 1.0f },
+			};
+			SpriteInstance* pInstance = static_cast<SpriteInstance*>(AppendDynamicVertex(&g_instanceStream,_countof(vertices)));
+			if(pInstance == nullptr)
+			{
+				return false;
+			}
+			for(UINT n = 0;n < _countof(vertices);n++)
+			{
+				pInstance[n].position = vertices[n].possition;
+				pInstance[n].size = vertices[n].scale;
+				pInstance[n].color = color[n];
+				pInstance[n].rotation = angle * (n + 1);
+			}
+		}
+		g_instanceBufferView = GetDynamicVertexBufferView(&g_instanceStream);
+		return true;
+	}
+	if(g_spriteMode == SPRITE_MODE_CPU_EXPAND)
+	{
+		//GSMain̑ɁA萔obt@Ɠs4̊pɂĂ珑
+		BeginDynamicVertexStream(&g_quadStream,g_frameIndex);
+		SpriteVertex* pQuad = static_cast<SpriteVertex*>(AppendDynamicVertex(&g_quadStream,_countof(vertices) * 4));
+		if(pQuad == nullptr)
+		{
+			return false;
+		}
+		ExpandPointSprites(vertices,_countof(vertices),
+			g_constantBufferData.world * g_constantBufferData.view * g_constantBufferData.project,pQuad);
+		g_quadVertexBufferView = GetDynamicVertexBufferView(&g_quadStream);
+		return true;
+	}
+	if(!AppendDynamicVertex(&g_vertexStream,vertices,_countof(vertices)))
+	{
+		return false;
+	}
+	g_vertexBufferView = GetDynamicVertexBufferView(&g_vertexStream);
+
 	/*static float angle = 0.0f;
 	angle += 0.01f;
 	g_constantBufferData.world = XMMatrixRotationY(angle);
@@ -563,9 +802,30 @@ bool PopulateCommandList()
 
 	
 	
-	g_commandList->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
-	g_commandList->IASetVertexBuffers(0, 1, &g_vertexBufferView);
-	g_commandList->DrawInstanced(3, 1, 0, 0);
+	if(g_spriteMode == SPRITE_MODE_CPU_EXPAND)
+	{
+		g_commandList->SetPipelineState(g_quadPipelineState.Get());
+		g_commandList->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		g_commandList->IASetVertexBuffers(0, 1, &g_quadVertexBufferView);
+		g_commandList->IASetIndexBuffer(&g_quadIndexBufferView);
+		g_commandList->DrawIndexedInstanced(g_quadStream.count / 4 * 6, 1, 0, 0, 0);
+	}
+	else if(g_spriteMode == SPRITE_MODE_INSTANCED)
+	{
+		//Xbg0ɋʂ̎lp`AXbg1ɃXvCgƂ̃f[^
+		const D3D12_VERTEX_BUFFER_VIEW vertexBufferView[] = { g_spriteCornerBufferView, g_instanceBufferView };
+		g_commandList->SetPipelineState(g_instancedPipelineState.Get());
+		g_commandList->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		g_commandList->IASetVertexBuffers(0, _countof(vertexBufferView), vertexBufferView);
+		g_commandList->IASetIndexBuffer(&g_quadIndexBufferView);
+		g_commandList->DrawIndexedInstanced(6, g_instanceStream.count, 0, 0, 0);
+	}
+	else
+	{
+		g_commandList->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_POINTLIST);
+		g_commandList->IASetVertexBuffers(0, 1, &g_vertexBufferView);
+		g_commandList->DrawInstanced(g_vertexStream.count, 1, 0, 0);
+	}
 
 	//obNobt@\
 	{
@@ -653,6 +913,9 @@ bool MoveToNextFrame()
 
 bool Destroy()
 {
+	//p[eBÑXbhGPU҂ĂȂĂ~߂
+	DestroyParticleSystem(&g_particles);
+
 	//Õt[҂
 	if(!WaitForGpu())
 	{
@@ -951,7 +1214,7 @@ bool CreateRootSignature()
 	//[gp[^̐ݒ
 	D3D12_ROOT_PARAMETER param[2];
 	param[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-	param[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_GEOMETRY;
+	param[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;	//GSMainVSInstancedMainŎg
 	param[0].DescriptorTable.NumDescriptorRanges = 1;
 	param[0].DescriptorTable.pDescriptorRanges = &range[0];
 
@@ -1015,26 +1278,26 @@ bool CompileShader()
 //pCvC̏ԃIuWFNg쐬
 bool CreatePipelineStateObject()
 {
-	//VF[_[̃RpC
-	ComPtr<ID3DBlob> vertexShader;
-	ComPtr<ID3DBlob> geometryShader;
-	ComPtr<ID3DBlob> pixelShader;
-	ComPtr<ID3DBlob> error;
+	//VF[_[̃RpC(LbVɂ΂g)
+	vector<uint8_t> vertexShader;
+	vector<uint8_t> geometryShader;
+	vector<uint8_t> pixelShader;
 
 #if defined(_DEBUG)
 	UINT compileFlag = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;;
 #else
 	UINT compileFlag = 0;
 #endif
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlag, 0, &vertexShader, &error) ) )
+	InitShaderCache(&g_shaderCache,SHADER_CACHE_DIRECTORY,CompileShaderWithD3DCompiler,D3D_COMPILER_VERSION);
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"VSMain","vs_5_0",compileFlag,&vertexShader,nullptr))
 	{
 		return false;
 	}
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "GSMain", "gs_5_0", compileFlag, 0, &geometryShader, &error) ) )
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"GSMain","gs_5_0",compileFlag,&geometryShader,nullptr))
 	{
 		return false;
 	}
-	if( FAILED(D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlag, 0, &pixelShader, &error) ) )
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"PSMain","ps_5_0",compileFlag,&pixelShader,nullptr))
 	{
 		return false;
 	}
@@ -1084,12 +1347,12 @@ bool CreatePipelineStateObject()
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
 	psoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
 	psoDesc.pRootSignature = g_rootSignature.Get();
-	psoDesc.VS.pShaderBytecode = vertexShader->GetBufferPointer();
-	psoDesc.VS.BytecodeLength = vertexShader->GetBufferSize();
-	psoDesc.GS.pShaderBytecode = geometryShader->GetBufferPointer();
-	psoDesc.GS.BytecodeLength = geometryShader->GetBufferSize();
-	psoDesc.PS.pShaderBytecode = pixelShader->GetBufferPointer();
-	psoDesc.PS.BytecodeLength = pixelShader->GetBufferSize();
+	psoDesc.VS.pShaderBytecode = vertexShader.data();
+	psoDesc.VS.BytecodeLength = vertexShader.size();
+	psoDesc.GS.pShaderBytecode = geometryShader.data();
+	psoDesc.GS.BytecodeLength = geometryShader.size();
+	psoDesc.PS.pShaderBytecode = pixelShader.data();
+	psoDesc.PS.BytecodeLength = pixelShader.size();
 	psoDesc.RasterizerState = rasterrizerStateDesc;
 	psoDesc.BlendState = blendStateDesc;
 	psoDesc.DepthStencilState.DepthEnable = TRUE;
@@ -1107,76 +1370,125 @@ bool CreatePipelineStateObject()
 		return false;
 	}
 
-	return true;
-}
-
-//_obt@̍쐬
-bool CreateVertexBuffer()
-{
-	//Op`̃WIg`
-	Vertex vertices[] =
+	//CPUœWJlp``pCvC(_̓NbvԂȂ̂ŁÂ܂ܓnăWIgVF[_[͎gȂ)
+	vector<uint8_t> quadVertexShader;
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"VSQuadMain","vs_5_0",compileFlag,&quadVertexShader,nullptr))
 	{
-		{ {0.0f, 1.0f, 0.0f}, 1.0f },
-		{ {1.0f, -1.0f, 0.0f}, 5.0f },
-		{ {-1.0f, -1.0f, 0.0f}, 10.0f},
-
-		/*{ {1.0f, 1.0f, 0.0f}, { 1.0f, 0.0f } },
-		{ {1.0f, -1.0f, 0.0f}, { 1.0f, 1.0f } },
-		{ {-1.0f, -1.0f, 0.0f}, { 0.0f, 1.0f } },*/
-
-		/*{ {1.0f, 1.0f, 0.0f}, { 1.0f, 0.0f } },
-		{ {-1.0f, 1.0f, 0.0f}, { 0.0f, 0.0f } },
-		{ {-1.0f, -1.0f, 0.0f}, { 0.0f, 1.0f } },*/
+		return false;
+	}
+	D3D12_INPUT_ELEMENT_DESC quadInputElementDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 	};
+	psoDesc.InputLayout = { quadInputElementDescs, _countof(quadInputElementDescs) };
+	psoDesc.VS.pShaderBytecode = quadVertexShader.data();
+	psoDesc.VS.BytecodeLength = quadVertexShader.size();
+	psoDesc.GS.pShaderBytecode = nullptr;
+	psoDesc.GS.BytecodeLength = 0;
+	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	if(FAILED(g_device->CreateGraphicsPipelineState(&psoDesc,IID_PPV_ARGS(&g_quadPipelineState))))
+	{
+		return false;
+	}
 
-	const UINT vertexBufferSize = sizeof(vertices);
+	//ʂ̎lp`CX^X`悷pCvC(Xbg1̓CX^XƂɐi߂)
+	vector<uint8_t> instancedVertexShader;
+	vector<uint8_t> instancedPixelShader;
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"VSInstancedMain","vs_5_0",compileFlag,&instancedVertexShader,nullptr))
+	{
+		return false;
+	}
+	if(!LoadShader(&g_shaderCache,"shader.hlsl",nullptr,"PSInstancedMain","ps_5_0",compileFlag,&instancedPixelShader,nullptr))
+	{
+		return false;
+	}
+	D3D12_INPUT_ELEMENT_DESC instancedInputElementDescs[] =
+	{
+		{"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{"SPRITE_POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{"PSIZE", 0, DXGI_FORMAT_R32_FLOAT, 1, 12, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+		{"ROTATION", 0, DXGI_FORMAT_R32_FLOAT, 1, 32, D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 },
+	};
+	psoDesc.InputLayout = { instancedInputElementDescs, _countof(instancedInputElementDescs) };
+	psoDesc.VS.pShaderBytecode = instancedVertexShader.data();
+	psoDesc.VS.BytecodeLength = instancedVertexShader.size();
+	psoDesc.PS.pShaderBytecode = instancedPixelShader.data();
+	psoDesc.PS.BytecodeLength = instancedPixelShader.size();
+	if(FAILED(g_device->CreateGraphicsPipelineState(&psoDesc,IID_PPV_ARGS(&g_instancedPipelineState))))
+	{
+		return false;
+	}
 
-	//q[vvpeB̐ݒ
-	D3D12_HEAP_PROPERTIES heapProperties = {};
-	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
-	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-	heapProperties.CreationNodeMask = 1;
-	heapProperties.VisibleNodeMask = 1;
+	char message[256];
+	sprintf_s(message,"shader cache: shader hit %u miss %u\n",g_shaderCache.shaderHit.load(),g_shaderCache.shaderMiss.load());
+	OutputDebugStringA(message);
 
-	//\[X̐ݒ
-	D3D12_RESOURCE_DESC resourceDesc = {};
-	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	resourceDesc.Alignment = 0;
-	resourceDesc.Width = vertexBufferSize;
-	resourceDesc.Height = 1;
-	resourceDesc.DepthOrArraySize = 1;
-	resourceDesc.MipLevels = 1;
-	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-	resourceDesc.SampleDesc.Count = 1;
-	resourceDesc.SampleDesc.Quality = 0;
-	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+	return true;
+}
 
-	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
-		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,IID_PPV_ARGS(&g_vertexBuffer))))
+//D3DCompileŃRpC(VF[_[̃LbṼRpC)
+bool CompileShaderWithD3DCompiler( const char* pSource, size_t sourceSize, const char* pSourceName,
+	const ShaderMacro* pDefines, const char* pEntryPoint, const char* pTarget, uint32_t flags, vector<uint8_t>* pBytecode )
+{
+	ComPtr<ID3DBlob> bytecode;
+	ComPtr<ID3DBlob> error;
+	if(FAILED(D3DCompile(pSource,sourceSize,pSourceName,reinterpret_cast<const D3D_SHADER_MACRO*>(pDefines),nullptr,
+		pEntryPoint,pTarget,flags,0,&bytecode,&error)))
 	{
+		if(error)
+		{
+			OutputDebugStringA(static_cast<const char*>(error->GetBufferPointer()));
+		}
 		return false;
 	}
 
-	//}bv
-	UINT8* pVertexDataBegin;
-	D3D12_RANGE readRange = {0,0};
-	if(FAILED(g_vertexBuffer->Map(0,&readRange,
-		reinterpret_cast<void**>(&pVertexDataBegin))))
+	const UINT8* pBegin = static_cast<const UINT8*>(bytecode->GetBufferPointer());
+	pBytecode->assign(pBegin,pBegin + bytecode->GetBufferSize());
+	return true;
+}
+
+//_obt@̍쐬
+bool CreateVertexBuffer()
+{
+	//_͖t[Update()ŏ
+	if(!CreateDynamicVertexStream(&g_vertexStream,DYNAMIC_VERTEX_CAPACITY,sizeof(Vertex)))
 	{
 		return false;
 	}
-	//_f[^Rs[
-	memcpy(pVertexDataBegin,vertices, sizeof(vertices) );
-	//A}bv
-	g_vertexBuffer->Unmap( 0, nullptr );
 
-	//_obt@r[̐ݒ
-	g_vertexBufferView.BufferLocation = g_vertexBuffer->GetGPUVirtualAddress();
-	g_vertexBufferView.StrideInBytes = sizeof(Vertex);
-	g_vertexBufferView.SizeInBytes = vertexBufferSize;
+	if(g_spriteMode == SPRITE_MODE_CPU_EXPAND)
+	{
+		if(!CreateDynamicVertexStream(&g_quadStream,DYNAMIC_VERTEX_CAPACITY,sizeof(SpriteVertex)))
+		{
+			return false;
+		}
+		if(!CreateQuadIndexBuffer(DYNAMIC_VERTEX_CAPACITY / 4))
+		{
+			return false;
+		}
+	}
+
+	if(g_spriteMode == SPRITE_MODE_INSTANCED)
+	{
+		if(!CreateDynamicVertexStream(&g_instanceStream,SPRITE_INSTANCE_CAPACITY,sizeof(SpriteInstance)))
+		{
+			return false;
+		}
+		if(!CreateSpriteCornerBuffer())
+		{
+			return false;
+		}
+		//SCX^Xœlp`ĝŃCfbNX1ł悢
+		if(!CreateQuadIndexBuffer(1))
+		{
+			return false;
+		}
+		g_spriteInstances.resize(g_spriteInstanceCount);
+		BuildSpriteInstances(g_spriteInstanceCount,g_spriteInstances.data());
+	}
 
 	return true;
 }
@@ -1811,3 +2123,357 @@ std::vector<UINT8> LoadTexture( const char* fileName )
 	return data;
 }
 
+//I_Xg[̍쐬
+bool CreateDynamicVertexStream( DynamicVertexStream* pStream, UINT capacity, UINT stride )
+{
+	//q[vvpeB̐ݒ
+	D3D12_HEAP_PROPERTIES heapProperties = {};
+	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapProperties.CreationNodeMask = 1;
+	heapProperties.VisibleNodeMask = 1;
+
+	//\[X̐ݒ(t[̗̈1̃obt@ɂ܂Ƃ߂)
+	D3D12_RESOURCE_DESC resourceDesc = {};
+	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	resourceDesc.Alignment = 0;
+	resourceDesc.Width = static_cast<UINT64>(stride) * capacity * FRAME_COUNT;
+	resourceDesc.Height = 1;
+	resourceDesc.DepthOrArraySize = 1;
+	resourceDesc.MipLevels = 1;
+	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+	resourceDesc.SampleDesc.Count = 1;
+	resourceDesc.SampleDesc.Quality = 0;
+	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
+		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,IID_PPV_ARGS(&pStream->buffer))))
+	{
+		return false;
+	}
+
+	//}bv܂܂ɂ(A}bv͂Ȃ)
+	D3D12_RANGE readRange = {0,0};
+	if(FAILED(pStream->buffer->Map(0,&readRange,
+		reinterpret_cast<void**>(&pStream->pDataBegin))))
+	{
+		return false;
+	}
+
+	pStream->stride = stride;
+	pStream->capacity = capacity;
+	pStream->frame = 0;
+	pStream->count = 0;
+
+	return true;
+}
+
+//t[݂̏Jn
+void BeginDynamicVertexStream( DynamicVertexStream* pStream, UINT frame )
+{
+	pStream->frame = frame;
+	pStream->count = 0;
+}
+
+//count̏ݐmۂĕԂ(Ȃnullptr)
+//V~[V璼ڏނƂɎg
+void* AppendDynamicVertex( DynamicVertexStream* pStream, UINT count )
+{
+	if(count > pStream->capacity - pStream->count)
+	{
+		return nullptr;
+	}
+
+	UINT8* pVertex = pStream->pDataBegin + (static_cast<UINT64>(pStream->capacity) * pStream->frame + pStream->count) * pStream->stride;
+	pStream->count += count;
+	return pVertex;
+}
+
+//_z܂Ƃ߂Ēǉ
+bool AppendDynamicVertex( DynamicVertexStream* pStream, const void* pVertices, UINT count )
+{
+	void* pVertex = AppendDynamicVertex(pStream,count);
+	if(pVertex == nullptr)
+	{
+		return false;
+	}
+	memcpy(pVertex,pVertices,static_cast<size_t>(pStream->stride) * count);
+	return true;
+}
+
+//̃t[ŏ񂾔͈͂̒_obt@r[擾
+D3D12_VERTEX_BUFFER_VIEW GetDynamicVertexBufferView( const DynamicVertexStream* pStream )
+{
+	D3D12_VERTEX_BUFFER_VIEW view;
+	view.BufferLocation = pStream->buffer->GetGPUVirtualAddress() +
+		static_cast<UINT64>(pStream->stride) * pStream->capacity * pStream->frame;
+	view.StrideInBytes = pStream->stride;
+	view.SizeInBytes = pStream->stride * pStream->count;
+	return view;
+}
+
+//I_Xg[ւ̏ݑxv
+//`JnOɌĂԂ̂őSt[̗̈RɎg
+bool BenchmarkDynamicVertexStream()
+{
+	const UINT iterationCount = 120;
+	const UINT vertexCount = g_vertexStream.capacity;
+
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER begin;
+	LARGE_INTEGER end;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&begin);
+
+	for(UINT i = 0;i < iterationCount;i++)
+	{
+		BeginDynamicVertexStream(&g_vertexStream,i % FRAME_COUNT);
+
+		//V~[V̏o͂z肵āA1024_mۂďԂɏ
+		for(UINT k = 0;k < vertexCount;k += 1024)
+		{
+			const UINT count = min(1024u,vertexCount - k);
+			Vertex* pVertex = static_cast<Vertex*>(AppendDynamicVertex(&g_vertexStream,count));
+			if(pVertex == nullptr)
+			{
+				return false;
+			}
+			for(UINT n = 0;n < count;n++)
+			{
+				const float t = static_cast<float>(k + n + i);
+				pVertex[n].possition = XMFLOAT3(t,-t,0.0f);
+				pVertex[n].scale = 1.0f;
+			}
+		}
+	}
+
+	QueryPerformanceCounter(&end);
+
+	const double seconds = static_cast<double>(end.QuadPart - begin.QuadPart) / frequency.QuadPart;
+	const double bytes = static_cast<double>(sizeof(Vertex)) * vertexCount * iterationCount;
+	char text[256];
+	sprintf_s(text,"DynamicVertexStream: %u vertices x %u frames, %.3f ms/frame, %.2f GB/s\n",
+		vertexCount,iterationCount,seconds * 1000.0 / iterationCount,bytes / seconds / (1024.0 * 1024.0 * 1024.0));
+	OutputDebugStringA(text);
+
+	BeginDynamicVertexStream(&g_vertexStream,g_frameIndex);
+
+	return true;
+}
+
+//lp`2̎Op`ɂCfbNXobt@̍쐬
+//p̕тGSMaiñXgbvƓ(AEAAE)Ȃ̂ŁA0,1,22,1,3ɂ
+bool CreateQuadIndexBuffer( UINT quadCount )
+{
+	D3D12_HEAP_PROPERTIES heapProperties = {};
+	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapProperties.CreationNodeMask = 1;
+	heapProperties.VisibleNodeMask = 1;
+
+	const UINT64 size = static_cast<UINT64>(sizeof(UINT32)) * 6 * quadCount;
+	D3D12_RESOURCE_DESC resourceDesc = {};
+	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	resourceDesc.Alignment = 0;
+	resourceDesc.Width = size;
+	resourceDesc.Height = 1;
+	resourceDesc.DepthOrArraySize = 1;
+	resourceDesc.MipLevels = 1;
+	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+	resourceDesc.SampleDesc.Count = 1;
+	resourceDesc.SampleDesc.Quality = 0;
+	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
+		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,IID_PPV_ARGS(&g_quadIndexBuffer))))
+	{
+		return false;
+	}
+
+	UINT32* pIndex;
+	D3D12_RANGE readRange = {0,0};
+	if(FAILED(g_quadIndexBuffer->Map(0,&readRange,reinterpret_cast<void**>(&pIndex))))
+	{
+		return false;
+	}
+	const UINT32 QUAD_INDEX[] = { 0, 1, 2, 2, 1, 3 };
+	for(UINT n = 0;n < quadCount;n++)
+	{
+		for(UINT k = 0;k < 6;k++)
+		{
+			pIndex[n * 6 + k] = n * 4 + QUAD_INDEX[k];
+		}
+	}
+	g_quadIndexBuffer->Unmap(0,nullptr);
+
+	g_quadIndexBufferView.BufferLocation = g_quadIndexBuffer->GetGPUVirtualAddress();
+	g_quadIndexBufferView.SizeInBytes = static_cast<UINT>(size);
+	g_quadIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+	return true;
+}
+
+//EBhEƃfoCX炸CPUœ_lp`ɓWJ
+//pointCount̓_Update()̍sŉ񂵂ȂWJĎԂo͂(GSMainƓ̌vZƂ̔rTests/SpriteExpandTest.cpp)
+//ʂ͕Wo͂ɏ(r{[h̊mFTests/SpriteBillboardTest.cpp)
+bool RunHeadless( UINT pointCount )
+{
+	const UINT FRAME_COUNT_HEADLESS = 60;
+	if(pointCount == 0)
+	{
+		pointCount = 1000000;
+	}
+
+	//-10`10͈̔͂ɎU΂傫̈Ⴄ_
+	vector<Vertex> point(pointCount);
+	for(UINT n = 0;n < pointCount;n++)
+	{
+		point[n].possition = XMFLOAT3(sinf(n * 0.37f) * 10.0f,cosf(n * 0.11f) * 10.0f,sinf(n * 0.05f + 1.0f) * 10.0f);
+		point[n].scale = 0.1f + (n % 10) * 0.1f;
+	}
+	vector<SpriteVertex> quad(static_cast<size_t>(pointCount) * 4);
+
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,0.0f,-10.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(0.78539816339744830961566084581988f,1280.0f/720.0f,1.0f,1000.0f);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER begin;
+	QueryPerformanceCounter(&begin);
+
+	for(UINT frame = 0;frame < FRAME_COUNT_HEADLESS;frame++)
+	{
+		const XMMATRIX world = XMMatrixRotationY(frame * 0.01f);
+		ExpandPointSprites(point.data(),pointCount,world * view * project,quad.data());
+	}
+
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	const double ms = (end.QuadPart - begin.QuadPart) * 1000.0 / frequency.QuadPart / FRAME_COUNT_HEADLESS;
+	printf("Headless: %u points, SIMD width %u, %.3f ms/frame (%.1f Mpoints/s)\n",
+		pointCount,SOFTWARE_SIMD_WIDTH,ms,pointCount / ms / 1000.0);
+
+	//SPRITE_MODE_INSTANCEDŖt[SpriteInstance̎
+	vector<SpriteInstance> instance(pointCount);
+	BuildSpriteInstances(pointCount,instance.data());
+	vector<SpriteInstance> instanceStream(pointCount);
+	QueryPerformanceCounter(&begin);
+	for(UINT frame = 0;frame < FRAME_COUNT_HEADLESS;frame++)
+	{
+		memcpy(instanceStream.data(),instance.data(),sizeof(SpriteInstance) * pointCount);
+	}
+	QueryPerformanceCounter(&end);
+	const double instanceMs = (end.QuadPart - begin.QuadPart) * 1000.0 / frequency.QuadPart / FRAME_COUNT_HEADLESS;
+
+	printf("Instanced: %u sprites, %u bytes/sprite (CPU expand %u, GS %u), %.3f ms/frame write\n",
+		pointCount,static_cast<UINT>(sizeof(SpriteInstance)),static_cast<UINT>(sizeof(SpriteVertex) * 4),static_cast<UINT>(sizeof(Vertex)),
+		instanceMs);
+
+	//p[eBN̍XV(SXbh1XbhŔׂ)
+	const UINT threadCount = min(max(thread::hardware_concurrency(),1u),MAX_PARTICLE_THREAD_COUNT);
+	const UINT particleCount[] = { pointCount, pointCount * 10 };
+	for(UINT n = 0;n < _countof(particleCount);n++)
+	{
+		if(!BenchmarkParticleSystem(particleCount[n],threadCount))
+		{
+			return false;
+		}
+		if(threadCount > 1 && !BenchmarkParticleSystem(particleCount[n],1))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//SPRITE_CORNER̒_obt@̍쐬(SPRITE_MODE_INSTANCEDőSXvCgL)
+bool CreateSpriteCornerBuffer()
+{
+	D3D12_HEAP_PROPERTIES heapProperties = {};
+	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapProperties.CreationNodeMask = 1;
+	heapProperties.VisibleNodeMask = 1;
+
+	D3D12_RESOURCE_DESC resourceDesc = {};
+	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	resourceDesc.Alignment = 0;
+	resourceDesc.Width = sizeof(SPRITE_CORNER);
+	resourceDesc.Height = 1;
+	resourceDesc.DepthOrArraySize = 1;
+	resourceDesc.MipLevels = 1;
+	resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+	resourceDesc.SampleDesc.Count = 1;
+	resourceDesc.SampleDesc.Quality = 0;
+	resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	if(FAILED(g_device->CreateCommittedResource(&heapProperties,
+		D3D12_HEAP_FLAG_NONE,&resourceDesc,D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,IID_PPV_ARGS(&g_spriteCornerBuffer))))
+	{
+		return false;
+	}
+
+	UINT8* pDataBegin;
+	D3D12_RANGE readRange = {0,0};
+	if(FAILED(g_spriteCornerBuffer->Map(0,&readRange,reinterpret_cast<void**>(&pDataBegin))))
+	{
+		return false;
+	}
+	memcpy(pDataBegin,SPRITE_CORNER,sizeof(SPRITE_CORNER));
+	g_spriteCornerBuffer->Unmap(0,nullptr);
+
+	g_spriteCornerBufferView.BufferLocation = g_spriteCornerBuffer->GetGPUVirtualAddress();
+	g_spriteCornerBufferView.StrideInBytes = sizeof(SpriteCorner);
+	g_spriteCornerBufferView.SizeInBytes = sizeof(SPRITE_CORNER);
+	return true;
+}
+
+//count̃p[eBNthreadCount̃XbhōXVASpriteInstanceɏގԂo͂
+//(߂̂邱ƂXbh̐ŌʂςȂƂTests/ParticleSystemTest.cppŊm߂)
+bool BenchmarkParticleSystem( UINT count, UINT threadCount )
+{
+	const UINT FRAME_COUNT_BENCHMARK = 30;
+	const float deltaTime = 1.0f / 60.0f;
+
+	ParticleSystem system;
+	if(!CreateParticleFountain(&system,count,count / 4 * 5,threadCount))
+	{
+		return false;
+	}
+	vector<SpriteInstance> output(system.capacity);
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	LONGLONG updateTicks = 0;
+	LONGLONG writeTicks = 0;
+	for(UINT frame = 0;frame < FRAME_COUNT_BENCHMARK;frame++)
+	{
+		LARGE_INTEGER begin;
+		LARGE_INTEGER middle;
+		LARGE_INTEGER end;
+		QueryPerformanceCounter(&begin);
+		UpdateParticleSystem(&system,deltaTime);
+		QueryPerformanceCounter(&middle);
+		WriteParticleSprites(&system,output.data());
+		QueryPerformanceCounter(&end);
+		updateTicks += middle.QuadPart - begin.QuadPart;
+		writeTicks += end.QuadPart - middle.QuadPart;
+	}
+
+	const double updateMs = updateTicks * 1000.0 / frequency.QuadPart / FRAME_COUNT_BENCHMARK;
+	const double writeMs = writeTicks * 1000.0 / frequency.QuadPart / FRAME_COUNT_BENCHMARK;
+	printf("Particles: %u alive, %u threads, update %.3f ms, write %.3f ms (%.1f Mparticles/s)\n",
+		system.count,system.threadCount,updateMs,writeMs,system.count / (updateMs + writeMs) / 1000.0);
+
+	DestroyParticleSystem(&system);
+	return true;
+}
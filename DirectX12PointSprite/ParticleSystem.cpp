@@ -0,0 +1,384 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+using namespace std;
+
+void RunParticleJobLoop( ParticleSystem* pSystem );
+void ParticleWorkerMain( ParticleSystem* pSystem );
+void MoveParticle( ParticleSystem* pSystem, uint32_t to, uint32_t from );
+
+//0`1ɓԊuɒuPARTICLE_CURVE_KEY_COUNT̒l܂łȂ
+//ԂƂ̌XɁA̋ԂŐi񂾊(0`1)|đĂ̂ŕ򂪖
+inline SoftwareFloat EvaluateParticleCurve( const float* pKey, SoftwareFloat t )
+{
+	const SoftwareFloat x = SoftwareMul(t,SoftwareSet(static_cast<float>(PARTICLE_CURVE_KEY_COUNT - 1)));
+	SoftwareFloat value = SoftwareSet(pKey[0]);
+	for(uint32_t k = 0;k < PARTICLE_CURVE_KEY_COUNT - 1;k++)
+	{
+		SoftwareFloat segment = SoftwareSub(x,SoftwareSet(static_cast<float>(k)));
+		segment = SoftwareMin(SoftwareMax(segment,SoftwareSet(0.0f)),SoftwareSet(1.0f));
+		value = SoftwareMulAdd(segment,SoftwareSet(pKey[k + 1] - pKey[k]),value);
+	}
+	return value;
+}
+
+//0ȏ1̗(xorshift)
+inline float NextParticleRandom( uint32_t* pState )
+{
+	uint32_t x = *pState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*pState = x;
+	return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+//p[eBN̍쐬(capacityPARTICLE_CHUNK_SIZE̔{ɐ؂グ)
+bool InitParticleSystem( ParticleSystem* pSystem, uint32_t capacity, uint32_t threadCount )
+{
+	const uint32_t chunkCount = (capacity + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+	const size_t length = static_cast<size_t>(chunkCount) * PARTICLE_CHUNK_SIZE;
+	pSystem->capacity = capacity;
+	pSystem->count = 0;
+	pSystem->positionX.assign(length,0.0f);
+	pSystem->positionY.assign(length,0.0f);
+	pSystem->positionZ.assign(length,0.0f);
+	pSystem->velocityX.assign(length,0.0f);
+	pSystem->velocityY.assign(length,0.0f);
+	pSystem->velocityZ.assign(length,0.0f);
+	pSystem->age.assign(length,0.0f);
+	pSystem->invLife.assign(length,0.0f);
+	pSystem->dead.assign(chunkCount,vector<uint32_t>());
+
+	pSystem->gravity = XMFLOAT3(0.0f,0.0f,0.0f);
+	pSystem->drag = 0.0f;
+	pSystem->spin = 0.0f;
+	for(uint32_t k = 0;k < PARTICLE_CURVE_KEY_COUNT;k++)
+	{
+		pSystem->sizeCurve[k] = 1.0f;
+		for(uint32_t channel = 0;channel < 4;channel++)
+		{
+			pSystem->colorCurve[channel][k] = 1.0f;
+		}
+	}
+	pSystem->emitter.clear();
+	pSystem->random = 0x12345678;
+
+	pSystem->threadCount = min(max(threadCount,1u),MAX_PARTICLE_THREAD_COUNT);
+	pSystem->jobCount = 0;
+	pSystem->nextJob = 0;
+	pSystem->generation = 0;
+	pSystem->runningCount = 0;
+	pSystem->quit = false;
+	for(uint32_t n = 1;n < pSystem->threadCount;n++)
+	{
+		pSystem->worker[n] = thread(ParticleWorkerMain,pSystem);
+	}
+	return true;
+}
+
+//XbhI
+//ĂȂXbh͔΂̂ŁA̓rŎsƂ2ڂɌĂł悢
+void DestroyParticleSystem( ParticleSystem* pSystem )
+{
+	{
+		lock_guard<mutex> lock(pSystem->lock);
+		pSystem->quit = true;
+	}
+	pSystem->wake.notify_all();
+	for(uint32_t n = 0;n < MAX_PARTICLE_THREAD_COUNT;n++)
+	{
+		if(pSystem->worker[n].joinable())
+		{
+			pSystem->worker[n].join();
+		}
+	}
+	pSystem->threadCount = 0;
+}
+
+//cĂWuoĎs
+void RunParticleJobLoop( ParticleSystem* pSystem )
+{
+	for(;;)
+	{
+		const uint32_t jobIndex = pSystem->nextJob++;
+		if(jobIndex >= pSystem->jobCount)
+		{
+			break;
+		}
+		pSystem->job(jobIndex);
+	}
+}
+
+//p[eBÑXbh
+void ParticleWorkerMain( ParticleSystem* pSystem )
+{
+	uint64_t generation = 0;
+	for(;;)
+	{
+		{
+			unique_lock<mutex> lock(pSystem->lock);
+			pSystem->wake.wait(lock,[&](){ return pSystem->quit || pSystem->generation != generation; });
+			if(pSystem->quit)
+			{
+				return;
+			}
+			generation = pSystem->generation;
+		}
+
+		RunParticleJobLoop(pSystem);
+
+		{
+			lock_guard<mutex> lock(pSystem->lock);
+			pSystem->runningCount--;
+		}
+		pSystem->done.notify_one();
+	}
+}
+
+//jobCount̃WuSXbhŎsAI܂ő҂
+void RunParticleJobs( ParticleSystem* pSystem, uint32_t jobCount, const function<void(uint32_t)>& job )
+{
+	{
+		lock_guard<mutex> lock(pSystem->lock);
+		pSystem->job = job;
+		pSystem->jobCount = jobCount;
+		pSystem->nextJob = 0;
+		pSystem->runningCount = pSystem->threadCount - 1;
+		pSystem->generation++;
+	}
+	pSystem->wake.notify_all();
+
+	RunParticleJobLoop(pSystem);
+
+	unique_lock<mutex> lock(pSystem->lock);
+	pSystem->done.wait(lock,[pSystem](){ return pSystem->runningCount == 0; });
+}
+
+//emittercount𖖔ɒǉ(capacity𒴂镪͎̂Ă)
+//prewarmȂ̓rn߂āAŏ̃t[痬ꑱĂԂɂ
+void EmitParticles( ParticleSystem* pSystem, const ParticleEmitter& emitter, uint32_t count, bool prewarm )
+{
+	count = min(count,pSystem->capacity - pSystem->count);
+	for(uint32_t n = 0;n < count;n++)
+	{
+		const uint32_t index = pSystem->count++;
+		uint32_t* pRandom = &pSystem->random;
+		const float life = emitter.lifeMin + (emitter.lifeMax - emitter.lifeMin) * NextParticleRandom(pRandom);
+		float velocityX = emitter.velocity.x + (NextParticleRandom(pRandom) - 0.5f) * emitter.spread;
+		float velocityY = emitter.velocity.y + (NextParticleRandom(pRandom) - 0.5f) * emitter.spread;
+		float velocityZ = emitter.velocity.z + (NextParticleRandom(pRandom) - 0.5f) * emitter.spread;
+		float positionX = emitter.position.x;
+		float positionY = emitter.position.y;
+		float positionZ = emitter.position.z;
+		float age = 0.0f;
+		if(prewarm)
+		{
+			//R𖳎āA̓rɒu
+			age = life * NextParticleRandom(pRandom);
+			positionX += (velocityX + 0.5f * pSystem->gravity.x * age) * age;
+			positionY += (velocityY + 0.5f * pSystem->gravity.y * age) * age;
+			positionZ += (velocityZ + 0.5f * pSystem->gravity.z * age) * age;
+			velocityX += pSystem->gravity.x * age;
+			velocityY += pSystem->gravity.y * age;
+			velocityZ += pSystem->gravity.z * age;
+		}
+		pSystem->positionX[index] = positionX;
+		pSystem->positionY[index] = positionY;
+		pSystem->positionZ[index] = positionZ;
+		pSystem->velocityX[index] = velocityX;
+		pSystem->velocityY[index] = velocityY;
+		pSystem->velocityZ[index] = velocityZ;
+		pSystem->age[index] = age;
+		pSystem->invLife[index] = 1.0f / life;
+	}
+}
+
+//from̏ԂtoɎʂ
+void MoveParticle( ParticleSystem* pSystem, uint32_t to, uint32_t from )
+{
+	pSystem->positionX[to] = pSystem->positionX[from];
+	pSystem->positionY[to] = pSystem->positionY[from];
+	pSystem->positionZ[to] = pSystem->positionZ[from];
+	pSystem->velocityX[to] = pSystem->velocityX[from];
+	pSystem->velocityY[to] = pSystem->velocityY[from];
+	pSystem->velocityZ[to] = pSystem->velocityZ[from];
+	pSystem->age[to] = pSystem->age[from];
+	pSystem->invLife[to] = pSystem->invLife[from];
+}
+
+//p[eBNdeltaTimebi߂
+//1.`NƂɕőxƈʒuƌoߎԂXVAŝ̔ԍW߂
+//2.W߂ԍ傫ɖƓւď(납̂ŁAւ閖͏ɐĂ)
+//3.G~b^[V̂𖖔ɒǉ
+void UpdateParticleSystem( ParticleSystem* pSystem, float deltaTime )
+{
+	const uint32_t chunkCount = (pSystem->count + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+	const uint32_t count = pSystem->count;
+	const float damping = max(1.0f - pSystem->drag * deltaTime,0.0f);
+	RunParticleJobs(pSystem,chunkCount,[pSystem,count,deltaTime,damping](uint32_t chunk)
+	{
+		const uint32_t begin = chunk * PARTICLE_CHUNK_SIZE;
+		const uint32_t end = min(begin + PARTICLE_CHUNK_SIZE,count);
+		const SoftwareFloat delta = SoftwareSet(deltaTime);
+		const SoftwareFloat damp = SoftwareSet(damping);
+		const SoftwareFloat gravityX = SoftwareSet(pSystem->gravity.x * deltaTime);
+		const SoftwareFloat gravityY = SoftwareSet(pSystem->gravity.y * deltaTime);
+		const SoftwareFloat gravityZ = SoftwareSet(pSystem->gravity.z * deltaTime);
+		float* pPositionX = pSystem->positionX.data();
+		float* pPositionY = pSystem->positionY.data();
+		float* pPositionZ = pSystem->positionZ.data();
+		float* pVelocityX = pSystem->velocityX.data();
+		float* pVelocityY = pSystem->velocityY.data();
+		float* pVelocityZ = pSystem->velocityZ.data();
+		float* pAge = pSystem->age.data();
+		const float* pInvLife = pSystem->invLife.data();
+		vector<uint32_t>& dead = pSystem->dead[chunk];
+		dead.clear();
+		for(uint32_t base = begin;base < end;base += SOFTWARE_SIMD_WIDTH)
+		{
+			const SoftwareFloat velocityX = SoftwareMul(SoftwareAdd(SoftwareLoad(pVelocityX + base),gravityX),damp);
+			const SoftwareFloat velocityY = SoftwareMul(SoftwareAdd(SoftwareLoad(pVelocityY + base),gravityY),damp);
+			const SoftwareFloat velocityZ = SoftwareMul(SoftwareAdd(SoftwareLoad(pVelocityZ + base),gravityZ),damp);
+			SoftwareStore(pVelocityX + base,velocityX);
+			SoftwareStore(pVelocityY + base,velocityY);
+			SoftwareStore(pVelocityZ + base,velocityZ);
+			SoftwareStore(pPositionX + base,SoftwareMulAdd(velocityX,delta,SoftwareLoad(pPositionX + base)));
+			SoftwareStore(pPositionY + base,SoftwareMulAdd(velocityY,delta,SoftwareLoad(pPositionY + base)));
+			SoftwareStore(pPositionZ + base,SoftwareMulAdd(velocityZ,delta,SoftwareLoad(pPositionZ + base)));
+			SoftwareStore(pAge + base,SoftwareAdd(SoftwareLoad(pAge + base),delta));
+
+			const uint32_t laneEnd = min(base + SOFTWARE_SIMD_WIDTH,end);
+			for(uint32_t n = base;n < laneEnd;n++)
+			{
+				if(pAge[n] * pInvLife[n] >= 1.0f)
+				{
+					dead.push_back(n);
+				}
+			}
+		}
+	});
+
+	for(uint32_t chunk = chunkCount;chunk-- > 0;)
+	{
+		const vector<uint32_t>& dead = pSystem->dead[chunk];
+		for(auto it = dead.rbegin();it != dead.rend();++it)
+		{
+			const uint32_t last = --pSystem->count;
+			if(*it != last)
+			{
+				MoveParticle(pSystem,*it,last);
+			}
+		}
+	}
+
+	for(ParticleEmitter& emitter : pSystem->emitter)
+	{
+		emitter.accumulator += emitter.rate * deltaTime;
+		const uint32_t emitCount = static_cast<uint32_t>(emitter.accumulator);
+		emitter.accumulator -= emitCount;
+		EmitParticles(pSystem,emitter,emitCount,false);
+	}
+}
+
+//Ăp[eBNSpriteInstanceɂpOutputɏ(傫ƐF͎ɑ΂܂Ō߂)
+void WriteParticleSprites( ParticleSystem* pSystem, SpriteInstance* pOutput )
+{
+	const uint32_t chunkCount = (pSystem->count + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+	const uint32_t count = pSystem->count;
+	RunParticleJobs(pSystem,chunkCount,[pSystem,count,pOutput](uint32_t chunk)
+	{
+		const uint32_t begin = chunk * PARTICLE_CHUNK_SIZE;
+		const uint32_t end = min(begin + PARTICLE_CHUNK_SIZE,count);
+		for(uint32_t base = begin;base < end;base += SOFTWARE_SIMD_WIDTH)
+		{
+			const SoftwareFloat age = SoftwareLoad(pSystem->age.data() + base);
+			const SoftwareFloat t = SoftwareMul(age,SoftwareLoad(pSystem->invLife.data() + base));
+			float laneSize[SOFTWARE_SIMD_WIDTH];
+			float laneRotation[SOFTWARE_SIMD_WIDTH];
+			float laneColor[4][SOFTWARE_SIMD_WIDTH];
+			SoftwareStore(laneSize,EvaluateParticleCurve(pSystem->sizeCurve,t));
+			SoftwareStore(laneRotation,SoftwareMul(age,SoftwareSet(pSystem->spin)));
+			for(uint32_t channel = 0;channel < 4;channel++)
+			{
+				SoftwareStore(laneColor[channel],EvaluateParticleCurve(pSystem->colorCurve[channel],t));
+			}
+
+			//ݐ̓Abv[hq[vȂ̂ŁA珇ɏɂ
+			const uint32_t laneCount = min(SOFTWARE_SIMD_WIDTH,end - base);
+			for(uint32_t n = 0;n < laneCount;n++)
+			{
+				SpriteInstance& sprite = pOutput[base + n];
+				sprite.position = XMFLOAT3(pSystem->positionX[base + n],pSystem->positionY[base + n],pSystem->positionZ[base + n]);
+				sprite.size = laneSize[n];
+				sprite.color = XMFLOAT4(laneColor[0][n],laneColor[1][n],laneColor[2][n],laneColor[3][n]);
+				sprite.rotation = laneRotation[n];
+			}
+		}
+	});
+}
+
+//Ăp[eBNVertexɂpOutputɏ(GSMainCPUł̓WJpŁAF͎gȂ)
+void WriteParticleVertices( ParticleSystem* pSystem, Vertex* pOutput )
+{
+	const uint32_t chunkCount = (pSystem->count + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+	const uint32_t count = pSystem->count;
+	RunParticleJobs(pSystem,chunkCount,[pSystem,count,pOutput](uint32_t chunk)
+	{
+		const uint32_t begin = chunk * PARTICLE_CHUNK_SIZE;
+		const uint32_t end = min(begin + PARTICLE_CHUNK_SIZE,count);
+		for(uint32_t base = begin;base < end;base += SOFTWARE_SIMD_WIDTH)
+		{
+			const SoftwareFloat t = SoftwareMul(SoftwareLoad(pSystem->age.data() + base),SoftwareLoad(pSystem->invLife.data() + base));
+			float laneSize[SOFTWARE_SIMD_WIDTH];
+			SoftwareStore(laneSize,EvaluateParticleCurve(pSystem->sizeCurve,t));
+
+			const uint32_t laneCount = min(SOFTWARE_SIMD_WIDTH,end - base);
+			for(uint32_t n = 0;n < laneCount;n++)
+			{
+				Vertex& vertex = pOutput[base + n];
+				vertex.possition = XMFLOAT3(pSystem->positionX[base + n],pSystem->positionY[base + n],pSystem->positionZ[base + n]);
+				vertex.scale = laneSize[n];
+			}
+		}
+	});
+}
+
+//畬グėĂp[eBN
+//count͗ꑱĂƂ̐ŁAŏ瓯̓rɂԂŎn߂
+bool CreateParticleFountain( ParticleSystem* pSystem, uint32_t count, uint32_t capacity, uint32_t threadCount )
+{
+	if(!InitParticleSystem(pSystem,capacity,threadCount))
+	{
+		return false;
+	}
+	pSystem->gravity = XMFLOAT3(0.0f,-9.8f,0.0f);
+	pSystem->drag = 0.3f;
+	pSystem->spin = 1.5f;
+	const float sizeCurve[PARTICLE_CURVE_KEY_COUNT] = { 0.05f, 0.25f, 0.2f, 0.0f };
+	const float colorCurve[4][PARTICLE_CURVE_KEY_COUNT] =
+	{
+		{ 1.0f, 1.0f, 1.0f, 0.5f },		//物FAԂƕςďĂ
+		{ 1.0f, 0.8f, 0.3f, 0.1f },
+		{ 0.6f, 0.2f, 0.05f, 0.05f },
+		{ 0.0f, 1.0f, 0.8f, 0.0f },
+	};
+	memcpy(pSystem->sizeCurve,sizeCurve,sizeof(sizeCurve));
+	memcpy(pSystem->colorCurve,colorCurve,sizeof(colorCurve));
+
+	ParticleEmitter emitter = {};
+	emitter.position = XMFLOAT3(0.0f,-3.0f,0.0f);
+	emitter.velocity = XMFLOAT3(0.0f,8.0f,0.0f);
+	emitter.spread = 3.0f;
+	emitter.lifeMin = 1.5f;
+	emitter.lifeMax = 2.5f;
+	emitter.rate = count / ((emitter.lifeMin + emitter.lifeMax) * 0.5f);
+	emitter.accumulator = 0.0f;
+	pSystem->emitter.push_back(emitter);
+
+	EmitParticles(pSystem,emitter,count,true);
+	return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+//p[eBN
+//Ԃ𐬕Ƃ̔zɂSIMDƃXbhōXVA`@ɍ킹SpriteInstanceVertexɏo
+//D3D12Win32ɂ͈ˑȂ̂ŁAWindowsȊOłeXgrhł
+
+#include "SpriteExpand.h"
+#include "SpriteBillboard.h"
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+const uint32_t PARTICLE_CHUNK_SIZE = 16 * 1024;		//1̃Wuň(SOFTWARE_SIMD_WIDTH̔{)
+const uint32_t PARTICLE_CURVE_KEY_COUNT = 4;		//ɑ΂傫ƐF̐܂̓_̐
+const uint32_t MAX_PARTICLE_THREAD_COUNT = 16;
+
+struct ParticleEmitter
+{
+	DirectX::XMFLOAT3 position;
+	DirectX::XMFLOAT3 velocity;
+	float spread;		//ʒuƑxɉ闐̕
+	float rate;			//1b̕o
+	float lifeMin;		//(b)
+	float lifeMax;
+	float accumulator;	//Õt[ŕoȂ[
+};
+
+struct ParticleSystem
+{
+	//Ԃ͐Ƃ̔z(SoA)ɂāASOFTWARE_SIMD_WIDTHǂݏ
+	//Ă̂擪countɋl߂ĕׁA񂾂͖̂Ɠւď
+	//zPARTICLE_CHUNK_SIZE̔{̒ɂāAŌ̃`N̒[ۂƓǂݏł悤ɂ
+	uint32_t capacity;
+	uint32_t count;
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> velocityZ;
+	std::vector<float> age;			//܂Ă̕b
+	std::vector<float> invLife;		//̋t(age * invLife1ɂȂƏ)
+
+	DirectX::XMFLOAT3 gravity;
+	float drag;					//1b̑x̌
+	float spin;					//1b̉](SpriteInstancerotation)
+	float sizeCurve[PARTICLE_CURVE_KEY_COUNT];
+	float colorCurve[4][PARTICLE_CURVE_KEY_COUNT];	//RGBA
+	std::vector<ParticleEmitter> emitter;
+	uint32_t random;
+
+	std::vector<std::vector<uint32_t>> dead;	//`NƂ̎񂾃p[eBN̔ԍ()
+
+	//WuzXbh(threadCount͌ĂяõXbh܂)
+	uint32_t threadCount;
+	std::thread worker[MAX_PARTICLE_THREAD_COUNT];
+	std::mutex lock;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::function<void(uint32_t)> job;
+	uint32_t jobCount;
+	std::atomic<uint32_t> nextJob;
+	uint64_t generation;
+	uint32_t runningCount;
+	bool quit;
+};
+
+bool InitParticleSystem( ParticleSystem* pSystem, uint32_t capacity, uint32_t threadCount );
+void DestroyParticleSystem( ParticleSystem* pSystem );
+void RunParticleJobs( ParticleSystem* pSystem, uint32_t jobCount, const std::function<void(uint32_t)>& job );
+void EmitParticles( ParticleSystem* pSystem, const ParticleEmitter& emitter, uint32_t count, bool prewarm );
+void UpdateParticleSystem( ParticleSystem* pSystem, float deltaTime );
+void WriteParticleSprites( ParticleSystem* pSystem, SpriteInstance* pOutput );
+void WriteParticleVertices( ParticleSystem* pSystem, Vertex* pOutput );
+bool CreateParticleFountain( ParticleSystem* pSystem, uint32_t count, uint32_t capacity, uint32_t threadCount );
@@ -0,0 +1,35 @@
+#include "SpriteBillboard.h"
+
+#include <cmath>
+
+using namespace DirectX;
+using namespace std;
+
+//"-instanced N"ŕ`XvCg(-10`10͈̔͂ɐFƑ傫ƌ̈ႤXvCgU炷)
+void BuildSpriteInstances( uint32_t count, SpriteInstance* pOutput )
+{
+	for(uint32_t n = 0;n < count;n++)
+	{
+		pOutput[n].position = XMFLOAT3(sinf(n * 0.37f) * 10.0f,cosf(n * 0.11f) * 10.0f,sinf(n * 0.05f + 1.0f) * 10.0f);
+		pOutput[n].size = 0.05f + (n % 10) * 0.02f;
+		pOutput[n].color = XMFLOAT4(0.5f + sinf(n * 0.13f) * 0.5f,0.5f + sinf(n * 0.17f) * 0.5f,0.5f + sinf(n * 0.19f) * 0.5f,1.0f);
+		pOutput[n].rotation = n * 0.7f;
+	}
+}
+
+//VSInstancedMainƓvZŁAXvCg4̊pSPRITE_CORNEȐɋ߂
+//Sr[ԂɈڂĂA]r[ԂXYɑ̂ŁAlp`͏ɃJ
+void ComputeBillboardCorners( const SpriteInstance& instance, FXMMATRIX worldView, CXMMATRIX project, XMFLOAT4* pCorner )
+{
+	const XMVECTOR center = XMVector4Transform(XMVectorSet(instance.position.x,instance.position.y,instance.position.z,1.0f),worldView);
+	const float s = sinf(instance.rotation);
+	const float c = cosf(instance.rotation);
+	for(uint32_t k = 0;k < 4;k++)
+	{
+		const XMFLOAT2& offset = SPRITE_CORNER[k].offset;
+		const XMVECTOR position = XMVectorAdd(center,XMVectorSet(
+			(offset.x * c - offset.y * s) * instance.size,
+			(offset.x * s + offset.y * c) * instance.size,0.0f,0.0f));
+		XMStoreFloat4(&pCorner[k],XMVector4Transform(position,project));
+	}
+}
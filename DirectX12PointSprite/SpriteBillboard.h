@@ -0,0 +1,37 @@
+#pragma once
+
+//CX^X`悷XvCg(SPRITE_MODE_INSTANCED)
+//ʂ̎lp`̊pVSInstancedMainƓvZ܂Ƃ߂BD3D12Win32ɂ͈ˑȂ̂ŁAWindowsȊOłeXgrhł
+
+#include <DirectXMath.h>
+#include <cstdint>
+
+//CX^X`悷XvCg1
+struct SpriteInstance
+{
+	DirectX::XMFLOAT3 position;
+	float size;
+	DirectX::XMFLOAT4 color;
+	float rotation;		//ʏł̉](WA)
+};
+
+//SXvCgŋʂ̎lp`̊p(ŜUV)
+struct SpriteCorner
+{
+	DirectX::XMFLOAT2 offset;
+	DirectX::XMFLOAT2 uv;
+};
+
+//p̕тGSMainƓ(AEAAE)
+//VSInstancedMainɓn_obt@ComputeBillboardCorners()̗Ŏg
+const SpriteCorner SPRITE_CORNER[4] =
+{
+	{ { -0.5f, 0.5f }, { 0.0f, 0.0f } },
+	{ { 0.5f, 0.5f }, { 1.0f, 0.0f } },
+	{ { -0.5f, -0.5f }, { 0.0f, 1.0f } },
+	{ { 0.5f, -0.5f }, { 1.0f, 1.0f } },
+};
+
+void BuildSpriteInstances( uint32_t count, SpriteInstance* pOutput );
+void ComputeBillboardCorners( const SpriteInstance& instance, DirectX::FXMMATRIX worldView, DirectX::CXMMATRIX project,
+	DirectX::XMFLOAT4* pCorner );
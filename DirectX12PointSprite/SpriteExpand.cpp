@@ -0,0 +1,99 @@
+#include "SpriteExpand.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+using namespace std;
+
+//GSMainƓA_offset * scale炵4̊pworldAviewAprojectŕϊ
+//SOFTWARE_SIMD_WIDTH̓_܂Ƃ߂ČvZA_n̊pipOutput[n * 4 + i]ɏ
+//ϊ͐`Ȃ̂ŁASϊ̂ɁApƂ̂(offset * s)scale{đ
+void ExpandPointSprites( const Vertex* pPoint, uint32_t count, FXMMATRIX worldViewProject, SpriteVertex* pOutput )
+{
+	const float OFFSET[4][2] = { { -0.5f, 0.5f }, { 0.5f, 0.5f }, { -0.5f, -0.5f }, { 0.5f, -0.5f } };
+	const XMFLOAT2 UV[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } };
+
+	XMFLOAT4X4 matrix;
+	XMStoreFloat4x4(&matrix,worldViewProject);
+	SoftwareFloat row[4][4];
+	SoftwareFloat corner[4][4];
+	for(uint32_t column = 0;column < 4;column++)
+	{
+		for(uint32_t n = 0;n < 4;n++)
+		{
+			row[n][column] = SoftwareSet(matrix.m[n][column]);
+			corner[n][column] = SoftwareSet(OFFSET[n][0] * matrix.m[0][column] + OFFSET[n][1] * matrix.m[1][column]);
+		}
+	}
+
+	for(uint32_t base = 0;base < count;base += SOFTWARE_SIMD_WIDTH)
+	{
+		//Ƃɕבւ([̃[͍Ō̓_Ŗ߂)
+		const uint32_t laneCount = min(SOFTWARE_SIMD_WIDTH,count - base);
+		float laneX[SOFTWARE_SIMD_WIDTH];
+		float laneY[SOFTWARE_SIMD_WIDTH];
+		float laneZ[SOFTWARE_SIMD_WIDTH];
+		float laneScale[SOFTWARE_SIMD_WIDTH];
+		for(uint32_t n = 0;n < SOFTWARE_SIMD_WIDTH;n++)
+		{
+			const Vertex& point = pPoint[base + min(n,laneCount - 1)];
+			laneX[n] = point.possition.x;
+			laneY[n] = point.possition.y;
+			laneZ[n] = point.possition.z;
+			laneScale[n] = point.scale;
+		}
+		const SoftwareFloat x = SoftwareLoad(laneX);
+		const SoftwareFloat y = SoftwareLoad(laneY);
+		const SoftwareFloat z = SoftwareLoad(laneZ);
+		const SoftwareFloat scale = SoftwareLoad(laneScale);
+
+		float lane[4][4][SOFTWARE_SIMD_WIDTH];	//[p][]
+		for(uint32_t column = 0;column < 4;column++)
+		{
+			SoftwareFloat center = SoftwareMulAdd(x,row[0][column],row[3][column]);
+			center = SoftwareMulAdd(y,row[1][column],center);
+			center = SoftwareMulAdd(z,row[2][column],center);
+			for(uint32_t n = 0;n < 4;n++)
+			{
+				SoftwareStore(lane[n][column],SoftwareMulAdd(scale,corner[n][column],center));
+			}
+		}
+
+		for(uint32_t n = 0;n < laneCount;n++)
+		{
+			SpriteVertex* pVertex = &pOutput[(base + n) * 4];
+			for(uint32_t k = 0;k < 4;k++)
+			{
+				pVertex[k].position = XMFLOAT4(lane[k][0][n],lane[k][1][n],lane[k][2][n],lane[k][3][n]);
+				pVertex[k].uv = UV[k];
+			}
+		}
+	}
+}
+
+//GSMainƓ1_WJ(ExpandPointSprites()̌ʂ̊mFɎg)
+void ExpandPointSpritesReference( const Vertex* pPoint, uint32_t count, FXMMATRIX world, CXMMATRIX view, CXMMATRIX project, SpriteVertex* pOutput )
+{
+	const XMVECTOR OFFSET[4] =
+	{
+		XMVectorSet(-0.5f,0.5f,0.0f,0.0f),
+		XMVectorSet(0.5f,0.5f,0.0f,0.0f),
+		XMVectorSet(-0.5f,-0.5f,0.0f,0.0f),
+		XMVectorSet(0.5f,-0.5f,0.0f,0.0f),
+	};
+	const XMFLOAT2 UV[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f } };
+	for(uint32_t n = 0;n < count;n++)
+	{
+		//POSITION3vfȂ̂w1Ƃēǂ܂
+		const XMVECTOR center = XMVectorSet(pPoint[n].possition.x,pPoint[n].possition.y,pPoint[n].possition.z,1.0f);
+		for(uint32_t k = 0;k < 4;k++)
+		{
+			XMVECTOR position = XMVectorAdd(center,XMVectorScale(OFFSET[k],pPoint[n].scale));
+			position = XMVector4Transform(position,world);
+			position = XMVector4Transform(position,view);
+			position = XMVector4Transform(position,project);
+			XMStoreFloat4(&pOutput[n * 4 + k].position,position);
+			pOutput[n * 4 + k].uv = UV[k];
+		}
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+//|CgXvCgCPUł̓WJ(SPRITE_MODE_CPU_EXPAND)
+//_GSMainƓ4̊p̎lp`ɂBD3D12Win32ɂ͈ˑȂ̂ŁAWindowsȊOłeXgrhł
+//SIMD̊֐̓\tgEFAX^CU[ƋL
+
+#include "../DirectX12Model/SoftwareRenderer.h"
+
+#include <cstdint>
+
+struct Vertex
+{
+	DirectX::XMFLOAT3 possition;
+	float scale;
+	//XMFLOAT4 color;
+	//XMFLOAT2 uv;
+};
+
+//CPUŎlp`ɓWJXvCg̒_(GSMain̏o͂ƓŃNbvԂ̈ʒu)
+struct SpriteVertex
+{
+	DirectX::XMFLOAT4 position;
+	DirectX::XMFLOAT2 uv;
+};
+
+void ExpandPointSprites( const Vertex* pPoint, uint32_t count, DirectX::FXMMATRIX worldViewProject, SpriteVertex* pOutput );
+void ExpandPointSpritesReference( const Vertex* pPoint, uint32_t count, DirectX::FXMMATRIX world, DirectX::CXMMATRIX view,
+	DirectX::CXMMATRIX project, SpriteVertex* pOutput );
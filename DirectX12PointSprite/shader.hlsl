@@ -25,6 +25,16 @@ GSInput VSMain(float4 position : POSITION,float scale : PSIZE)
     return result;
 }
 
+//CPU expanded quads are already in clip space
+PSInput VSQuadMain(float4 position : POSITION,float2 uv : TEXCOORD)
+{
+	PSInput result;
+	result.position = position;
+	result.uv = uv;
+
+	return result;
+}
+
 cbuffer ConstantBuffer : register(b0)
 {
 	float4x4 world;
@@ -59,4 +69,37 @@ void GSMain(point GSInput In[1], inout TriangleStream<PSInput> stream)
 float4 PSMain(PSInput input) : SV_TARGET
 {
 	return g_texture.Sample(g_sampler, input.uv);
-}
\ No newline at end of file
+}
+struct PSSpriteInput
+{
+	float4 position : SV_POSITION;
+	float2 uv : TEXCOORD;
+	float4 color : COLOR;
+};
+
+//One shared quad drawn once per sprite instance.
+//The corner is rotated and added in view space, so the quad always faces the camera.
+PSSpriteInput VSInstancedMain(float2 corner : POSITION, float2 uv : TEXCOORD,
+	float3 center : SPRITE_POSITION, float size : PSIZE, float4 color : COLOR, float rotation : ROTATION)
+{
+	float s;
+	float c;
+	sincos(rotation, s, c);
+	float2 offset = float2(corner.x * c - corner.y * s, corner.x * s + corner.y * c) * size;
+
+	float4 position = mul(world, float4(center, 1.0));
+	position = mul(view, position);
+	position.xy += offset;
+
+	PSSpriteInput result;
+	result.position = mul(proj, position);
+	result.uv = uv;
+	result.color = color;
+
+	return result;
+}
+
+float4 PSInstancedMain(PSSpriteInput input) : SV_TARGET
+{
+	return g_texture.Sample(g_sampler, input.uv) * input.color;
+}
@@ -0,0 +1,28 @@
+#include "LightScene.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+//DirectX12Light̃wbhX̕`悾sR\[̃vO
+//LightHeadless [-headless t[]
+//EBhEł-headlessƓAƃfBNgtest.bmp\̂`headless.bmpɕۑ
+int main( int argc, char* argv[] )
+{
+	uint32_t frameCount = 0;
+	for(int i = 1;i < argc;i += 2)
+	{
+		if(i + 1 < argc && strcmp(argv[i],"-headless") == 0)
+		{
+			frameCount = static_cast<uint32_t>(atoi(argv[i + 1]));
+		}
+		else
+		{
+			fprintf(stderr,"usage: LightHeadless [-headless frames]\n");
+			return 1;
+		}
+	}
+	return RunLightHeadless("test.bmp",frameCount) ? 0 : 1;
+}
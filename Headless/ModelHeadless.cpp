@@ -0,0 +1,34 @@
+#include "ModelScene.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace DirectX;
+using namespace std;
+
+//DirectX12Model̃wbhX̕`悾sR\[̃vO
+//ModelHeadless [-headless t[] [-instances CX^X]
+//EBhEł-headlessƓAƃfBNgboxMaterial.gmb`headless.bmpɕۑ
+int main( int argc, char* argv[] )
+{
+	uint32_t frameCount = 0;
+	uint32_t instanceCount = 1;
+	for(int i = 1;i < argc;i += 2)
+	{
+		if(i + 1 < argc && strcmp(argv[i],"-headless") == 0)
+		{
+			frameCount = static_cast<uint32_t>(atoi(argv[i + 1]));
+		}
+		else if(i + 1 < argc && strcmp(argv[i],"-instances") == 0)
+		{
+			instanceCount = static_cast<uint32_t>(atoi(argv[i + 1]));
+		}
+		else
+		{
+			fprintf(stderr,"usage: ModelHeadless [-headless frames] [-instances count]\n");
+			return 1;
+		}
+	}
+	return RunModelHeadless("boxMaterial.gmb",frameCount,instanceCount,XM_PIDIV4) ? 0 : 1;
+}
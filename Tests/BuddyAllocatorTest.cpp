@@ -0,0 +1,293 @@
+#include "BuddyAllocator.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+struct BuddyPoolStatistics
+{
+	uint32_t blockCount;
+	uint32_t allocationCount;
+	uint64_t usedSize;
+	uint64_t requestedSize;
+	uint64_t largestFreeSize;
+	float fragmentation;		//1 - ő󂫃ubN / 󂫗eʂ̍v
+};
+
+bool TestBuddyInit();
+bool TestBuddySplitAndMerge();
+bool TestBuddyAlignment();
+bool TestBuddyExhaustion();
+void GetBuddyPoolStatistics( const vector<BuddyAllocator>& pool, BuddyPoolStatistics* pStatistics );
+bool TestBuddyRandom( uint32_t operationCount, bool check, BuddyPoolStatistics* pStatistics );
+bool BenchmarkBuddyAllocator( uint32_t operationCount );
+
+int main()
+{
+	bool result = true;
+	result = TestBuddyInit() && result;
+	result = TestBuddySplitAndMerge() && result;
+	result = TestBuddyAlignment() && result;
+	result = TestBuddyExhaustion() && result;
+	result = BenchmarkBuddyAllocator(200000) && result;
+	printf("BuddyAllocatorTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//2ׂ̂łȂTCYAŏubN菬Ŝ͎󂯕tȂ
+bool TestBuddyInit()
+{
+	BuddyAllocator allocator;
+	CHECK(!InitBuddyAllocator(&allocator,0,256));
+	CHECK(!InitBuddyAllocator(&allocator,1024,0));
+	CHECK(!InitBuddyAllocator(&allocator,1000,256));
+	CHECK(!InitBuddyAllocator(&allocator,1024,100));
+	CHECK(!InitBuddyAllocator(&allocator,256,1024));
+	CHECK(InitBuddyAllocator(&allocator,1024,1024));
+	CHECK(allocator.orderCount == 1);
+	CHECK(InitBuddyAllocator(&allocator,4096,256));
+	CHECK(allocator.orderCount == 5);
+	CHECK(IsBuddyAllocatorEmpty(&allocator));
+	CHECK(GetBuddyLargestFreeSize(&allocator) == 4096);
+	return true;
+}
+
+//ubNAƌ1ɖ߂
+bool TestBuddySplitAndMerge()
+{
+	BuddyAllocator allocator;
+	CHECK(InitBuddyAllocator(&allocator,4096,256));
+
+	uint64_t offset[4];
+	CHECK(BuddyAllocate(&allocator,100,1,&offset[0]));
+	CHECK(offset[0] == 0);
+	CHECK(GetBuddyBlockSize(&allocator,offset[0]) == 256);
+	CHECK(GetBuddyLargestFreeSize(&allocator) == 2048);
+
+	//͕Ŏc256̌딼
+	CHECK(BuddyAllocate(&allocator,256,1,&offset[1]));
+	CHECK(offset[1] == 256);
+	CHECK(BuddyAllocate(&allocator,1024,1,&offset[2]));
+	CHECK(offset[2] == 1024);
+	CHECK(BuddyAllocate(&allocator,500,1,&offset[3]));
+	CHECK(offset[3] == 512);
+	CHECK(GetBuddyBlockSize(&allocator,offset[3]) == 512);
+	CHECK(allocator.allocationCount == 4);
+	CHECK(allocator.usedSize == 256 + 256 + 1024 + 512);
+	CHECK(allocator.requestedSize == 100 + 256 + 1024 + 500);
+	CHECK(GetBuddyLargestFreeSize(&allocator) == 2048);
+
+	//ofBgp̊Ԃ͌Ȃ
+	BuddyFree(&allocator,offset[0],100);
+	CHECK(GetBuddyBlockSize(&allocator,offset[0]) == 0);
+	CHECK(allocator.freeHead[0] == 0);
+	BuddyFree(&allocator,offset[2],1024);
+	CHECK(allocator.freeHead[2] == 1024 / 256);
+
+	//ꏊxĂNȂ
+	BuddyFree(&allocator,offset[0],100);
+	CHECK(allocator.allocationCount == 2);
+
+	BuddyFree(&allocator,offset[1],256);
+	CHECK(allocator.freeHead[0] == BUDDY_INVALID_INDEX);
+	CHECK(allocator.freeHead[1] == 0);
+	BuddyFree(&allocator,offset[3],500);
+	CHECK(IsBuddyAllocatorEmpty(&allocator));
+	return true;
+}
+
+//ACg̓ubNTCY̐؂グŖ
+bool TestBuddyAlignment()
+{
+	BuddyAllocator allocator;
+	CHECK(InitBuddyAllocator(&allocator,64 * 1024,256));
+
+	uint64_t small;
+	CHECK(BuddyAllocate(&allocator,64,256,&small));
+	uint64_t aligned;
+	CHECK(BuddyAllocate(&allocator,64,4096,&aligned));
+	CHECK(aligned % 4096 == 0);
+	CHECK(aligned != small);
+	CHECK(GetBuddyBlockSize(&allocator,aligned) == 4096);
+
+	BuddyFree(&allocator,small,64);
+	BuddyFree(&allocator,aligned,64);
+	CHECK(IsBuddyAllocatorEmpty(&allocator));
+	return true;
+}
+
+//Ŝ𒴂vƁA󂫂Ƃ͎s
+bool TestBuddyExhaustion()
+{
+	BuddyAllocator allocator;
+	CHECK(InitBuddyAllocator(&allocator,1024,256));
+
+	uint64_t offset;
+	CHECK(!BuddyAllocate(&allocator,2048,1,&offset));
+	CHECK(!BuddyAllocate(&allocator,256,2048,&offset));
+
+	uint64_t block[4];
+	for(uint32_t i = 0;i < 4;i++)
+	{
+		CHECK(BuddyAllocate(&allocator,256,1,&block[i]));
+	}
+	CHECK(!BuddyAllocate(&allocator,1,1,&offset));
+	CHECK(GetBuddyLargestFreeSize(&allocator) == 0);
+
+	//1󂯂΂܂蓖Ă
+	BuddyFree(&allocator,block[2],256);
+	CHECK(BuddyAllocate(&allocator,1,1,&offset));
+	CHECK(offset == block[2]);
+	return true;
+}
+
+//ubN܂蓖ĂƒfЉ̓v
+void GetBuddyPoolStatistics( const vector<BuddyAllocator>& pool, BuddyPoolStatistics* pStatistics )
+{
+	*pStatistics = {};
+	uint64_t freeSize = 0;
+	for(const BuddyAllocator& allocator : pool)
+	{
+		pStatistics->blockCount++;
+		pStatistics->allocationCount += allocator.allocationCount;
+		pStatistics->usedSize += allocator.usedSize;
+		pStatistics->requestedSize += allocator.requestedSize;
+		pStatistics->largestFreeSize = max(pStatistics->largestFreeSize,GetBuddyLargestFreeSize(&allocator));
+		freeSize += allocator.size - allocator.usedSize;
+	}
+	pStatistics->fragmentation = (freeSize > 0) ?
+		1.0f - static_cast<float>(pStatistics->largestFreeSize) / static_cast<float>(freeSize) : 0.0f;
+}
+
+//q[vv[ƓAȂȂubN𑫂Ȃ
+//傫ƃACg΂΂Ȋ蓖ĂƉoperationCounts
+//checkȂ犄蓖ĂdȂȂƁAACgASĉƂ1̃ubNɌ邱Ƃm߂
+bool TestBuddyRandom( uint32_t operationCount, bool check, BuddyPoolStatistics* pStatistics )
+{
+	const uint64_t BLOCK_SIZE = 16 * 1024 * 1024;
+	const uint64_t MIN_BLOCK_SIZE = 256;	//D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+	const uint32_t LIVE_COUNT = 4096;		//Ă銄蓖Ă̖ڈ
+	const uint64_t ALIGNMENT[] = { 256, 4 * 1024, 64 * 1024 };
+
+	struct Allocation
+	{
+		uint32_t blockIndex;
+		uint64_t offset;
+		uint64_t size;
+		uint64_t blockSize;	//ۂɊ蓖ĂꂽubÑTCY
+	};
+
+	vector<BuddyAllocator> pool;
+	vector<vector<uint8_t>> owner;	//ŏubNƂɎgpȂ1
+	vector<Allocation> live;
+	live.reserve(LIVE_COUNT * 2);
+	uint32_t seed = 12345;
+
+	for(uint32_t operation = 0;operation < operationCount;operation++)
+	{
+		if(operation == operationCount / 2)
+		{
+			GetBuddyPoolStatistics(pool,pStatistics);
+		}
+
+		seed = seed * 1664525 + 1013904223;
+		const bool allocate = live.empty() || (seed >> 8) % (LIVE_COUNT * 2) >= live.size();
+		seed = seed * 1664525 + 1013904223;
+		if(!allocate)
+		{
+			const uint32_t n = (seed >> 8) % live.size();
+			const Allocation allocation = live[n];
+			live[n] = live.back();
+			live.pop_back();
+			BuddyFree(&pool[allocation.blockIndex],allocation.offset,allocation.size);
+			if(check)
+			{
+				vector<uint8_t>& used = owner[allocation.blockIndex];
+				fill(used.begin() + static_cast<size_t>(allocation.offset / MIN_BLOCK_SIZE),
+					used.begin() + static_cast<size_t>((allocation.offset + allocation.blockSize) / MIN_BLOCK_SIZE),0);
+			}
+			continue;
+		}
+
+		//̂AƂǂ傫̂
+		uint64_t size = 64 + (seed >> 8) % (16 * 1024);
+		if((seed & 0xff) < 16)
+		{
+			size = 64 * 1024 + (seed >> 8) % (1024 * 1024);
+		}
+		seed = seed * 1664525 + 1013904223;
+		const uint64_t alignment = ALIGNMENT[(seed >> 8) % (sizeof(ALIGNMENT) / sizeof(ALIGNMENT[0]))];
+
+		Allocation allocation = {};
+		allocation.size = size;
+		bool allocated = false;
+		for(uint32_t i = 0;i < pool.size() && !allocated;i++)
+		{
+			allocated = BuddyAllocate(&pool[i],size,alignment,&allocation.offset);
+			allocation.blockIndex = i;
+		}
+		if(!allocated)
+		{
+			pool.emplace_back();
+			CHECK(InitBuddyAllocator(&pool.back(),BLOCK_SIZE,MIN_BLOCK_SIZE));
+			if(check)
+			{
+				owner.push_back(vector<uint8_t>(static_cast<size_t>(BLOCK_SIZE / MIN_BLOCK_SIZE),0));
+			}
+			allocation.blockIndex = static_cast<uint32_t>(pool.size() - 1);
+			CHECK(BuddyAllocate(&pool.back(),size,alignment,&allocation.offset));
+		}
+		allocation.blockSize = GetBuddyBlockSize(&pool[allocation.blockIndex],allocation.offset);
+		live.push_back(allocation);
+
+		if(check)
+		{
+			//ACgƔ͈́Aق̊蓖ĂƏdȂȂƂm߂
+			CHECK(allocation.offset % alignment == 0);
+			CHECK(allocation.blockSize >= size);
+			CHECK(allocation.offset + allocation.blockSize <= BLOCK_SIZE);
+			vector<uint8_t>& used = owner[allocation.blockIndex];
+			const uint64_t first = allocation.offset / MIN_BLOCK_SIZE;
+			for(uint64_t unit = first;unit < first + allocation.blockSize / MIN_BLOCK_SIZE;unit++)
+			{
+				CHECK(used[unit] == 0);
+				used[unit] = 1;
+			}
+		}
+	}
+
+	//SĉƁAeubN͍ő̎̋󂫃ubN1ɖ߂
+	for(const Allocation& allocation : live)
+	{
+		BuddyFree(&pool[allocation.blockIndex],allocation.offset,allocation.size);
+	}
+	if(check)
+	{
+		for(const BuddyAllocator& allocator : pool)
+		{
+			CHECK(IsBuddyAllocatorEmpty(&allocator));
+		}
+	}
+	return true;
+}
+
+//1ڂ͊mFȂA2ڂ͓菇mFōsĎԂvAr̒fЉƍ킹ďo͂
+bool BenchmarkBuddyAllocator( uint32_t operationCount )
+{
+	BuddyPoolStatistics statistics;
+	CHECK(TestBuddyRandom(operationCount,true,&statistics));
+
+	const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	BuddyPoolStatistics unused;
+	CHECK(TestBuddyRandom(operationCount,false,&unused));
+	const chrono::duration<double,milli> time = chrono::steady_clock::now() - begin;
+
+	printf("BuddyAllocator: %u operations, %.3f ms, %u heaps, %u allocations, used %llu, requested %llu, largest free %llu, fragmentation %.3f\n",
+		operationCount,time.count(),statistics.blockCount,statistics.allocationCount,
+		static_cast<unsigned long long>(statistics.usedSize),static_cast<unsigned long long>(statistics.requestedSize),
+		static_cast<unsigned long long>(statistics.largestFreeSize),statistics.fragmentation);
+	return true;
+}
@@ -0,0 +1,250 @@
+#include "DescriptorAllocator.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+bool TestFreeListMerge();
+bool TestFreeListExhaustion();
+bool TestFreeListRandom();
+bool TestDescriptorRing();
+bool TestDescriptorRingFrames( uint32_t frameCount );
+
+int main()
+{
+	bool result = true;
+	result = TestFreeListMerge() && result;
+	result = TestFreeListExhaustion() && result;
+	result = TestFreeListRandom() && result;
+	result = TestDescriptorRing() && result;
+	for(uint32_t frameCount = 1;frameCount <= 4;frameCount++)
+	{
+		result = TestDescriptorRingFrames(frameCount) && result;
+	}
+	printf("DescriptorAllocatorTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//Ԃ͈͂͑Ő󂫔͈͂Ƃ܂Ƃ߂Aŏɓ󂫔͈͂犄蓖Ă
+bool TestFreeListMerge()
+{
+	DescriptorFreeList freeList;
+	InitDescriptorFreeList(&freeList,100);
+
+	DescriptorRange a, b, c;
+	CHECK(AllocatePersistentDescriptors(&freeList,10,&a) && a.index == 0);
+	CHECK(AllocatePersistentDescriptors(&freeList,20,&b) && b.index == 10);
+	CHECK(AllocatePersistentDescriptors(&freeList,30,&c) && c.index == 30);
+	CHECK(freeList.used == 60);
+
+	//^񒆂ԂƁAc̋󂫂Ƃ͗Ă̂ł̂܂܎c
+	FreePersistentDescriptors(&freeList,&b);
+	CHECK(b.count == 0);
+	CHECK(freeList.freeRange.size() == 2);
+	CHECK(freeList.freeRange[0].index == 10 && freeList.freeRange[0].count == 20);
+
+	//ŏɓ󂫔͈(ԂƂ)犄蓖Ă
+	DescriptorRange d;
+	CHECK(AllocatePersistentDescriptors(&freeList,15,&d) && d.index == 10);
+	CHECK(freeList.freeRange[0].index == 25 && freeList.freeRange[0].count == 5);
+
+	//O󂢂Ă
+	FreePersistentDescriptors(&freeList,&a);
+	CHECK(freeList.freeRange.size() == 3);
+	//OオȂ1ɂȂ
+	FreePersistentDescriptors(&freeList,&d);
+	CHECK(freeList.freeRange.size() == 2);
+	CHECK(freeList.freeRange[0].index == 0 && freeList.freeRange[0].count == 30);
+	//̋󂫔͈͂ƂȂ
+	FreePersistentDescriptors(&freeList,&c);
+	CHECK(freeList.freeRange.size() == 1);
+	CHECK(freeList.freeRange[0].index == 0 && freeList.freeRange[0].count == 100);
+	CHECK(freeList.used == 0);
+
+	//2ԂĂȂ
+	FreePersistentDescriptors(&freeList,&c);
+	CHECK(freeList.freeRange.size() == 1 && freeList.used == 0);
+	return true;
+}
+
+//󂫔͈͂ΎsA󂫂̍vĂĂfЉĂΊ蓖ĂȂ
+bool TestFreeListExhaustion()
+{
+	DescriptorFreeList freeList;
+	InitDescriptorFreeList(&freeList,64);
+	DescriptorRange range[4];
+	for(uint32_t n = 0;n < 4;n++)
+	{
+		CHECK(AllocatePersistentDescriptors(&freeList,16,&range[n]));
+	}
+	CHECK(freeList.freeRange.empty());
+	DescriptorRange rest;
+	CHECK(!AllocatePersistentDescriptors(&freeList,1,&rest));
+
+	FreePersistentDescriptors(&freeList,&range[0]);
+	FreePersistentDescriptors(&freeList,&range[2]);
+	CHECK(freeList.used == 32);
+	CHECK(!AllocatePersistentDescriptors(&freeList,17,&rest));
+	CHECK(AllocatePersistentDescriptors(&freeList,16,&rest) && rest.index == 0);
+
+	DescriptorFreeList empty;
+	InitDescriptorFreeList(&empty,0);
+	CHECK(!AllocatePersistentDescriptors(&empty,1,&rest));
+	return true;
+}
+
+//_Ɋ蓖ĂƉJԂAgp͈̔͂dȂ炸A󂫔͈͂ʒuŗׂ荇ȂƂm߂
+bool TestFreeListRandom()
+{
+	const uint32_t DESCRIPTOR_COUNT = 4096;
+	DescriptorFreeList freeList;
+	InitDescriptorFreeList(&freeList,DESCRIPTOR_COUNT);
+
+	vector<bool> owned(DESCRIPTOR_COUNT,false);
+	vector<DescriptorRange> live;
+	uint32_t seed = 12345;
+	for(uint32_t step = 0;step < 20000;step++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		if(((seed >> 16) & 3) != 0 || live.empty())
+		{
+			const uint32_t count = (seed >> 8) % 64 + 1;
+			DescriptorRange range;
+			if(AllocatePersistentDescriptors(&freeList,count,&range))
+			{
+				CHECK(range.index + range.count <= DESCRIPTOR_COUNT);
+				for(uint32_t n = range.index;n < range.index + range.count;n++)
+				{
+					CHECK(!owned[n]);
+					owned[n] = true;
+				}
+				live.push_back(range);
+			}
+		}
+		else
+		{
+			const size_t n = (seed >> 8) % live.size();
+			for(uint32_t i = live[n].index;i < live[n].index + live[n].count;i++)
+			{
+				owned[i] = false;
+			}
+			FreePersistentDescriptors(&freeList,&live[n]);
+			live[n] = live.back();
+			live.pop_back();
+		}
+
+		uint32_t freeCount = 0;
+		for(size_t n = 0;n < freeList.freeRange.size();n++)
+		{
+			const DescriptorRange& range = freeList.freeRange[n];
+			CHECK(range.count > 0);
+			if(n > 0)
+			{
+				const DescriptorRange& prev = freeList.freeRange[n - 1];
+				CHECK(prev.index + prev.count < range.index);
+			}
+			freeCount += range.count;
+		}
+		CHECK(freeCount + freeList.used == DESCRIPTOR_COUNT);
+	}
+
+	for(DescriptorRange& range : live)
+	{
+		FreePersistentDescriptors(&freeList,&range);
+	}
+	CHECK(freeList.used == 0);
+	CHECK(freeList.freeRange.size() == 1 && freeList.freeRange[0].count == DESCRIPTOR_COUNT);
+	return true;
+}
+
+//O͖ɓ肫Ȃΐ擪֐܂ԂAGPUIt[̕
+bool TestDescriptorRing()
+{
+	DescriptorRing ring;
+	InitDescriptorRing(&ring,1000,100);
+
+	DescriptorRange range;
+	CHECK(AllocateTransientDescriptors(&ring,30,&range) && range.index == 1000);
+	CHECK(AllocateTransientDescriptors(&ring,30,&range) && range.index == 1030);
+	FinishDescriptorFrame(&ring,1);
+	CHECK(AllocateTransientDescriptors(&ring,30,&range) && range.index == 1060);
+
+	//10ɂ͓炸A擪̓t[1gĂ
+	CHECK(!AllocateTransientDescriptors(&ring,20,&range));
+	CHECK(ring.used == 90);
+
+	//tFXt[1̒l܂ŐiނƐ擪犄蓖Ă
+	RetireDescriptorFrames(&ring,0);
+	CHECK(ring.used == 90);
+	RetireDescriptorFrames(&ring,1);
+	CHECK(ring.used == 30 && ring.tail == 60);
+	CHECK(AllocateTransientDescriptors(&ring,20,&range) && range.index == 1000);
+	CHECK(ring.used == 60);
+	FinishDescriptorFrame(&ring,2);
+
+	//蓖ĂȂt[Ԃ
+	FinishDescriptorFrame(&ring,3);
+	RetireDescriptorFrames(&ring,3);
+	CHECK(ring.used == 0 && ring.frame.empty() && ring.tail == ring.head);
+
+	CHECK(!AllocateTransientDescriptors(&ring,0,&range));
+	CHECK(!AllocateTransientDescriptors(&ring,101,&range));
+	//󂢂ĂĂ܂ԂŎ̂Ă]͎̕gȂ
+	CHECK(!AllocateTransientDescriptors(&ring,100,&range));
+	CHECK(AllocateTransientDescriptors(&ring,80,&range) && range.index == 1020);
+	CHECK(ring.used == 80 && ring.head == 0);
+	return true;
+}
+
+//MoveToNextFrame()ƓAframeCount̃t[𓯎ɏȂ
+//t[ƂɋL^Xbh̐e[u蓖ĂāAGPUgĂ͈͂ƏdȂȂƂm߂
+bool TestDescriptorRingFrames( uint32_t frameCount )
+{
+	const uint32_t RING_COUNT = 1000;
+	const uint32_t FRAME_COUNT = 500;
+	const uint32_t TABLE_COUNT = 8;
+
+	DescriptorRing ring;
+	InitDescriptorRing(&ring,0,RING_COUNT);
+
+	vector<uint64_t> owner(RING_COUNT,0);		//gĂt[̃tFX̒l(0͋)
+	uint64_t completedValue = 0;
+	uint32_t seed = 12345;
+	for(uint64_t value = 1;value <= FRAME_COUNT;value++)
+	{
+		//frameCountÕt[I܂ő҂
+		if(value > frameCount)
+		{
+			completedValue = value - frameCount;
+			RetireDescriptorFrames(&ring,completedValue);
+		}
+		for(uint64_t& o : owner)
+		{
+			if(o != 0 && o <= completedValue)
+			{
+				o = 0;
+			}
+		}
+
+		for(uint32_t table = 0;table < TABLE_COUNT;table++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			const uint32_t count = (seed >> 8) % 24 + 1;
+			DescriptorRange range;
+			CHECK(AllocateTransientDescriptors(&ring,count,&range));
+			for(uint32_t n = range.index;n < range.index + range.count;n++)
+			{
+				CHECK(owner[n] == 0);
+				owner[n] = value;
+			}
+		}
+		FinishDescriptorFrame(&ring,value);
+		CHECK(ring.frame.size() <= frameCount);
+	}
+
+	RetireDescriptorFrames(&ring,FRAME_COUNT);
+	CHECK(ring.used == 0 && ring.frame.empty());
+	return true;
+}
@@ -0,0 +1,218 @@
+#include "FramePacer.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+
+//͋[GPU̎vŏ
+struct FramePacingResult
+{
+	uint32_t maxInFlight;		//ɏĂt[̍ő吔
+	double frameTime;			//1t[̎(~b)
+	double latency;				//CPUŎn߂ĂGPUI܂ł̕(~b)
+	uint64_t retiredCount;		//Ă΂ꂽ̐
+	bool retiredInOrder;		//l̏ɁAɌĂ΂ꂽ
+	bool drained;				//ŌɉcĂȂ
+};
+
+bool TestTimelineFence();
+bool TestFramePacer();
+void SimulateFramePacing( uint32_t frameCount, uint32_t simulatedFrameCount, FramePacingResult* pResult );
+bool TestFramePacing();
+
+int main()
+{
+	bool result = true;
+	result = TestTimelineFence() && result;
+	result = TestFramePacer() && result;
+	result = TestFramePacing() && result;
+	printf("FramePacerTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//͓o^ł͂Ȃl̏ɁAƂ1񂾂Ă΂
+bool TestTimelineFence()
+{
+	TimelineFence timeline;
+	InitTimelineFence(&timeline);
+	CHECK(AdvanceTimelineFence(&timeline) == 1);
+	CHECK(AdvanceTimelineFence(&timeline) == 2);
+	CHECK(AdvanceTimelineFence(&timeline) == 3);
+
+	vector<uint64_t> called;
+	RetireAfter(&timeline,3,[&called]() { called.push_back(3); });
+	RetireAfter(&timeline,1,[&called]() { called.push_back(1); });
+	RetireAfter(&timeline,2,[&called]() { called.push_back(2); });
+	RetireAfter(&timeline,1,[&called]() { called.push_back(10); });
+	CHECK(called.empty());
+
+	PollTimelineFence(&timeline,1);
+	CHECK(called.size() == 2 && called[0] == 1 && called[1] == 10);
+
+	//l͖߂Ȃ
+	PollTimelineFence(&timeline,0);
+	CHECK(timeline.completedValue == 1);
+	CHECK(called.size() == 2);
+
+	PollTimelineFence(&timeline,3);
+	CHECK(called.size() == 4 && called[2] == 2 && called[3] == 3);
+	CHECK(timeline.retirement.empty());
+
+	//ς݂̒lȂ炷ɌĂ
+	RetireAfter(&timeline,2,[&called]() { called.push_back(20); });
+	CHECK(called.size() == 5 && called[4] == 20);
+
+	//jƎc͌Ă΂Ȃ
+	RetireAfter(&timeline,4,[&called]() { called.push_back(4); });
+	DestroyTimelineFence(&timeline);
+	PollTimelineFence(&timeline,4);
+	CHECK(called.size() == 5);
+	return true;
+}
+
+//frameCountÕt[ŋL^l҂
+bool TestFramePacer()
+{
+	FramePacer pacer;
+	InitFramePacer(&pacer,0);
+	CHECK(pacer.frameCount == 1);
+	InitFramePacer(&pacer,MAX_FRAME_COUNT + 1);
+	CHECK(pacer.frameCount == MAX_FRAME_COUNT);
+
+	InitFramePacer(&pacer,3);
+	uint64_t waitValue;
+	CHECK(AdvanceFramePacer(&pacer,1,&waitValue) == 1);
+	CHECK(waitValue == 0);
+	CHECK(AdvanceFramePacer(&pacer,2,&waitValue) == 2);
+	CHECK(waitValue == 0);
+	CHECK(AdvanceFramePacer(&pacer,3,&waitValue) == 0);
+	CHECK(waitValue == 1);
+	CHECK(AdvanceFramePacer(&pacer,4,&waitValue) == 1);
+	CHECK(waitValue == 2);
+
+	InitFramePacer(&pacer,1);
+	CHECK(AdvanceFramePacer(&pacer,7,&waitValue) == 0);
+	CHECK(waitValue == 7);
+	return true;
+}
+
+//͋[GPU̎vframeCount̃t[𓯎ɏ
+//GPU͎󂯎1t[ACPUFramePaceȓ҂l܂Ŏvi߂
+void SimulateFramePacing( uint32_t frameCount, uint32_t simulatedFrameCount, FramePacingResult* pResult )
+{
+	const double CPU_TIME[] = { 2.0, 7.0 };		//t[ƂɌ݂ɕςCPUGPU̎(~b)
+	const double GPU_TIME[] = { 8.0, 5.0 };
+
+	TimelineFence timeline;
+	FramePacer pacer;
+	InitTimelineFence(&timeline);
+	InitFramePacer(&pacer,frameCount);
+
+	vector<double> finishTime(1,0.0);	//lƂGPŮ(l0͍ŏ犮)
+	vector<uint64_t> retired;			//Ă΂ꂽl̏
+	double cpuTime = 0.0;
+	double gpuTime = 0.0;
+	double latency = 0.0;
+	uint32_t maxInFlight = 0;
+	bool valid = true;
+
+	//time܂łGPUl
+	auto completedAt = [&finishTime](double time)
+	{
+		uint64_t value = 0;
+		while(value + 1 < finishTime.size() && finishTime[value + 1] <= time)
+		{
+			value++;
+		}
+		return value;
+	};
+
+	for(uint32_t frame = 0;frame < simulatedFrameCount;frame++)
+	{
+		const double beginTime = cpuTime;
+		cpuTime += CPU_TIME[frame % 2];
+
+		//̃t[̒lƁA1Õt[̒lŉo^(o^ƒl̏tɂȂ)
+		const uint64_t value = AdvanceTimelineFence(&timeline);
+		RetireAfter(&timeline,value,[&timeline,&retired,&valid,value]()
+		{
+			valid = valid && timeline.completedValue >= value;
+			retired.push_back(value);
+		});
+		if(value > 1)
+		{
+			RetireAfter(&timeline,value - 1,[&timeline,&retired,&valid,value]()
+			{
+				valid = valid && timeline.completedValue >= value - 1;
+				retired.push_back(value - 1);
+			});
+		}
+
+		gpuTime = max(gpuTime,cpuTime) + GPU_TIME[frame % 2];
+		finishTime.push_back(gpuTime);
+		latency += gpuTime - beginTime;
+
+		const uint32_t inFlight = static_cast<uint32_t>(value - completedAt(cpuTime));
+		maxInFlight = max(maxInFlight,inFlight);
+
+		//̃t[̃\[X󂭂܂ő҂
+		uint64_t waitValue;
+		AdvanceFramePacer(&pacer,value,&waitValue);
+		if(completedAt(cpuTime) < waitValue)
+		{
+			cpuTime = finishTime[static_cast<size_t>(waitValue)];
+		}
+		PollTimelineFence(&timeline,completedAt(cpuTime));
+	}
+	PollTimelineFence(&timeline,finishTime.size() - 1);
+
+	pResult->maxInFlight = maxInFlight;
+	pResult->frameTime = gpuTime / simulatedFrameCount;
+	pResult->latency = latency / simulatedFrameCount;
+	pResult->retiredCount = retired.size();
+	pResult->retiredInOrder = valid && is_sorted(retired.begin(),retired.end());
+	pResult->drained = timeline.retirement.empty();
+}
+
+//ɏt[frameCount𒴂A₷GPU̎ԂŌ܂鑬ɋ߂Â
+//1t[ȂCPUGPU݂ɓ̂ŁA1t[̎Ԃ͗̍vɂȂ
+bool TestFramePacing()
+{
+	const uint32_t SIMULATED_FRAME_COUNT = 1000;
+	const double SERIAL_FRAME_TIME = (2.0 + 8.0 + 7.0 + 5.0) / 2;
+	const double GPU_FRAME_TIME = (8.0 + 5.0) / 2;
+
+	double previousFrameTime = SERIAL_FRAME_TIME;
+	for(uint32_t frameCount = 1;frameCount <= MAX_FRAME_COUNT;frameCount++)
+	{
+		FramePacingResult result;
+		SimulateFramePacing(frameCount,SIMULATED_FRAME_COUNT,&result);
+		printf("FramePacing: %u frames in flight (max %u), %.2f ms/frame, latency %.2f ms\n",
+			frameCount,result.maxInFlight,result.frameTime,result.latency);
+
+		//1`N1񂸂A2ڈȍ~2񂸂Al̏ɌĂ΂Ă
+		CHECK(result.maxInFlight <= frameCount);
+		CHECK(result.retiredCount == SIMULATED_FRAME_COUNT * 2 - 1);
+		CHECK(result.retiredInOrder);
+		CHECK(result.drained);
+
+		CHECK(result.frameTime <= previousFrameTime + 1e-9);
+		CHECK(result.frameTime >= GPU_FRAME_TIME - 1e-9);
+		if(frameCount == 1)
+		{
+			CHECK(result.maxInFlight == 1);
+			CHECK(fabs(result.frameTime - SERIAL_FRAME_TIME) < 1e-9);
+		}
+		else
+		{
+			CHECK(result.maxInFlight > 1);
+			CHECK(fabs(result.frameTime - GPU_FRAME_TIME) < 0.01);
+		}
+		previousFrameTime = result.frameTime;
+	}
+	return true;
+}
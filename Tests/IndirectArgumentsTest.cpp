@@ -0,0 +1,155 @@
+#include "IndirectArguments.h"
+#include "RecordWorkers.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+//VF[_[̃R}hVOl`([g萔1ƕ`)Ɠ傫ŋl߂ĕ
+static_assert(sizeof(DrawIndexedArguments) == 20, "DrawIndexedArguments");
+static_assert(sizeof(IndirectCommand) == 24, "IndirectCommand");
+static_assert(offsetof(IndirectCommand,draw) == 4, "IndirectCommand");
+
+const uint32_t MAX_INSTANCE_COUNT = 128 * 1024;
+
+bool TestSmallArguments();
+bool TestIndirectArguments( uint32_t drawCount );
+
+int main()
+{
+	bool result = true;
+	result = TestSmallArguments() && result;
+	result = TestIndirectArguments(64 * 1024) && result;
+	printf("IndirectArgumentsTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//`悲ƂɃob`̏ňсAeʂȂ`͏Ȃ
+bool TestSmallArguments()
+{
+	const Subset subset[] = { { 5, 36, 0 }, { 7, 6, 36 } };
+	const DrawItem item[] = { { 0, 1 }, { 0, 0 }, { 0, 1 } };
+	const InstanceBatch batch[] = { { 0, 0, 10 }, { 1, 10, 3 } };
+
+	IndirectCommand command[7] = {};
+	CHECK(BuildIndirectArguments(item,3,subset,batch,2,command,6) == 6);
+	CHECK(command[0].materialIndex == 7 && command[0].draw.IndexCountPerInstance == 6 && command[0].draw.StartIndexLocation == 36);
+	CHECK(command[0].draw.InstanceCount == 10 && command[0].draw.StartInstanceLocation == 0);
+	CHECK(command[1].materialIndex == 7 && command[1].draw.InstanceCount == 3 && command[1].draw.StartInstanceLocation == 10);
+	CHECK(command[2].materialIndex == 5 && command[2].draw.IndexCountPerInstance == 36 && command[2].draw.StartIndexLocation == 0);
+	CHECK(command[5].materialIndex == 7 && command[5].draw.BaseVertexLocation == 0);
+
+	//`̓rŐ؂Ȃ
+	IndirectCommand guard = {};
+	guard.materialIndex = 0xffffffff;
+	command[4] = guard;
+	command[5] = guard;
+	CHECK(BuildIndirectArguments(item,3,subset,batch,2,command,5) == 4);
+	CHECK(command[4].materialIndex == 0xffffffff && command[5].materialIndex == 0xffffffff);
+
+	//ob``悪ΉȂ
+	CHECK(BuildIndirectArguments(item,3,subset,batch,0,command,6) == 0);
+	CHECK(BuildIndirectArguments(item,0,subset,batch,2,command,6) == 0);
+	CHECK(BuildIndirectArguments(item,3,subset,batch,2,command,1) == 0);
+	return true;
+}
+
+//_ȕ`ƃob``A1gݗĂƔׂ
+//eʂŐ؂Ƃ͕`PʂŐ؂邱ƁARecordDrawRange()ƓL^WuƂ
+//ʒu炵ďʂ1ŏʂƓŁA̍vv邱Ƃm߂
+bool TestIndirectArguments( uint32_t drawCount )
+{
+	const uint32_t SUBSET_COUNT = 256;
+	const uint32_t BATCH_COUNT[] = { 0, 1, 3, 8 };
+	const uint32_t LOOP_COUNT = 10;
+
+	uint32_t seed = 12345;
+	vector<Subset> subset(SUBSET_COUNT);
+	for(Subset& s : subset)
+	{
+		seed = seed * 1664525 + 1013904223;
+		s.mat_index = static_cast<int>((seed >> 8) % 64);
+		s.vertexCount = static_cast<int>((seed >> 4) % 3000) * 3 + 3;
+		s.vertexStart = static_cast<int>(seed >> 12);
+	}
+	vector<DrawItem> item(drawCount);
+	for(DrawItem& draw : item)
+	{
+		seed = seed * 1664525 + 1013904223;
+		draw.key = seed;
+		draw.subset = (seed >> 8) % SUBSET_COUNT;
+	}
+
+	vector<IndirectCommand> command;
+	vector<IndirectCommand> jobCommand;
+	vector<RecordJob> jobs;
+	chrono::duration<double,milli> time(0);
+	for(uint32_t batchCount : BATCH_COUNT)
+	{
+		vector<InstanceBatch> batch(batchCount);
+		for(uint32_t b = 0;b < batchCount;b++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			batch[b].meshIndex = b;
+			batch[b].firstInstance = (seed >> 8) % MAX_INSTANCE_COUNT;
+			batch[b].instanceCount = (seed >> 4) % 1000 + 1;
+		}
+
+		//eʂȂƂƑƂ̗
+		const uint32_t capacity[] = { drawCount * batchCount, drawCount * batchCount / 2 + 1 };
+		for(uint32_t c : capacity)
+		{
+			command.assign(static_cast<size_t>(c) + 1,IndirectCommand());
+			uint32_t commandCount = 0;
+			const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+			for(uint32_t loop = 0;loop < LOOP_COUNT;loop++)
+			{
+				commandCount = BuildIndirectArguments(item.data(),drawCount,subset.data(),batch.data(),batchCount,command.data(),c);
+			}
+			if(batchCount == BATCH_COUNT[3] && c == capacity[0])
+			{
+				time = chrono::steady_clock::now() - begin;
+			}
+
+			const uint32_t expectedDraws = (batchCount > 0) ? min(drawCount,c / batchCount) : 0;
+			CHECK(commandCount == expectedDraws * batchCount);
+			for(uint32_t n = 0;n < commandCount;n++)
+			{
+				const Subset& s = subset[item[n / batchCount].subset];
+				const InstanceBatch& b = batch[n % batchCount];
+				const IndirectCommand& a = command[n];
+				CHECK(a.materialIndex == static_cast<uint32_t>(s.mat_index));
+				CHECK(a.draw.IndexCountPerInstance == static_cast<uint32_t>(s.vertexCount));
+				CHECK(a.draw.InstanceCount == b.instanceCount);
+				CHECK(a.draw.StartIndexLocation == static_cast<uint32_t>(s.vertexStart));
+				CHECK(a.draw.BaseVertexLocation == 0);
+				CHECK(a.draw.StartInstanceLocation == b.firstInstance);
+			}
+
+			//L^WuƂɏ(RecordDraws()ƓʒuƗe)
+			PartitionDraws(drawCount,MAX_RECORD_THREAD_COUNT,MIN_DRAWS_PER_RECORD_JOB,&jobs);
+			jobCommand.assign(static_cast<size_t>(c) + 1,IndirectCommand());
+			uint32_t jobCommandCount = 0;
+			for(const RecordJob& job : jobs)
+			{
+				const uint32_t first = job.first * batchCount;
+				const uint32_t jobCapacity = (first < c) ? min(job.count * batchCount,c - first) : 0;
+				jobCommandCount += BuildIndirectArguments(&item[job.first],job.count,subset.data(),batch.data(),batchCount,
+					jobCommand.data() + min(first,c),jobCapacity);
+			}
+			CHECK(jobCommandCount == commandCount);
+			CHECK(memcmp(jobCommand.data(),command.data(),sizeof(IndirectCommand) * commandCount) == 0);
+		}
+	}
+
+	const double ms = time.count() / LOOP_COUNT;
+	printf("IndirectArguments: %u draws x %u batches, %.3f ms (%.0f arguments/ms), matches reference\n",
+		drawCount,BATCH_COUNT[3],ms,drawCount * BATCH_COUNT[3] / max(ms,0.001));
+	return true;
+}
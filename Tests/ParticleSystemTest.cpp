@@ -0,0 +1,171 @@
+#include "ParticleSystem.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace DirectX;
+using namespace std;
+
+const float TOLERANCE = 1e-4f;
+
+bool TestParticleMotion();
+bool TestParticleCapacity();
+bool TestParticleThreads( uint32_t count, uint32_t threadCount );
+bool TestDestroyParticleSystem();
+
+int main()
+{
+	const uint32_t threadCount = min(max(thread::hardware_concurrency(),1u),MAX_PARTICLE_THREAD_COUNT);
+
+	bool result = true;
+	result = TestParticleMotion() && result;
+	result = TestParticleCapacity() && result;
+	result = TestParticleThreads(100000,max(threadCount,4u)) && result;
+	result = TestDestroyParticleSystem() && result;
+	printf("ParticleSystemTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//d͂ƒRőxƈʒui݁A傫ƐF͎ɑ΂܂A]spinɔႷ
+bool TestParticleMotion()
+{
+	ParticleSystem system;
+	CHECK(InitParticleSystem(&system,100,2));
+	system.gravity = XMFLOAT3(0.0f,-10.0f,0.0f);
+	system.drag = 0.5f;
+	system.spin = 2.0f;
+	const float sizeCurve[PARTICLE_CURVE_KEY_COUNT] = { 0.0f, 3.0f, 6.0f, 0.0f };
+	for(uint32_t k = 0;k < PARTICLE_CURVE_KEY_COUNT;k++)
+	{
+		system.sizeCurve[k] = sizeCurve[k];
+		system.colorCurve[0][k] = k * 0.25f;
+	}
+
+	ParticleEmitter emitter = {};
+	emitter.position = XMFLOAT3(1.0f,2.0f,3.0f);
+	emitter.velocity = XMFLOAT3(4.0f,0.0f,0.0f);
+	emitter.lifeMin = 1.0f;
+	emitter.lifeMax = 1.0f;
+	EmitParticles(&system,emitter,3,false);
+	CHECK(system.count == 3);
+
+	//̔i߂ƁA܂2ڂ̋Ԃ̐^
+	UpdateParticleSystem(&system,0.5f);
+	CHECK(system.count == 3);
+	const float damping = 1.0f - 0.5f * 0.5f;
+	SpriteInstance sprite[3];
+	WriteParticleSprites(&system,sprite);
+	for(uint32_t n = 0;n < 3;n++)
+	{
+		CHECK(fabsf(sprite[n].position.x - (1.0f + 4.0f * damping * 0.5f)) <= TOLERANCE);
+		CHECK(fabsf(sprite[n].position.y - (2.0f - 10.0f * 0.5f * damping * 0.5f)) <= TOLERANCE);
+		CHECK(sprite[n].position.z == 3.0f);
+		CHECK(fabsf(sprite[n].size - 4.5f) <= TOLERANCE);
+		CHECK(fabsf(sprite[n].rotation - 1.0f) <= TOLERANCE);
+		CHECK(fabsf(sprite[n].color.x - 0.375f) <= TOLERANCE && sprite[n].color.y == 1.0f);
+	}
+	Vertex vertex[3];
+	WriteParticleVertices(&system,vertex);
+	CHECK(vertex[0].possition.x == sprite[0].position.x && vertex[0].scale == sprite[0].size);
+
+	//s
+	UpdateParticleSystem(&system,0.5f);
+	CHECK(system.count == 0);
+	DestroyParticleSystem(&system);
+	return true;
+}
+
+//capacity𒴂镪͎̂āAG~b^[͒[̃t[Ɏz
+bool TestParticleCapacity()
+{
+	ParticleSystem system;
+	CHECK(InitParticleSystem(&system,10,1));
+	CHECK(system.positionX.size() == PARTICLE_CHUNK_SIZE);
+
+	ParticleEmitter emitter = {};
+	emitter.lifeMin = 10.0f;
+	emitter.lifeMax = 10.0f;
+	EmitParticles(&system,emitter,25,false);
+	CHECK(system.count == 10);
+
+	system.count = 0;
+	emitter.rate = 3.0f;
+	system.emitter.push_back(emitter);
+	UpdateParticleSystem(&system,0.5f);
+	CHECK(system.count == 1);
+	UpdateParticleSystem(&system,0.5f);
+	CHECK(system.count == 3);
+	DestroyParticleSystem(&system);
+	return true;
+}
+
+//̃`Nɂ܂镬i߂ĂA߂͎̂c炸Aʂ̓Xbh̐ɂȂ
+bool TestParticleThreads( uint32_t count, uint32_t threadCount )
+{
+	const uint32_t FRAME_COUNT = 60;
+	const float deltaTime = 1.0f / 60.0f;
+
+	ParticleSystem single;
+	ParticleSystem parallel;
+	CHECK(CreateParticleFountain(&single,count,count / 4 * 5,1));
+	CHECK(CreateParticleFountain(&parallel,count,count / 4 * 5,threadCount));
+	CHECK(count > PARTICLE_CHUNK_SIZE * 2);
+	vector<SpriteInstance> singleOutput(single.capacity);
+	vector<SpriteInstance> parallelOutput(parallel.capacity);
+
+	chrono::steady_clock::duration singleTime = chrono::steady_clock::duration::zero();
+	chrono::steady_clock::duration parallelTime = chrono::steady_clock::duration::zero();
+	for(uint32_t frame = 0;frame < FRAME_COUNT;frame++)
+	{
+		chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		UpdateParticleSystem(&single,deltaTime);
+		WriteParticleSprites(&single,singleOutput.data());
+		singleTime += chrono::steady_clock::now() - begin;
+
+		begin = chrono::steady_clock::now();
+		UpdateParticleSystem(&parallel,deltaTime);
+		WriteParticleSprites(&parallel,parallelOutput.data());
+		parallelTime += chrono::steady_clock::now() - begin;
+
+		CHECK(single.count == parallel.count);
+		for(uint32_t n = 0;n < single.count;n++)
+		{
+			CHECK(single.age[n] * single.invLife[n] < 1.0f);
+			CHECK(single.positionX[n] == parallel.positionX[n] && single.positionY[n] == parallel.positionY[n]);
+			CHECK(single.age[n] == parallel.age[n]);
+			CHECK(singleOutput[n].size == parallelOutput[n].size && singleOutput[n].color.w == parallelOutput[n].color.w);
+		}
+	}
+	//oƏłނ荇āA͂قڕۂ
+	CHECK(single.count > count / 2 && single.count <= single.capacity);
+
+	printf("Particles: %u alive, 1 thread %.3f ms/frame, %u threads %.3f ms/frame\n",single.count,
+		chrono::duration<double,milli>(singleTime).count() / FRAME_COUNT,parallel.threadCount,
+		chrono::duration<double,milli>(parallelTime).count() / FRAME_COUNT);
+	DestroyParticleSystem(&single);
+	DestroyParticleSystem(&parallel);
+	return true;
+}
+
+//ĂȂ̂2ڂ̔jł~܂炸ɖ߂AjƂ͍蒼
+bool TestDestroyParticleSystem()
+{
+	static ParticleSystem system;	//ÓIȋLȂ̂ŃXbh̐0
+	DestroyParticleSystem(&system);
+	CHECK(InitParticleSystem(&system,10,4));
+	DestroyParticleSystem(&system);
+	DestroyParticleSystem(&system);
+	CHECK(InitParticleSystem(&system,10,4));
+	ParticleEmitter emitter = {};
+	emitter.lifeMin = 1.0f;
+	emitter.lifeMax = 1.0f;
+	EmitParticles(&system,emitter,5,false);
+	UpdateParticleSystem(&system,0.1f);
+	CHECK(system.count == 5);
+	DestroyParticleSystem(&system);
+	return true;
+}
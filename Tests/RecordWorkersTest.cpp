@@ -0,0 +1,268 @@
+#include "RecordWorkers.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+const uint32_t STATE_MARK = 0xfffffffd;		//SetState()̑
+const uint32_t BEGIN_MARK = 0xfffffffe;		//JnXgƏIXg̑
+const uint32_t END_MARK = 0xffffffff;
+
+//`̔ԍL^邾̃R}hXg
+struct MockCommandList : RecordCommandList
+{
+	vector<uint32_t> command;
+	bool recording = false;
+	bool failClose = false;		//Close()s
+	uint32_t resetCount = 0;
+	uint32_t closeCount = 0;
+	uint32_t workerIndex = 0;	//ŌɋL^Xbh̔ԍ
+
+	bool Reset() override
+	{
+		if(recording)
+		{
+			return false;
+		}
+		command.clear();
+		recording = true;
+		resetCount++;
+		return true;
+	}
+	void SetState() override
+	{
+		command.push_back(STATE_MARK);
+	}
+	void RecordDraws( uint32_t index, const RecordJob& job ) override
+	{
+		workerIndex = index;
+		for(uint32_t draw = job.first;draw < job.first + job.count;draw++)
+		{
+			command.push_back(draw);
+		}
+	}
+	bool Close() override
+	{
+		recording = false;
+		closeCount++;
+		return !failClose;
+	}
+};
+
+bool TestPartitionDraws();
+bool RecordFrames( RecordWorkerPool* pPool, MockCommandList* pList, uint32_t drawCount, uint32_t frameCount );
+bool TestRecordDraws();
+bool TestRecordFailure();
+bool TestRecordWorkerTask();
+bool BenchmarkDrawRecording( uint32_t drawCount );
+
+int main()
+{
+	bool result = true;
+	result = TestPartitionDraws() && result;
+	result = TestRecordDraws() && result;
+	result = TestRecordFailure() && result;
+	result = TestRecordWorkerTask() && result;
+	result = BenchmarkDrawRecording(100000) && result;
+	printf("RecordWorkersTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//Wu̓Xbhȉ̘A͈͂ŁAŏ𖞂
+bool TestPartitionDraws()
+{
+	const uint32_t DRAW_COUNT[] = { 0, 1, MIN_DRAWS_PER_RECORD_JOB - 1, MIN_DRAWS_PER_RECORD_JOB, MIN_DRAWS_PER_RECORD_JOB + 1,
+		MIN_DRAWS_PER_RECORD_JOB * 2 - 1, MIN_DRAWS_PER_RECORD_JOB * MAX_RECORD_THREAD_COUNT + 3, 1000, 100000 };
+
+	vector<RecordJob> jobs;
+	for(uint32_t count : DRAW_COUNT)
+	{
+		for(uint32_t threadCount = 0;threadCount <= MAX_RECORD_THREAD_COUNT;threadCount++)
+		{
+			PartitionDraws(count,threadCount,MIN_DRAWS_PER_RECORD_JOB,&jobs);
+			CHECK(jobs.size() <= max(threadCount,1u));
+			CHECK((count == 0) == jobs.empty());
+			uint32_t next = 0;
+			for(const RecordJob& job : jobs)
+			{
+				CHECK(job.first == next);
+				CHECK(job.count >= min(count,MIN_DRAWS_PER_RECORD_JOB));
+				next += job.count;
+			}
+			CHECK(next == count);
+		}
+	}
+	return true;
+}
+
+//Render()ƓAJnXgAWũXgAIXg̏ɕׂƂ
+//SĂ̕`悪1񂸂`L[̏ɕсAXgƂɏԂݒ肵Ă`悷邱
+bool RecordFrames( RecordWorkerPool* pPool, MockCommandList* pList, uint32_t drawCount, uint32_t frameCount )
+{
+	RecordCommandList* ppCommandList[MAX_RECORD_THREAD_COUNT];
+	for(uint32_t n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+	{
+		ppCommandList[n] = &pList[n];
+		pList[n].resetCount = 0;
+		pList[n].closeCount = 0;
+	}
+
+	vector<RecordJob> jobs;
+	vector<uint32_t> submitted;
+	for(uint32_t frame = 0;frame < frameCount;frame++)
+	{
+		BeginRecordDraws(pPool,drawCount,ppCommandList,&jobs);
+		CHECK(EndRecordDraws(pPool,ppCommandList,jobs));
+		CHECK(jobs.size() <= pPool->threadCount);
+
+		submitted.clear();
+		submitted.push_back(BEGIN_MARK);
+		for(uint32_t n = 0;n < jobs.size();n++)
+		{
+			const MockCommandList& list = pList[n];
+			CHECK(!list.recording);
+			CHECK(list.workerIndex == n);
+			CHECK(!list.command.empty() && list.command.front() == STATE_MARK);
+			submitted.insert(submitted.end(),list.command.begin() + 1,list.command.end());
+		}
+		submitted.push_back(END_MARK);
+
+		CHECK(submitted.size() == drawCount + 2);
+		CHECK(submitted.back() == END_MARK);
+		for(uint32_t n = 0;n < drawCount;n++)
+		{
+			CHECK(submitted[n + 1] == n);
+		}
+	}
+
+	//Wû郊Xgt[1񂸂L^
+	PartitionDraws(drawCount,pPool->threadCount,MIN_DRAWS_PER_RECORD_JOB,&jobs);
+	for(uint32_t n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+	{
+		const uint32_t expected = (n < jobs.size()) ? frameCount : 0;
+		CHECK(pList[n].resetCount == expected);
+		CHECK(pList[n].closeCount == expected);
+	}
+	return true;
+}
+
+//Xbhƕ`搔ςāAL^XbhŋL^đ҂܂łt[JԂ
+bool TestRecordDraws()
+{
+	const uint32_t DRAW_COUNT[] = { 0, 1, MIN_DRAWS_PER_RECORD_JOB - 1, MIN_DRAWS_PER_RECORD_JOB, MIN_DRAWS_PER_RECORD_JOB + 1,
+		MIN_DRAWS_PER_RECORD_JOB * 2 - 1, MIN_DRAWS_PER_RECORD_JOB * MAX_RECORD_THREAD_COUNT + 3, 1000 };
+
+	for(uint32_t threadCount = 0;threadCount <= MAX_RECORD_THREAD_COUNT;threadCount++)
+	{
+		RecordWorkerPool pool;
+		CreateRecordWorkerPool(&pool,threadCount);
+		const bool running = IsRecordWorkerPoolRunning(&pool);
+		bool result = pool.threadCount == max(threadCount,1u) && running == (threadCount > 1);
+
+		MockCommandList list[MAX_RECORD_THREAD_COUNT];
+		for(uint32_t count : DRAW_COUNT)
+		{
+			result = result && RecordFrames(&pool,list,count,3);
+		}
+		DestroyRecordWorkerPool(&pool);
+		CHECK(result);
+		CHECK(!IsRecordWorkerPoolRunning(&pool));
+	}
+	return true;
+}
+
+//ǂꂩ̃Xg̋L^ɎsAS҂Ă玸sԂ
+bool TestRecordFailure()
+{
+	RecordWorkerPool pool;
+	CreateRecordWorkerPool(&pool,4);
+	MockCommandList list[MAX_RECORD_THREAD_COUNT];
+	RecordCommandList* ppCommandList[MAX_RECORD_THREAD_COUNT];
+	for(uint32_t n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+	{
+		ppCommandList[n] = &list[n];
+	}
+
+	vector<RecordJob> jobs;
+	list[2].failClose = true;
+	BeginRecordDraws(&pool,1000,ppCommandList,&jobs);
+	const bool failed = !EndRecordDraws(&pool,ppCommandList,jobs);
+	bool closed = true;
+	for(uint32_t n = 0;n < jobs.size();n++)
+	{
+		closed = closed && list[n].closeCount == 1 && !list[n].recording;
+	}
+
+	//s͎̃t[ɎzȂ
+	list[2].failClose = false;
+	BeginRecordDraws(&pool,1000,ppCommandList,&jobs);
+	const bool recovered = EndRecordDraws(&pool,ppCommandList,jobs);
+	DestroyRecordWorkerPool(&pool);
+
+	CHECK(jobs.size() == 4);
+	CHECK(failed);
+	CHECK(closed);
+	CHECK(recovered);
+
+	//CXbhŋL^Ƃ
+	CreateRecordWorkerPool(&pool,1);
+	list[0].failClose = true;
+	BeginRecordDraws(&pool,10,ppCommandList,&jobs);
+	const bool failedOnMain = !EndRecordDraws(&pool,ppCommandList,jobs);
+	DestroyRecordWorkerPool(&pool);
+	CHECK(failedOnMain);
+	return true;
+}
+
+//`ȊO̕SłAS1񂸂̔ԍŌĂ΂
+bool TestRecordWorkerTask()
+{
+	for(uint32_t threadCount : { 1u, 2u, MAX_RECORD_THREAD_COUNT })
+	{
+		RecordWorkerPool pool;
+		CreateRecordWorkerPool(&pool,threadCount);
+		atomic<uint32_t> called[MAX_RECORD_THREAD_COUNT] = {};
+		bool result = true;
+		for(uint32_t repeat = 0;repeat < 100;repeat++)
+		{
+			result = RunRecordWorkerTask(&pool,[&called]( uint32_t workerIndex )
+			{
+				called[workerIndex]++;
+				return true;
+			}) && result;
+		}
+		const bool failed = !RunRecordWorkerTask(&pool,[]( uint32_t workerIndex ) { return workerIndex != 0; });
+		DestroyRecordWorkerPool(&pool);
+
+		CHECK(result);
+		CHECK(failed);
+		for(uint32_t n = 0;n < MAX_RECORD_THREAD_COUNT;n++)
+		{
+			CHECK(called[n] == ((n < pool.threadCount) ? 100u : 0u));
+		}
+	}
+	return true;
+}
+
+//drawCount̕`ő̃XbhŃbÑXgɋL^鎞Ԃo͂
+bool BenchmarkDrawRecording( uint32_t drawCount )
+{
+	const uint32_t FRAME_COUNT = 10;
+
+	RecordWorkerPool pool;
+	CreateRecordWorkerPool(&pool,MAX_RECORD_THREAD_COUNT);
+	MockCommandList list[MAX_RECORD_THREAD_COUNT];
+	const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	const bool result = RecordFrames(&pool,list,drawCount,FRAME_COUNT);
+	const chrono::duration<double,milli> time = chrono::steady_clock::now() - begin;
+	DestroyRecordWorkerPool(&pool);
+	CHECK(result);
+
+	printf("DrawRecording: %u draws, %u threads, %.3f ms/frame (mock lists, including the order check)\n",
+		drawCount,pool.threadCount,time.count() / FRAME_COUNT);
+	return true;
+}
@@ -0,0 +1,177 @@
+#include "RenderGraph.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+const uint64_t MB = 1024 * 1024;
+const uint64_t ALIGNMENT = 65536;		//D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+
+bool TestReadOnlyState();
+bool TestFixedGraph();
+bool TestMergedReads();
+bool TestRandomGraph( uint32_t passCount );
+
+int main()
+{
+	bool result = true;
+	result = TestReadOnlyState() && result;
+	result = TestFixedGraph() && result;
+	result = TestMergedReads() && result;
+	result = TestRandomGraph(1000) && result;
+	printf("RenderGraphTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//݂܂ޏԂCOMMON͓ǂݍݓmƂĂ܂Ƃ߂Ȃ
+bool TestReadOnlyState()
+{
+	CHECK(IsReadOnlyRenderGraphState(RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE));
+	CHECK(IsReadOnlyRenderGraphState(RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE | RENDER_GRAPH_STATE_NON_PIXEL_SHADER_RESOURCE));
+	CHECK(IsReadOnlyRenderGraphState(RENDER_GRAPH_STATE_DEPTH_READ));
+	CHECK(!IsReadOnlyRenderGraphState(RENDER_GRAPH_STATE_COMMON));
+	CHECK(!IsReadOnlyRenderGraphState(RENDER_GRAPH_STATE_RENDER_TARGET));
+	CHECK(!IsReadOnlyRenderGraphState(RENDER_GRAPH_STATE_DEPTH_WRITE | RENDER_GRAPH_STATE_DEPTH_READ));
+	return true;
+}
+
+//Shadow  Lighting  Bloom  CompositȅɎgAUnused̏o͂͂ǂǂ܂Ȃ
+//Shadow̐[xLightinǧɕsvɂȂ̂ŁABloom̏o͂Ɠꏊɒu
+bool TestFixedGraph()
+{
+	RenderGraph graph = {};
+	const uint32_t backBuffer = AddRenderGraphImport(&graph,"BackBuffer",RENDER_GRAPH_STATE_PRESENT,RENDER_GRAPH_STATE_PRESENT);
+	const uint32_t shadow = AddRenderGraphTransient(&graph,"Shadow",8 * MB,ALIGNMENT);
+	const uint32_t light = AddRenderGraphTransient(&graph,"Light",8 * MB,ALIGNMENT);
+	const uint32_t unused = AddRenderGraphTransient(&graph,"Unused",4 * MB,ALIGNMENT);
+	const uint32_t bloom = AddRenderGraphTransient(&graph,"Bloom",8 * MB,ALIGNMENT);
+
+	uint32_t pass = AddRenderGraphPass(&graph,"Shadow");
+	RenderGraphWrite(&graph,pass,shadow,RENDER_GRAPH_STATE_DEPTH_WRITE);
+	pass = AddRenderGraphPass(&graph,"Lighting");
+	RenderGraphRead(&graph,pass,shadow,RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE);
+	RenderGraphWrite(&graph,pass,light,RENDER_GRAPH_STATE_RENDER_TARGET);
+	const uint32_t unusedPass = AddRenderGraphPass(&graph,"Unused");
+	RenderGraphRead(&graph,unusedPass,shadow,RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE);
+	RenderGraphWrite(&graph,unusedPass,unused,RENDER_GRAPH_STATE_RENDER_TARGET);
+	pass = AddRenderGraphPass(&graph,"Bloom");
+	RenderGraphRead(&graph,pass,light,RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE);
+	RenderGraphWrite(&graph,pass,bloom,RENDER_GRAPH_STATE_RENDER_TARGET);
+	const uint32_t compositePass = AddRenderGraphPass(&graph,"Composite");
+	RenderGraphRead(&graph,compositePass,light,RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE);
+	RenderGraphRead(&graph,compositePass,bloom,RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE);
+	RenderGraphWrite(&graph,compositePass,backBuffer,RENDER_GRAPH_STATE_RENDER_TARGET);
+	CompileRenderGraph(&graph);
+
+	CHECK(graph.culledPassCount == 1);
+	CHECK(graph.pass[unusedPass].culled);
+	CHECK(graph.resource[unused].firstPass == RENDER_GRAPH_INVALID);
+	CHECK(graph.resource[shadow].aliased);
+	CHECK(graph.resource[bloom].aliased);
+	CHECK(!graph.resource[light].aliased);
+	CHECK(graph.resource[shadow].heapOffset == graph.resource[bloom].heapOffset);
+	CHECK(graph.transientHeapSize == 16 * MB);
+	CHECK(graph.transientRequestedSize == 24 * MB);
+	CHECK(ValidateRenderGraph(&graph));
+
+	//obNobt@CompositȇOɃ_[^[Qbg֑JڂAŌɕ\łԂ֖߂
+	bool toRenderTarget = false;
+	for(const RenderGraphBarrier& barrier : graph.pass[compositePass].barrier)
+	{
+		toRenderTarget = toRenderTarget || (barrier.resource == backBuffer && !barrier.aliasing &&
+			barrier.before == RENDER_GRAPH_STATE_PRESENT && barrier.after == RENDER_GRAPH_STATE_RENDER_TARGET);
+	}
+	CHECK(toRenderTarget);
+	bool toPresent = false;
+	for(const RenderGraphBarrier& barrier : graph.finalBarrier)
+	{
+		toPresent = toPresent || (barrier.resource == backBuffer && barrier.after == RENDER_GRAPH_STATE_PRESENT);
+	}
+	CHECK(toPresent);
+	return true;
+}
+
+//1̃pX\[Xʂ̃VF[_[ǂނƂ́AԂ܂Ƃ߂đJڂ1ɂ
+bool TestMergedReads()
+{
+	RenderGraph graph = {};
+	const uint32_t backBuffer = AddRenderGraphImport(&graph,"BackBuffer",RENDER_GRAPH_STATE_PRESENT,RENDER_GRAPH_STATE_PRESENT);
+	const uint32_t texture = AddRenderGraphTransient(&graph,"Texture",MB,ALIGNMENT);
+
+	const uint32_t writePass = AddRenderGraphPass(&graph,"Write");
+	RenderGraphWrite(&graph,writePass,texture,RENDER_GRAPH_STATE_RENDER_TARGET);
+	const uint32_t readPass = AddRenderGraphPass(&graph,"Read");
+	RenderGraphRead(&graph,readPass,texture,RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE);
+	RenderGraphRead(&graph,readPass,texture,RENDER_GRAPH_STATE_NON_PIXEL_SHADER_RESOURCE);
+	RenderGraphWrite(&graph,readPass,backBuffer,RENDER_GRAPH_STATE_RENDER_TARGET);
+	CompileRenderGraph(&graph);
+
+	CHECK(graph.culledPassCount == 0);
+	CHECK(ValidateRenderGraph(&graph));
+	uint32_t transitionCount = 0;
+	for(const RenderGraphBarrier& barrier : graph.pass[readPass].barrier)
+	{
+		if(barrier.resource == texture && !barrier.aliasing)
+		{
+			CHECK(barrier.after == (RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE | RENDER_GRAPH_STATE_NON_PIXEL_SHADER_RESOURCE));
+			transitionCount++;
+		}
+	}
+	CHECK(transitionCount == 1);
+	return true;
+}
+
+//passCount̃pX_Ɉꎞ\[XǂݏOtRpCAʂm߂ĎԂo͂
+//epX1̃\[XɏAÕpXʂ̂̂2܂œǂށBŌ̃pX̓obNobt@ɏ
+bool TestRandomGraph( uint32_t passCount )
+{
+	RenderGraph graph = {};
+	const uint32_t resourceCount = max(passCount / 4,1u);
+	const uint32_t backBuffer = AddRenderGraphImport(&graph,"BackBuffer",RENDER_GRAPH_STATE_PRESENT,RENDER_GRAPH_STATE_PRESENT);
+	uint32_t seed = 12345;
+	vector<uint32_t> transient;
+	for(uint32_t n = 0;n < resourceCount;n++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		transient.push_back(AddRenderGraphTransient(&graph,"Transient",((seed >> 8) % 256 + 1) * ALIGNMENT,ALIGNMENT));
+	}
+	vector<uint32_t> written;
+	for(uint32_t p = 0;p < passCount;p++)
+	{
+		const uint32_t pass = AddRenderGraphPass(&graph,"Random");
+		seed = seed * 1664525 + 1013904223;
+		const uint32_t target = (p + 1 == passCount) ? backBuffer : transient[(seed >> 8) % resourceCount];
+		for(uint32_t n = 0;n < 2 && !written.empty();n++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			const uint32_t source = written[(seed >> 8) % written.size()];
+			if(source != target)
+			{
+				const RenderGraphState state = ((seed & 1) != 0) ? RENDER_GRAPH_STATE_PIXEL_SHADER_RESOURCE : RENDER_GRAPH_STATE_NON_PIXEL_SHADER_RESOURCE;
+				RenderGraphRead(&graph,pass,source,state);
+			}
+		}
+		if(target == backBuffer)
+		{
+			RenderGraphWrite(&graph,pass,target,RENDER_GRAPH_STATE_RENDER_TARGET);
+			continue;
+		}
+		RenderGraphWrite(&graph,pass,target,((seed & 2) != 0) ? RENDER_GRAPH_STATE_RENDER_TARGET : RENDER_GRAPH_STATE_DEPTH_WRITE);
+		written.push_back(target);
+	}
+
+	const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	CompileRenderGraph(&graph);
+	const chrono::duration<double,milli> time = chrono::steady_clock::now() - begin;
+	CHECK(ValidateRenderGraph(&graph));
+	CHECK(!graph.pass[passCount - 1].culled);
+	CHECK(graph.transientHeapSize <= graph.transientRequestedSize);
+
+	printf("RenderGraph: compiled %u passes in %.3f ms, culled %u, barriers %u, transient heap %llu KB (without aliasing %llu KB)\n",
+		passCount,time.count(),graph.culledPassCount,graph.barrierCount,
+		static_cast<unsigned long long>(graph.transientHeapSize / 1024),static_cast<unsigned long long>(graph.transientRequestedSize / 1024));
+	return true;
+}
@@ -0,0 +1,204 @@
+#include "ShaderCache.h"
+#include "TestCheck.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//eXg̊ԂgfBNg(ŌɒgƏ)
+const char* CACHE_DIRECTORY = "ShaderCacheTest";
+
+bool TestWriteFileBytes();
+bool TestShaderKeys();
+bool TestParallelLoad( uint32_t threadCount, uint32_t shaderCount );
+
+int main()
+{
+	error_code error;
+	filesystem::remove_all(CACHE_DIRECTORY,error);
+
+	bool result = true;
+	result = TestWriteFileBytes() && result;
+	result = TestShaderKeys() && result;
+	result = TestParallelLoad(8,64) && result;
+
+	filesystem::remove_all(CACHE_DIRECTORY,error);
+	printf("ShaderCacheTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//fBNg͏ƂɍAOɏƒuAꎞt@C͎cȂ
+bool TestWriteFileBytes()
+{
+	ShaderCache cache;
+	InitShaderCache(&cache,CACHE_DIRECTORY,CompileShaderWithStub,1);
+
+	const char FIRST[] = "first";
+	const char SECOND[] = "second entry";
+	vector<uint8_t> data;
+	CHECK(!ReadShaderCacheFile(&cache,1,"cso",&data));
+	CHECK(WriteShaderCacheFile(&cache,1,"cso",FIRST,sizeof(FIRST)));
+	CHECK(ReadShaderCacheFile(&cache,1,"cso",&data) && data.size() == sizeof(FIRST));
+	CHECK(WriteShaderCacheFile(&cache,1,"cso",SECOND,sizeof(SECOND)));
+	CHECK(ReadShaderCacheFile(&cache,1,"cso",&data) && data.size() == sizeof(SECOND));
+	CHECK(string(reinterpret_cast<const char*>(data.data())) == SECOND);
+
+	//gqƂɕʂ̃t@C
+	CHECK(!ReadShaderCacheFile(&cache,1,"pso",&data));
+	CHECK(GetShaderCacheFileName(&cache,0x1234,"pso") == (filesystem::path(CACHE_DIRECTORY) / "0000000000001234.pso").string());
+
+	uint32_t fileCount = 0;
+	for(const filesystem::directory_entry& entry : filesystem::directory_iterator(CACHE_DIRECTORY))
+	{
+		CHECK(entry.path().extension() != ".tmp");
+		fileCount++;
+	}
+	CHECK(fileCount == 1);
+
+	CHECK(DeleteShaderCacheFile(&cache,1,"cso"));
+	CHECK(!DeleteShaderCacheFile(&cache,1,"cso"));
+	CHECK(!ReadShaderCacheFile(&cache,1,"cso",&data));
+
+	//fBNgȂΎs
+	ShaderCache fileAsDirectory;
+	const string blockerName = string(CACHE_DIRECTORY) + "/blocker";
+	CHECK(WriteFileBytes(blockerName.c_str(),FIRST,sizeof(FIRST)));
+	InitShaderCache(&fileAsDirectory,blockerName.c_str(),CompileShaderWithStub,1);
+	CHECK(!WriteShaderCacheFile(&fileAsDirectory,1,"cso",FIRST,sizeof(FIRST)));
+	error_code error;
+	filesystem::remove(blockerName,error);
+	return true;
+}
+
+//mFp̃RpCŃVF[_[̃LbVm߂
+//E1ڂ̓RpCĕۑA2ڂ̓RpCɓoCgR[hƃL[Ԃ
+//E\[XA}NAGg|CgA^[QbgAtOARpC̃o[ŴǂꂩႦΕʂ̃L[ɂȂ
+bool TestShaderKeys()
+{
+	const string sourceName = string(CACHE_DIRECTORY) + "/CacheCheck.hlsl";
+	const char SOURCE[] = "float4 main() : SV_Target { return 1; }";
+	const char CHANGED_SOURCE[] = "float4 main() : SV_Target { return 0; }";
+	const ShaderMacro DEFINES[] = { { "CHECK", "1" }, { nullptr, nullptr } };
+	const ShaderMacro OTHER_DEFINES[] = { { "CHECK", "2" }, { nullptr, nullptr } };
+
+	ShaderCache cache;
+	InitShaderCache(&cache,CACHE_DIRECTORY,CompileShaderWithStub,1);
+	filesystem::create_directories(CACHE_DIRECTORY);
+	CHECK(WriteFileBytes(sourceName.c_str(),SOURCE,sizeof(SOURCE) - 1));
+
+	//1ڂ̓RpCA2ڂ̓LbV
+	vector<uint8_t> bytecode;
+	vector<uint8_t> cached;
+	uint64_t key = 0;
+	uint64_t cachedKey = 0;
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_0",0,&bytecode,&key));
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_0",0,&cached,&cachedKey));
+	CHECK(cache.shaderMiss == 1 && cache.shaderHit == 1);
+	CHECK(key == cachedKey && bytecode == cached && !bytecode.empty());
+
+	//ǂꂩςƃL[ςăRpC
+	vector<uint64_t> keys;
+	keys.push_back(key);
+	CHECK(LoadShader(&cache,sourceName.c_str(),DEFINES,"main","ps_5_0",0,&bytecode,&key));
+	keys.push_back(key);
+	CHECK(LoadShader(&cache,sourceName.c_str(),OTHER_DEFINES,"main","ps_5_0",0,&bytecode,&key));
+	keys.push_back(key);
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main2","ps_5_0",0,&bytecode,&key));
+	keys.push_back(key);
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_1",0,&bytecode,&key));
+	keys.push_back(key);
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_0",1,&bytecode,&key));
+	keys.push_back(key);
+	cache.compilerVersion = 2;
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_0",0,&bytecode,&key));
+	keys.push_back(key);
+	cache.compilerVersion = 1;
+	CHECK(WriteFileBytes(sourceName.c_str(),CHANGED_SOURCE,sizeof(CHANGED_SOURCE) - 1));
+	CHECK(LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_0",0,&bytecode,&key));
+	keys.push_back(key);
+	CHECK(cache.shaderMiss == keys.size() && cache.shaderHit == 1);
+	for(size_t a = 0;a < keys.size();a++)
+	{
+		for(size_t b = a + 1;b < keys.size();b++)
+		{
+			CHECK(keys[a] != keys[b]);
+		}
+	}
+
+	//\[XΎs
+	CHECK(!LoadShader(&cache,(string(CACHE_DIRECTORY) + "/Missing.hlsl").c_str(),nullptr,"main","ps_5_0",0,&bytecode,&key));
+
+	//t@C
+	for(uint64_t k : keys)
+	{
+		CHECK(DeleteShaderCacheFile(&cache,k,"cso"));
+	}
+	filesystem::remove(sourceName);
+	return true;
+}
+
+//rh̃XbhƓAʁX̃VF[_[ɓǂݍ
+//1ڂ͑SăRpCA2ڂ͑SăLbVǂ
+bool TestParallelLoad( uint32_t threadCount, uint32_t shaderCount )
+{
+	const string sourceName = string(CACHE_DIRECTORY) + "/Parallel.hlsl";
+	const char SOURCE[] = "float4 main() : SV_Target { return 1; }";
+	filesystem::create_directories(CACHE_DIRECTORY);
+	CHECK(WriteFileBytes(sourceName.c_str(),SOURCE,sizeof(SOURCE) - 1));
+
+	ShaderCache cache;
+	InitShaderCache(&cache,CACHE_DIRECTORY,CompileShaderWithStub,1);
+	vector<uint64_t> key(shaderCount);
+	vector<vector<uint8_t>> bytecode(shaderCount);
+	vector<vector<uint8_t>> cached(shaderCount);
+	vector<char> loaded(shaderCount * 2,0);
+	chrono::duration<double,milli> time[2];
+	for(uint32_t pass = 0;pass < 2;pass++)
+	{
+		const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		vector<thread> worker;
+		for(uint32_t t = 0;t < threadCount;t++)
+		{
+			worker.emplace_back([&,t,pass]()
+			{
+				for(uint32_t n = t;n < shaderCount;n += threadCount)
+				{
+					//tOŕʂ̃VF[_[ɂ
+					uint64_t k = 0;
+					vector<uint8_t>* pBytecode = (pass == 0) ? &bytecode[n] : &cached[n];
+					loaded[pass * shaderCount + n] = LoadShader(&cache,sourceName.c_str(),nullptr,"main","ps_5_0",n,pBytecode,&k);
+					if(pass == 0)
+					{
+						key[n] = k;
+					}
+				}
+			});
+		}
+		for(thread& w : worker)
+		{
+			w.join();
+		}
+		time[pass] = chrono::steady_clock::now() - begin;
+	}
+
+	for(uint32_t n = 0;n < shaderCount * 2;n++)
+	{
+		CHECK(loaded[n]);
+	}
+	CHECK(cache.shaderMiss == shaderCount && cache.shaderHit == shaderCount);
+	for(uint32_t n = 0;n < shaderCount;n++)
+	{
+		CHECK(bytecode[n] == cached[n]);
+		CHECK(DeleteShaderCacheFile(&cache,key[n],"cso"));
+	}
+	filesystem::remove(sourceName);
+
+	printf("ShaderCache: %u shaders on %u threads, compile and store %.3f ms, load from cache %.3f ms\n",
+		shaderCount,threadCount,time[0].count(),time[1].count());
+	return true;
+}
@@ -0,0 +1,103 @@
+#include "SpriteBillboard.h"
+#include "SpriteExpand.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace DirectX;
+using namespace std;
+
+const float TOLERANCE = 1e-4f;	//s̊|ɂۂ߂̈Ⴂ͋
+
+bool TestBillboardCorners();
+bool TestBillboardReference( uint32_t spriteCount );
+
+int main()
+{
+	bool result = true;
+	result = TestBillboardCorners() && result;
+	result = TestBillboardReference(100000) && result;
+	printf("SpriteBillboardTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//pSPRITE_CORNEȐɕсArotationʏŉ
+bool TestBillboardCorners()
+{
+	SpriteInstance sprite = {};
+	sprite.position = XMFLOAT3(3.0f,4.0f,5.0f);
+	sprite.size = 2.0f;
+	XMFLOAT4 corner[4];
+	ComputeBillboardCorners(sprite,XMMatrixIdentity(),XMMatrixIdentity(),corner);
+	for(uint32_t k = 0;k < 4;k++)
+	{
+		CHECK(corner[k].x == 3.0f + SPRITE_CORNER[k].offset.x * 2.0f && corner[k].y == 4.0f + SPRITE_CORNER[k].offset.y * 2.0f);
+		CHECK(corner[k].z == 5.0f && corner[k].w == 1.0f);
+	}
+
+	//90x񂷂ƍ̊p͍ɗ
+	sprite.rotation = XM_PIDIV2;
+	ComputeBillboardCorners(sprite,XMMatrixIdentity(),XMMatrixIdentity(),corner);
+	CHECK(fabsf(corner[0].x - 2.0f) <= TOLERANCE && fabsf(corner[0].y - 3.0f) <= TOLERANCE);
+	CHECK(fabsf(corner[3].x - 4.0f) <= TOLERANCE && fabsf(corner[3].y - 5.0f) <= TOLERANCE);
+
+	//UVGSMainƓ
+	const float U[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+	const float V[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+	for(uint32_t k = 0;k < 4;k++)
+	{
+		CHECK(SPRITE_CORNER[k].uv.x == U[k] && SPRITE_CORNER[k].uv.y == V[k]);
+	}
+	return true;
+}
+
+//]ŃJZĂƂ́AGSMainƓœWJlp`ƈv
+//J񂵂Ălp`̓r[ԂZĂ(JĂ)A]Ăӂ̒sizê܂
+bool TestBillboardReference( uint32_t spriteCount )
+{
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,0.0f,-10.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(XM_PIDIV4,1280.0f/720.0f,1.0f,1000.0f);
+
+	vector<SpriteInstance> instance(spriteCount);
+	BuildSpriteInstances(spriteCount,instance.data());
+
+	float billboardError = 0.0f;
+	XMFLOAT4 corner[4];
+	SpriteVertex reference[4];
+	for(uint32_t n = 0;n < spriteCount;n++)
+	{
+		SpriteInstance sprite = instance[n];
+		sprite.rotation = 0.0f;
+		Vertex point;
+		point.possition = sprite.position;
+		point.scale = sprite.size;
+		ComputeBillboardCorners(sprite,view,project,corner);
+		ExpandPointSpritesReference(&point,1,XMMatrixIdentity(),view,project,reference);
+		for(uint32_t k = 0;k < 4;k++)
+		{
+			const XMVECTOR difference = XMVectorSubtract(XMLoadFloat4(&corner[k]),XMLoadFloat4(&reference[k].position));
+			billboardError = max(billboardError,XMVectorGetX(XMVector4Length(difference)));
+		}
+	}
+
+	float facingError = 0.0f;
+	const XMMATRIX rotatedView = XMMatrixLookAtLH({7.0f,5.0f,-6.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	for(uint32_t n = 0;n < spriteCount;n++)
+	{
+		ComputeBillboardCorners(instance[n],XMMatrixRotationY(n * 0.001f) * rotatedView,XMMatrixIdentity(),corner);
+		for(uint32_t k = 1;k < 4;k++)
+		{
+			facingError = max(facingError,fabsf(corner[k].z - corner[0].z));
+		}
+		const XMVECTOR edge = XMVectorSubtract(XMLoadFloat4(&corner[1]),XMLoadFloat4(&corner[0]));
+		facingError = max(facingError,fabsf(XMVectorGetX(XMVector4Length(edge)) - instance[n].size));
+	}
+
+	printf("Billboard: %u sprites, billboard max error %g, facing error %g\n",spriteCount,billboardError,facingError);
+	CHECK(billboardError <= TOLERANCE);
+	CHECK(facingError <= TOLERANCE);
+	return true;
+}
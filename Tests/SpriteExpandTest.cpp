@@ -0,0 +1,108 @@
+#include "SpriteExpand.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace DirectX;
+using namespace std;
+
+const float TOLERANCE = 1e-4f;	//s܂Ƃ߂Ċ|Ƃ̊ۂ߂̈Ⴂ͋
+
+bool TestSmallExpand();
+bool TestExpandReference( uint32_t pointCount );
+
+int main()
+{
+	bool result = true;
+	result = TestSmallExpand() && result;
+	result = TestExpandReference(100000) && result;
+	printf("SpriteExpandTest: %s\n",result ? "passed" : "FAILED");
+	return result ? 0 : 1;
+}
+
+//pGSMainƓ(AEAAE)ɕсAcountɂ͏Ȃ
+bool TestSmallExpand()
+{
+	const uint32_t POINT_COUNT = 3;	//SIMD̕Ŋ؂Ȃ
+	Vertex point[POINT_COUNT];
+	for(uint32_t n = 0;n < POINT_COUNT;n++)
+	{
+		point[n].possition = XMFLOAT3(n * 10.0f,1.0f,2.0f);
+		point[n].scale = 2.0f;
+	}
+
+	SpriteVertex guard = {};
+	guard.position = XMFLOAT4(-1.0f,-1.0f,-1.0f,-1.0f);
+	vector<SpriteVertex> quad((POINT_COUNT + 1) * 4,guard);
+	ExpandPointSprites(point,POINT_COUNT,XMMatrixIdentity(),quad.data());
+
+	const float X[4] = { -1.0f, 1.0f, -1.0f, 1.0f };
+	const float Y[4] = { 2.0f, 2.0f, 0.0f, 0.0f };
+	const float U[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+	const float V[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+	for(uint32_t n = 0;n < POINT_COUNT;n++)
+	{
+		for(uint32_t k = 0;k < 4;k++)
+		{
+			const SpriteVertex& vertex = quad[n * 4 + k];
+			CHECK(vertex.position.x == n * 10.0f + X[k] && vertex.position.y == Y[k]);
+			CHECK(vertex.position.z == 2.0f && vertex.position.w == 1.0f);
+			CHECK(vertex.uv.x == U[k] && vertex.uv.y == V[k]);
+		}
+	}
+	for(uint32_t k = 0;k < 4;k++)
+	{
+		CHECK(quad[POINT_COUNT * 4 + k].position.w == -1.0f);
+	}
+
+	//_ΉȂ
+	ExpandPointSprites(point,0,XMMatrixIdentity(),&guard);
+	CHECK(guard.position.w == -1.0f);
+	return true;
+}
+
+//s܂Ƃ߂Ċ|SIMDœWĴAGSMainƓ1_WĴƈv
+bool TestExpandReference( uint32_t pointCount )
+{
+	const uint32_t FRAME_COUNT = 10;
+
+	//-10`10͈̔͂ɎU΂傫̈Ⴄ_
+	vector<Vertex> point(pointCount);
+	for(uint32_t n = 0;n < pointCount;n++)
+	{
+		point[n].possition = XMFLOAT3(sinf(n * 0.37f) * 10.0f,cosf(n * 0.11f) * 10.0f,sinf(n * 0.05f + 1.0f) * 10.0f);
+		point[n].scale = 0.1f + (n % 10) * 0.1f;
+	}
+	vector<SpriteVertex> quad(static_cast<size_t>(pointCount) * 4);
+	vector<SpriteVertex> reference(static_cast<size_t>(pointCount) * 4);
+
+	const XMMATRIX view = XMMatrixLookAtLH({0.0f,0.0f,-10.0f,0.0f},{0.0f,0.0f,0.0f,0.0f},{0.0f,1.0f,0.0f,0.0f});
+	const XMMATRIX project = XMMatrixPerspectiveFovLH(XM_PIDIV4,1280.0f/720.0f,1.0f,1000.0f);
+
+	float maxError = 0.0f;
+	chrono::steady_clock::duration time = chrono::steady_clock::duration::zero();
+	for(uint32_t frame = 0;frame < FRAME_COUNT;frame++)
+	{
+		const XMMATRIX world = XMMatrixRotationY(frame * 0.1f);
+		const chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		ExpandPointSprites(point.data(),pointCount,world * view * project,quad.data());
+		time += chrono::steady_clock::now() - begin;
+
+		ExpandPointSpritesReference(point.data(),pointCount,world,view,project,reference.data());
+		for(size_t n = 0;n < quad.size();n++)
+		{
+			const XMVECTOR difference = XMVectorSubtract(XMLoadFloat4(&quad[n].position),XMLoadFloat4(&reference[n].position));
+			maxError = max(maxError,XMVectorGetX(XMVector4Length(difference)));
+			CHECK(quad[n].uv.x == reference[n].uv.x && quad[n].uv.y == reference[n].uv.y);
+		}
+	}
+
+	const double ms = chrono::duration<double,milli>(time).count() / FRAME_COUNT;
+	printf("Expand: %u points, SIMD width %u, %.3f ms/frame, max error %g\n",pointCount,SOFTWARE_SIMD_WIDTH,ms,maxError);
+	CHECK(maxError <= TOLERANCE);
+	return true;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+//eXgp̊mF}N
+//藧ȂΏꏊƎWG[ɏo͂āAeXg֐falseԂ
+
+#include <cstdio>
+
+#define CHECK( condition ) \
+	do \
+	{ \
+		if(!(condition)) \
+		{ \
+			fprintf(stderr,"%s(%d): CHECK failed: %s\n",__FILE__,__LINE__,#condition); \
+			return false; \
+		} \
+	} while(false)